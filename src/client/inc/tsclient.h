@@ -147,6 +147,13 @@ typedef struct STableDataBlocks {
   uint32_t       numOfParams;
   SParamInfo *   params;
   SMemRowHelper  rowHelper;
+
+  // columnar submit blocks bound by taos_stmt_bind_columns, each one is a SSubmitBlk head in host byte order
+  // followed by its column chunks
+  char *         pColData;
+  uint32_t       colDataSize;
+  uint32_t       colDataAlloc;
+  int32_t        numOfColBlocks;
 } STableDataBlocks;
 
 typedef struct {
@@ -253,6 +260,8 @@ typedef struct STscObj {
   char               sversion[TSDB_VERSION_LEN];
   char               writeAuth : 1;
   char               superAuth : 1;
+  char               compColData : 1;  // the server returns the compressed column data of query result
+  char               colSubmit : 1;    // all dnodes of the cluster accept the columnar submit blocks
   uint32_t           connId;
   uint64_t           rid;      // ref ID returned by taosAddRef
   int64_t            hbrid;
@@ -355,6 +364,13 @@ void tscAsyncResultOnError(SSqlObj *pSql);
 void tscQueueAsyncError(void(*fp), void *param, int32_t code);
 
 int tscProcessLocalCmd(SSqlObj *pSql);
+
+/**
+ * restore the raw layout of the fetch rsp in pSql->res if its column data is compressed
+ * @param pSql
+ * @param pQueryInfo
+ */
+int32_t tscRestoreRetrieveRsp(SSqlObj *pSql, SQueryInfo *pQueryInfo);
 int tscCfgDynamicOptions(char *msg);
 
 int32_t tscTansformFuncForSTableQuery(SQueryInfo *pQueryInfo);
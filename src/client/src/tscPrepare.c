@@ -808,6 +808,10 @@ static int32_t insertStmtGenLastBlock(STableDataBlocks** lastBlock, STableDataBl
   (*lastBlock)->cloned = true;
   
   (*lastBlock)->pData    = NULL;
+  (*lastBlock)->pColData = NULL;
+  (*lastBlock)->colDataSize  = 0;
+  (*lastBlock)->colDataAlloc = 0;
+  (*lastBlock)->numOfColBlocks = 0;
   (*lastBlock)->ordered  = true;
   (*lastBlock)->prevTS   = INT64_MIN;
   (*lastBlock)->size     = sizeof(SSubmitBlk);
@@ -909,11 +913,8 @@ static int doBindBatchParam(STableDataBlocks* pBlock, SParamInfo* param, TAOS_MU
   return TSDB_CODE_SUCCESS;
 }
 
-static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
-  SSqlCmd* pCmd = &stmt->pSql->cmd;
-  STscStmt* pStmt = (STscStmt*)stmt;
-
-  STableDataBlocks* pBlock = NULL;
+static int32_t insertStmtGetDataBlock(STscStmt* pStmt, STableDataBlocks** pBlock) {
+  SSqlCmd* pCmd = &pStmt->pSql->cmd;
 
   if (pStmt->multiTbInsert) {
     if (pCmd->insertParam.pTableBlockHashList == NULL) {
@@ -927,21 +928,30 @@ static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
       return TSDB_CODE_TSC_APP_ERROR;
     }
 
-    pBlock = *t1;
-  } else {
-    STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(pCmd, 0);
+    *pBlock = *t1;
+    return TSDB_CODE_SUCCESS;
+  }
 
-    STableMeta* pTableMeta = pTableMetaInfo->pTableMeta;
-    if (pCmd->insertParam.pTableBlockHashList == NULL) {
-      pCmd->insertParam.pTableBlockHashList = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, false);
-    }
+  STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(pCmd, 0);
 
-    int32_t ret =
-        tscGetDataBlockFromList(pCmd->insertParam.pTableBlockHashList, pTableMeta->id.uid, TSDB_PAYLOAD_SIZE, sizeof(SSubmitBlk),
-                                pTableMeta->tableInfo.rowSize, &pTableMetaInfo->name, pTableMeta, &pBlock, NULL);
-    if (ret != 0) {
-      return ret;
-    }
+  STableMeta* pTableMeta = pTableMetaInfo->pTableMeta;
+  if (pCmd->insertParam.pTableBlockHashList == NULL) {
+    pCmd->insertParam.pTableBlockHashList = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, false);
+  }
+
+  return tscGetDataBlockFromList(pCmd->insertParam.pTableBlockHashList, pTableMeta->id.uid, TSDB_PAYLOAD_SIZE, sizeof(SSubmitBlk),
+                                 pTableMeta->tableInfo.rowSize, &pTableMetaInfo->name, pTableMeta, pBlock, NULL);
+}
+
+static int insertStmtBindParam(STscStmt* stmt, TAOS_BIND* bind) {
+  SSqlCmd* pCmd = &stmt->pSql->cmd;
+  STscStmt* pStmt = (STscStmt*)stmt;
+
+  STableDataBlocks* pBlock = NULL;
+
+  int32_t ret = insertStmtGetDataBlock(pStmt, &pBlock);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
   }
 
   uint32_t totalDataSize = sizeof(SSubmitBlk) + (pCmd->batchSize + 1) * pBlock->rowSize;
@@ -979,33 +989,9 @@ static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int c
 
   STableDataBlocks* pBlock = NULL;
 
-  if (pStmt->multiTbInsert) {
-    if (pCmd->insertParam.pTableBlockHashList == NULL) {
-      tscError("0x%"PRIx64" Table block hash list is empty", pStmt->pSql->self);
-      return TSDB_CODE_TSC_APP_ERROR;
-    }
-
-    STableDataBlocks** t1 = (STableDataBlocks**)taosHashGet(pCmd->insertParam.pTableBlockHashList, (const char*)&pStmt->mtb.currentUid, sizeof(pStmt->mtb.currentUid));
-    if (t1 == NULL) {
-      tscError("0x%"PRIx64" no table data block in hash list, uid:%" PRId64 , pStmt->pSql->self, pStmt->mtb.currentUid);
-      return TSDB_CODE_TSC_APP_ERROR;
-    }
-
-    pBlock = *t1;
-  } else {
-    STableMetaInfo* pTableMetaInfo = tscGetTableMetaInfoFromCmd(pCmd, 0);
-
-    STableMeta* pTableMeta = pTableMetaInfo->pTableMeta;
-    if (pCmd->insertParam.pTableBlockHashList == NULL) {
-      pCmd->insertParam.pTableBlockHashList = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, false);
-    }
-
-    int32_t ret =
-        tscGetDataBlockFromList(pCmd->insertParam.pTableBlockHashList, pTableMeta->id.uid, TSDB_PAYLOAD_SIZE, sizeof(SSubmitBlk),
-                                pTableMeta->tableInfo.rowSize, &pTableMetaInfo->name, pTableMeta, &pBlock, NULL);
-    if (ret != 0) {
-      return ret;
-    }
+  int32_t ret = insertStmtGetDataBlock(pStmt, &pBlock);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
   }
 
   if (!(colIdx == -1 || (colIdx >= 0 && colIdx < pBlock->numOfParams))) {
@@ -1060,6 +1046,218 @@ static int insertStmtBindParamBatch(STscStmt* stmt, TAOS_MULTI_BIND* bind, int c
 }
 
 
+// Size of the values of a var length column in a columnar submit block, nchar values are sized by the maximum
+// bytes after conversion
+static int32_t insertStmtColumnVarSize(int16_t type, int16_t bytes, TAOS_MULTI_BIND* bind, int32_t rowNum) {
+  int32_t size = 0;
+  int32_t maxLen = bytes - VARSTR_HEADER_SIZE;
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    if (bind == NULL || (bind->is_null != NULL && bind->is_null[i])) {
+      size += VARSTR_HEADER_SIZE + ((type == TSDB_DATA_TYPE_BINARY) ? sizeof(int8_t) : sizeof(int32_t));
+    } else if (bind->length[i] < 0 || bind->length[i] > maxLen) {
+      tscError("binary/nchar length too long, max:%d, actual:%d", maxLen, bind->length[i]);
+      return -1;
+    } else if (type == TSDB_DATA_TYPE_BINARY) {
+      size += VARSTR_HEADER_SIZE + bind->length[i];
+    } else {
+      size += VARSTR_HEADER_SIZE + MIN(bind->length[i] * TSDB_NCHAR_SIZE, maxLen);
+    }
+  }
+
+  return size;
+}
+
+// Write the values of one column to a columnar submit block, a column not bound is filled with NULL
+static int32_t insertStmtBindColumn(int16_t type, int16_t bytes, TAOS_MULTI_BIND* bind, int32_t rowNum, char** ptr) {
+  char* p = *ptr;
+
+  if (!IS_VAR_DATA_TYPE(type)) {
+    int32_t tbytes = TYPE_BYTES[type];
+    if (bind == NULL) {
+      setNullN(p, type, tbytes, rowNum);
+    } else if (bind->buffer_length == tbytes) {
+      memcpy(p, bind->buffer, (size_t)tbytes * rowNum);
+    } else {
+      for (int32_t i = 0; i < rowNum; ++i) {
+        memcpy(p + tbytes * i, (char*)bind->buffer + bind->buffer_length * i, tbytes);
+      }
+    }
+
+    if (bind != NULL && bind->is_null != NULL) {
+      for (int32_t i = 0; i < rowNum; ++i) {
+        if (bind->is_null[i]) {
+          setNull(p + tbytes * i, type, tbytes);
+        }
+      }
+    }
+
+    *ptr = p + tbytes * rowNum;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t* offsets = (int32_t*)p;
+  char*    pVar = p + sizeof(int32_t) * (rowNum + 1);
+  int32_t  len = 0;
+
+  for (int32_t i = 0; i < rowNum; ++i) {
+    char* v = pVar + len;
+    offsets[i] = len;
+
+    if (bind == NULL || (bind->is_null != NULL && bind->is_null[i])) {
+      setVardataNull(v, type);
+    } else if (type == TSDB_DATA_TYPE_BINARY) {
+      STR_WITH_SIZE_TO_VARSTR(v, (char*)bind->buffer + bind->buffer_length * i, bind->length[i]);
+    } else {
+      int32_t output = 0;
+      if (!taosMbsToUcs4((char*)bind->buffer + bind->buffer_length * i, bind->length[i], varDataVal(v),
+                         bytes - VARSTR_HEADER_SIZE, &output)) {
+        tscError("convert nchar string to UCS4_LE failed:%s", (char*)bind->buffer + bind->buffer_length * i);
+        return TSDB_CODE_TSC_INVALID_VALUE;
+      }
+      varDataSetLen(v, output);
+    }
+
+    len += varDataTLen(v);
+  }
+
+  offsets[rowNum] = len;
+  *ptr = pVar + len;
+  return TSDB_CODE_SUCCESS;
+}
+
+// Append the bound columns to the table data block as one columnar submit block. The vnode builds the rows from the
+// columns, so neither the client row buffer nor the SDataRow conversion is needed.
+static int insertStmtBindColumns(STscStmt* pStmt, TAOS_MULTI_BIND* bind) {
+  SSqlCmd*          pCmd = &pStmt->pSql->cmd;
+  STableDataBlocks* pBlock = NULL;
+
+  int32_t code = insertStmtGetDataBlock(pStmt, &pBlock);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  STableMeta* pTableMeta = pBlock->pTableMeta;
+  SSchema*    pSchema = tscGetTableSchema(pTableMeta);
+  int32_t     numOfCols = tscGetNumOfColumns(pTableMeta);
+
+  if (pBlock->numOfParams == 0) {
+    return invalidOperationMsg(tscGetErrorMsgPayload(pCmd), "no param to bind");
+  }
+
+  int32_t rowNum = bind[pBlock->params[0].idx].num;
+  if (rowNum <= 0 || rowNum > INT16_MAX) {
+    tscError("0x%"PRIx64" invalid row num:%d", pStmt->pSql->self, rowNum);
+    return invalidOperationMsg(tscGetErrorMsgPayload(pCmd), "invalid bind param");
+  }
+
+  TAOS_MULTI_BIND** colBinds = calloc(numOfCols, POINTER_BYTES);
+  if (colBinds == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  // the params are matched with the table columns by their offsets in the row
+  int32_t size = sizeof(SSubmitBlk);
+  int32_t offset = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SParamInfo* param = NULL;
+    for (uint32_t j = 0; j < pBlock->numOfParams; ++j) {
+      if (pBlock->params[j].offset == offset) {
+        param = &pBlock->params[j];
+        break;
+      }
+    }
+    offset += pSchema[i].bytes;
+
+    TAOS_MULTI_BIND* b = (param == NULL) ? NULL : &bind[param->idx];
+    if (b != NULL && (b->buffer_type != param->type || b->num != rowNum ||
+                      (IS_VAR_DATA_TYPE(param->type) && b->length == NULL))) {
+      tscError("0x%"PRIx64" bind column %d: type or row num mismatch", pStmt->pSql->self, param->idx);
+      code = invalidOperationMsg(tscGetErrorMsgPayload(pCmd), "bind column type or row num mismatch");
+      goto _end;
+    }
+
+    if (i == PRIMARYKEY_TIMESTAMP_COL_INDEX) {
+      bool hasNull = (b == NULL);
+      for (int32_t n = 0; !hasNull && b->is_null != NULL && n < rowNum; ++n) {
+        hasNull = b->is_null[n];
+      }
+
+      if (hasNull) {
+        code = invalidOperationMsg(tscGetErrorMsgPayload(pCmd), "primary timestamp should not be null");
+        goto _end;
+      }
+    }
+
+    colBinds[i] = b;
+    if (IS_VAR_DATA_TYPE(pSchema[i].type)) {
+      int32_t vsize = insertStmtColumnVarSize(pSchema[i].type, pSchema[i].bytes, b, rowNum);
+      if (vsize < 0) {
+        code = invalidOperationMsg(tscGetErrorMsgPayload(pCmd), "binary/nchar string length too long");
+        goto _end;
+      }
+      size += sizeof(int32_t) * (rowNum + 1) + vsize;
+    } else {
+      size += TYPE_BYTES[pSchema[i].type] * rowNum;
+    }
+  }
+
+  if (pBlock->colDataSize + size > pBlock->colDataAlloc) {
+    uint32_t nAllocSize = (uint32_t)((pBlock->colDataSize + size) * 1.5);
+    char*    tmp = realloc(pBlock->pColData, nAllocSize);
+    if (tmp == NULL) {
+      code = TSDB_CODE_TSC_OUT_OF_MEMORY;
+      goto _end;
+    }
+
+    pBlock->pColData = tmp;
+    pBlock->colDataAlloc = nAllocSize;
+  }
+
+  SSubmitBlk* pBlk = (SSubmitBlk*)(pBlock->pColData + pBlock->colDataSize);
+  memset(pBlk, 0, sizeof(SSubmitBlk));
+  pBlk->uid = pTableMeta->id.uid;
+  pBlk->tid = pTableMeta->id.tid;
+  pBlk->flag = SUBMIT_BLK_COLUMNAR;
+  pBlk->sversion = pTableMeta->sversion;
+  pBlk->numOfRows = (int16_t)rowNum;
+
+  char* ptr = pBlk->data;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    code = insertStmtBindColumn(pSchema[i].type, pSchema[i].bytes, colBinds[i], rowNum, &ptr);
+    if (code != TSDB_CODE_SUCCESS) {
+      code = invalidOperationMsg(tscGetErrorMsgPayload(pCmd), "bind column type mismatch or invalid");
+      goto _end;
+    }
+  }
+
+  pBlk->dataLen = (int32_t)(ptr - pBlk->data);
+  pBlock->colDataSize += sizeof(SSubmitBlk) + pBlk->dataLen;
+  pBlock->numOfColBlocks += 1;
+
+_end:
+  tfree(colBinds);
+  return code;
+}
+
+static bool insertStmtHasColumnData(SSqlCmd* pCmd) {
+  if (pCmd->insertParam.pTableBlockHashList == NULL) {
+    return false;
+  }
+
+  STableDataBlocks** p = taosHashIterate(pCmd->insertParam.pTableBlockHashList, NULL);
+  while (p != NULL) {
+    if ((*p)->numOfColBlocks > 0) {
+      taosHashCancelIterate(pCmd->insertParam.pTableBlockHashList, p);
+      return true;
+    }
+
+    p = taosHashIterate(pCmd->insertParam.pTableBlockHashList, p);
+  }
+
+  return false;
+}
+
 static int insertStmtUpdateBatch(STscStmt* stmt) {
   SSqlObj* pSql = stmt->pSql;
   SSqlCmd* pCmd = &pSql->cmd;
@@ -1130,7 +1328,7 @@ static int insertStmtReset(STscStmt* pStmt) {
 
 static int insertStmtExecute(STscStmt* stmt) {
   SSqlCmd* pCmd = &stmt->pSql->cmd;
-  if (pCmd->batchSize == 0) {
+  if (pCmd->batchSize == 0 && !insertStmtHasColumnData(pCmd)) {
     tscError("no records bind");
     return invalidOperationMsg(tscGetErrorMsgPayload(&stmt->pSql->cmd), "no records bind");
   }
@@ -1849,6 +2047,56 @@ int taos_stmt_bind_param_batch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind) {
   STMT_RET(insertStmtBindParamBatch(pStmt, bind, -1));
 }
 
+int taos_stmt_bind_columns(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind) {
+  STscStmt* pStmt = (STscStmt*)stmt;
+
+  if (stmt == NULL || pStmt->pSql == NULL || pStmt->taos == NULL) {
+    STMT_RET(TSDB_CODE_TSC_DISCONNECTED);
+  }
+
+  if (bind == NULL) {
+    tscError("0x%"PRIx64" invalid parameter", pStmt->pSql->self);
+    STMT_RET(invalidOperationMsg(tscGetErrorMsgPayload(&pStmt->pSql->cmd), "invalid bind param"));
+  }
+
+  if (!pStmt->isInsert) {
+    tscError("0x%"PRIx64" not or invalid batch insert", pStmt->pSql->self);
+    STMT_RET(invalidOperationMsg(tscGetErrorMsgPayload(&pStmt->pSql->cmd), "not or invalid batch insert"));
+  }
+
+  if (pStmt->multiTbInsert) {
+    if (pStmt->last != STMT_SETTBNAME && pStmt->last != STMT_ADD_BATCH) {
+      tscError("0x%"PRIx64" bind param status error, last:%d", pStmt->pSql->self, pStmt->last);
+      STMT_RET(invalidOperationMsg(tscGetErrorMsgPayload(&pStmt->pSql->cmd), "bind param status error"));
+    }
+  } else {
+    if (pStmt->last != STMT_PREPARE && pStmt->last != STMT_ADD_BATCH && pStmt->last != STMT_EXECUTE) {
+      tscError("0x%"PRIx64" bind param status error, last:%d", pStmt->pSql->self, pStmt->last);
+      STMT_RET(invalidOperationMsg(tscGetErrorMsgPayload(&pStmt->pSql->cmd), "bind param status error"));
+    }
+  }
+
+  int code = TSDB_CODE_SUCCESS;
+  if (pStmt->taos->colSubmit) {
+    code = insertStmtBindColumns(pStmt, bind);
+  } else {
+    // the server can't parse the columnar submit blocks, the columns are bound as rows
+    tscDebug("0x%"PRIx64" columnar submit block not supported by server %s, bind as rows", pStmt->pSql->self,
+             pStmt->taos->sversion);
+    code = insertStmtBindParamBatch(pStmt, bind, -1);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = insertStmtAddBatch(pStmt);
+    }
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    // the columns are a complete batch, no taos_stmt_add_batch is needed
+    pStmt->last = STMT_ADD_BATCH;
+  }
+
+  STMT_RET(code);
+}
+
 int taos_stmt_bind_single_param_batch(TAOS_STMT* stmt, TAOS_MULTI_BIND* bind, int colIdx) {
   STscStmt* pStmt = (STscStmt*)stmt;
   if (stmt == NULL || pStmt->pSql == NULL || pStmt->taos == NULL) {
@@ -230,6 +230,11 @@ void tscProcessHeartBeatRsp(void *param, TAOS_RES *tres, int code) {
 
     pSql->pTscObj->connId = htonl(pRsp->connId);
 
+    // a dnode of an older version may join the cluster after the connection is built
+    if (pRes->rspLen >= (int32_t)sizeof(SHeartBeatRsp)) {
+      pObj->colSubmit = (pRsp->colSubmit != 0);
+    }
+
     if (pRsp->killConnection) {
       tscKillConnection(pObj);
       return;
@@ -562,6 +567,11 @@ int tscBuildAndSendRequest(SSqlObj *pSql, SQueryInfo* pQueryInfo) {
   return doBuildAndSendMsg(pSql);
 }
 
+// the ts comp query returns the ts comp file instead of the column data
+static bool tscRetrieveCompColData(SSqlObj *pSql, SQueryInfo *pQueryInfo) {
+  return pSql->pTscObj->compColData && !isTsCompQuery(pQueryInfo);
+}
+
 int tscBuildFetchMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
   SRetrieveTableMsg *pRetrieveMsg = (SRetrieveTableMsg *) pSql->cmd.payload;
 
@@ -569,6 +579,7 @@ int tscBuildFetchMsg(SSqlObj *pSql, SSqlInfo *pInfo) {
 
   pRetrieveMsg->free = htons(pQueryInfo->type);
   pRetrieveMsg->qId  = htobe64(pSql->res.qId);
+  pRetrieveMsg->compColData = tscRetrieveCompColData(pSql, pQueryInfo)? 1:0;
 
   // todo valid the vgroupId at the client side
   STableMetaInfo* pTableMetaInfo = tscGetMetaInfo(pQueryInfo, 0);
@@ -2478,6 +2489,8 @@ int tscProcessConnectRsp(SSqlObj *pSql) {
   strcpy(pObj->sversion, pConnect->serverVersion);
   pObj->writeAuth = pConnect->writeAuth;
   pObj->superAuth = pConnect->superAuth;
+  pObj->compColData = (pConnect->compColData != 0);
+  pObj->colSubmit = (pConnect->colSubmit != 0);
   pObj->connId = htonl(pConnect->connId);
 
   createHbObj(pObj);
@@ -2567,6 +2580,92 @@ int tscProcessQueryRsp(SSqlObj *pSql) {
   return 0;
 }
 
+/*
+ * Restore the compressed column data of the retrieve rsp into the layout of the uncompressed rsp, so that all the
+ * consumers of the result block are not aware of the compression.
+ */
+static int32_t tscDecompressColData(SSqlObj *pSql, SQueryInfo *pQueryInfo) {
+  SSqlRes *pRes = &pSql->res;
+
+  int32_t numOfCols = pQueryInfo->fieldsInfo.numOfOutput;
+  int32_t numOfRows = pRes->numOfRows;
+
+  SRetrieveTableRsp *pRetrieve = (SRetrieveTableRsp *)pRes->pRsp;
+  SRetrieveColHead  *pHead = (SRetrieveColHead *)pRetrieve->data;
+
+  char   *input = pRetrieve->data + sizeof(SRetrieveColHead) * numOfCols;
+  int64_t rawSize = 0;
+  int64_t compSize = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SInternalField *pInfo = (SInternalField *)TARRAY_GET_ELEM(pQueryInfo->fieldsInfo.internalField, i);
+    rawSize += (int64_t)pInfo->field.bytes * numOfRows;
+    compSize += (int32_t)htonl(pHead[i].len);
+  }
+
+  // the table id info of subscription follows the column data
+  int64_t remain = pRes->pRsp + pRes->rspLen - input - compSize;
+  if (remain < 0) {
+    tscError("0x%"PRIx64" invalid compressed column data, rspLen:%d, numOfCols:%d", pSql->self, pRes->rspLen, numOfCols);
+    return TSDB_CODE_TSC_INVALID_VALUE;
+  }
+
+  int32_t len = (int32_t)(sizeof(SRetrieveTableRsp) + rawSize + remain);
+  char   *pRsp = malloc(len);
+  if (pRsp == NULL) {
+    return TSDB_CODE_TSC_OUT_OF_MEMORY;
+  }
+
+  memcpy(pRsp, pRetrieve, sizeof(SRetrieveTableRsp));
+  char *output = ((SRetrieveTableRsp *)pRsp)->data;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SInternalField *pInfo = (SInternalField *)TARRAY_GET_ELEM(pQueryInfo->fieldsInfo.internalField, i);
+
+    int32_t rawLen  = pInfo->field.bytes * numOfRows;
+    int32_t compLen = htonl(pHead[i].len);
+    int8_t  type    = pHead[i].compType;
+
+    int32_t outLen = -1;
+    if (type == TSDB_DATA_TYPE_NULL) {
+      if (compLen == rawLen) {
+        memcpy(output, input, rawLen);
+        outLen = rawLen;
+      }
+    } else if (type > TSDB_DATA_TYPE_NULL && type <= TSDB_DATA_TYPE_UBIGINT) {
+      outLen = (*(tDataTypes[type].decompFunc))(input, compLen, numOfRows, output, rawLen, ONE_STAGE_COMP, NULL, 0);
+    }
+
+    if (outLen != rawLen) {
+      tscError("0x%"PRIx64" failed to decompress column:%d, type:%d, len:%d, expected:%d", pSql->self, i, type, outLen,
+               rawLen);
+      free(pRsp);
+      return TSDB_CODE_TSC_INVALID_VALUE;
+    }
+
+    input += compLen;
+    output += rawLen;
+  }
+
+  memcpy(output, input, (size_t)remain);
+
+  free(pRes->pRsp);
+  pRes->pRsp = pRsp;
+  pRes->rspLen = len;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t tscRestoreRetrieveRsp(SSqlObj *pSql, SQueryInfo *pQueryInfo) {
+  SSqlRes *pRes = &pSql->res;
+
+  // the vnode marks each rsp, it returns the raw column data if compressColData is disabled on it
+  SRetrieveTableRsp *pRetrieve = (SRetrieveTableRsp *)pRes->pRsp;
+  if (pSql->cmd.command != TSDB_SQL_FETCH || pRes->numOfRows <= 0 || pRetrieve->compressed == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return tscDecompressColData(pSql, pQueryInfo);
+}
+
 int tscProcessRetrieveRspFromNode(SSqlObj *pSql) {
   SSqlRes *pRes = &pSql->res;
   SSqlCmd *pCmd = &pSql->cmd;
@@ -2579,14 +2678,21 @@ int tscProcessRetrieveRspFromNode(SSqlObj *pSql) {
     return pRes->code;
   }
 
+  SQueryInfo* pQueryInfo = tscGetQueryInfo(pCmd);
+
   pRes->numOfRows = htonl(pRetrieve->numOfRows);
+  if ((pRes->code = tscRestoreRetrieveRsp(pSql, pQueryInfo)) != TSDB_CODE_SUCCESS) {
+    return pRes->code;
+  }
+
+  pRetrieve = (SRetrieveTableRsp *)pRes->pRsp;
+
   pRes->precision = htons(pRetrieve->precision);
   pRes->offset    = htobe64(pRetrieve->offset);
   pRes->useconds  = htobe64(pRetrieve->useconds);
   pRes->completed = (pRetrieve->completed == 1);
   pRes->data      = pRetrieve->data;
   
-  SQueryInfo* pQueryInfo = tscGetQueryInfo(pCmd);
   if (tscCreateResPointerInfo(pRes, pQueryInfo) != TSDB_CODE_SUCCESS) {
     return pRes->code;
   }
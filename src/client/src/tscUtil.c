@@ -811,7 +811,7 @@ static void freeNcharFilterColumn(SSingleColumnFilterInfo* pFilterInfo, int32_t
 }
 
 
-static void doSetupSDataBlock(SSqlRes* pRes, SSDataBlock* pBlock, SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols) {
+static int32_t doSetupSDataBlock(SSqlRes* pRes, SSDataBlock* pBlock, SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols) {
   int32_t offset = 0;
   char* pData = pRes->data;
 
@@ -832,10 +832,15 @@ static void doSetupSDataBlock(SSqlRes* pRes, SSDataBlock* pBlock, SSingleColumnF
     bool gotNchar = false;
     converNcharFilterColumn(pFilterInfo, numOfFilterCols, pBlock->info.rows, &gotNchar);
     int8_t* p = calloc(pBlock->info.rows, sizeof(int8_t));
-    bool all = doFilterDataBlock(pFilterInfo, numOfFilterCols, pBlock->info.rows, p);
+    bool all = true;
+    int32_t code = (p == NULL) ? TSDB_CODE_TSC_OUT_OF_MEMORY : doFilterDataBlock(pFilterInfo, numOfFilterCols, pBlock->info.rows, p, &all);
     if (gotNchar) {
       freeNcharFilterColumn(pFilterInfo, numOfFilterCols);
     }
+    if (code != TSDB_CODE_SUCCESS) {
+      tfree(p);
+      return code;
+    }
     if (!all) {
       doCompactSDataBlock(pBlock, pBlock->info.rows, p);
     }
@@ -852,6 +857,7 @@ static void doSetupSDataBlock(SSqlRes* pRes, SSDataBlock* pBlock, SSingleColumnF
   }
 
   pRes->numOfRows = 0;
+  return TSDB_CODE_SUCCESS;
 }
 
 // NOTE: there is already exists data blocks before this function calls.
@@ -872,7 +878,13 @@ SSDataBlock* doGetDataBlock(void* param, bool* newgroup) {
 
   pBlock->info.rows = pRes->numOfRows;
   if (pRes->numOfRows != 0) {
-    doSetupSDataBlock(pRes, pBlock, pInput->pFilterInfo, pInput->numOfFilterCols);
+    int32_t code = doSetupSDataBlock(pRes, pBlock, pInput->pFilterInfo, pInput->numOfFilterCols);
+    if (code != TSDB_CODE_SUCCESS) {
+      pRes->code = code;
+      pOperator->status = OP_EXEC_DONE;
+      return NULL;
+    }
+
     *newgroup = false;
     return pBlock;
   }
@@ -887,7 +899,13 @@ SSDataBlock* doGetDataBlock(void* param, bool* newgroup) {
   }
 
   pBlock->info.rows = pRes->numOfRows;
-  doSetupSDataBlock(pRes, pBlock, pInput->pFilterInfo, pInput->numOfFilterCols);
+  int32_t code = doSetupSDataBlock(pRes, pBlock, pInput->pFilterInfo, pInput->numOfFilterCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    pRes->code = code;
+    pOperator->status = OP_EXEC_DONE;
+    return NULL;
+  }
+
   *newgroup = false;
   return pBlock;
 }
@@ -1517,6 +1535,7 @@ void tscDestroyDataBlock(STableDataBlocks* pDataBlock, bool removeMeta) {
   }
 
   tfree(pDataBlock->pData);
+  tfree(pDataBlock->pColData);
 
   if (removeMeta) {
     char name[TSDB_TABLE_FNAME_LEN] = {0};
@@ -1980,6 +1999,59 @@ static void extractTableNameList(SInsertStatementParam *pInsertParam, bool freeB
   }
 }
 
+// Append the columnar submit blocks of a table to the submit block of its vnode. They are appended as they are,
+// only the heads are converted to network byte order.
+static int32_t mergeColumnarDataBlocks(SInsertStatementParam* pInsertParam, STableDataBlocks* pOneTableBlock,
+                                       void* pVnodeDataBlockHashList, SArray* pVnodeDataBlockList) {
+  STableDataBlocks* dataBuf = NULL;
+
+  int32_t ret = tscGetDataBlockFromList(pVnodeDataBlockHashList, pOneTableBlock->vgId, TSDB_PAYLOAD_SIZE,
+                                        sizeof(SMsgDesc) + sizeof(SSubmitMsg), 0, &pOneTableBlock->tableName,
+                                        pOneTableBlock->pTableMeta, &dataBuf, pVnodeDataBlockList);
+  if (ret != TSDB_CODE_SUCCESS) {
+    tscError("0x%"PRIx64" failed to prepare the data block buffer for merging table data, code:%d", pInsertParam->objectId, ret);
+    return ret;
+  }
+
+  uint32_t destSize = dataBuf->size + pOneTableBlock->colDataSize;
+  if (dataBuf->nAllocSize < destSize) {
+    char* tmp = realloc(dataBuf->pData, (size_t)(destSize * 1.5));
+    if (tmp == NULL) {
+      tscError("0x%"PRIx64" failed to allocate memory for merging submit block, size:%u", pInsertParam->objectId, destSize);
+      return TSDB_CODE_TSC_OUT_OF_MEMORY;
+    }
+
+    dataBuf->pData = tmp;
+    dataBuf->nAllocSize = (uint32_t)(destSize * 1.5);
+  }
+
+  char* p = dataBuf->pData + dataBuf->size;
+  memcpy(p, pOneTableBlock->pColData, pOneTableBlock->colDataSize);
+
+  for (int32_t i = 0; i < pOneTableBlock->numOfColBlocks; ++i) {
+    SSubmitBlk* pBlocks = (SSubmitBlk*)p;
+    p += sizeof(SSubmitBlk) + pBlocks->dataLen;
+
+    tscDebug("0x%" PRIx64 " name:%s, tid:%d columnar rows:%d sversion:%d", pInsertParam->objectId,
+             tNameGetTableName(&pOneTableBlock->tableName), pBlocks->tid, pBlocks->numOfRows, pBlocks->sversion);
+
+    pBlocks->uid = htobe64(pBlocks->uid);
+    pBlocks->tid = htonl(pBlocks->tid);
+    pBlocks->flag = htonl(pBlocks->flag);
+    pBlocks->sversion = htonl(pBlocks->sversion);
+    pBlocks->dataLen = htonl(pBlocks->dataLen);
+    pBlocks->schemaLen = htonl(pBlocks->schemaLen);
+    pBlocks->numOfRows = htons(pBlocks->numOfRows);
+  }
+
+  dataBuf->size += pOneTableBlock->colDataSize;
+  dataBuf->numOfTables += pOneTableBlock->numOfColBlocks;
+
+  pOneTableBlock->colDataSize = 0;
+  pOneTableBlock->numOfColBlocks = 0;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tscMergeTableDataBlocks(SInsertStatementParam *pInsertParam, bool freeBlockMap) {
   const int INSERT_HEAD_SIZE = sizeof(SMsgDesc) + sizeof(SSubmitMsg);
   int       code = 0;
@@ -2074,9 +2146,19 @@ int32_t tscMergeTableDataBlocks(SInsertStatementParam *pInsertParam, bool freeBl
       dataBuf->numOfTables += 1;
 
       pBlocks->numOfRows = 0;
-    }else {
+    } else if (pOneTableBlock->numOfColBlocks == 0) {
       tscDebug("0x%"PRIx64" table %s data block is empty", pInsertParam->objectId, pOneTableBlock->tableName.tname);
     }
+
+    if (pOneTableBlock->numOfColBlocks > 0) {
+      code = mergeColumnarDataBlocks(pInsertParam, pOneTableBlock, pVnodeDataBlockHashList, pVnodeDataBlockList);
+      if (code != TSDB_CODE_SUCCESS) {
+        taosHashCleanup(pVnodeDataBlockHashList);
+        tscDestroyBlockArrayList(pVnodeDataBlockList);
+        tfree(blkKeyInfo.pKeyTuple);
+        return code;
+      }
+    }
     
     p = taosHashIterate(pInsertParam->pTableBlockHashList, p);
     if (p == NULL) {
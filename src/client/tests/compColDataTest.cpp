@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+
+#include "os.h"
+
+extern "C" {
+#include "qExecutor.h"
+#include "tglobal.h"
+#include "tscompression.h"
+#include "tsclient.h"
+}
+
+namespace {
+
+const int32_t numOfRows = 1000;
+
+// the columns of one fetch block: ts, int, double, bool and smallint
+class CompColDataTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    addColumn(TSDB_DATA_TYPE_TIMESTAMP);
+    addColumn(TSDB_DATA_TYPE_INT);
+    addColumn(TSDB_DATA_TYPE_DOUBLE);
+    addColumn(TSDB_DATA_TYPE_BOOL);
+    addColumn(TSDB_DATA_TYPE_SMALLINT);
+
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      ((int64_t *)cols[0].pData)[i] = 1600000000000L + i * 1000;
+      ((int32_t *)cols[1].pData)[i] = i % 17;
+      ((double *)cols[2].pData)[i] = i * 0.5;
+      ((int8_t *)cols[3].pData)[i] = (i % 3 == 0);
+      ((int16_t *)cols[4].pData)[i] = (int16_t)(i * 7919);
+    }
+
+    memset(&queryInfo, 0, sizeof(queryInfo));
+    queryInfo.fieldsInfo.numOfOutput = (int16_t)cols.size();
+    queryInfo.fieldsInfo.internalField = (SArray *)taosArrayInit(cols.size(), sizeof(SInternalField));
+    for (size_t i = 0; i < cols.size(); ++i) {
+      SInternalField f = {0};
+      f.field.type = (int8_t)cols[i].info.type;
+      f.field.bytes = cols[i].info.bytes;
+      taosArrayPush(queryInfo.fieldsInfo.internalField, &f);
+    }
+
+    memset(&sql, 0, sizeof(sql));
+    sql.cmd.command = TSDB_SQL_FETCH;
+    sql.res.numOfRows = numOfRows;
+
+    compressColData = tsCompressColData;
+  }
+
+  void TearDown() override {
+    tsCompressColData = compressColData;
+    taosArrayDestroy(queryInfo.fieldsInfo.internalField);
+    for (size_t i = 0; i < cols.size(); ++i) free(cols[i].pData);
+    free(sql.res.pRsp);
+  }
+
+  void addColumn(int16_t type) {
+    SColumnInfoData col;
+    memset(&col, 0, sizeof(col));
+    col.info.colId = (int16_t)cols.size();
+    col.info.type = type;
+    col.info.bytes = tDataTypes[type].bytes;
+    col.pData = (char *)calloc(numOfRows, col.info.bytes);
+    cols.push_back(col);
+  }
+
+  // the rsp as doCopyQueryResultToMsg builds it, the number of subscribed tables follows the column data
+  void buildRsp(bool compressed) {
+    int32_t size = sizeof(SRetrieveTableRsp) + sizeof(int32_t);
+    for (size_t i = 0; i < cols.size(); ++i) {
+      size += cols[i].info.bytes * numOfRows + sizeof(SRetrieveColHead) + COMP_OVERFLOW_BYTES;
+    }
+
+    SRetrieveTableRsp *pRsp = (SRetrieveTableRsp *)calloc(1, size);
+    pRsp->numOfRows = htonl(numOfRows);
+    pRsp->compressed = compressed ? 1 : 0;
+
+    char *data = pRsp->data;
+    if (compressed) {
+      SRetrieveColHead *pHead = (SRetrieveColHead *)data;
+      data += sizeof(SRetrieveColHead) * cols.size();
+      for (size_t i = 0; i < cols.size(); ++i) {
+        data += doCompressColDataToMsg(&cols[i], numOfRows, data, &pHead[i]);
+      }
+    } else {
+      for (size_t i = 0; i < cols.size(); ++i) {
+        memcpy(data, cols[i].pData, cols[i].info.bytes * numOfRows);
+        data += cols[i].info.bytes * numOfRows;
+      }
+    }
+
+    *(int32_t *)data = htonl(0);
+    data += sizeof(int32_t);
+
+    sql.res.pRsp = (char *)pRsp;
+    sql.res.rspLen = (int32_t)(data - (char *)pRsp);
+  }
+
+  // the rsp restored by the client must be the uncompressed rsp
+  void checkRsp() {
+    ASSERT_EQ(tscRestoreRetrieveRsp(&sql, &queryInfo), TSDB_CODE_SUCCESS);
+
+    SRetrieveTableRsp *pRsp = (SRetrieveTableRsp *)sql.res.pRsp;
+    EXPECT_EQ(htonl(pRsp->numOfRows), numOfRows);
+
+    int32_t rawLen = sizeof(SRetrieveTableRsp) + sizeof(int32_t);
+    char   *data = pRsp->data;
+    for (size_t i = 0; i < cols.size(); ++i) {
+      int32_t len = cols[i].info.bytes * numOfRows;
+      EXPECT_EQ(memcmp(data, cols[i].pData, len), 0) << "column:" << i;
+      data += len;
+      rawLen += len;
+    }
+
+    EXPECT_EQ(*(int32_t *)data, htonl(0));
+    EXPECT_EQ(sql.res.rspLen, rawLen);
+  }
+
+  std::vector<SColumnInfoData> cols;
+  SQueryInfo                   queryInfo;
+  SSqlObj                      sql;
+  int32_t                      compressColData;
+};
+
+}  // namespace
+
+TEST_F(CompColDataTest, compressed_rsp) {
+  tsCompressColData = 0;
+  buildRsp(true);
+
+  // each column is shrunk by the codec of its type
+  int32_t rawLen = sizeof(SRetrieveTableRsp) + sizeof(int32_t);
+  for (size_t i = 0; i < cols.size(); ++i) rawLen += cols[i].info.bytes * numOfRows;
+  EXPECT_LT(sql.res.rspLen, rawLen);
+
+  checkRsp();
+}
+
+TEST_F(CompColDataTest, compressed_rsp_with_raw_columns) {
+  // only the ts and double columns exceed the threshold, the others are sent raw after their head
+  tsCompressColData = 4 * numOfRows;
+  buildRsp(true);
+
+  SRetrieveColHead *pHead = (SRetrieveColHead *)((SRetrieveTableRsp *)sql.res.pRsp)->data;
+  EXPECT_EQ(pHead[0].compType, TSDB_DATA_TYPE_TIMESTAMP);
+  EXPECT_EQ(pHead[1].compType, TSDB_DATA_TYPE_NULL);
+  EXPECT_EQ(pHead[2].compType, TSDB_DATA_TYPE_DOUBLE);
+  EXPECT_EQ(pHead[3].compType, TSDB_DATA_TYPE_NULL);
+  EXPECT_EQ(pHead[4].compType, TSDB_DATA_TYPE_NULL);
+
+  checkRsp();
+}
+
+TEST_F(CompColDataTest, uncompressed_rsp) {
+  // the vnode of compressColData -1, or of an old version, returns the raw columns although they are requested
+  tsCompressColData = -1;
+  buildRsp(false);
+
+  char *pRsp = sql.res.pRsp;
+  checkRsp();
+  EXPECT_EQ(sql.res.pRsp, pRsp);
+}
+
+TEST_F(CompColDataTest, corrupted_rsp) {
+  tsCompressColData = 0;
+  buildRsp(true);
+
+  // the length of the first column exceeds the rsp
+  SRetrieveColHead *pHead = (SRetrieveColHead *)((SRetrieveTableRsp *)sql.res.pRsp)->data;
+  pHead[0].len = htonl(sql.res.rspLen);
+  EXPECT_EQ(tscRestoreRetrieveRsp(&sql, &queryInfo), TSDB_CODE_TSC_INVALID_VALUE);
+}
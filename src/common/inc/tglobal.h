@@ -46,12 +46,17 @@ extern int32_t  tsDnodeId;
 extern int      tsRpcTimer;
 extern int      tsRpcMaxTime;
 extern int      tsRpcForceTcp; // all commands go to tcp protocol if this is enabled
+extern int32_t  tsRpcBufPoolSize;  // MB of free rpc message buffers kept for reuse
+extern int32_t  tsRpcIoUring;      // serve TCP connections by io_uring instead of epoll
 extern int32_t  tsMaxConnections;
 extern int32_t  tsMaxShellConns;
 extern int32_t  tsShellActivityTimer;
 extern uint32_t tsMaxTmrCtrl;
 extern float    tsNumOfThreadsPerCore;
 extern int32_t  tsNumOfCommitThreads;
+extern int32_t  tsNumOfFsetCommitThreads;
+extern int32_t  tsWalGroupCommit;  // KB of the wal group commit buffer of one vnode
+extern int32_t  tsWalRestoreReadAhead;  // KB of the wal records read ahead while a vnode restores its wal
 extern float    tsRatioOfQueryCores;
 extern int8_t   tsDaylight;
 extern char     tsTimezone[];
@@ -59,12 +64,25 @@ extern char     tsLocale[];
 extern char     tsCharset[];            // default encode string
 extern int8_t   tsEnableCoreFile;
 extern int32_t  tsCompressMsgSize;
+extern int32_t  tsCompressColData;
 extern char     tsTempDir[];
 
 //query buffer management
 extern int32_t  tsQueryBufferSize;      // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t  tsQueryBufferSizeBytes; // maximum allowed usage buffer size in byte for each data node during query processing
 extern int32_t  tsRetrieveBlockingModel;// retrieve threads will be blocked
+extern int32_t  tsBlockCacheSize;       // decoded data block cache size in MB of each vnode
+extern int32_t  tsBlockBloomBits;       // bloom filter bits per row of each data block column
+extern int32_t  tsAdaptiveCodec;        // codec of each data block column picked by its data
+extern int32_t  tsQueryParallelism;     // scan threads of one super table aggregate query in a vnode
+extern int32_t  tsTagInvertedIndex;     // keep an inverted index of the tag values of each super table
+extern int32_t  tsQueryHeavyCost;       // estimated MB to scan of the queries run by the heavy query threads
+extern int32_t  tsCompactInterval;      // seconds between two background compactions of a vnode
+extern int32_t  tsCompactIoRate;        // MB per second of the reads and writes of a background compaction
+extern int32_t  tsSyncDelta;            // sync only the data blocks a replica misses of a file set
+extern int32_t  tsSyncFwdBatchSize;     // KB of wal records forwarded to a slave by one write
+extern int32_t  tsSyncFwdBatchTime;     // microseconds a forward batch waits at most for more records
+extern int32_t  tsSyncRecvRate;         // MB per second a dnode receives at most from the masters it syncs from
 
 extern int8_t   tsKeepOriginalColumnName;
 
@@ -224,6 +242,7 @@ extern int32_t  tsDiskCfgNum;
 extern SDiskCfg tsDiskCfg[];
 
 #define NEEDTO_COMPRESSS_MSG(size) (tsCompressMsgSize != -1 && (size) > tsCompressMsgSize)
+#define NEEDTO_COMPRESS_COL(size)  (tsCompressColData != -1 && (size) > tsCompressColData)
 
 void    taosInitGlobalCfg();
 int32_t taosCheckGlobalCfg();
@@ -28,6 +28,9 @@ void *  dnodeAllocVQueryQueue(void *pVnode);
 void *  dnodeAllocVFetchQueue(void *pVnode);
 void    dnodeFreeVQueryQueue(void *pQqueue);
 void    dnodeFreeVFetchQueue(void *pFqueue);
+void *  dnodeAllocVHeavyQueue(void *pVnode);
+void    dnodeFreeVHeavyQueue(void *pHqueue);
+void    dnodeGetVReadStat(SVReadLaneStat *pStat);
 
 #ifdef __cplusplus
 }
@@ -17,6 +17,7 @@
 #include "os.h"
 #include "http.h"
 #include "mnode.h"
+#include "tsdb.h"
 #include "dnodeVRead.h"
 #include "dnodeVWrite.h"
 #include "dnodeMRead.h"
@@ -243,6 +244,24 @@ SStatisInfo dnodeGetStatisInfo() {
     info.httpReqNum   = httpGetReqCount();
     info.queryReqNum  = atomic_exchange_32(&tsQueryReqNum, 0);
     info.submitReqNum = atomic_exchange_32(&tsSubmitReqNum, 0);
+
+    STsdbBlkCacheStat blkCacheStat = {0};
+    tsdbGetBlkCacheStat(&blkCacheStat);
+    info.blkCacheHits      = blkCacheStat.hits;
+    info.blkCacheMisses    = blkCacheStat.misses;
+    info.blkCacheEvictions = blkCacheStat.evictions;
+    info.blkCacheSize      = blkCacheStat.size;
+
+    STsdbSyncStat syncStat = {0};
+    tsdbGetSyncStat(&syncStat);
+    info.syncSentBytes   = syncStat.sentBytes;
+    info.syncRecvBytes   = syncStat.recvBytes;
+    info.syncReusedBytes = syncStat.reusedBytes;
+    info.syncFileFSets   = syncStat.fileFSets;
+    info.syncDeltaFSets  = syncStat.deltaFSets;
+
+    walGetStat(&info.walStat);
+    dnodeGetVReadStat(info.vreadStat);
   }
 
   return info;
@@ -24,6 +24,8 @@ static void *dnodeProcessReadQueue(void *pWorker);
 // module global variable
 static SWorkerPool tsVQueryWP;
 static SWorkerPool tsVFetchWP;
+static SWorkerPool tsVHeavyWP;
+static SVReadLaneStat tsVReadStat[VREAD_LANE_MAX];
 
 int32_t dnodeInitVRead() {
   const int32_t maxFetchThreads = 4;
@@ -43,10 +45,22 @@ int32_t dnodeInitVRead() {
   tsVFetchWP.max = tsVFetchWP.min;
   if (tWorkerInit(&tsVFetchWP) != 0) return -1;
 
+  // the heavy queries share a few threads, so they can not hold up all the query threads
+  if (tsQueryHeavyCost > 0) {
+    tsVHeavyWP.name = "vheavy";
+    tsVHeavyWP.workerFp = dnodeProcessReadQueue;
+    tsVHeavyWP.min = MAX((int32_t)threadsForQuery / 4, 1);
+    tsVHeavyWP.max = tsVHeavyWP.min;
+    if (tWorkerInit(&tsVHeavyWP) != 0) return -1;
+  }
+
   return 0;
 }
 
 void dnodeCleanupVRead() {
+  if (tsVHeavyWP.qset != NULL) {
+    tWorkerCleanup(&tsVHeavyWP);
+  }
   tWorkerCleanup(&tsVFetchWP);
   tWorkerCleanup(&tsVQueryWP);
 }
@@ -98,6 +112,48 @@ void dnodeFreeVFetchQueue(void *pFqueue) {
   tWorkerFreeQueue(&tsVFetchWP, pFqueue);
 }
 
+void *dnodeAllocVHeavyQueue(void *pVnode) {
+  if (tsVHeavyWP.qset == NULL) return NULL;
+  return tWorkerAllocQueue(&tsVHeavyWP, pVnode);
+}
+
+void dnodeFreeVHeavyQueue(void *pHqueue) {
+  tWorkerFreeQueue(&tsVHeavyWP, pHqueue);
+}
+
+void dnodeGetVReadStat(SVReadLaneStat *pStat) {
+  SWorkerPool *pools[VREAD_LANE_MAX] = {&tsVQueryWP, &tsVHeavyWP, &tsVFetchWP};
+
+  for (int32_t i = 0; i < VREAD_LANE_MAX; ++i) {
+    pStat[i].queued = taosGetQsetItemsNumber(pools[i]->qset);
+    pStat[i].processed = atomic_load_64(&tsVReadStat[i].processed);
+    pStat[i].waitUs = atomic_load_64(&tsVReadStat[i].waitUs);
+    pStat[i].maxWaitUs = atomic_exchange_64(&tsVReadStat[i].maxWaitUs, 0);
+  }
+}
+
+static void dnodeUpdateVReadStat(SWorkerPool *pPool, SVReadMsg *pRead) {
+  int32_t lane = VREAD_LANE_QUERY;
+  if (pPool == &tsVHeavyWP) {
+    lane = VREAD_LANE_HEAVY;
+  } else if (pPool == &tsVFetchWP) {
+    lane = VREAD_LANE_FETCH;
+  }
+
+  SVReadLaneStat *pStat = tsVReadStat + lane;
+  int64_t         waitUs = taosGetTimestampUs() - pRead->qtime;
+
+  atomic_add_fetch_64(&pStat->processed, 1);
+  atomic_add_fetch_64(&pStat->waitUs, waitUs);
+
+  int64_t maxWaitUs = atomic_load_64(&pStat->maxWaitUs);
+  while (waitUs > maxWaitUs) {
+    int64_t oldVal = atomic_val_compare_exchange_64(&pStat->maxWaitUs, maxWaitUs, waitUs);
+    if (oldVal == maxWaitUs) break;
+    maxWaitUs = oldVal;
+  }
+}
+
 void dnodeSendRpcVReadRsp(void *pVnode, SVReadMsg *pRead, int32_t code) {
   SRpcMsg rpcRsp = {
     .handle  = pRead->rpcHandle,
@@ -130,8 +186,10 @@ static void *dnodeProcessReadQueue(void *wparam) {
       break;
     }
 
-    dTrace("msg:%p, app:%p type:%s will be processed in vquery queue, qtype:%d", pRead, pRead->rpcAhandle,
-           taosMsg[pRead->msgType], qtype);
+    dTrace("msg:%p, app:%p type:%s will be processed in %s queue, qtype:%d", pRead, pRead->rpcAhandle,
+           taosMsg[pRead->msgType], pPool->name, qtype);
+
+    dnodeUpdateVReadStat(pPool, pRead);
 
     int32_t code = vnodeProcessRead(pVnode, pRead);
 
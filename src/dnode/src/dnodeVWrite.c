@@ -214,7 +214,20 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
       dTrace("msg:%p is processed in vwrite queue, code:0x%x", pWrite, pWrite->code);
     }
 
-    walFsync(vnodeGetWal(pVnode), forceFsync);
+    // the forwards of the batch go to the slaves while the wal records are made durable
+    vnodeFlushForwards(pVnode);
+
+    // the writes are acknowledged only after their wal records are durable. The batch fails if the group commit
+    // buffer can't be flushed, its records are lost, or if the forwards are batched, a slave acks all it has written.
+    // Otherwise the fsync error is only logged, as before
+    int32_t code = walFsync(vnodeGetWal(pVnode), forceFsync);
+    if (code != 0 && (tsWalGroupCommit > 0 || tsSyncFwdBatchSize > 0)) {
+      taosResetQitems(pWorker->qall);
+      for (int32_t i = 0; i < numOfMsgs; ++i) {
+        taosGetQitem(pWorker->qall, &qtype, (void **)&pWrite);
+        if (pWrite->code == 0) pWrite->code = code;
+      }
+    }
 
     // browse all items, and process them one by one
     taosResetQitems(pWorker->qall);
@@ -232,6 +245,9 @@ static void *dnodeProcessVWriteQueue(void *wparam) {
         vnodeFreeFromWQueue(pVnode, pWrite);
       }
     }
+
+    // the forwards written as slave are acknowledged to the master together
+    vnodeFlushForwards(pVnode);
   }
 
   return NULL;
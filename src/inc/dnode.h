@@ -22,11 +22,33 @@ extern "C" {
 
 #include "trpc.h"
 #include "taosmsg.h"
+#include "twal.h"
+
+// the vread worker pools, the heavy one runs the queries of high estimated cost if queryHeavyCost is set
+typedef enum { VREAD_LANE_QUERY, VREAD_LANE_HEAVY, VREAD_LANE_FETCH, VREAD_LANE_MAX } EVReadLane;
+
+typedef struct {
+  int32_t queued;     // messages waiting in the queues of the lane
+  int64_t processed;  // messages processed by the lane
+  int64_t waitUs;     // total time the processed messages waited in the queues
+  int64_t maxWaitUs;  // max time a message waited in the queues since the last report
+} SVReadLaneStat;
 
 typedef struct {
   int32_t queryReqNum;
   int32_t submitReqNum;
   int32_t httpReqNum;
+  int64_t blkCacheHits;
+  int64_t blkCacheMisses;
+  int64_t blkCacheEvictions;
+  int64_t blkCacheSize;
+  int64_t syncSentBytes;
+  int64_t syncRecvBytes;
+  int64_t syncReusedBytes;
+  int64_t syncFileFSets;
+  int64_t syncDeltaFSets;
+  SWalStat walStat;
+  SVReadLaneStat vreadStat[VREAD_LANE_MAX];
 } SStatisInfo;
 
 SStatisInfo dnodeGetStatisInfo();
@@ -55,6 +77,8 @@ void *dnodeAllocVQueryQueue(void *pVnode);
 void *dnodeAllocVFetchQueue(void *pVnode);
 void  dnodeFreeVQueryQueue(void *pQqueue);
 void  dnodeFreeVFetchQueue(void *pFqueue);
+void *dnodeAllocVHeavyQueue(void *pVnode);
+void  dnodeFreeVHeavyQueue(void *pHqueue);
 
 int32_t dnodeAllocateMPeerQueue();
 void    dnodeFreeMPeerQueue();
@@ -46,9 +46,10 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId);
  * in which case enough results have been produced already.
  *
  * @param qinfo
+ * @param compColData  the column data in the response message may be compressed
  * @return
  */
-int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContext);
+int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContext, bool compColData);
 
 /**
  *
@@ -78,6 +79,13 @@ int32_t qKillQuery(qinfo_t qinfo);
 
 int32_t qQueryCompleted(qinfo_t qinfo);
 
+/**
+ * the estimated cost of the query, which is the bytes of the data files to scan
+ * @param qinfo  qhandle
+ * @return
+ */
+int64_t qGetQueryCost(qinfo_t qinfo);
+
 /**
  * destroy query info structure
  * @param qHandle
@@ -224,7 +224,7 @@ typedef struct SMsgHead {
 typedef struct SSubmitBlk {
   uint64_t uid;        // table unique id
   int32_t  tid;        // table id
-  int32_t  padding;    // TODO just for padding here
+  int32_t  flag;       // SUBMIT_BLK_xxx
   int32_t  sversion;   // data schema version
   int32_t  dataLen;    // data part length, not including the SSubmitBlk head
   int32_t  schemaLen;  // schema length, if length is 0, no schema exists
@@ -232,6 +232,16 @@ typedef struct SSubmitBlk {
   char     data[];
 } SSubmitBlk;
 
+/*
+ * A columnar submit block carries the columns of all rows instead of rows. The columns follow the
+ * schema order and are in host byte order:
+ *   fixed length column: numOfRows values, a NULL is the null value of the column type
+ *   var length column:   int32_t offset[numOfRows], int32_t len, then len bytes of VarData
+ * The first column is the timestamp column.
+ */
+#define SUBMIT_BLK_COLUMNAR 0x1
+#define SUBMIT_BLK_IS_COLUMNAR(pBlock) (((pBlock)->flag & SUBMIT_BLK_COLUMNAR) != 0)
+
 // Submit message for this TSDB
 typedef struct SSubmitMsg {
   SMsgHead   header;
@@ -345,8 +355,8 @@ typedef struct {
   char      clusterId[TSDB_CLUSTER_ID_LEN];
   int8_t    writeAuth;
   int8_t    superAuth;
-  int8_t    reserved1;
-  int8_t    reserved2;
+  int8_t    compColData;  // the server is able to return the compressed column data in the retrieve rsp
+  int8_t    colSubmit;    // all dnodes accept the columnar submit blocks, SUBMIT_BLK_COLUMNAR
   int32_t   connId;
   SRpcEpSet epSet;
 } SConnectRsp;
@@ -526,17 +536,29 @@ typedef struct {
   SMsgHead header;
   union{uint64_t qhandle; uint64_t qId;}; // query handle
   uint16_t free;
+  int8_t   compColData;  // the columns in rsp may be compressed, absent in the msg of the old client
 } SRetrieveTableMsg;
 
 typedef struct SRetrieveTableRsp {
   int32_t numOfRows;
   int8_t  completed;  // all results are returned to client
+  int8_t  compressed; // the data starts with SRetrieveColHead, always 0 from the old server
   int16_t precision;
   int64_t offset;     // updated offset value for multi-vnode projection query
   int64_t useconds;
   char    data[];
 } SRetrieveTableRsp;
 
+/*
+ * If the compressed column data is requested in SRetrieveTableMsg and compressColData is enabled on the vnode, the
+ * compressed flag of SRetrieveTableRsp is set and its data starts with one SRetrieveColHead for each column, followed
+ * by the data of each column, compressed or not.
+ */
+typedef struct SRetrieveColHead {
+  int8_t  compType;  // data type of the codec, TSDB_DATA_TYPE_NULL if the column data is not compressed
+  int32_t len;       // length of the column data in rsp
+} SRetrieveColHead;
+
 typedef struct {
   int32_t  vgId;
   int32_t  dbCfgVersion;
@@ -682,6 +704,9 @@ typedef struct {
   int8_t   reserved[4];
 } SClusterCfg;
 
+// features of a dnode reported in SStatusMsg, which the version check does not tell
+#define TSDB_DNODE_FEATURE_COL_SUBMIT 0x1  // the vnodes accept the columnar submit blocks
+
 typedef struct {
   uint32_t    version;
   int32_t     dnodeId;
@@ -694,7 +719,8 @@ typedef struct {
   float       diskAvailable;  // GB
   char        clusterId[TSDB_CLUSTER_ID_LEN];
   uint8_t     alternativeRole;
-  uint8_t     reserve2[15];
+  uint8_t     features;          // TSDB_DNODE_FEATURE_*, 0 from the old dnode
+  uint8_t     reserve2[14];
   SClusterCfg clusterCfg;
   SVnodeLoad  load[];
 } SStatusMsg;
@@ -910,6 +936,7 @@ typedef struct {
   uint32_t  connId;
   int8_t    killConnection;
   SRpcEpSet epSet;
+  int8_t    colSubmit;  // as in SConnectRsp, absent in the rsp of the old server
 } SHeartBeatRsp;
 
 typedef struct {
@@ -83,6 +83,27 @@ typedef struct {
   int64_t pointsWritten;  // total data points written
 } STsdbStat;
 
+// --------- TSDB DECODED BLOCK CACHE STATISTICS
+typedef struct {
+  int64_t hits;
+  int64_t misses;
+  int64_t evictions;
+  int64_t size;  // bytes cached by all vnodes
+} STsdbBlkCacheStat;
+
+void tsdbGetBlkCacheStat(STsdbBlkCacheStat *pStat);
+
+// --------- TSDB FILE SYNC STATISTICS
+typedef struct {
+  int64_t sentBytes;    // bytes of files and data blocks sent to replicas
+  int64_t recvBytes;    // bytes of files and data blocks received from the master
+  int64_t reusedBytes;  // bytes of data blocks copied from local files by delta syncs instead of received
+  int64_t fileFSets;    // file sets received as whole files
+  int64_t deltaFSets;   // file sets received by delta syncs
+} STsdbSyncStat;
+
+void tsdbGetSyncStat(STsdbSyncStat *pStat);
+
 typedef struct STsdbRepo STsdbRepo;
 
 STsdbCfg *tsdbGetCfg(const STsdbRepo *repo);
@@ -332,6 +353,15 @@ void tsdbRetrieveDataBlockInfo(TsdbQueryHandleT *pQueryHandle, SDataBlockInfo *p
  */
 int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT *pQueryHandle, SDataStatis **pBlockStatis);
 
+/**
+ * Check the bloom filter of a column in current data block, must be called after the statistics of current
+ * block have been retrieved by tsdbRetrieveDataBlockStatisInfo.
+ *
+ * @pVal the value to check, an int64_t for integer columns, or the string content for binary/nchar columns
+ * @return false only if the column in current block definitely does not contain the value
+ */
+bool tsdbDataBlockMayContain(TsdbQueryHandleT *pQueryHandle, int16_t colId, int8_t type, const void *pVal, int32_t len);
+
 /**
  *
  * The query condition with primary timestamp is passed to iterator during its constructor function,
@@ -390,6 +420,16 @@ void tsdbResetQueryHandleForNewTable(TsdbQueryHandleT queryHandle, STsdbQueryCon
 
 int32_t tsdbGetFileBlocksDistInfo(TsdbQueryHandleT* queryHandle, STableBlockDist* pTableBlockInfo);
 
+/**
+ * estimate the bytes of the data files a query reads
+ * @param tsdb
+ * @param pWindow     query time window
+ * @param numOfTables number of the tables queried
+ * @return the estimated bytes, which are the sizes of the data and last files within the time window, prorated by
+ *         the share of the tables queried
+ */
+int64_t tsdbEstimateScanBytes(STsdbRepo *tsdb, STimeWindow *pWindow, int32_t numOfTables);
+
 /**
  * get the statistics of repo usage
  * @param repo. point to the tsdbrepo
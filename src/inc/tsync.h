@@ -110,6 +110,7 @@ void    syncStop(int64_t rid);
 int32_t syncReconfig(int64_t rid, const SSyncCfg *);
 int32_t syncForwardToPeer(int64_t rid, void *pHead, void *mhandle, int32_t qtype, bool force);
 void    syncConfirmForward(int64_t rid, uint64_t version, int32_t code, bool force);
+void    syncFlushForwards(int64_t rid);  // send the forwards and acks accumulated if syncFwdBatchSize is set
 void    syncRecover(int64_t rid);  // recover from other nodes:
 int32_t syncGetNodesRole(int64_t rid, SNodesRole *);
 
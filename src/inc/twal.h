@@ -46,8 +46,20 @@ typedef struct {
   int32_t  fsyncPeriod;  // millisecond
   EWalType walLevel;     // wal level
   EWalKeep keep;         // keep the wal file when closed
+  int32_t  bufSize;      // group commit buffer in bytes, 0: each record is written by itself
+  int32_t  restoreBufSize;  // read ahead buffer of restore in bytes, 0: records are read and applied by one thread
 } SWalCfg;
 
+#define WAL_HIST_BUCKETS 5
+
+typedef struct {
+  int64_t flushes;                       // group commits of all wals
+  int64_t records;                       // records written by group commits
+  int64_t bytes;                         // bytes written by group commits
+  int64_t batchHist[WAL_HIST_BUCKETS];   // records of a group commit: 1, <=4, <=16, <=64, >64
+  int64_t latencyHist[WAL_HIST_BUCKETS]; // write and sync time of a group commit: <=100us, <=1ms, <=10ms, <=100ms, >100ms
+} SWalStat;
+
 typedef void *  twalh;  // WAL HANDLE
 typedef int32_t FWalWrite(void *ahandle, void *pHead, int32_t qtype, void *pMsg);
 
@@ -61,11 +73,12 @@ int32_t  walRenew(twalh);
 void     walRemoveOneOldFile(twalh);
 void     walRemoveAllOldFiles(twalh);
 int32_t  walWrite(twalh, SWalHead *);
-void     walFsync(twalh, bool forceFsync);
+int32_t  walFsync(twalh, bool forceFsync);
 int32_t  walRestore(twalh, void *pVnode, FWalWrite writeFp);
 int32_t  walGetWalFile(twalh, char *fileName, int64_t *fileId);
 uint64_t walGetVersion(twalh);
 void     walResetVersion(twalh, uint64_t newVer);
+void     walGetStat(SWalStat *pStat);
 
 #ifdef __cplusplus
 }
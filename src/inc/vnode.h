@@ -37,6 +37,7 @@ typedef struct {
   void *  pVnode;
   int8_t  qtype;
   int8_t  msgType;
+  int64_t qtime;  // the time in us the message is put into the queue
   SRspRet rspRet;
   char    pCont[];
 } SVReadMsg;
@@ -82,6 +83,7 @@ int32_t vnodeProcessWrite(void *pVnode, void *pHead, int32_t qtype, void *pRspRe
 
 // vnodeSync
 void    vnodeConfirmForward(void *pVnode, uint64_t version, int32_t code, bool force);
+void    vnodeFlushForwards(void *pVnode);
 
 // vnodeRead
 int32_t vnodeWriteToRQueue(void *pVnode, void *pCont, int32_t contLen, int8_t qtype, void *rparam);
@@ -69,7 +69,7 @@ typedef struct SDnodeObj {
   int16_t    memoryAvgUsage;   // calc from sys.mem
   int16_t    bandwidthUsage;   // calc from sys.band
   int8_t     offlineReason;
-  int8_t     reserved2[1];
+  uint8_t    features;         // from dnode status msg, TSDB_DNODE_FEATURE_*
 } SDnodeObj;
 
 typedef struct SMnodeObj {
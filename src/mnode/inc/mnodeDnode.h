@@ -68,6 +68,7 @@ int32_t mnodeGetDnodesNum();
 int32_t mnodeGetOnlinDnodesCpuCoreNum();
 int32_t mnodeGetOnlineDnodesNum();
 void    mnodeGetOnlineAndTotalDnodesNum(int32_t *onlineNum, int32_t *totalNum);
+bool    mnodeAllDnodesHaveFeature(uint8_t feature);
 void *  mnodeGetNextDnode(void *pIter, SDnodeObj **pDnode);
 void    mnodeCancelGetNextDnode(void *pIter);
 void    mnodeIncDnodeRef(SDnodeObj *pDnode);
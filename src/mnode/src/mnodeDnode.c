@@ -265,6 +265,25 @@ int32_t mnodeGetOnlineDnodesNum() {
   return onlineDnodes;
 }
 
+// a dnode has no features before its first status msg, so an offline one of an older version is not taken as capable
+bool mnodeAllDnodesHaveFeature(uint8_t feature) {
+  SDnodeObj *pDnode = NULL;
+  void *     pIter = NULL;
+
+  while (1) {
+    pIter = mnodeGetNextDnode(pIter, &pDnode);
+    if (pDnode == NULL) break;
+    if ((pDnode->features & feature) != feature) {
+      mnodeDecDnodeRef(pDnode);
+      mnodeCancelGetNextDnode(pIter);
+      return false;
+    }
+    mnodeDecDnodeRef(pDnode);
+  }
+
+  return true;
+}
+
 void mnodeGetOnlineAndTotalDnodesNum(int32_t *onlineNum, int32_t *totalNum) {
   SDnodeObj *pDnode = NULL;
   void *     pIter = NULL;
@@ -556,6 +575,7 @@ static int32_t mnodeProcessDnodeStatusMsg(SMnodeMsg *pMsg) {
   pDnode->diskAvailable    = pStatus->diskAvailable;
   pDnode->alternativeRole  = pStatus->alternativeRole;
   pDnode->moduleStatus     = pStatus->moduleStatus;
+  pDnode->features         = pStatus->features;
 
   if (pStatus->dnodeId == 0) {
     mDebug("dnode:%d %s, first access, set clusterId %s", pDnode->dnodeId, pDnode->dnodeEp, mnodeGetClusterId());
@@ -1133,6 +1133,7 @@ static void *sdbWorkerFp(void *pWorker) {
       sdbTrace("vgId:1, msg:%p is processed in sdb queue, code:%x", pRow->pMsg, pRow->code);
     }
 
+    syncFlushForwards(tsSdbMgmt.sync);
     walFsync(tsSdbMgmt.wal, true);
 
     // browse all items, and process them one by one
@@ -1152,6 +1153,8 @@ static void *sdbWorkerFp(void *pWorker) {
         sdbFreeFromQueue(pRow);
       }
     }
+
+    syncFlushForwards(tsSdbMgmt.sync);
   }
 
   return NULL;
@@ -282,6 +282,7 @@ static int32_t mnodeProcessHeartBeatMsg(SMnodeMsg *pMsg) {
 
   pRsp->onlineDnodes = htonl(onlineDnodes);
   pRsp->totalDnodes = htonl(totalDnodes);
+  pRsp->colSubmit = mnodeAllDnodesHaveFeature(TSDB_DNODE_FEATURE_COL_SUBMIT) ? 1 : 0;
   mnodeGetMnodeEpSetForShell(&pRsp->epSet, false);
 
   pMsg->rpcRsp.rsp = pRsp;
@@ -348,6 +349,8 @@ static int32_t mnodeProcessConnectMsg(SMnodeMsg *pMsg) {
   memcpy(pConnectRsp->serverVersion, version, TSDB_VERSION_LEN);
   pConnectRsp->writeAuth = pUser->writeAuth;
   pConnectRsp->superAuth = pUser->superAuth;
+  pConnectRsp->compColData = 1;
+  pConnectRsp->colSubmit = mnodeAllDnodesHaveFeature(TSDB_DNODE_FEATURE_COL_SUBMIT) ? 1 : 0;
   
   mnodeGetMnodeEpSetForShell(&pConnectRsp->epSet, false);
 
@@ -32,6 +32,10 @@ extern "C" {
 #if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
 typedef int32_t FileFd;
 typedef SOCKET  SocketFd;
+struct iovec {
+  void * iov_base;
+  size_t iov_len;
+};
 #else
 typedef int32_t FileFd;
 typedef int32_t SocketFd;
@@ -39,10 +43,12 @@ typedef int32_t SocketFd;
 
 int64_t taosRead(FileFd fd, void *buf, int64_t count);
 int64_t taosWrite(FileFd fd, void *buf, int64_t count);
+int64_t taosWritev(FileFd fd, struct iovec *iov, int32_t iovcnt);
 
 int64_t taosLSeek(FileFd fd, int64_t offset, int32_t whence);
 int32_t taosFtruncate(FileFd fd, int64_t length);
 int32_t taosFsync(FileFd fd);
+int32_t taosFdatasync(FileFd fd);
 
 int32_t taosRename(char* oldName, char *newName);
 int64_t taosCopy(char *from, char *to);
@@ -371,6 +371,18 @@ int32_t taosFsync(FileFd fd) {
   return FlushFileBuffers(h);
 }
 
+int32_t taosFdatasync(FileFd fd) { return taosFsync(fd); }
+
+int64_t taosWritev(FileFd fd, struct iovec *iov, int32_t iovcnt) {
+  int64_t n = 0;
+  for (int32_t i = 0; i < iovcnt; ++i) {
+    if (taosWrite(fd, iov[i].iov_base, iov[i].iov_len) < 0) return -1;
+    n += iov[i].iov_len;
+  }
+
+  return n;
+}
+
 int32_t taosRename(char *oldName, char *newName) {
   int32_t code = MoveFileEx(oldName, newName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED);
   if (code < 0) {
@@ -387,6 +399,42 @@ int32_t taosRename(char *oldName, char *newName) {
 int32_t taosFtruncate(FileFd fd, int64_t length) { return ftruncate(fd, length); }
 int32_t taosFsync(FileFd fd) { return fsync(fd); }
 
+int32_t taosFdatasync(FileFd fd) {
+#if defined(_TD_DARWIN_64)
+  return fsync(fd);
+#else
+  return fdatasync(fd);
+#endif
+}
+
+int64_t taosWritev(FileFd fd, struct iovec *iov, int32_t iovcnt) {
+  int64_t n = 0;
+
+  while (iovcnt > 0) {
+    int64_t nwritten = writev(fd, iov, iovcnt);
+    if (nwritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    n += nwritten;
+
+    // skip the vectors written completely, and move into the partially written one
+    while (iovcnt > 0 && nwritten >= (int64_t)iov->iov_len) {
+      nwritten -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = (char *)iov->iov_base + nwritten;
+      iov->iov_len -= nwritten;
+    }
+  }
+
+  return n;
+}
+
 int32_t taosRename(char *oldName, char *newName) {
   int32_t code = rename(oldName, newName);
   if (code < 0) {
@@ -33,7 +33,7 @@
 #define monDebug(...) { if (monDebugFlag & DEBUG_DEBUG) { taosPrintLog("MON ", monDebugFlag, __VA_ARGS__); }}
 #define monTrace(...) { if (monDebugFlag & DEBUG_TRACE) { taosPrintLog("MON ", monDebugFlag, __VA_ARGS__); }}
 
-#define SQL_LENGTH     1030
+#define SQL_LENGTH     2048
 #define LOG_LEN_STR    100
 #define IP_LEN_STR     TSDB_EP_LEN
 #define CHECK_INTERVAL 1000
@@ -46,6 +46,14 @@ typedef enum {
   MON_CMD_CREATE_TB_DN,
   MON_CMD_CREATE_TB_ACCT_ROOT,
   MON_CMD_CREATE_TB_SLOWQUERY,
+  MON_CMD_CREATE_MT_BLKCACHE,
+  MON_CMD_CREATE_TB_BLKCACHE,
+  MON_CMD_CREATE_MT_WAL,
+  MON_CMD_CREATE_TB_WAL,
+  MON_CMD_CREATE_MT_VREAD,
+  MON_CMD_CREATE_TB_VREAD,
+  MON_CMD_CREATE_MT_TSDBSYNC,
+  MON_CMD_CREATE_TB_TSDBSYNC,
   MON_CMD_MAX
 } EMonCmd;
 
@@ -239,6 +247,46 @@ static void monBuildMonitorSql(char *sql, int32_t cmd) {
              "create table if not exists %s.log(ts timestamp, level tinyint, "
              "content binary(%d), ipaddr binary(%d))",
              tsMonitorDbName, LOG_LEN_STR, IP_LEN_STR);
+  } else if (cmd == MON_CMD_CREATE_MT_BLKCACHE) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.blkcache(ts timestamp"
+             ", hits bigint, misses bigint, evictions bigint, cached_bytes bigint"
+             ") tags (dnodeid int, fqdn binary(%d))",
+             tsMonitorDbName, TSDB_FQDN_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_BLKCACHE) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.blkcache_dn%d using %s.blkcache tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
+  } else if (cmd == MON_CMD_CREATE_MT_WAL) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.walgc(ts timestamp"
+             ", flushes bigint, records bigint, bytes bigint"
+             ", batch_1 bigint, batch_4 bigint, batch_16 bigint, batch_64 bigint, batch_inf bigint"
+             ", latency_100us bigint, latency_1ms bigint, latency_10ms bigint, latency_100ms bigint, latency_inf bigint"
+             ") tags (dnodeid int, fqdn binary(%d))",
+             tsMonitorDbName, TSDB_FQDN_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_WAL) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.walgc_dn%d using %s.walgc tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
+  } else if (cmd == MON_CMD_CREATE_MT_VREAD) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.vread(ts timestamp"
+             ", query_queued int, query_processed bigint, query_wait_us bigint, query_max_wait_us bigint"
+             ", heavy_queued int, heavy_processed bigint, heavy_wait_us bigint, heavy_max_wait_us bigint"
+             ", fetch_queued int, fetch_processed bigint, fetch_wait_us bigint, fetch_max_wait_us bigint"
+             ") tags (dnodeid int, fqdn binary(%d))",
+             tsMonitorDbName, TSDB_FQDN_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_VREAD) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.vread_dn%d using %s.vread tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
+  } else if (cmd == MON_CMD_CREATE_MT_TSDBSYNC) {
+    snprintf(sql, SQL_LENGTH,
+             "create table if not exists %s.tsdbsync(ts timestamp"
+             ", sent_bytes bigint, recv_bytes bigint, reused_bytes bigint, file_fsets bigint, delta_fsets bigint"
+             ") tags (dnodeid int, fqdn binary(%d))",
+             tsMonitorDbName, TSDB_FQDN_LEN);
+  } else if (cmd == MON_CMD_CREATE_TB_TSDBSYNC) {
+    snprintf(sql, SQL_LENGTH, "create table if not exists %s.tsdbsync_dn%d using %s.tsdbsync tags(%d, '%s')",
+             tsMonitorDbName, dnodeGetDnodeId(), tsMonitorDbName, dnodeGetDnodeId(), tsLocalEp);
   }
 
   sql[SQL_LENGTH] = 0;
@@ -313,9 +361,8 @@ static int32_t monBuildBandSql(char *sql) {
   return sprintf(sql, ", %f", bandSpeedKb);
 }
 
-static int32_t monBuildReqSql(char *sql) {
-  SStatisInfo info = dnodeGetStatisInfo();
-  return sprintf(sql, ", %d, %d, %d)", info.httpReqNum, info.queryReqNum, info.submitReqNum);
+static int32_t monBuildReqSql(char *sql, SStatisInfo *pInfo) {
+  return sprintf(sql, ", %d, %d, %d)", pInfo->httpReqNum, pInfo->queryReqNum, pInfo->submitReqNum);
 }
 
 static int32_t monBuildIoSql(char *sql) {
@@ -328,17 +375,62 @@ static int32_t monBuildIoSql(char *sql) {
   return sprintf(sql, ", %f, %f", readKB, writeKB);
 }
 
+static int32_t monBuildBlkCacheSql(char *sql, SStatisInfo *pInfo) {
+  return sprintf(sql, " %s.blkcache_dn%d values(%" PRId64 ", %" PRId64 ", %" PRId64 ", %" PRId64 ", %" PRId64 ")",
+                 tsMonitorDbName, dnodeGetDnodeId(), taosGetTimestampUs(), pInfo->blkCacheHits,
+                 pInfo->blkCacheMisses, pInfo->blkCacheEvictions, pInfo->blkCacheSize);
+}
+
+static int32_t monBuildWalSql(char *sql, SStatisInfo *pInfo) {
+  SWalStat *pStat = &pInfo->walStat;
+  int32_t   pos = sprintf(sql, " %s.walgc_dn%d values(%" PRId64 ", %" PRId64 ", %" PRId64 ", %" PRId64, tsMonitorDbName,
+                        dnodeGetDnodeId(), taosGetTimestampUs(), pStat->flushes, pStat->records, pStat->bytes);
+
+  for (int32_t i = 0; i < WAL_HIST_BUCKETS; ++i) {
+    pos += sprintf(sql + pos, ", %" PRId64, pStat->batchHist[i]);
+  }
+  for (int32_t i = 0; i < WAL_HIST_BUCKETS; ++i) {
+    pos += sprintf(sql + pos, ", %" PRId64, pStat->latencyHist[i]);
+  }
+
+  return pos + sprintf(sql + pos, ")");
+}
+
+static int32_t monBuildVReadSql(char *sql, SStatisInfo *pInfo) {
+  int32_t pos = sprintf(sql, " %s.vread_dn%d values(%" PRId64, tsMonitorDbName, dnodeGetDnodeId(), taosGetTimestampUs());
+
+  for (int32_t i = 0; i < VREAD_LANE_MAX; ++i) {
+    SVReadLaneStat *pStat = pInfo->vreadStat + i;
+    pos += sprintf(sql + pos, ", %d, %" PRId64 ", %" PRId64 ", %" PRId64, pStat->queued, pStat->processed,
+                   pStat->waitUs, pStat->maxWaitUs);
+  }
+
+  return pos + sprintf(sql + pos, ")");
+}
+
+static int32_t monBuildTsdbSyncSql(char *sql, SStatisInfo *pInfo) {
+  return sprintf(sql, " %s.tsdbsync_dn%d values(%" PRId64 ", %" PRId64 ", %" PRId64 ", %" PRId64 ", %" PRId64
+                 ", %" PRId64 ")",
+                 tsMonitorDbName, dnodeGetDnodeId(), taosGetTimestampUs(), pInfo->syncSentBytes, pInfo->syncRecvBytes,
+                 pInfo->syncReusedBytes, pInfo->syncFileFSets, pInfo->syncDeltaFSets);
+}
+
 static void monSaveSystemInfo() {
-  int64_t ts = taosGetTimestampUs();
-  char *  sql = tsMonitor.sql;
-  int32_t pos = snprintf(sql, SQL_LENGTH, "insert into %s.dn%d values(%" PRId64, tsMonitorDbName, dnodeGetDnodeId(), ts);
+  int64_t     ts = taosGetTimestampUs();
+  char *      sql = tsMonitor.sql;
+  SStatisInfo info = dnodeGetStatisInfo();
+  int32_t     pos = snprintf(sql, SQL_LENGTH, "insert into %s.dn%d values(%" PRId64, tsMonitorDbName, dnodeGetDnodeId(), ts);
 
   pos += monBuildCpuSql(sql + pos);
   pos += monBuildMemorySql(sql + pos);
   pos += monBuildDiskSql(sql + pos);
   pos += monBuildBandSql(sql + pos);
   pos += monBuildIoSql(sql + pos);
-  pos += monBuildReqSql(sql + pos);
+  pos += monBuildReqSql(sql + pos, &info);
+  pos += monBuildBlkCacheSql(sql + pos, &info);
+  pos += monBuildWalSql(sql + pos, &info);
+  pos += monBuildVReadSql(sql + pos, &info);
+  pos += monBuildTsdbSyncSql(sql + pos, &info);
 
   void *res = taos_query(tsMonitor.conn, tsMonitor.sql);
   int32_t code = taos_errno(res);
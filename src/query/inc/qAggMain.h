@@ -104,6 +104,8 @@ extern "C" {
 #define GET_FORWARD_DIRECTION_FACTOR(ord) (((ord) == TSDB_ORDER_ASC) ? QUERY_ASC_FORWARD_STEP : QUERY_DESC_FORWARD_STEP)
 
 #define MAX_INTERVAL_TIME_WINDOW 1000000  // maximum allowed time windows in final results
+#define MAX_DENSE_TIME_WINDOW    16384    // maximum time windows located by the dense index of one SResultRowInfo
+#define MAX_DENSE_INDEX_SIZE     (64 * 1048576L)  // maximum bytes of the dense time window index of one query
 #define TOP_BOTTOM_QUERY_LIMIT   100
 
 enum {
@@ -20,6 +20,7 @@
 #include "hash.h"
 #include "qAggMain.h"
 #include "qFill.h"
+#include "qGroupHash.h"
 #include "qResultbuf.h"
 #include "qSqlparser.h"
 #include "qTableMeta.h"
@@ -33,6 +34,7 @@
 
 struct SColumnFilterElem;
 typedef bool (*__filter_func_t)(struct SColumnFilterElem* pFilter, const char* val1, const char* val2, int16_t type);
+typedef void (*__filter_batch_func_t)(struct SColumnFilterElem* pFilter, const char* pData, int32_t numOfRows, int8_t* p);
 typedef int32_t (*__block_search_fn_t)(char* data, int32_t num, int64_t key, int32_t order);
 
 #define IS_QUERY_KILLED(_q) ((_q)->code == TSDB_CODE_TSC_QUERY_CANCELLED)
@@ -107,11 +109,18 @@ typedef struct SResultRowInfo {
   int32_t      size:24;    // number of result set
   int32_t      capacity;   // max capacity
   int32_t      curPos;     // current active result row index of pResult list
+  int32_t      denseSize;  // number of fixed length time windows in pDenseIndex, -1 if not available
+  int32_t*     pDenseIndex;// index in pResult list of each time window starting from denseSkey, -1 if not added
+  TSKEY        denseSkey;  // start key of the first time window in pDenseIndex
+  int64_t      denseTid;   // pDenseIndex only serves the time windows of one table in one group
+  uint64_t     denseGroupId;
+  int64_t*     pDenseCharged;  // the counter of runtime env charged with the bytes of pDenseIndex
 } SResultRowInfo;
 
 typedef struct SColumnFilterElem {
   int16_t           bytes;  // column length
   __filter_func_t   fp;
+  __filter_batch_func_t bfp;  // evaluate the filter over a column, NULL if not supported by the column type
   SColumnFilterInfo filterInfo;
   void              *q;
 } SColumnFilterElem;
@@ -280,6 +289,7 @@ typedef struct SQueryRuntimeEnv {
   SHashObj*             pResultRowHashTable; // quick locate the window object for each result
   SHashObj*             pResultRowListSet;   // used to check if current ResultRowInfo has ResultRow object or not
   char*                 keyBuf;           // window key buffer
+  int64_t               denseIndexSize;   // bytes of the dense time window index of all SResultRowInfo
   SResultRowPool*       pool;             // window result object pool
   char**                prevRow;
 
@@ -331,6 +341,7 @@ enum OPERATOR_TYPE_E {
   OP_Distinct          = 20,
   OP_Join              = 21,
   OP_StateWindow       = 22,
+  OP_ParallelScan      = 23,   // scan the tables of a super table query with multiple threads.
 };
 
 typedef struct SOperatorInfo {
@@ -374,7 +385,9 @@ typedef struct SQInfo {
   tsem_t           ready;
   int32_t          dataReady;   // denote if query result is ready or not
   void*            rspContext;  // response context
+  bool             compColData; // the column data in the retrieve rsp may be compressed
   int64_t          startExecTs; // start to exec timestamp
+  int64_t          scanCost;    // estimated bytes of the data files to scan, used to schedule the query
   char*            sql;         // query sql string
   SQueryCostInfo   summary;
 } SQInfo;
@@ -457,6 +470,23 @@ typedef struct SLimitOperatorInfo {
   int64_t   total;
 } SLimitOperatorInfo;
 
+typedef struct SParallelScanWorker {
+  SQInfo       *pQInfo;   // query over a subset of the tables, with its own runtime env and query handle
+  SSDataBlock  *pRes;     // the first result block, produced by the scan thread
+  bool          pending;  // pRes has not been returned yet
+  int32_t       code;
+  struct SParallelScanOperatorInfo *pInfo;
+} SParallelScanWorker;
+
+typedef struct SParallelScanOperatorInfo {
+  SParallelScanWorker *pWorkers;
+  int32_t              numOfWorkers;
+  int32_t              numOfRunning;
+  int32_t              current;   // index of the worker whose results are returned now
+  pthread_mutex_t      mutex;
+  pthread_cond_t       cond;
+} SParallelScanOperatorInfo;
+
 typedef struct SSLimitOperatorInfo {
   int64_t   groupTotal;
   int64_t   currentGroupOffset;
@@ -484,9 +514,19 @@ typedef struct SFillOperatorInfo {
 } SFillOperatorInfo;
 
 typedef struct SGroupbyOperatorInfo {
-  SOptrBasicInfo binfo;
-  int32_t        colIndex;
-  char          *prevData;   // previous group by value
+  SOptrBasicInfo  binfo;
+  int32_t         colIndex;
+  char           *prevData;   // previous group by value
+  SGroupHashInfo *pGroupHash; // group id of each group by value, the data of group is the SResultRow
+  int32_t         groupIndex; // the table group that the groups in pGroupHash belong to
+  int32_t         capacity;   // number of rows of the buffers below
+  int32_t        *pRowGroup;  // group of each row in current block
+  int32_t        *pGroups;    // group id of each group in current block
+  int32_t        *pRowIndex;  // rows of current block ordered by group
+  int32_t        *pOffset;    // end position in pRowIndex of each group
+  char          **pInput;     // original input of each function
+  char           *pGatherBuf; // input columns of current block ordered by group
+  int32_t         gatherBufSize;
 } SGroupbyOperatorInfo;
 
 typedef struct SSWindowOperatorInfo {
@@ -565,6 +605,7 @@ SOperatorInfo* createFilterOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, SOperator
                                         int32_t numOfOutput, SColumnInfo* pCols, int32_t numOfFilter);
 
 SOperatorInfo* createJoinOperatorInfo(SOperatorInfo** pUpstream, int32_t numOfUpstream, SSchema* pSchema, int32_t numOfOutput);
+SOperatorInfo* createParallelScanOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, void* tsdb, SQueryParam* param);
 
 SSDataBlock* doGlobalAggregate(void* param, bool* newgroup);
 SSDataBlock* doMultiwayMergeSort(void* param, bool* newgroup);
@@ -572,7 +613,8 @@ SSDataBlock* doSLimit(void* param, bool* newgroup);
 
 int32_t doCreateFilterInfo(SColumnInfo* pCols, int32_t numOfCols, int32_t numOfFilterCols, SSingleColumnFilterInfo** pFilterInfo, uint64_t qId);
 void doSetFilterColumnInfo(SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols, SSDataBlock* pBlock);
-bool doFilterDataBlock(SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols, int32_t numOfRows, int8_t* p);
+int32_t doFilterDataBlock(SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols, int32_t numOfRows, int8_t* p, bool* all);
+int32_t doFilterColumnBatch(SSingleColumnFilterInfo* pFilterInfo, int32_t numOfRows, int8_t* p, int8_t* buf);
 void doCompactSDataBlock(SSDataBlock* pBlock, int32_t numOfRows, int8_t* p);
 
 SSDataBlock* createOutputBuf(SExprInfo* pExpr, int32_t numOfOutput, int32_t numOfRows);
@@ -618,7 +660,10 @@ void destroyUdfInfo(SUdfInfo* pUdfInfo);
 
 bool isValidQInfo(void *param);
 
-int32_t doDumpQueryResult(SQInfo *pQInfo, char *data);
+int32_t doDumpQueryResult(SQInfo *pQInfo, char *data, int32_t *len);
+int32_t doCompressColDataToMsg(SColumnInfoData *pColRes, int32_t numOfRows, char *data, SRetrieveColHead *pHead);
+SResultRow* doSetResultOutBufByKey(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid,
+                                   char* pData, int16_t bytes, bool masterscan, uint64_t tableGroupId);
 
 size_t getResultSize(SQInfo *pQInfo, int64_t *numOfRows);
 void setQueryKilled(SQInfo *pQInfo);
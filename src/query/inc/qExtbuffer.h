@@ -30,6 +30,7 @@ extern "C" {
 #define MAX_TMPFILE_PATH_LENGTH        PATH_MAX
 #define INITIAL_ALLOCATION_BUFFER_SIZE 64
 #define DEFAULT_PAGE_SIZE              (1024L)  // 16k larger than the SHistoInfo
+#define RADIX_SORT_MIN_ROWS            64       // minimum rows sorted by radix sort in tColDataQSort
 
 typedef enum EXT_BUFFER_FLUSH_MODEL {
   /*
@@ -227,6 +228,16 @@ typedef int (*__col_compar_fn_t)(tOrderDescriptor *, int32_t numOfRows, int32_t
 
 void tColDataQSort(tOrderDescriptor *, int32_t numOfRows, int32_t start, int32_t end, char *data, int32_t orderType);
 
+void tColDataQuickSort(tOrderDescriptor *, int32_t numOfRows, int32_t start, int32_t end, char *data, int32_t orderType);
+
+/**
+ * LSD radix sort of the rows by the leading order column of integer or timestamp type, the rest order columns are
+ * compared only among the rows of identical leading key
+ * @return 0 if sorted, -1 if the leading order column is not supported or out of memory
+ */
+int32_t tColDataRadixSort(tOrderDescriptor *, int32_t numOfRows, int32_t start, int32_t end, char *data,
+                          int32_t orderType);
+
 int32_t compare_sa(tOrderDescriptor *, int32_t numOfRows, int32_t idx1, int32_t idx2, char *data);
 
 int32_t compare_sd(tOrderDescriptor *, int32_t numOfRows, int32_t idx1, int32_t idx2, char *data);
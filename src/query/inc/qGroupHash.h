@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_QGROUPHASH_H
+#define TDENGINE_QGROUPHASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "os.h"
+
+/*
+ * Open addressing hash table that assigns a dense group id to each distinct value of the group by column, one data
+ * block at a time. The slots are probed linearly and hold the normalized key of fixed length types inline, so that the
+ * lookup of one row usually touches one cache line only.
+ */
+typedef struct SGroupHashEntry {
+  int64_t  key;      // value of the fixed length key, length of the var length key
+  uint32_t hashVal;
+  int32_t  groupId;  // -1 if the slot is empty
+} SGroupHashEntry;
+
+typedef struct SGroupHashInfo {
+  int16_t          type;
+  int16_t          bytes;
+  int64_t          nullKey;      // normalized key of the NULL value of fixed length type
+  uint32_t         capacity;     // number of slots, power of 2
+  int32_t          numOfGroups;
+  int32_t          maxGroups;    // capacity of the group arrays below
+  SGroupHashEntry *pEntries;
+  char            *pKeys;        // key of each group, bytes per group
+  void           **pData;        // user data of each group
+  int32_t         *pLocal;       // index of each group in the groups of the last assigned block
+  uint32_t        *pStamp;       // pLocal is valid only if the stamp of group is identical to stamp
+  uint32_t         stamp;
+} SGroupHashInfo;
+
+#define tGroupHashGetKey(_h, _id)        ((_h)->pKeys + (int64_t)(_id) * (_h)->bytes)
+#define tGroupHashGetData(_h, _id)       ((_h)->pData[(_id)])
+#define tGroupHashSetData(_h, _id, _d)   ((_h)->pData[(_id)] = (_d))
+#define tGroupHashGetSize(_h)            ((_h)->numOfGroups)
+
+SGroupHashInfo *tGroupHashCreate(int16_t type, int16_t bytes);
+
+void tGroupHashDestroy(SGroupHashInfo *pHashInfo);
+
+void tGroupHashClear(SGroupHashInfo *pHashInfo);
+
+/**
+ * assign the group of each row of one column, the new values are added into the hash table
+ * @param pHashInfo
+ * @param pData       column data of fixed length or var length type
+ * @param numOfRows
+ * @param pRowGroup   index of the group in pGroups of each row, -1 for the NULL value
+ * @param pGroups     group id of the groups that appear in the rows, in the order of the first appearance
+ * @return            number of groups in pGroups, -1 if out of memory
+ */
+int32_t tGroupHashAssign(SGroupHashInfo *pHashInfo, const char *pData, int32_t numOfRows, int32_t *pRowGroup,
+                         int32_t *pGroups);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_QGROUPHASH_H
@@ -46,6 +46,7 @@ int32_t getOutputInterResultBufSize(SQueryAttr* pQueryAttr);
 size_t  getResultRowSize(SQueryRuntimeEnv* pRuntimeEnv);
 int32_t initResultRowInfo(SResultRowInfo* pResultRowInfo, int32_t size, int16_t type);
 void    cleanupResultRowInfo(SResultRowInfo* pResultRowInfo);
+void    freeDenseWindowIndex(SResultRowInfo* pResultRowInfo);
 
 void    resetResultRowInfo(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo);
 int32_t numOfClosedResultRows(SResultRowInfo* pResultRowInfo);
@@ -78,6 +79,7 @@ bool isNullOperator(SColumnFilterElem *pFilter, const char* minval, const char*
 bool notNullOperator(SColumnFilterElem *pFilter, const char* minval, const char* maxval, int16_t type);
 
 __filter_func_t getFilterOperator(int32_t lowerOptr, int32_t upperOptr);
+__filter_batch_func_t getFilterBatchOperator(int32_t lowerOptr, int32_t upperOptr, int16_t type);
 
 SResultRowPool* initResultRowPool(size_t size);
 SResultRow* getNewResultRow(SResultRowPool* p);
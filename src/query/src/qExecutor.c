@@ -30,6 +30,7 @@
 #include "tcompare.h"
 #include "tscompression.h"
 #include "qScript.h"
+#include "tsched.h"
 
 #define IS_MASTER_SCAN(runtime)        ((runtime)->scanFlag == MASTER_SCAN)
 #define IS_REVERSE_SCAN(runtime)       ((runtime)->scanFlag == REVERSE_SCAN)
@@ -197,6 +198,7 @@ static void destroyOperatorInfo(SOperatorInfo* pOperator);
 static int32_t doCopyToSDataBlock(SQueryRuntimeEnv* pRuntimeEnv, SGroupResInfo* pGroupResInfo, int32_t orderType, SSDataBlock* pBlock);
 
 static int32_t getGroupbyColumnIndex(SGroupbyExpr *pGroupbyExpr, SSDataBlock* pDataBlock);
+static SResultRow* doSetGroupResultRow(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, char *pData, int16_t type, int16_t bytes, int32_t groupIndex);
 static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binf, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex);
 
 static void initCtxOutputBuffer(SQLFunctionCtx* pCtx, int32_t size);
@@ -412,9 +414,95 @@ static void prepareResultListBuffer(SResultRowInfo* pResultRowInfo, SQueryRuntim
   pResultRowInfo->capacity = (int32_t)newCapacity;
 }
 
-static SResultRow* doSetResultOutBufByKey(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid,
-                                          char* pData, int16_t bytes, bool masterscan, uint64_t tableGroupId) {
-  bool existed = false;
+static int32_t initDenseWindowIndex(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid,
+                                    uint64_t tableGroupId, TSKEY skey) {
+  SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
+  SInterval*  pInterval = &pQueryAttr->interval;
+
+  // the start key of natural month/year time window can not be calculated arithmetically
+  if (pInterval->intervalUnit == 'n' || pInterval->intervalUnit == 'y' || pInterval->sliding <= 0) {
+    return -1;
+  }
+
+  // the time windows are generated from the first one in the scan order, until the end of query time range
+  uint64_t numOfWindows = 0;
+  if (QUERY_IS_ASC_QUERY(pQueryAttr)) {
+    TSKEY ekey = MAX(pQueryAttr->window.skey, pQueryAttr->window.ekey);
+    numOfWindows = (ekey > skey) ? ((uint64_t)ekey - (uint64_t)skey) / pInterval->sliding + 1 : 1;
+  } else {
+    TSKEY ekey = MIN(pQueryAttr->window.skey, pQueryAttr->window.ekey);
+    numOfWindows = (ekey < skey) ? ((uint64_t)skey - (uint64_t)ekey) / pInterval->sliding + 1 : 1;
+    numOfWindows += pInterval->interval / pInterval->sliding;
+  }
+
+  numOfWindows = MIN(numOfWindows, MAX_DENSE_TIME_WINDOW);
+
+  int64_t size = sizeof(int32_t) * numOfWindows;
+  if (atomic_add_fetch_64(&pRuntimeEnv->denseIndexSize, size) > MAX_DENSE_INDEX_SIZE) {
+    atomic_sub_fetch_64(&pRuntimeEnv->denseIndexSize, size);
+    return -1;
+  }
+
+  pResultRowInfo->pDenseIndex = malloc(size);
+  if (pResultRowInfo->pDenseIndex == NULL) {
+    atomic_sub_fetch_64(&pRuntimeEnv->denseIndexSize, size);
+    return -1;
+  }
+
+  memset(pResultRowInfo->pDenseIndex, -1, size);
+  pResultRowInfo->denseSize = (int32_t)numOfWindows;
+  pResultRowInfo->pDenseCharged = &pRuntimeEnv->denseIndexSize;
+  pResultRowInfo->denseSkey = QUERY_IS_ASC_QUERY(pQueryAttr) ? skey : skey - (numOfWindows - 1) * pInterval->sliding;
+  pResultRowInfo->denseTid = tid;
+  pResultRowInfo->denseGroupId = tableGroupId;
+  return TSDB_CODE_SUCCESS;
+}
+
+// fixed length time windows are located by the arithmetic on start key, instead of the lookup in pResultRowHashTable and
+// pResultRowListSet. NULL is returned if the window is not covered by the dense index.
+static int32_t* getDenseWindowIndex(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid,
+                                    uint64_t tableGroupId, TSKEY skey) {
+  if (pResultRowInfo->denseSize < 0) {
+    return NULL;
+  }
+
+  if (pResultRowInfo->denseSize == 0 &&
+      initDenseWindowIndex(pRuntimeEnv, pResultRowInfo, tid, tableGroupId, skey) != TSDB_CODE_SUCCESS) {
+    pResultRowInfo->denseSize = -1;
+    return NULL;
+  }
+
+  // the result rows of different tables or groups are shared, only the hash tables can tell them apart
+  if (pResultRowInfo->denseTid != tid || pResultRowInfo->denseGroupId != tableGroupId) {
+    freeDenseWindowIndex(pResultRowInfo);
+    pResultRowInfo->denseSize = -1;
+    return NULL;
+  }
+
+  int64_t sliding = pRuntimeEnv->pQueryAttr->interval.sliding;
+  if (skey < pResultRowInfo->denseSkey || (skey - pResultRowInfo->denseSkey) % sliding != 0) {
+    return NULL;
+  }
+
+  int64_t index = (skey - pResultRowInfo->denseSkey) / sliding;
+  return (index < pResultRowInfo->denseSize) ? &pResultRowInfo->pDenseIndex[index] : NULL;
+}
+
+SResultRow* doSetResultOutBufByKey(SQueryRuntimeEnv* pRuntimeEnv, SResultRowInfo* pResultRowInfo, int64_t tid,
+                                   char* pData, int16_t bytes, bool masterscan, uint64_t tableGroupId) {
+  bool     existed = false;
+  int32_t* pDenseIndex = NULL;
+
+  if (QUERY_IS_INTERVAL_QUERY(pRuntimeEnv->pQueryAttr) && bytes == TSDB_KEYSIZE) {
+    pDenseIndex = getDenseWindowIndex(pRuntimeEnv, pResultRowInfo, tid, tableGroupId, *(TSKEY*)pData);
+    if (pDenseIndex != NULL && *pDenseIndex >= 0) {
+      if (masterscan) {
+        pResultRowInfo->curPos = *pDenseIndex;
+      }
+      return pResultRowInfo->pResult[*pDenseIndex];
+    }
+  }
+
   SET_RES_WINDOW_KEY(pRuntimeEnv->keyBuf, pData, bytes, tableGroupId);
 
   SResultRow **p1 =
@@ -481,6 +569,10 @@ static SResultRow* doSetResultOutBufByKey(SQueryRuntimeEnv* pRuntimeEnv, SResult
     longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_TOO_MANY_TIMEWINDOW);
   }
 
+  if (pDenseIndex != NULL) {
+    *pDenseIndex = pResultRowInfo->curPos;
+  }
+
   return pResultRowInfo->pResult[pResultRowInfo->curPos];
 }
 
@@ -648,9 +740,22 @@ static bool resultRowInterpolated(SResultRow* pResult, SResultTsInterpType type)
 }
 
 static FORCE_INLINE int32_t getForwardStepsInBlock(int32_t numOfRows, __block_search_fn_t searchFn, TSKEY ekey, int16_t pos,
-                                      int16_t order, int64_t *pData) {
+                                      int16_t order, int64_t *pData, int32_t hint) {
   int32_t forwardStep = 0;
 
+  // regularly sampled data has the same number of rows in each fixed length time window, try the hint first
+  if (hint > 0) {
+    if (order == TSDB_ORDER_ASC) {
+      if (pos + hint <= numOfRows && pData[pos + hint - 1] <= ekey && (pos + hint == numOfRows || pData[pos + hint] > ekey)) {
+        return hint;
+      }
+    } else {
+      if (pos - hint + 1 >= 0 && pData[pos - hint + 1] >= ekey && (pos - hint + 1 == 0 || pData[pos - hint] < ekey)) {
+        return hint;
+      }
+    }
+  }
+
   if (order == TSDB_ORDER_ASC) {
     int32_t end = searchFn((char*) &pData[pos], numOfRows - pos, ekey, order);
     if (end >= 0) {
@@ -742,7 +847,8 @@ static void updateResultRowInfoActiveIndex(SResultRowInfo* pResultRowInfo, SQuer
 }
 
 static int32_t getNumOfRowsInTimeWindow(SQueryRuntimeEnv* pRuntimeEnv, SDataBlockInfo *pDataBlockInfo, TSKEY *pPrimaryColumn,
-                                        int32_t startPos, TSKEY ekey, __block_search_fn_t searchFn, bool updateLastKey) {
+                                        int32_t startPos, TSKEY ekey, __block_search_fn_t searchFn, bool updateLastKey,
+                                        int32_t hint) {
   assert(startPos >= 0 && startPos < pDataBlockInfo->rows);
   SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
   STableQueryInfo* item = pRuntimeEnv->current;
@@ -753,7 +859,7 @@ static int32_t getNumOfRowsInTimeWindow(SQueryRuntimeEnv* pRuntimeEnv, SDataBloc
 
   if (QUERY_IS_ASC_QUERY(pQueryAttr)) {
     if (ekey < pDataBlockInfo->window.ekey) {
-      num = getForwardStepsInBlock(pDataBlockInfo->rows, searchFn, ekey, startPos, order, pPrimaryColumn);
+      num = getForwardStepsInBlock(pDataBlockInfo->rows, searchFn, ekey, startPos, order, pPrimaryColumn, hint);
       if (updateLastKey) { // update the last key
         item->lastKey = pPrimaryColumn[startPos + (num - 1)] + step;
       }
@@ -765,7 +871,7 @@ static int32_t getNumOfRowsInTimeWindow(SQueryRuntimeEnv* pRuntimeEnv, SDataBloc
     }
   } else {  // desc
     if (ekey > pDataBlockInfo->window.skey) {
-      num = getForwardStepsInBlock(pDataBlockInfo->rows, searchFn, ekey, startPos, order, pPrimaryColumn);
+      num = getForwardStepsInBlock(pDataBlockInfo->rows, searchFn, ekey, startPos, order, pPrimaryColumn, hint);
       if (updateLastKey) {  // update the last key
         item->lastKey = pPrimaryColumn[startPos - (num - 1)] + step;
       }
@@ -1372,7 +1478,7 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
   int32_t forwardStep = 0;
   TSKEY   ekey = reviseWindowEkey(pQueryAttr, &win);
   forwardStep =
-      getNumOfRowsInTimeWindow(pRuntimeEnv, &pSDataBlock->info, tsCols, startPos, ekey, binarySearchForKey, true);
+      getNumOfRowsInTimeWindow(pRuntimeEnv, &pSDataBlock->info, tsCols, startPos, ekey, binarySearchForKey, true, 0);
 
   // prev time window not interpolation yet.
   int32_t curIndex = pResultRowInfo->curPos;
@@ -1430,7 +1536,8 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
     }
 
     ekey = reviseWindowEkey(pQueryAttr, &nextWin);
-    forwardStep = getNumOfRowsInTimeWindow(pRuntimeEnv, &pSDataBlock->info, tsCols, startPos, ekey, binarySearchForKey, true);
+    forwardStep = getNumOfRowsInTimeWindow(pRuntimeEnv, &pSDataBlock->info, tsCols, startPos, ekey, binarySearchForKey,
+                                           true, forwardStep);
 
     // window start(end) key interpolation
     doWindowBorderInterpolation(pOperatorInfo, pSDataBlock, pInfo->pCtx, pResult, &nextWin, startPos, forwardStep);
@@ -1445,6 +1552,236 @@ static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResul
   updateResultRowInfoActiveIndex(pResultRowInfo, pQueryAttr, pRuntimeEnv->current->lastKey);
 }
 
+static bool isGroupbyBatchSupported(SOperatorInfo* pOperator, SQLFunctionCtx* pCtx) {
+  for (int32_t k = 0; k < pOperator->numOfOutput; ++k) {
+    if (pCtx[k].functionId < 0 || pCtx[k].functionId == TSDB_FUNC_ARITHM) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static int32_t ensureGroupbyBuffer(SGroupbyOperatorInfo *pInfo, int32_t numOfRows) {
+  if (pInfo->capacity >= numOfRows) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t* p = NULL;
+  if ((p = realloc(pInfo->pRowGroup, sizeof(int32_t) * numOfRows)) == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pInfo->pRowGroup = p;
+
+  if ((p = realloc(pInfo->pGroups, sizeof(int32_t) * numOfRows)) == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pInfo->pGroups = p;
+
+  if ((p = realloc(pInfo->pRowIndex, sizeof(int32_t) * numOfRows)) == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pInfo->pRowIndex = p;
+
+  if ((p = realloc(pInfo->pOffset, sizeof(int32_t) * numOfRows)) == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+  pInfo->pOffset = p;
+
+  pInfo->capacity = numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void doGatherColumn(char* dst, const char* src, int32_t bytes, const int32_t* pRowIndex, int32_t numOfRows) {
+  switch (bytes) {
+    case 1:
+      for (int32_t i = 0; i < numOfRows; ++i) ((int8_t*)dst)[i] = ((const int8_t*)src)[pRowIndex[i]];
+      break;
+    case 2:
+      for (int32_t i = 0; i < numOfRows; ++i) ((int16_t*)dst)[i] = ((const int16_t*)src)[pRowIndex[i]];
+      break;
+    case 4:
+      for (int32_t i = 0; i < numOfRows; ++i) ((int32_t*)dst)[i] = ((const int32_t*)src)[pRowIndex[i]];
+      break;
+    case 8:
+      for (int32_t i = 0; i < numOfRows; ++i) ((int64_t*)dst)[i] = ((const int64_t*)src)[pRowIndex[i]];
+      break;
+    default:
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        memcpy(dst + (int64_t)bytes * i, src + (int64_t)bytes * pRowIndex[i], bytes);
+      }
+  }
+}
+
+static void doApplyGroupFunctions(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, int32_t groupId,
+                                  int32_t start, int32_t num, TSKEY* tsList, int32_t numOfTotal) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQueryAttr*       pQueryAttr = pRuntimeEnv->pQueryAttr;
+  SGroupHashInfo*   pGroupHash = pInfo->pGroupHash;
+
+  char* key = tGroupHashGetKey(pGroupHash, groupId);
+  if (pQueryAttr->stableQuery && pQueryAttr->stabledev && (pRuntimeEnv->prevResult != NULL)) {
+    setParamForStableStddevByColData(pRuntimeEnv, pInfo->binfo.pCtx, pOperator->numOfOutput, pOperator->pExpr, key, pGroupHash->bytes);
+  }
+
+  SResultRow* pResultRow = tGroupHashGetData(pGroupHash, groupId);
+  if (pResultRow == NULL) {
+    pResultRow = doSetGroupResultRow(pRuntimeEnv, &pInfo->binfo, key, pGroupHash->type, pGroupHash->bytes, pInfo->groupIndex);
+    if (pResultRow == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_APP_ERROR);
+    }
+
+    tGroupHashSetData(pGroupHash, groupId, pResultRow);
+  }
+
+  setResultOutputBuf(pRuntimeEnv, pResultRow, pInfo->binfo.pCtx, pOperator->numOfOutput, pInfo->binfo.rowCellInfoOffset);
+  initCtxOutputBuffer(pInfo->binfo.pCtx, pOperator->numOfOutput);
+
+  STimeWindow w = TSWINDOW_INITIALIZER;
+  int32_t offset = QUERY_IS_ASC_QUERY(pQueryAttr)? start : start + num - 1;
+  doApplyFunctions(pRuntimeEnv, pInfo->binfo.pCtx, &w, offset, num, tsList, numOfTotal, pOperator->numOfOutput);
+}
+
+/*
+ * The group of each row of the block is found through the open addressing hash table pGroupHash at first. If each
+ * group is contiguous in the block, the functions are applied on the rows of each group in place. Otherwise the rows
+ * are ordered by group, the input columns are gathered in this order, and the functions are applied once for each
+ * group of the block, instead of once for each run of the identical group by value.
+ */
+static void doHashGroupbyAggBatch(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock,
+                                  SColumnInfoData* pColInfoData) {
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQLFunctionCtx*   pCtx = pInfo->binfo.pCtx;
+  STableQueryInfo*  item = pRuntimeEnv->current;
+  int32_t           numOfRows = pSDataBlock->info.rows;
+
+  if (pInfo->pGroupHash == NULL) {
+    pInfo->pGroupHash = tGroupHashCreate(pColInfoData->info.type, pColInfoData->info.bytes);
+    if (pInfo->pGroupHash == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
+    pInfo->groupIndex = item->groupIndex;
+  } else if (pInfo->groupIndex != item->groupIndex) {
+    tGroupHashClear(pInfo->pGroupHash);
+    pInfo->groupIndex = item->groupIndex;
+  }
+
+  int32_t code = ensureGroupbyBuffer(pInfo, numOfRows);
+  if (code != TSDB_CODE_SUCCESS) {
+    longjmp(pRuntimeEnv->env, code);
+  }
+
+  int32_t numOfGroups = tGroupHashAssign(pInfo->pGroupHash, pColInfoData->pData, numOfRows, pInfo->pRowGroup, pInfo->pGroups);
+  if (numOfGroups < 0) {
+    longjmp(pRuntimeEnv->env, terrno);
+  }
+
+  SColumnInfoData* pFirstColData = taosArrayGet(pSDataBlock->pDataBlock, 0);
+  int64_t* tsList = (pFirstColData->info.type == TSDB_DATA_TYPE_TIMESTAMP)? (int64_t*) pFirstColData->pData:NULL;
+
+  int32_t* pRowGroup = pInfo->pRowGroup;
+  int32_t* pOffset = pInfo->pOffset;
+  memset(pOffset, 0, sizeof(int32_t) * numOfGroups);
+
+  int32_t numOfRuns = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (pRowGroup[i] >= 0) {
+      pOffset[pRowGroup[i]] += 1;
+      numOfRuns += (i == 0 || pRowGroup[i] != pRowGroup[i - 1]);
+    }
+  }
+
+  if (numOfRuns == numOfGroups) {
+    for (int32_t j = 0; j < numOfRows;) {
+      if (pRowGroup[j] < 0) {
+        j += 1;
+        continue;
+      }
+
+      int32_t num = pOffset[pRowGroup[j]];
+      doApplyGroupFunctions(pOperator, pInfo, pInfo->pGroups[pRowGroup[j]], j, num, tsList, numOfRows);
+      j += num;
+    }
+
+    return;
+  }
+
+  // counting sort of the rows by group, pOffset[g] is the end position of group g in pRowIndex afterwards
+  int32_t total = 0;
+  for (int32_t g = 0; g < numOfGroups; ++g) {
+    int32_t num = pOffset[g];
+    pOffset[g] = total;
+    total += num;
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (pRowGroup[i] >= 0) {
+      pInfo->pRowIndex[pOffset[pRowGroup[i]]++] = i;
+    }
+  }
+
+  if (pInfo->pInput == NULL) {
+    pInfo->pInput = calloc(pOperator->numOfOutput, POINTER_BYTES);
+    if (pInfo->pInput == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
+  }
+
+  int32_t size = (tsList != NULL)? (int32_t) sizeof(TSKEY) * total : 0;
+  for (int32_t k = 0; k < pOperator->numOfOutput; ++k) {
+    pInfo->pInput[k] = pCtx[k].pInput;
+    if (pCtx[k].pInput != NULL) {
+      size += ALIGN8(pCtx[k].inputBytes * total);
+    }
+  }
+
+  if (pInfo->gatherBufSize < size) {
+    char* p = realloc(pInfo->pGatherBuf, size);
+    if (p == NULL) {
+      longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+    }
+
+    pInfo->pGatherBuf = p;
+    pInfo->gatherBufSize = size;
+  }
+
+  char* pBuf = pInfo->pGatherBuf;
+  if (tsList != NULL) {
+    doGatherColumn(pBuf, (char*) tsList, sizeof(TSKEY), pInfo->pRowIndex, total);
+    tsList = (TSKEY*) pBuf;
+    pBuf += sizeof(TSKEY) * total;
+  }
+
+  for (int32_t k = 0; k < pOperator->numOfOutput; ++k) {
+    if (pCtx[k].pInput == NULL) {
+      continue;
+    }
+
+    // the functions of the same column share the gathered column
+    int32_t j = 0;
+    while (j < k && pInfo->pInput[j] != pInfo->pInput[k]) {
+      ++j;
+    }
+
+    if (j < k) {
+      pCtx[k].pInput = pCtx[j].pInput;
+    } else {
+      doGatherColumn(pBuf, pInfo->pInput[k], pCtx[k].inputBytes, pInfo->pRowIndex, total);
+      pCtx[k].pInput = pBuf;
+      pBuf += ALIGN8(pCtx[k].inputBytes * total);
+    }
+  }
+
+  for (int32_t g = 0; g < numOfGroups; ++g) {
+    int32_t start = (g == 0)? 0 : pOffset[g - 1];
+    doApplyGroupFunctions(pOperator, pInfo, pInfo->pGroups[g], start, pOffset[g] - start, tsList, numOfRows);
+  }
+
+  for (int32_t k = 0; k < pOperator->numOfOutput; ++k) {
+    pCtx[k].pInput = pInfo->pInput[k];
+  }
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pInfo, SSDataBlock *pSDataBlock) {
   SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
   STableQueryInfo*  item = pRuntimeEnv->current;
@@ -1460,6 +1797,11 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SGroupbyOperatorInfo *pIn
     return;
   }
 
+  if (isGroupbyBatchSupported(pOperator, pInfo->binfo.pCtx)) {
+    doHashGroupbyAggBatch(pOperator, pInfo, pSDataBlock, pColInfoData);
+    return;
+  }
+
   SColumnInfoData* pFirstColData = taosArrayGet(pSDataBlock->pDataBlock, 0);
   int64_t* tsList = (pFirstColData->info.type == TSDB_DATA_TYPE_TIMESTAMP)? (int64_t*) pFirstColData->pData:NULL;
 
@@ -1613,12 +1955,9 @@ static void setResultRowKey(SResultRow* pResultRow, char* pData, int16_t type) {
   }
 }
 
-static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex) {
+static SResultRow* doSetGroupResultRow(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, char *pData, int16_t type, int16_t bytes, int32_t groupIndex) {
   SDiskbasedResultBuf *pResultBuf = pRuntimeEnv->pResultBuf;
-
-  int32_t        *rowCellInfoOffset = binfo->rowCellInfoOffset;
-  SResultRowInfo *pResultRowInfo    = &binfo->resultRowInfo;
-  SQLFunctionCtx *pCtx              = binfo->pCtx;
+  SResultRowInfo      *pResultRowInfo = &binfo->resultRowInfo;
 
   // not assign result buffer yet, add new result buffer, TODO remove it
   char* d = pData;
@@ -1636,12 +1975,21 @@ static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasic
   if (pResultRow->pageId == -1) {
     int32_t ret = addNewWindowResultBuf(pResultRow, pResultBuf, groupIndex, pRuntimeEnv->pQueryAttr->resultRowSize);
     if (ret != 0) {
-      return -1;
+      return NULL;
     }
   }
 
-  setResultOutputBuf(pRuntimeEnv, pResultRow, pCtx, numOfCols, rowCellInfoOffset);
-  initCtxOutputBuffer(pCtx, numOfCols);
+  return pResultRow;
+}
+
+static int32_t setGroupResultOutputBuf(SQueryRuntimeEnv *pRuntimeEnv, SOptrBasicInfo *binfo, int32_t numOfCols, char *pData, int16_t type, int16_t bytes, int32_t groupIndex) {
+  SResultRow *pResultRow = doSetGroupResultRow(pRuntimeEnv, binfo, pData, type, bytes, groupIndex);
+  if (pResultRow == NULL) {
+    return -1;
+  }
+
+  setResultOutputBuf(pRuntimeEnv, pResultRow, binfo->pCtx, numOfCols, binfo->rowCellInfoOffset);
+  initCtxOutputBuffer(binfo->pCtx, numOfCols);
   return TSDB_CODE_SUCCESS;
 }
 
@@ -2280,6 +2628,15 @@ bool onlyQueryTags(SQueryAttr* pQueryAttr) {
   return true;
 }
 
+// the queries reading the cached last rows or the tags only are the cheap ones, whatever their time windows are
+static int64_t estimateQueryScanCost(SQueryAttr *pQueryAttr, void* tsdb) {
+  if (onlyQueryTags(pQueryAttr) || isFirstLastRowQuery(pQueryAttr) || isCachedLastQuery(pQueryAttr)) {
+    return 0;
+  }
+
+  return tsdbEstimateScanBytes(tsdb, &pQueryAttr->window, (int32_t)pQueryAttr->tableGroupInfo.numOfTables);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////
 
 void getAlignQueryTimeWindow(SQueryAttr *pQueryAttr, int64_t key, int64_t keyFirst, int64_t keyLast, STimeWindow *win) {
@@ -2505,6 +2862,41 @@ static void getIntermediateBufInfo(SQueryRuntimeEnv* pRuntimeEnv, int32_t* ps, i
 
 #define IS_PREFILTER_TYPE(_t) ((_t) != TSDB_DATA_TYPE_BINARY && (_t) != TSDB_DATA_TYPE_NCHAR)
 
+// Only the equal filters are able to be checked against the bloom filter of data block columns. A block is discarded
+// when all filters of one column are equal filters that are rejected by the bloom filter.
+static bool doFilterByBlockBloom(SQueryAttr* pQueryAttr, TsdbQueryHandleT pQueryHandle) {
+  for (int32_t k = 0; k < pQueryAttr->numOfFilterCols; ++k) {
+    SSingleColumnFilterInfo *pFilterInfo = &pQueryAttr->pFilterInfo[k];
+
+    int16_t type = pFilterInfo->info.type;
+    if (pFilterInfo->numOfFilters == 0 || IS_FLOAT_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) {
+      continue;
+    }
+
+    bool qualified = false;
+    for (int32_t j = 0; j < pFilterInfo->numOfFilters; ++j) {
+      SColumnFilterInfo *pInfo = &pFilterInfo->pFilters[j].filterInfo;
+      if (pInfo->lowerRelOptr != TSDB_RELATION_EQUAL) {
+        qualified = true;
+        break;
+      }
+
+      const void* pVal = IS_VAR_DATA_TYPE(type)? (const void*)pInfo->pz : (const void*)&pInfo->lowerBndi;
+      int32_t     len = IS_VAR_DATA_TYPE(type)? (int32_t)pInfo->len : (int32_t)sizeof(int64_t);
+      if (tsdbDataBlockMayContain(pQueryHandle, pFilterInfo->info.colId, (int8_t)type, pVal, len)) {
+        qualified = true;
+        break;
+      }
+    }
+
+    if (!qualified) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 static bool doFilterByBlockStatistics(SQueryRuntimeEnv* pRuntimeEnv, SDataStatis *pDataStatis, SQLFunctionCtx *pCtx, int32_t numOfRows) {
   SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
 
@@ -2653,54 +3045,23 @@ static int32_t doTSJoinFilter(SQueryRuntimeEnv *pRuntimeEnv, TSKEY key, bool asc
   return TS_JOIN_TS_EQUAL;
 }
 
-bool doFilterDataBlock(SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols, int32_t numOfRows, int8_t* p) {
-  bool all = true;
-
-  for (int32_t i = 0; i < numOfRows; ++i) {
-    bool qualified = false;
-
-    for (int32_t k = 0; k < numOfFilterCols; ++k) {
-      char* pElem = (char*)pFilterInfo[k].pData + pFilterInfo[k].info.bytes * i;
-
-      qualified = false;
-      for (int32_t j = 0; j < pFilterInfo[k].numOfFilters; ++j) {
-        SColumnFilterElem* pFilterElem = &pFilterInfo[k].pFilters[j];
-
-        bool isnull = isNull(pElem, pFilterInfo[k].info.type);
-        if (isnull) {
-          if (pFilterElem->fp == isNullOperator) {
-            qualified = true;
-            break;
-          } else {
-            continue;
-          }
-        } else {
-          if (pFilterElem->fp == notNullOperator) {
-            qualified = true;
-            break;
-          } else if (pFilterElem->fp == isNullOperator) {
-            continue;
-          }
-        }
-
-        if (pFilterElem->fp(pFilterElem, pElem, pElem, pFilterInfo[k].info.type)) {
-          qualified = true;
-          break;
-        }
-      }
+int32_t doFilterDataBlock(SSingleColumnFilterInfo* pFilterInfo, int32_t numOfFilterCols, int32_t numOfRows, int8_t* p, bool* all) {
+  // the filters are evaluated column by column, p keeps the rows qualified by all the columns evaluated so far
+  int8_t* buf = malloc(numOfRows * 2);
+  if (buf == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
 
-      if (!qualified) {
-        break;
-      }
-    }
+  int32_t numOfQualified = numOfRows;
 
-    p[i] = qualified ? 1 : 0;
-    if (!qualified) {
-      all = false;
-    }
+  memset(p, 1, numOfRows);
+  for (int32_t k = 0; k < numOfFilterCols && numOfQualified > 0; ++k) {
+    numOfQualified = doFilterColumnBatch(&pFilterInfo[k], numOfRows, p, buf);
   }
 
-  return all;
+  tfree(buf);
+  *all = (numOfQualified == numOfRows);
+  return TSDB_CODE_SUCCESS;
 }
 
 void doCompactSDataBlock(SSDataBlock* pBlock, int32_t numOfRows, int8_t* p) {
@@ -2758,6 +3119,9 @@ void filterRowsInDataBlock(SQueryRuntimeEnv* pRuntimeEnv, SSingleColumnFilterInf
 
   int8_t *p = calloc(numOfRows, sizeof(int8_t));
   bool    all = true;
+  if (p == NULL) {
+    longjmp(pRuntimeEnv->env, TSDB_CODE_QRY_OUT_OF_MEMORY);
+  }
 
   if (pRuntimeEnv->pTsBuf != NULL) {
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, 0);
@@ -2784,7 +3148,11 @@ void filterRowsInDataBlock(SQueryRuntimeEnv* pRuntimeEnv, SSingleColumnFilterInf
     // save the cursor status
     pRuntimeEnv->current->cur = tsBufGetCursor(pRuntimeEnv->pTsBuf);
   } else {
-    all = doFilterDataBlock(pFilterInfo, numOfFilterCols, numOfRows, p);
+    int32_t code = doFilterDataBlock(pFilterInfo, numOfFilterCols, numOfRows, p, &all);
+    if (code != TSDB_CODE_SUCCESS) {
+      tfree(p);
+      longjmp(pRuntimeEnv->env, code);
+    }
   }
 
   if (!all) {
@@ -2958,7 +3326,8 @@ int32_t loadDataBlockOnDemand(SQueryRuntimeEnv* pRuntimeEnv, STableScanInfo* pTa
     }
 
     // current block has been discard due to filter applied
-    if (!doFilterByBlockStatistics(pRuntimeEnv, pBlock->pBlockStatis, pTableScanInfo->pCtx, pBlockInfo->rows)) {
+    if (!doFilterByBlockStatistics(pRuntimeEnv, pBlock->pBlockStatis, pTableScanInfo->pCtx, pBlockInfo->rows) ||
+        (pBlock->pBlockStatis != NULL && !doFilterByBlockBloom(pQueryAttr, pTableScanInfo->pQueryHandle))) {
       pCost->discardBlocks += 1;
       qDebug("QInfo:0x%"PRIx64" data block discard, brange:%" PRId64 "-%" PRId64 ", rows:%d", pQInfo->qId, pBlockInfo->window.skey,
              pBlockInfo->window.ekey, pBlockInfo->rows);
@@ -3966,20 +4335,58 @@ static void updateNumOfRowsInResultRows(SQueryRuntimeEnv* pRuntimeEnv, SQLFuncti
   }
 }
 
-static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char *data) {
+// compress the data of one column by the algorithm of its data type, it is copied as it is if not shrunk
+int32_t doCompressColDataToMsg(SColumnInfoData *pColRes, int32_t numOfRows, char *data, SRetrieveColHead *pHead) {
+  int32_t len = pColRes->info.bytes * numOfRows;
+  int16_t type = pColRes->info.type;
+
+  // the intermediate result of fixed length type may not be of the length of its type
+  if (!IS_VAR_DATA_TYPE(type) &&
+      (type <= TSDB_DATA_TYPE_NULL || type > TSDB_DATA_TYPE_UBIGINT || pColRes->info.bytes != tDataTypes[type].bytes)) {
+    type = TSDB_DATA_TYPE_BINARY;
+  }
+
+#ifdef TD_TSZ
+  // the query result is never compressed lossy
+  if ((type == TSDB_DATA_TYPE_FLOAT && lossyFloat) || (type == TSDB_DATA_TYPE_DOUBLE && lossyDouble)) {
+    type = TSDB_DATA_TYPE_BINARY;
+  }
+#endif
+
+  if (NEEDTO_COMPRESS_COL(len)) {
+    int32_t compLen = (*(tDataTypes[type].compFunc))(pColRes->pData, len, numOfRows, data, len + COMP_OVERFLOW_BYTES,
+                                                     ONE_STAGE_COMP, NULL, 0);
+    if (compLen > 0 && compLen < len) {
+      pHead->compType = (int8_t)type;
+      pHead->len = htonl(compLen);
+      return compLen;
+    }
+  }
+
+  memmove(data, pColRes->pData, len);
+  pHead->compType = TSDB_DATA_TYPE_NULL;
+  pHead->len = htonl(len);
+  return len;
+}
+
+static int32_t doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char *data) {
   SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
   SQueryAttr *pQueryAttr = pRuntimeEnv->pQueryAttr;
 
   SSDataBlock* pRes = pRuntimeEnv->outputBuf;
+  char*        start = data;
+
+  int32_t numOfCols = (pQueryAttr->pExpr2 == NULL)? pQueryAttr->numOfOutput:pQueryAttr->numOfExpr2;
+  if (pQInfo->compColData) {
+    SRetrieveColHead* pHead = (SRetrieveColHead*) data;
+    data += sizeof(SRetrieveColHead) * numOfCols;
 
-  if (pQueryAttr->pExpr2 == NULL) {
-    for (int32_t col = 0; col < pQueryAttr->numOfOutput; ++col) {
+    for (int32_t col = 0; col < numOfCols; ++col) {
       SColumnInfoData* pColRes = taosArrayGet(pRes->pDataBlock, col);
-      memmove(data, pColRes->pData, pColRes->info.bytes * pRes->info.rows);
-      data += pColRes->info.bytes * pRes->info.rows;
+      data += doCompressColDataToMsg(pColRes, numOfRows, data, &pHead[col]);
     }
   } else {
-    for (int32_t col = 0; col < pQueryAttr->numOfExpr2; ++col) {
+    for (int32_t col = 0; col < numOfCols; ++col) {
       SColumnInfoData* pColRes = taosArrayGet(pRes->pDataBlock, col);
       memmove(data, pColRes->pData, pColRes->info.bytes * numOfRows);
       data += pColRes->info.bytes * numOfRows;
@@ -4011,6 +4418,8 @@ static void doCopyQueryResultToMsg(SQInfo *pQInfo, int32_t numOfRows, char *data
   if (Q_STATUS_EQUAL(pRuntimeEnv->status, QUERY_COMPLETED) && pRuntimeEnv->proot->status == OP_EXEC_DONE) {
     setQueryStatus(pRuntimeEnv, QUERY_OVER);
   }
+
+  return (int32_t)(data - start);
 }
 
 int32_t doFillTimeIntervalGapsInResults(SFillInfo* pFillInfo, SSDataBlock *pOutput, int32_t capacity) {
@@ -6036,6 +6445,14 @@ static void destroyGroupbyOperatorInfo(void* param, int32_t numOfOutput) {
   SGroupbyOperatorInfo* pInfo = (SGroupbyOperatorInfo*) param;
   doDestroyBasicInfo(&pInfo->binfo, numOfOutput);
   tfree(pInfo->prevData);
+
+  tGroupHashDestroy(pInfo->pGroupHash);
+  tfree(pInfo->pRowGroup);
+  tfree(pInfo->pGroups);
+  tfree(pInfo->pRowIndex);
+  tfree(pInfo->pOffset);
+  tfree(pInfo->pInput);
+  tfree(pInfo->pGatherBuf);
 }
 
 static void destroyProjectOperatorInfo(void* param, int32_t numOfOutput) {
@@ -7573,6 +7990,7 @@ int32_t doCreateFilterInfo(SColumnInfo* pCols, int32_t numOfCols, int32_t numOfF
           return TSDB_CODE_QRY_INVALID_MSG;
         }
 
+        pSingleColFilter->bfp = getFilterBatchOperator(lower, upper, pCols[i].type);
         pSingleColFilter->bytes = pCols[i].bytes;
 
         if (lower == TSDB_RELATION_IN) {
@@ -7908,6 +8326,438 @@ bool isValidQInfo(void *param) {
   return (sig == (uint64_t)pQInfo);
 }
 
+static void*          tsParallelScanSched = NULL;
+static pthread_once_t tsParallelScanInit  = PTHREAD_ONCE_INIT;
+
+static void doInitParallelScanSched() {
+  int32_t numOfThreads = MAX(tsQueryParallelism, tsNumOfCores);
+  tsParallelScanSched = taosInitScheduler(numOfThreads * 4, numOfThreads, "qscan");
+}
+
+/*
+ * Only the super table aggregation queries, of which the partial results generated by each table subset can be
+ * merged by the global merge stage in client, are eligible for the parallel table scan.
+ */
+static bool isParallelScanQuery(SQInfo* pQInfo, SQueryParam* param, STSBuf* pTsBuf) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  SQueryAttr*       pQueryAttr  = pRuntimeEnv->pQueryAttr;
+
+  if (tsQueryParallelism <= 1 || !pQueryAttr->stableQuery || pQueryAttr->tableGroupInfo.numOfTables < 2) {
+    return false;
+  }
+
+  if (pTsBuf != NULL || pRuntimeEnv->prevResult != NULL || pRuntimeEnv->pUdfInfo != NULL || pQueryAttr->pUdfInfo != NULL) {
+    return false;
+  }
+
+  if (pQueryAttr->limit.limit > 0 || pQueryAttr->limit.offset > 0 || pQueryAttr->tsCompQuery || pQueryAttr->diffQuery ||
+      pQueryAttr->pointInterpQuery || pQueryAttr->queryBlockDist || pQueryAttr->stabledev) {
+    return false;
+  }
+
+  if (onlyQueryTags(pQueryAttr) || isFirstLastRowQuery(pQueryAttr) || isCachedLastQuery(pQueryAttr)) {
+    return false;
+  }
+
+  if (param->pOperator == NULL || taosArrayGetSize(param->pOperator) != 1) {
+    return false;
+  }
+
+  int32_t op = *(int32_t*) taosArrayGet(param->pOperator, 0);
+  if (op != OP_MultiTableAggregate && op != OP_MultiTableTimeInterval) {
+    return false;
+  }
+
+  for (int32_t i = 0; i < pQueryAttr->numOfOutput; ++i) {
+    if (pQueryAttr->pExpr1[i].base.functionId == TSDB_FUNC_ARITHM) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void destroyParallelScanWorker(SQInfo* pQInfo) {
+  if (pQInfo == NULL) {
+    return;
+  }
+
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+  SQueryAttr*       pQueryAttr  = &pQInfo->query;
+
+  doDestroyTableQueryInfo(&pRuntimeEnv->tableqinfoGroupInfo);
+  teardownQueryRuntimeEnv(pRuntimeEnv);
+
+  pQueryAttr->pFilterInfo = doDestroyFilterInfo(pQueryAttr->pFilterInfo, pQueryAttr->numOfFilterCols);
+
+  // the table objects are referenced by the parent query, only the table lists are released here
+  if (pQueryAttr->tableGroupInfo.pGroupList != NULL) {
+    size_t numOfGroups = taosArrayGetSize(pQueryAttr->tableGroupInfo.pGroupList);
+    for (int32_t i = 0; i < numOfGroups; ++i) {
+      taosArrayDestroy(taosArrayGetP(pQueryAttr->tableGroupInfo.pGroupList, i));
+    }
+
+    taosArrayDestroy(pQueryAttr->tableGroupInfo.pGroupList);
+  }
+
+  taosArrayDestroy(pQInfo->summary.queryProfEvents);
+  taosHashCleanup(pQInfo->summary.operatorProfResults);
+  taosArrayDestroy(pRuntimeEnv->groupResInfo.pRows);
+
+  tfree(pQInfo->pBuf);
+  tfree(pQInfo);
+}
+
+/*
+ * The worker shares the expressions, columns and tables with the parent query, while the states that are updated
+ * during query processing, i.e., the filter info, the mem snapshot, the table query info and the runtime env, are
+ * created for each worker. The tables are assigned to workers in a round-robin manner.
+ */
+static SQInfo* createParallelScanWorker(SQInfo* pQInfo, void* tsdb, SQueryParam* param, int32_t index, int32_t numOfWorkers) {
+  SQueryAttr* pQueryAttr = pQInfo->runtimeEnv.pQueryAttr;
+
+  SQInfo* pWorker = calloc(1, sizeof(SQInfo));
+  if (pWorker == NULL) {
+    return NULL;
+  }
+
+  pWorker->qId = pQInfo->qId;
+  pWorker->signature = pWorker;
+  pWorker->query = *pQueryAttr;
+
+  SQueryAttr* pAttr = &pWorker->query;
+  pAttr->pFilterInfo = NULL;
+  pAttr->numOfFilterCols = 0;
+  pAttr->createFilterOperator = false;
+  memset(&pAttr->memRef, 0, sizeof(pAttr->memRef));
+  memset(&pAttr->tableGroupInfo, 0, sizeof(pAttr->tableGroupInfo));
+
+  SQueryRuntimeEnv* pRuntimeEnv = &pWorker->runtimeEnv;
+  pRuntimeEnv->pQueryAttr = pAttr;
+  pRuntimeEnv->qinfo = pWorker;
+
+  if (createFilterInfo(pAttr, pWorker->qId) != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  size_t numOfGroups = taosArrayGetSize(pQueryAttr->tableGroupInfo.pGroupList);
+  size_t numOfTables = pQueryAttr->tableGroupInfo.numOfTables / numOfWorkers + 1;
+
+  STableGroupInfo* pTableqinfo = &pRuntimeEnv->tableqinfoGroupInfo;
+  pAttr->tableGroupInfo.pGroupList = taosArrayInit(numOfGroups, POINTER_BYTES);
+  pTableqinfo->pGroupList = taosArrayInit(numOfGroups, POINTER_BYTES);
+  pTableqinfo->map = taosHashInit(numOfTables, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_NO_LOCK);
+  pWorker->pBuf = calloc(numOfTables, sizeof(STableQueryInfo));
+
+  if (pAttr->tableGroupInfo.pGroupList == NULL || pTableqinfo->pGroupList == NULL || pTableqinfo->map == NULL ||
+      pWorker->pBuf == NULL) {
+    goto _error;
+  }
+
+  STimeWindow window = pQueryAttr->window;
+
+  int32_t seq = 0;
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfGroups; ++i) {
+    SArray* pa = taosArrayGetP(pQueryAttr->tableGroupInfo.pGroupList, i);
+    SArray* pKeyList = NULL;
+    SArray* pList = NULL;
+
+    size_t s = taosArrayGetSize(pa);
+    for (int32_t j = 0; j < s; ++j, ++seq) {
+      if (seq % numOfWorkers != index) {
+        continue;
+      }
+
+      if (pKeyList == NULL) {  // empty groups are not kept by the worker
+        pKeyList = taosArrayInit(s / numOfWorkers + 1, sizeof(STableKeyInfo));
+        pList = taosArrayInit(s / numOfWorkers + 1, POINTER_BYTES);
+        if (pKeyList == NULL || pList == NULL) {
+          taosArrayDestroy(pKeyList);
+          taosArrayDestroy(pList);
+          goto _error;
+        }
+
+        taosArrayPush(pAttr->tableGroupInfo.pGroupList, &pKeyList);
+        taosArrayPush(pTableqinfo->pGroupList, &pList);
+      }
+
+      STableKeyInfo* info = taosArrayGet(pa, j);
+      taosArrayPush(pKeyList, info);
+
+      window.skey = info->lastKey;
+
+      void* buf = (char*) pWorker->pBuf + num * sizeof(STableQueryInfo);
+      STableQueryInfo* item = createTableQueryInfo(pAttr, info->pTable, pAttr->groupbyColumn, window, buf);
+      if (item == NULL) {
+        goto _error;
+      }
+
+      item->groupIndex = (int32_t) taosArrayGetSize(pTableqinfo->pGroupList) - 1;
+      taosArrayPush(pList, &item);
+
+      STableId* id = TSDB_TABLEID(info->pTable);
+      taosHashPut(pTableqinfo->map, &id->tid, sizeof(id->tid), &item, POINTER_BYTES);
+      num += 1;
+    }
+  }
+
+  pAttr->tableGroupInfo.numOfTables = num;
+  pTableqinfo->numOfTables = num;
+
+  if (doInitQInfo(pWorker, NULL, tsdb, NULL, param->tableScanOperator, param->pOperator, NULL) != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pWorker;
+
+_error:
+  destroyParallelScanWorker(pWorker);
+  return NULL;
+}
+
+static SSDataBlock* doExecParallelScanWorker(SParallelScanWorker* pWorker) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pWorker->pQInfo->runtimeEnv;
+
+  int32_t ret = setjmp(pRuntimeEnv->env);
+  if (ret != TSDB_CODE_SUCCESS) {
+    pWorker->code = ret;
+    return NULL;
+  }
+
+  bool newgroup = false;
+  return pRuntimeEnv->proot->exec(pRuntimeEnv->proot, &newgroup);
+}
+
+static void doParallelScanTask(SSchedMsg* pMsg) {
+  SParallelScanWorker*       pWorker = pMsg->ahandle;
+  SParallelScanOperatorInfo* pInfo   = pWorker->pInfo;
+
+  pWorker->pRes = doExecParallelScanWorker(pWorker);
+  pWorker->pending = true;
+
+  pthread_mutex_lock(&pInfo->mutex);
+  pInfo->numOfRunning -= 1;
+  pthread_cond_signal(&pInfo->cond);
+  pthread_mutex_unlock(&pInfo->mutex);
+}
+
+static void waitParallelScanWorkers(SOperatorInfo* pOperator) {
+  SParallelScanOperatorInfo* pInfo = pOperator->info;
+  SQInfo* pQInfo = pOperator->pRuntimeEnv->qinfo;
+
+  pthread_mutex_lock(&pInfo->mutex);
+  while (pInfo->numOfRunning > 0) {
+    struct timespec ts = {0};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += 100 * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec += 1;
+      ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_cond_timedwait(&pInfo->cond, &pInfo->mutex, &ts);
+
+    // the workers check the kill flag of their own, so pass the cancel request on to them
+    if (isQueryKilled(pQInfo)) {
+      for (int32_t i = 0; i < pInfo->numOfWorkers; ++i) {
+        setQueryKilled(pInfo->pWorkers[i].pQInfo);
+      }
+    }
+  }
+  pthread_mutex_unlock(&pInfo->mutex);
+}
+
+static void addParallelScanCost(SQueryCostInfo* pDst, SQueryCostInfo* pSrc) {
+  pDst->loadStatisTime      += pSrc->loadStatisTime;
+  pDst->loadFileBlockTime   += pSrc->loadFileBlockTime;
+  pDst->loadDataInCacheTime += pSrc->loadDataInCacheTime;
+  pDst->loadStatisSize      += pSrc->loadStatisSize;
+  pDst->loadFileBlockSize   += pSrc->loadFileBlockSize;
+  pDst->loadDataInCacheSize += pSrc->loadDataInCacheSize;
+  pDst->loadDataTime        += pSrc->loadDataTime;
+  pDst->totalRows           += pSrc->totalRows;
+  pDst->totalCheckedRows    += pSrc->totalCheckedRows;
+  pDst->totalBlocks         += pSrc->totalBlocks;
+  pDst->loadBlocks          += pSrc->loadBlocks;
+  pDst->loadBlockStatis     += pSrc->loadBlockStatis;
+  pDst->discardBlocks       += pSrc->discardBlocks;
+  pDst->winInfoSize         += pSrc->winInfoSize;
+  pDst->tableInfoSize       += pSrc->tableInfoSize;
+  pDst->hashSize            += pSrc->hashSize;
+  pDst->numOfTimeWindows    += pSrc->numOfTimeWindows;
+}
+
+/*
+ * The first call runs the blocking aggregation of all workers in the scan threads, and waits for all of them.
+ * Then the results of the workers are returned one after another, each worker being drained before the next one.
+ */
+static SSDataBlock* doParallelScan(void* param, bool* newgroup) {
+  SOperatorInfo* pOperator = (SOperatorInfo*) param;
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  SParallelScanOperatorInfo* pInfo = pOperator->info;
+  SQueryRuntimeEnv* pRuntimeEnv = pOperator->pRuntimeEnv;
+  SQInfo* pQInfo = pRuntimeEnv->qinfo;
+
+  if (pOperator->status == OP_IN_EXECUTING) {
+    pthread_once(&tsParallelScanInit, doInitParallelScanSched);
+
+    int64_t st = taosGetTimestampUs();
+    pInfo->numOfRunning = pInfo->numOfWorkers;
+
+    for (int32_t i = 0; i < pInfo->numOfWorkers; ++i) {
+      SSchedMsg schedMsg = {0};
+      schedMsg.fp = doParallelScanTask;
+      schedMsg.ahandle = &pInfo->pWorkers[i];
+      taosScheduleTask(tsParallelScanSched, &schedMsg);
+    }
+
+    waitParallelScanWorkers(pOperator);
+
+    for (int32_t i = 0; i < pInfo->numOfWorkers; ++i) {
+      addParallelScanCost(&pQInfo->summary, &pInfo->pWorkers[i].pQInfo->summary);
+    }
+
+    for (int32_t i = 0; i < pInfo->numOfWorkers; ++i) {
+      if (pInfo->pWorkers[i].code != TSDB_CODE_SUCCESS) {
+        longjmp(pRuntimeEnv->env, pInfo->pWorkers[i].code);
+      }
+    }
+
+    qDebug("QInfo:0x%"PRIx64" %d workers completed scan of %u tables, elapsed:%"PRId64" us", pQInfo->qId,
+           pInfo->numOfWorkers, pRuntimeEnv->tableqinfoGroupInfo.numOfTables, taosGetTimestampUs() - st);
+
+    pInfo->current = 0;
+    pOperator->status = OP_RES_TO_RETURN;
+  }
+
+  while (pInfo->current < pInfo->numOfWorkers) {
+    SParallelScanWorker* pWorker = &pInfo->pWorkers[pInfo->current];
+
+    SSDataBlock* pBlock = NULL;
+    if (pWorker->pending) {
+      pBlock = pWorker->pRes;
+      pWorker->pending = false;
+    } else {
+      if (isQueryKilled(pQInfo)) {
+        longjmp(pRuntimeEnv->env, TSDB_CODE_TSC_QUERY_CANCELLED);
+      }
+
+      pBlock = doExecParallelScanWorker(pWorker);
+      if (pWorker->code != TSDB_CODE_SUCCESS) {
+        longjmp(pRuntimeEnv->env, pWorker->code);
+      }
+    }
+
+    if (pBlock != NULL && pBlock->info.rows > 0) {
+      return pBlock;
+    }
+
+    pInfo->current += 1;
+  }
+
+  setQueryStatus(pRuntimeEnv, QUERY_COMPLETED);
+  pOperator->status = OP_EXEC_DONE;
+  return NULL;
+}
+
+static void destroyParallelScanOperatorInfo(void* param, int32_t numOfOutput) {
+  SParallelScanOperatorInfo* pInfo = (SParallelScanOperatorInfo*) param;
+
+  if (pInfo->pWorkers != NULL) {
+    for (int32_t i = 0; i < pInfo->numOfWorkers; ++i) {
+      destroyParallelScanWorker(pInfo->pWorkers[i].pQInfo);
+    }
+
+    tfree(pInfo->pWorkers);
+  }
+
+  pthread_mutex_destroy(&pInfo->mutex);
+  pthread_cond_destroy(&pInfo->cond);
+}
+
+SOperatorInfo* createParallelScanOperatorInfo(SQueryRuntimeEnv* pRuntimeEnv, void* tsdb, SQueryParam* param) {
+  SQInfo*     pQInfo     = pRuntimeEnv->qinfo;
+  SQueryAttr* pQueryAttr = pRuntimeEnv->pQueryAttr;
+
+  SParallelScanOperatorInfo* pInfo = calloc(1, sizeof(SParallelScanOperatorInfo));
+  if (pInfo == NULL) {
+    return NULL;
+  }
+
+  pthread_mutex_init(&pInfo->mutex, NULL);
+  pthread_cond_init(&pInfo->cond, NULL);
+
+  SOperatorInfo* pOperator = calloc(1, sizeof(SOperatorInfo));
+  if (pOperator == NULL) {
+    destroyParallelScanOperatorInfo(pInfo, 0);
+    tfree(pInfo);
+    return NULL;
+  }
+
+  pOperator->name         = "ParallelScanOperator";
+  pOperator->operatorType = OP_ParallelScan;
+  pOperator->blockingOptr = true;
+  pOperator->status       = OP_IN_EXECUTING;
+  pOperator->pExpr        = pQueryAttr->pExpr1;
+  pOperator->numOfOutput  = pQueryAttr->numOfOutput;
+  pOperator->exec         = doParallelScan;
+  pOperator->info         = pInfo;
+  pOperator->pRuntimeEnv  = pRuntimeEnv;
+  pOperator->cleanup      = destroyParallelScanOperatorInfo;
+
+  int32_t numOfWorkers = (int32_t) MIN(tsQueryParallelism, pQueryAttr->tableGroupInfo.numOfTables);
+  pInfo->pWorkers = calloc(numOfWorkers, sizeof(SParallelScanWorker));
+  if (pInfo->pWorkers == NULL) {
+    destroyOperatorInfo(pOperator);
+    return NULL;
+  }
+
+  pInfo->numOfWorkers = numOfWorkers;
+  for (int32_t i = 0; i < numOfWorkers; ++i) {
+    SParallelScanWorker* pWorker = &pInfo->pWorkers[i];
+    pWorker->pInfo = pInfo;
+    pWorker->pQInfo = createParallelScanWorker(pQInfo, tsdb, param, i, numOfWorkers);
+    if (pWorker->pQInfo == NULL) {
+      qError("QInfo:0x%"PRIx64" failed to create parallel scan worker %d", pQInfo->qId, i);
+      destroyOperatorInfo(pOperator);
+      return NULL;
+    }
+  }
+
+  qDebug("QInfo:0x%"PRIx64" %u tables are scanned by %d workers", pQInfo->qId,
+         pRuntimeEnv->tableqinfoGroupInfo.numOfTables, numOfWorkers);
+  return pOperator;
+}
+
+/*
+ * The parent query does not scan any table, its operator tree only consists of the parallel scan operator, whose
+ * workers build the complete operator tree of the query over their own table subset.
+ */
+static int32_t doInitParallelScanQInfo(SQInfo* pQInfo, void* tsdb, SQueryParam* param) {
+  SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
+
+  SOperatorInfo* pOperator = createParallelScanOperatorInfo(pRuntimeEnv, tsdb, param);
+  if (pOperator == NULL) {
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  SArray* plan = taosArrayInit(1, sizeof(int32_t));
+  if (plan == NULL) {
+    destroyOperatorInfo(pOperator);
+    return TSDB_CODE_QRY_OUT_OF_MEMORY;
+  }
+
+  int32_t code = doInitQInfo(pQInfo, NULL, NULL, pOperator, -1, plan, NULL);
+  pRuntimeEnv->pQueryAttr->tsdb = tsdb;
+
+  taosArrayDestroy(plan);
+  return code;
+}
+
 int32_t initQInfo(STsBufInfo* pTsBufInfo, void* tsdb, void* sourceOptr, SQInfo* pQInfo, SQueryParam* param, char* start,
                   int32_t prevResultLen, void* merger) {
   int32_t code = TSDB_CODE_SUCCESS;
@@ -7961,6 +8811,18 @@ int32_t initQInfo(STsBufInfo* pTsBufInfo, void* tsdb, void* sourceOptr, SQInfo*
     return TSDB_CODE_SUCCESS;
   }
 
+  if (tsdb != NULL && sourceOptr == NULL) {
+    pQInfo->scanCost = estimateQueryScanCost(pQueryAttr, tsdb);
+  }
+
+  if (tsdb != NULL && sourceOptr == NULL && isParallelScanQuery(pQInfo, param, pTsBuf)) {
+    if ((code = doInitParallelScanQInfo(pQInfo, tsdb, param)) != TSDB_CODE_SUCCESS) {
+      goto _error;
+    }
+
+    return code;
+  }
+
   // filter the qualified
   if ((code = doInitQInfo(pQInfo, pTsBuf, tsdb, sourceOptr, param->tableScanOperator, param->pOperator, merger)) != TSDB_CODE_SUCCESS) {
     goto _error;
@@ -8083,7 +8945,7 @@ void freeQInfo(SQInfo *pQInfo) {
   tfree(pQInfo);
 }
 
-int32_t doDumpQueryResult(SQInfo *pQInfo, char *data) {
+int32_t doDumpQueryResult(SQInfo *pQInfo, char *data, int32_t *len) {
   // the remained number of retrieved rows, not the interpolated result
   SQueryRuntimeEnv* pRuntimeEnv = &pQInfo->runtimeEnv;
   SQueryAttr *pQueryAttr = pQInfo->runtimeEnv.pQueryAttr;
@@ -8126,7 +8988,7 @@ int32_t doDumpQueryResult(SQInfo *pQInfo, char *data) {
       setQueryStatus(pRuntimeEnv, QUERY_OVER);
     }
   } else {
-    doCopyQueryResultToMsg(pQInfo, (int32_t)pRuntimeEnv->outputBuf->info.rows, data);
+    *len = doCopyQueryResultToMsg(pQInfo, (int32_t)pRuntimeEnv->outputBuf->info.rows, data);
   }
 
   qDebug("QInfo:0x%"PRIx64" current numOfRes rows:%d, total:%" PRId64, pQInfo->qId,
@@ -734,7 +734,8 @@ static void columnwiseQSortImpl(tOrderDescriptor *pDescriptor, int32_t numOfRows
   }
 }
 
-void tColDataQSort(tOrderDescriptor *pDescriptor, int32_t numOfRows, int32_t start, int32_t end, char *data, int32_t order) {
+void tColDataQuickSort(tOrderDescriptor *pDescriptor, int32_t numOfRows, int32_t start, int32_t end, char *data,
+                       int32_t order) {
   // short array sort, incur another sort procedure instead of quick sort process
   __col_compar_fn_t compareFn = (order == TSDB_ORDER_ASC) ? compare_sa : compare_sd;
 
@@ -760,6 +761,168 @@ void tColDataQSort(tOrderDescriptor *pDescriptor, int32_t numOfRows, int32_t sta
   free(buf);
 }
 
+typedef struct SRadixSortItem {
+  uint64_t key;    // value of the leading order column mapped to the unsigned order of the sort
+  int32_t  index;  // row index in data
+} SRadixSortItem;
+
+typedef struct SRadixSortTieParam {
+  tOrderDescriptor *pDescriptor;
+  int32_t           numOfRows;
+  char             *data;
+  __col_compar_fn_t compareFn;
+} SRadixSortTieParam;
+
+static FORCE_INLINE bool isRadixSortType(int32_t type) {
+  return type == TSDB_DATA_TYPE_BOOL || type == TSDB_DATA_TYPE_TIMESTAMP || IS_SIGNED_NUMERIC_TYPE(type) ||
+         IS_UNSIGNED_NUMERIC_TYPE(type);
+}
+
+// the sign bit of signed value is flipped to make the unsigned order of the key identical to the signed order
+static FORCE_INLINE uint64_t getRadixSortKey(const char *val, int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:   return (uint64_t)(int64_t)GET_INT8_VAL(val) ^ (1ULL << 63u);
+    case TSDB_DATA_TYPE_SMALLINT:  return (uint64_t)(int64_t)GET_INT16_VAL(val) ^ (1ULL << 63u);
+    case TSDB_DATA_TYPE_INT:       return (uint64_t)(int64_t)GET_INT32_VAL(val) ^ (1ULL << 63u);
+    case TSDB_DATA_TYPE_UTINYINT:  return GET_UINT8_VAL(val);
+    case TSDB_DATA_TYPE_USMALLINT: return GET_UINT16_VAL(val);
+    case TSDB_DATA_TYPE_UINT:      return GET_UINT32_VAL(val);
+    case TSDB_DATA_TYPE_UBIGINT:   return GET_UINT64_VAL(val);
+    default:                       return (uint64_t)GET_INT64_VAL(val) ^ (1ULL << 63u);
+  }
+}
+
+static int32_t radixSortTieComparator(const void *p1, const void *p2, const void *param) {
+  const SRadixSortTieParam *pParam = param;
+  return pParam->compareFn(pParam->pDescriptor, pParam->numOfRows, ((SRadixSortItem *)p1)->index,
+                           ((SRadixSortItem *)p2)->index, pParam->data);
+}
+
+// move the rows of each column to the sorted position of each row through one gather into the buffer
+static void radixSortPermute(SColumnModel *pModel, int32_t numOfRows, int32_t start, int32_t num, char *data,
+                             SRadixSortItem *pItems, char *buf) {
+  for (int32_t i = 0; i < pModel->numOfCols; ++i) {
+    int32_t bytes = pModel->pFields[i].field.bytes;
+    char   *pCol = COLMODEL_GET_VAL(data, pModel, numOfRows, 0, i);
+
+    switch (bytes) {
+      case sizeof(int64_t):
+        for (int32_t j = 0; j < num; ++j) ((int64_t *)buf)[j] = ((int64_t *)pCol)[pItems[j].index];
+        break;
+      case sizeof(int32_t):
+        for (int32_t j = 0; j < num; ++j) ((int32_t *)buf)[j] = ((int32_t *)pCol)[pItems[j].index];
+        break;
+      default:
+        for (int32_t j = 0; j < num; ++j) memcpy(buf + (int64_t)j * bytes, pCol + (int64_t)pItems[j].index * bytes, bytes);
+        break;
+    }
+
+    memcpy(pCol + (int64_t)start * bytes, buf, (size_t)num * bytes);
+  }
+}
+
+int32_t tColDataRadixSort(tOrderDescriptor *pDescriptor, int32_t numOfRows, int32_t start, int32_t end, char *data,
+                          int32_t order) {
+  SColumnModel *pModel = pDescriptor->pColumnModel;
+
+  int32_t colIdx = pDescriptor->orderInfo.colIndex[0];
+  int32_t type = pModel->pFields[colIdx].field.type;
+  if (pDescriptor->orderInfo.numOfCols <= 0 || !isRadixSortType(type)) {
+    return -1;
+  }
+
+  int32_t num = end - start + 1;
+  int32_t width = 0;
+  for (int32_t i = 0; i < pModel->numOfCols; ++i) {
+    width = MAX(width, pModel->pFields[i].field.bytes);
+  }
+
+  SRadixSortItem *pItems = malloc(sizeof(SRadixSortItem) * num * 2);
+  char           *buf = malloc((size_t)num * width);
+  if (pItems == NULL || buf == NULL) {
+    tfree(pItems);
+    tfree(buf);
+    return -1;
+  }
+
+  // the timestamp is always ordered by the ts order, see compare_a and compare_d
+  bool     desc = (type == TSDB_DATA_TYPE_TIMESTAMP) ? (pDescriptor->tsOrder == TSDB_ORDER_DESC) : (order == TSDB_ORDER_DESC);
+  uint64_t mask = desc ? UINT64_MAX : 0;
+
+  // build the histogram of all the 8 digits in one pass
+  uint32_t counts[sizeof(uint64_t)][256] = {{0}};
+  for (int32_t i = 0; i < num; ++i) {
+    uint64_t key = getRadixSortKey(COLMODEL_GET_VAL(data, pModel, numOfRows, start + i, colIdx), type) ^ mask;
+    pItems[i].key = key;
+    pItems[i].index = start + i;
+
+    for (int32_t d = 0; d < (int32_t)sizeof(uint64_t); ++d) {
+      counts[d][(key >> (d * 8u)) & 0xFFu]++;
+    }
+  }
+
+  SRadixSortItem *pSrc = pItems;
+  SRadixSortItem *pDst = pItems + num;
+  for (int32_t d = 0; d < (int32_t)sizeof(uint64_t); ++d) {
+    uint32_t *c = counts[d];
+    uint32_t  shift = d * 8u;
+
+    // the digit is identical for all keys, e.g., the high digits of timestamps in one page
+    if (c[(pSrc[0].key >> shift) & 0xFFu] == (uint32_t)num) {
+      continue;
+    }
+
+    uint32_t offset = 0;
+    for (int32_t j = 0; j < 256; ++j) {
+      uint32_t t = c[j];
+      c[j] = offset;
+      offset += t;
+    }
+
+    for (int32_t i = 0; i < num; ++i) {
+      pDst[c[(pSrc[i].key >> shift) & 0xFFu]++] = pSrc[i];
+    }
+
+    SRadixSortItem *p = pSrc;
+    pSrc = pDst;
+    pDst = p;
+  }
+
+  // the rows of the identical leading key are ordered by the rest order columns
+  if (pDescriptor->orderInfo.numOfCols > 1) {
+    SRadixSortTieParam param = {.pDescriptor = pDescriptor, .numOfRows = numOfRows, .data = data,
+                                .compareFn = (order == TSDB_ORDER_ASC) ? compare_sa : compare_sd};
+
+    for (int32_t i = 0; i < num;) {
+      int32_t j = i + 1;
+      while (j < num && pSrc[j].key == pSrc[i].key) {
+        ++j;
+      }
+
+      if (j - i > 1) {
+        taosqsort(&pSrc[i], j - i, sizeof(SRadixSortItem), &param, radixSortTieComparator);
+      }
+      i = j;
+    }
+  }
+
+  radixSortPermute(pModel, numOfRows, start, num, data, pSrc, buf);
+
+  free(pItems);
+  free(buf);
+  return 0;
+}
+
+void tColDataQSort(tOrderDescriptor *pDescriptor, int32_t numOfRows, int32_t start, int32_t end, char *data, int32_t order) {
+  // the radix sort is used if the leading order column is of integer or timestamp type
+  if (end - start + 1 >= RADIX_SORT_MIN_ROWS && tColDataRadixSort(pDescriptor, numOfRows, start, end, data, order) == 0) {
+    return;
+  }
+
+  tColDataQuickSort(pDescriptor, numOfRows, start, end, data, order);
+}
+
 /*
  * deep copy of sschema
  */
@@ -463,3 +463,204 @@ __filter_func_t getFilterOperator(int32_t lowerOptr, int32_t upperOptr) {
 
   return funcFp;
 }
+
+////////////////////////////////////////////////////////////////////////////
+// Batch filters: evaluate one filter over a whole column of fixed length values and or the results into a selection
+// array. The kernels are generated per type and operator with the same comparisons as the filter functions above,
+// the bounds are loaded once so that the loops can be vectorized by the compiler. NULL values are not skipped by
+// the kernels, the caller masks them out.
+#define FILTER_BATCH_LT      1
+#define FILTER_BATCH_GT      2
+#define FILTER_BATCH_EQ      3
+#define FILTER_BATCH_LE      4
+#define FILTER_BATCH_GE      5
+#define FILTER_BATCH_NE      6
+#define FILTER_BATCH_RANGE_EE 7
+#define FILTER_BATCH_RANGE_IE 8
+#define FILTER_BATCH_RANGE_EI 9
+#define FILTER_BATCH_RANGE_II 10
+#define FILTER_BATCH_MAX     11
+
+#define FILTER_BATCH_KERNEL(_name, _type, _expr)                                                    \
+  static void _name(SColumnFilterElem *pFilter, const char *pData, int32_t numOfRows, int8_t *p) { \
+    const _type * val = (const _type *)pData;                                                      \
+    const int64_t lowerI = pFilter->filterInfo.lowerBndi;                                          \
+    const int64_t upperI = pFilter->filterInfo.upperBndi;                                          \
+    const double  lowerD = pFilter->filterInfo.lowerBndd;                                          \
+    const double  upperD = pFilter->filterInfo.upperBndd;                                          \
+    (void)lowerI;                                                                                  \
+    (void)upperI;                                                                                  \
+    (void)lowerD;                                                                                  \
+    (void)upperD;                                                                                  \
+    for (int32_t i = 0; i < numOfRows; ++i) {                                                      \
+      const _type x = val[i];                                                                      \
+      p[i] |= (int8_t)(_expr);                                                                     \
+    }                                                                                              \
+  }
+
+#define FILTER_BATCH_INT_KERNELS(_suffix, _type)                                                    \
+  FILTER_BATCH_KERNEL(filterBatchLt_##_suffix, _type, x < upperI)                                   \
+  FILTER_BATCH_KERNEL(filterBatchGt_##_suffix, _type, x > lowerI)                                   \
+  FILTER_BATCH_KERNEL(filterBatchEq_##_suffix, _type, x == lowerI)                                  \
+  FILTER_BATCH_KERNEL(filterBatchLe_##_suffix, _type, x <= upperI)                                  \
+  FILTER_BATCH_KERNEL(filterBatchGe_##_suffix, _type, x >= lowerI)                                  \
+  FILTER_BATCH_KERNEL(filterBatchNe_##_suffix, _type, x != lowerI)                                  \
+  FILTER_BATCH_KERNEL(filterBatchRangeEe_##_suffix, _type, (x < upperI) & (x > lowerI))             \
+  FILTER_BATCH_KERNEL(filterBatchRangeIe_##_suffix, _type, (x < upperI) & (x >= lowerI))            \
+  FILTER_BATCH_KERNEL(filterBatchRangeEi_##_suffix, _type, (x <= upperI) & (x > lowerI))            \
+  FILTER_BATCH_KERNEL(filterBatchRangeIi_##_suffix, _type, (x <= upperI) & (x >= lowerI))
+
+FILTER_BATCH_INT_KERNELS(i8, int8_t)
+FILTER_BATCH_INT_KERNELS(u8, uint8_t)
+FILTER_BATCH_INT_KERNELS(i16, int16_t)
+FILTER_BATCH_INT_KERNELS(u16, uint16_t)
+FILTER_BATCH_INT_KERNELS(i32, int32_t)
+FILTER_BATCH_INT_KERNELS(u32, uint32_t)
+FILTER_BATCH_INT_KERNELS(i64, int64_t)
+FILTER_BATCH_INT_KERNELS(u64, uint64_t)
+
+FILTER_BATCH_KERNEL(filterBatchLt_f, float, FLT_LESS(x, upperD))
+FILTER_BATCH_KERNEL(filterBatchGt_f, float, FLT_GREATER(x, lowerD))
+FILTER_BATCH_KERNEL(filterBatchEq_f, float, FLT_EQUAL((double)x, lowerD))
+FILTER_BATCH_KERNEL(filterBatchLe_f, float, FLT_LESSEQUAL(x, upperD))
+FILTER_BATCH_KERNEL(filterBatchGe_f, float, FLT_GREATEREQUAL(x, lowerD))
+FILTER_BATCH_KERNEL(filterBatchNe_f, float, !FLT_EQUAL((double)x, lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeEe_f, float, (x < upperD) & (x > lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeIe_f, float, (x < upperD) & (x >= lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeEi_f, float, FLT_GREATER(x, lowerD) && FLT_LESSEQUAL(x, upperD))
+FILTER_BATCH_KERNEL(filterBatchRangeIi_f, float, FLT_LESSEQUAL(x, upperD) && FLT_GREATEREQUAL(x, lowerD))
+
+FILTER_BATCH_KERNEL(filterBatchLt_d, double, x < upperD)
+FILTER_BATCH_KERNEL(filterBatchGt_d, double, x > lowerD)
+FILTER_BATCH_KERNEL(filterBatchEq_d, double, FLT_EQUAL(x, lowerD))
+FILTER_BATCH_KERNEL(filterBatchLe_d, double, ((fabs(x) - upperD) <= 2 * DBL_EPSILON) || (x <= upperD))
+FILTER_BATCH_KERNEL(filterBatchGe_d, double, (fabs(x - lowerD) <= 2 * DBL_EPSILON) || (x - lowerD > (2 * DBL_EPSILON)))
+FILTER_BATCH_KERNEL(filterBatchNe_d, double, !FLT_EQUAL(x, lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeEe_d, double, (x < upperD) & (x > lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeIe_d, double, (x < upperD) & (x >= lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeEi_d, double, (x <= upperD) & (x > lowerD))
+FILTER_BATCH_KERNEL(filterBatchRangeIi_d, double, (x <= upperD) & (x >= lowerD))
+
+#define FILTER_BATCH_KERNEL_LIST(_suffix)                                                                       \
+  {                                                                                                             \
+    NULL, filterBatchLt_##_suffix, filterBatchGt_##_suffix, filterBatchEq_##_suffix, filterBatchLe_##_suffix,  \
+        filterBatchGe_##_suffix, filterBatchNe_##_suffix, filterBatchRangeEe_##_suffix,                         \
+        filterBatchRangeIe_##_suffix, filterBatchRangeEi_##_suffix, filterBatchRangeIi_##_suffix                \
+  }
+
+// the bool type only supports the equal and not equal filters
+static __filter_batch_func_t filterBatchOperators[TSDB_DATA_TYPE_UBIGINT + 1][FILTER_BATCH_MAX] = {
+    [TSDB_DATA_TYPE_BOOL] = {[FILTER_BATCH_EQ] = filterBatchEq_i8, [FILTER_BATCH_NE] = filterBatchNe_i8},
+    [TSDB_DATA_TYPE_TINYINT] = FILTER_BATCH_KERNEL_LIST(i8),
+    [TSDB_DATA_TYPE_SMALLINT] = FILTER_BATCH_KERNEL_LIST(i16),
+    [TSDB_DATA_TYPE_INT] = FILTER_BATCH_KERNEL_LIST(i32),
+    [TSDB_DATA_TYPE_BIGINT] = FILTER_BATCH_KERNEL_LIST(i64),
+    [TSDB_DATA_TYPE_FLOAT] = FILTER_BATCH_KERNEL_LIST(f),
+    [TSDB_DATA_TYPE_DOUBLE] = FILTER_BATCH_KERNEL_LIST(d),
+    [TSDB_DATA_TYPE_TIMESTAMP] = FILTER_BATCH_KERNEL_LIST(i64),
+    [TSDB_DATA_TYPE_UTINYINT] = FILTER_BATCH_KERNEL_LIST(u8),
+    [TSDB_DATA_TYPE_USMALLINT] = FILTER_BATCH_KERNEL_LIST(u16),
+    [TSDB_DATA_TYPE_UINT] = FILTER_BATCH_KERNEL_LIST(u32),
+    [TSDB_DATA_TYPE_UBIGINT] = FILTER_BATCH_KERNEL_LIST(u64),
+};
+
+__filter_batch_func_t getFilterBatchOperator(int32_t lowerOptr, int32_t upperOptr, int16_t type) {
+  int32_t op = 0;
+
+  if (type < TSDB_DATA_TYPE_BOOL || type > TSDB_DATA_TYPE_UBIGINT) {
+    return NULL;
+  }
+
+  if ((lowerOptr == TSDB_RELATION_GREATER_EQUAL || lowerOptr == TSDB_RELATION_GREATER) &&
+      (upperOptr == TSDB_RELATION_LESS_EQUAL || upperOptr == TSDB_RELATION_LESS)) {
+    if (lowerOptr == TSDB_RELATION_GREATER_EQUAL) {
+      op = (upperOptr == TSDB_RELATION_LESS_EQUAL) ? FILTER_BATCH_RANGE_II : FILTER_BATCH_RANGE_IE;
+    } else {
+      op = (upperOptr == TSDB_RELATION_LESS_EQUAL) ? FILTER_BATCH_RANGE_EI : FILTER_BATCH_RANGE_EE;
+    }
+  } else if (lowerOptr != TSDB_RELATION_INVALID && upperOptr != TSDB_RELATION_INVALID) {
+    return NULL;
+  } else {
+    op = (lowerOptr != TSDB_RELATION_INVALID) ? lowerOptr : upperOptr;
+    if (op < TSDB_RELATION_LESS || op > TSDB_RELATION_NOT_EQUAL) {
+      return NULL;
+    }
+  }
+
+  return filterBatchOperators[type][op];
+}
+
+#define FILTER_NULL_KERNEL(_type, _null)              \
+  do {                                                \
+    const _type *val = (const _type *)pData;          \
+    for (int32_t i = 0; i < numOfRows; ++i) {         \
+      isnull[i] = (int8_t)(val[i] == (_type)(_null)); \
+    }                                                 \
+  } while (0)
+
+static void getColumnNullMask(const char *pData, int16_t type, int16_t bytes, int32_t numOfRows, int8_t *isnull) {
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL: FILTER_NULL_KERNEL(uint8_t, TSDB_DATA_BOOL_NULL); break;
+    case TSDB_DATA_TYPE_TINYINT: FILTER_NULL_KERNEL(uint8_t, TSDB_DATA_TINYINT_NULL); break;
+    case TSDB_DATA_TYPE_UTINYINT: FILTER_NULL_KERNEL(uint8_t, TSDB_DATA_UTINYINT_NULL); break;
+    case TSDB_DATA_TYPE_SMALLINT: FILTER_NULL_KERNEL(uint16_t, TSDB_DATA_SMALLINT_NULL); break;
+    case TSDB_DATA_TYPE_USMALLINT: FILTER_NULL_KERNEL(uint16_t, TSDB_DATA_USMALLINT_NULL); break;
+    case TSDB_DATA_TYPE_INT: FILTER_NULL_KERNEL(uint32_t, TSDB_DATA_INT_NULL); break;
+    case TSDB_DATA_TYPE_UINT: FILTER_NULL_KERNEL(uint32_t, TSDB_DATA_UINT_NULL); break;
+    case TSDB_DATA_TYPE_FLOAT: FILTER_NULL_KERNEL(uint32_t, TSDB_DATA_FLOAT_NULL); break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP: FILTER_NULL_KERNEL(uint64_t, TSDB_DATA_BIGINT_NULL); break;
+    case TSDB_DATA_TYPE_UBIGINT: FILTER_NULL_KERNEL(uint64_t, TSDB_DATA_UBIGINT_NULL); break;
+    case TSDB_DATA_TYPE_DOUBLE: FILTER_NULL_KERNEL(uint64_t, TSDB_DATA_DOUBLE_NULL); break;
+    default:
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        isnull[i] = isNull(pData + bytes * i, type);
+      }
+      break;
+  }
+}
+
+/*
+ * Evaluate the filters of one column over a block and and the result into p. A row of the column qualifies if it
+ * satisfies any of the filters, the NULL values only satisfy the is null filter. The buf has 2 * numOfRows bytes.
+ * Return the number of rows still qualified in p.
+ */
+int32_t doFilterColumnBatch(SSingleColumnFilterInfo *pFilterInfo, int32_t numOfRows, int8_t *p, int8_t *buf) {
+  const char *pData = (const char *)pFilterInfo->pData;
+  int16_t     type = pFilterInfo->info.type;
+  int16_t     bytes = pFilterInfo->info.bytes;
+  int8_t *    sel = buf;
+  int8_t *    isnull = buf + numOfRows;
+  bool        hasIsNull = false;
+
+  memset(sel, 0, numOfRows);
+  getColumnNullMask(pData, type, bytes, numOfRows, isnull);
+
+  for (int32_t j = 0; j < pFilterInfo->numOfFilters; ++j) {
+    SColumnFilterElem *pFilterElem = &pFilterInfo->pFilters[j];
+
+    if (pFilterElem->fp == isNullOperator) {
+      hasIsNull = true;
+    } else if (pFilterElem->fp == notNullOperator) {
+      memset(sel, 1, numOfRows);
+    } else if (pFilterElem->bfp != NULL) {
+      pFilterElem->bfp(pFilterElem, pData, numOfRows, sel);
+    } else {
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        if (!sel[i] && !isnull[i]) {
+          const char *pElem = pData + bytes * i;
+          sel[i] = pFilterElem->fp(pFilterElem, pElem, pElem, type);
+        }
+      }
+    }
+  }
+
+  int32_t numOfQualified = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int8_t qualified = isnull[i] ? (int8_t)hasIsNull : sel[i];
+    p[i] &= qualified;
+    numOfQualified += p[i];
+  }
+
+  return numOfQualified;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+
+#include "hashfunc.h"
+#include "qGroupHash.h"
+#include "taoserror.h"
+#include "ttype.h"
+
+#define GROUP_HASH_INIT_CAPACITY 1024
+#define GROUP_HASH_INIT_GROUPS   256
+
+static FORCE_INLINE int64_t getFixedKey(const char *val, int16_t bytes) {
+  switch (bytes) {
+    case 1:  return *(uint8_t *)val;
+    case 2:  return *(uint16_t *)val;
+    case 4:  return *(uint32_t *)val;
+    default: return *(int64_t *)val;
+  }
+}
+
+static FORCE_INLINE uint32_t hashFixedKey(int64_t key) {
+  return (uint32_t)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 32u);
+}
+
+static int32_t groupHashResize(SGroupHashInfo *pHashInfo) {
+  uint32_t         capacity = pHashInfo->capacity * 2;
+  SGroupHashEntry *pEntries = malloc(sizeof(SGroupHashEntry) * capacity);
+  if (pEntries == NULL) {
+    return -1;
+  }
+
+  memset(pEntries, -1, sizeof(SGroupHashEntry) * capacity);
+
+  uint32_t mask = capacity - 1;
+  for (uint32_t i = 0; i < pHashInfo->capacity; ++i) {
+    SGroupHashEntry *pEntry = &pHashInfo->pEntries[i];
+    if (pEntry->groupId < 0) {
+      continue;
+    }
+
+    uint32_t slot = pEntry->hashVal & mask;
+    while (pEntries[slot].groupId >= 0) {
+      slot = (slot + 1) & mask;
+    }
+
+    pEntries[slot] = *pEntry;
+  }
+
+  free(pHashInfo->pEntries);
+  pHashInfo->pEntries = pEntries;
+  pHashInfo->capacity = capacity;
+  return 0;
+}
+
+static int32_t groupHashExpandGroups(SGroupHashInfo *pHashInfo) {
+  int32_t maxGroups = pHashInfo->maxGroups * 2;
+
+  char *pKeys = realloc(pHashInfo->pKeys, (size_t)maxGroups * pHashInfo->bytes);
+  if (pKeys == NULL) {
+    return -1;
+  }
+  pHashInfo->pKeys = pKeys;
+
+  void **pData = realloc(pHashInfo->pData, (size_t)maxGroups * POINTER_BYTES);
+  if (pData == NULL) {
+    return -1;
+  }
+  pHashInfo->pData = pData;
+
+  int32_t *pLocal = realloc(pHashInfo->pLocal, (size_t)maxGroups * sizeof(int32_t));
+  if (pLocal == NULL) {
+    return -1;
+  }
+  pHashInfo->pLocal = pLocal;
+
+  uint32_t *pStamp = realloc(pHashInfo->pStamp, (size_t)maxGroups * sizeof(uint32_t));
+  if (pStamp == NULL) {
+    return -1;
+  }
+  pHashInfo->pStamp = pStamp;
+
+  pHashInfo->maxGroups = maxGroups;
+  return 0;
+}
+
+// return the group id of the key, a new group is added if the key does not exist
+static int32_t groupHashGetOrAdd(SGroupHashInfo *pHashInfo, int64_t key, uint32_t hashVal, const char *val) {
+  bool     varKey = IS_VAR_DATA_TYPE(pHashInfo->type);
+  uint32_t mask = pHashInfo->capacity - 1;
+  uint32_t slot = hashVal & mask;
+
+  while (1) {
+    SGroupHashEntry *pEntry = &pHashInfo->pEntries[slot];
+    if (pEntry->groupId < 0) {
+      break;
+    }
+
+    if (pEntry->hashVal == hashVal && pEntry->key == key &&
+        (!varKey || memcmp(varDataVal(tGroupHashGetKey(pHashInfo, pEntry->groupId)), varDataVal(val), (size_t)key) == 0)) {
+      return pEntry->groupId;
+    }
+
+    slot = (slot + 1) & mask;
+  }
+
+  // keep the load factor below 0.5 to make the probe sequence short
+  if ((uint32_t)(pHashInfo->numOfGroups + 1) * 2 > pHashInfo->capacity) {
+    if (groupHashResize(pHashInfo) != 0) {
+      return -1;
+    }
+
+    mask = pHashInfo->capacity - 1;
+    slot = hashVal & mask;
+    while (pHashInfo->pEntries[slot].groupId >= 0) {
+      slot = (slot + 1) & mask;
+    }
+  }
+
+  if (pHashInfo->numOfGroups >= pHashInfo->maxGroups && groupHashExpandGroups(pHashInfo) != 0) {
+    return -1;
+  }
+
+  int32_t groupId = pHashInfo->numOfGroups++;
+  if (varKey) {
+    varDataCopy(tGroupHashGetKey(pHashInfo, groupId), val);
+  } else {
+    memcpy(tGroupHashGetKey(pHashInfo, groupId), val, pHashInfo->bytes);
+  }
+
+  pHashInfo->pData[groupId] = NULL;
+  pHashInfo->pStamp[groupId] = 0;
+
+  SGroupHashEntry *pEntry = &pHashInfo->pEntries[slot];
+  pEntry->key = key;
+  pEntry->hashVal = hashVal;
+  pEntry->groupId = groupId;
+  return groupId;
+}
+
+SGroupHashInfo *tGroupHashCreate(int16_t type, int16_t bytes) {
+  SGroupHashInfo *pHashInfo = calloc(1, sizeof(SGroupHashInfo));
+  if (pHashInfo == NULL) {
+    return NULL;
+  }
+
+  pHashInfo->type = type;
+  pHashInfo->bytes = bytes;
+  pHashInfo->capacity = GROUP_HASH_INIT_CAPACITY;
+  pHashInfo->maxGroups = GROUP_HASH_INIT_GROUPS;
+
+  if (!IS_VAR_DATA_TYPE(type)) {
+    char buf[sizeof(int64_t)] = {0};
+    setNull(buf, type, bytes);
+    pHashInfo->nullKey = getFixedKey(buf, bytes);
+  }
+
+  pHashInfo->pEntries = malloc(sizeof(SGroupHashEntry) * pHashInfo->capacity);
+  pHashInfo->pKeys = malloc((size_t)pHashInfo->maxGroups * bytes);
+  pHashInfo->pData = malloc((size_t)pHashInfo->maxGroups * POINTER_BYTES);
+  pHashInfo->pLocal = malloc((size_t)pHashInfo->maxGroups * sizeof(int32_t));
+  pHashInfo->pStamp = malloc((size_t)pHashInfo->maxGroups * sizeof(uint32_t));
+
+  if (pHashInfo->pEntries == NULL || pHashInfo->pKeys == NULL || pHashInfo->pData == NULL ||
+      pHashInfo->pLocal == NULL || pHashInfo->pStamp == NULL) {
+    tGroupHashDestroy(pHashInfo);
+    return NULL;
+  }
+
+  memset(pHashInfo->pEntries, -1, sizeof(SGroupHashEntry) * pHashInfo->capacity);
+  return pHashInfo;
+}
+
+void tGroupHashDestroy(SGroupHashInfo *pHashInfo) {
+  if (pHashInfo == NULL) {
+    return;
+  }
+
+  tfree(pHashInfo->pEntries);
+  tfree(pHashInfo->pKeys);
+  tfree(pHashInfo->pData);
+  tfree(pHashInfo->pLocal);
+  tfree(pHashInfo->pStamp);
+  free(pHashInfo);
+}
+
+void tGroupHashClear(SGroupHashInfo *pHashInfo) {
+  memset(pHashInfo->pEntries, -1, sizeof(SGroupHashEntry) * pHashInfo->capacity);
+  pHashInfo->numOfGroups = 0;
+}
+
+int32_t tGroupHashAssign(SGroupHashInfo *pHashInfo, const char *pData, int32_t numOfRows, int32_t *pRowGroup,
+                         int32_t *pGroups) {
+  if (++pHashInfo->stamp == 0) {
+    memset(pHashInfo->pStamp, 0, sizeof(uint32_t) * pHashInfo->maxGroups);
+    pHashInfo->stamp = 1;
+  }
+
+  uint32_t stamp = pHashInfo->stamp;
+  int16_t  bytes = pHashInfo->bytes;
+  int32_t  numOfGroups = 0;
+
+  // the adjacent rows of the identical value are assigned without probing the hash table
+  int32_t prevGroup = -1;
+  int64_t prevKey = 0;
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    const char *val = pData + (int64_t)bytes * i;
+
+    int64_t  key = 0;
+    uint32_t hashVal = 0;
+    if (IS_VAR_DATA_TYPE(pHashInfo->type)) {
+      if (isNull(val, pHashInfo->type)) {
+        pRowGroup[i] = -1;
+        prevGroup = -1;
+        continue;
+      }
+
+      key = varDataLen(val);
+      if (prevGroup >= 0 && key == prevKey &&
+          memcmp(varDataVal(pData + (int64_t)bytes * (i - 1)), varDataVal(val), (size_t)key) == 0) {
+        pRowGroup[i] = pRowGroup[i - 1];
+        continue;
+      }
+
+      hashVal = MurmurHash3_32(varDataVal(val), (uint32_t)key);
+    } else {
+      key = getFixedKey(val, bytes);
+      if (key == pHashInfo->nullKey) {
+        pRowGroup[i] = -1;
+        prevGroup = -1;
+        continue;
+      }
+
+      if (prevGroup >= 0 && key == prevKey) {
+        pRowGroup[i] = pRowGroup[i - 1];
+        continue;
+      }
+
+      hashVal = hashFixedKey(key);
+    }
+
+    int32_t groupId = groupHashGetOrAdd(pHashInfo, key, hashVal, val);
+    if (groupId < 0) {
+      terrno = TSDB_CODE_QRY_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    if (pHashInfo->pStamp[groupId] != stamp) {
+      pHashInfo->pStamp[groupId] = stamp;
+      pHashInfo->pLocal[groupId] = numOfGroups;
+      pGroups[numOfGroups++] = groupId;
+    }
+
+    pRowGroup[i] = pHashInfo->pLocal[groupId];
+    prevGroup = groupId;
+    prevKey = key;
+  }
+
+  return numOfGroups;
+}
@@ -46,6 +46,9 @@ int32_t initResultRowInfo(SResultRowInfo *pResultRowInfo, int32_t size, int16_t
   pResultRowInfo->size     = 0;
   pResultRowInfo->curPos  = -1;
   pResultRowInfo->capacity = size;
+  pResultRowInfo->denseSize = 0;
+  pResultRowInfo->pDenseIndex = NULL;
+  pResultRowInfo->pDenseCharged = NULL;
 
   pResultRowInfo->pResult = calloc(pResultRowInfo->capacity, POINTER_BYTES);
   if (pResultRowInfo->pResult == NULL) {
@@ -60,6 +63,8 @@ void cleanupResultRowInfo(SResultRowInfo *pResultRowInfo) {
     return;
   }
 
+  freeDenseWindowIndex(pResultRowInfo);
+
   if (pResultRowInfo->capacity == 0) {
     assert(pResultRowInfo->pResult == NULL);
     return;
@@ -74,6 +79,20 @@ void cleanupResultRowInfo(SResultRowInfo *pResultRowInfo) {
   tfree(pResultRowInfo->pResult);
 }
 
+// the bytes of dense index are given back to the runtime env charged with them
+void freeDenseWindowIndex(SResultRowInfo *pResultRowInfo) {
+  if (pResultRowInfo->pDenseIndex == NULL) {
+    return;
+  }
+
+  if (pResultRowInfo->pDenseCharged != NULL) {
+    atomic_sub_fetch_64(pResultRowInfo->pDenseCharged, sizeof(int32_t) * pResultRowInfo->denseSize);
+    pResultRowInfo->pDenseCharged = NULL;
+  }
+
+  tfree(pResultRowInfo->pDenseIndex);
+}
+
 void resetResultRowInfo(SQueryRuntimeEnv *pRuntimeEnv, SResultRowInfo *pResultRowInfo) {
   if (pResultRowInfo == NULL || pResultRowInfo->capacity == 0) {
     return;
@@ -92,6 +111,10 @@ void resetResultRowInfo(SQueryRuntimeEnv *pRuntimeEnv, SResultRowInfo *pResultRo
 
   pResultRowInfo->size     = 0;
   pResultRowInfo->curPos  = -1;
+
+  if (pResultRowInfo->pDenseIndex != NULL) {
+    memset(pResultRowInfo->pDenseIndex, -1, sizeof(int32_t) * pResultRowInfo->denseSize);
+  }
 }
 
 int32_t numOfClosedResultRows(SResultRowInfo *pResultRowInfo) {
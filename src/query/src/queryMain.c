@@ -27,6 +27,7 @@
 #include "queryLog.h"
 #include "tlosertree.h"
 #include "ttype.h"
+#include "tscompression.h"
 
 typedef struct SQueryMgmt {
   pthread_mutex_t lock;
@@ -257,7 +258,7 @@ bool qTableQuery(qinfo_t qinfo, uint64_t *qId) {
   return doBuildResCheck(pQInfo);
 }
 
-int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContext) {
+int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContext, bool compColData) {
   SQInfo *pQInfo = (SQInfo *)qinfo;
 
   if (pQInfo == NULL || !isValidQInfo(pQInfo)) {
@@ -266,6 +267,7 @@ int32_t qRetrieveQueryResultInfo(qinfo_t qinfo, bool* buildRes, void* pRspContex
   }
 
   *buildRes = false;
+  pQInfo->compColData = compColData;
   if (IS_QUERY_KILLED(pQInfo)) {
     qDebug("QInfo:0x%"PRIx64" query is killed, code:0x%08x", pQInfo->qId, pQInfo->code);
     return pQInfo->code;
@@ -318,6 +320,14 @@ int32_t qDumpRetrieveResult(qinfo_t qinfo, SRetrieveTableRsp **pRsp, int32_t *co
   size += sizeof(int32_t);
   size += sizeof(STableIdInfo) * taosHashGetSize(pRuntimeEnv->pTableRetrieveTsMap);
 
+  // the compressed data of one column may exceed the raw data before it is replaced by the raw data
+  if (pQInfo->compColData && !pQueryAttr->tsCompQuery && tsCompressColData != -1) {
+    int32_t numOfCols = (pQueryAttr->pExpr2 == NULL)? pQueryAttr->numOfOutput:pQueryAttr->numOfExpr2;
+    size += sizeof(SRetrieveColHead) * numOfCols + COMP_OVERFLOW_BYTES;
+  } else {
+    pQInfo->compColData = false;
+  }
+
   *contLen = (int32_t)(size + sizeof(SRetrieveTableRsp));
 
   // current solution only avoid crash, but cannot return error code to client
@@ -337,8 +347,11 @@ int32_t qDumpRetrieveResult(qinfo_t qinfo, SRetrieveTableRsp **pRsp, int32_t *co
   }
 
   (*pRsp)->precision = htons(pQueryAttr->precision);
+  (*pRsp)->compressed = pQInfo->compColData? 1:0;
   if (GET_NUM_OF_RESULTS(&(pQInfo->runtimeEnv)) > 0 && pQInfo->code == TSDB_CODE_SUCCESS) {
-    doDumpQueryResult(pQInfo, (*pRsp)->data);
+    int32_t len = (int32_t)size;
+    doDumpQueryResult(pQInfo, (*pRsp)->data, &len);
+    *contLen = (int32_t)(len + sizeof(SRetrieveTableRsp));
   } else {
     setQueryStatus(pRuntimeEnv, QUERY_OVER);
   }
@@ -401,6 +414,16 @@ int32_t qQueryCompleted(qinfo_t qinfo) {
   return isQueryKilled(pQInfo) || Q_STATUS_EQUAL(pQInfo->runtimeEnv.status, QUERY_OVER);
 }
 
+int64_t qGetQueryCost(qinfo_t qinfo) {
+  SQInfo *pQInfo = (SQInfo *)qinfo;
+
+  if (pQInfo == NULL || !isValidQInfo(pQInfo)) {
+    return 0;
+  }
+
+  return pQInfo->scanCost;
+}
+
 void qDestroyQueryInfo(qinfo_t qHandle) {
   SQInfo* pQInfo = (SQInfo*) qHandle;
   if (!isValidQInfo(pQInfo)) {
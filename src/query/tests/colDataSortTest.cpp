@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+#include "taosmsg.h"
+#include "tdataformat.h"
+
+extern "C" {
+#include "qExtbuffer.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+SSchema createSchema(uint8_t type, int16_t bytes, int16_t colId) {
+  SSchema s = {0};
+  s.type = type;
+  s.bytes = bytes;
+  s.colId = colId;
+  snprintf(s.name, sizeof(s.name), "c%d", colId);
+  return s;
+}
+
+// sort the copy of data by radix sort and quick sort, the results must be identical since the order keys are unique
+void checkRadixSort(SColumnModel* pModel, const int32_t* orderColIdx, int32_t numOfOrderCols, int32_t tsOrder,
+                    int32_t order, char* data, int32_t numOfRows, int32_t start, int32_t end) {
+  size_t size = (size_t)pModel->rowSize * numOfRows;
+  char*  data1 = (char*)malloc(size);
+  char*  data2 = (char*)malloc(size);
+  memcpy(data1, data, size);
+  memcpy(data2, data, size);
+
+  tOrderDescriptor* pDesc = tOrderDesCreate(orderColIdx, numOfOrderCols, pModel, tsOrder);
+  ASSERT_EQ(tColDataRadixSort(pDesc, numOfRows, start, end, data1, order), 0);
+  tColDataQuickSort(pDesc, numOfRows, start, end, data2, order);
+
+  ASSERT_EQ(memcmp(data1, data2, size), 0);
+
+  free(data1);
+  free(data2);
+  free(pDesc);
+}
+
+}  // namespace
+
+TEST(testCase, radix_sort_timestamp_test) {
+  const int32_t numOfRows = 10000;
+
+  SSchema fields[3] = {createSchema(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1),
+                       createSchema(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), 2),
+                       createSchema(TSDB_DATA_TYPE_BINARY, 10 + VARSTR_HEADER_SIZE, 3)};
+
+  SColumnModel* pModel = createColumnModel(fields, 3, numOfRows);
+  char*         data = (char*)calloc(numOfRows, pModel->rowSize);
+
+  std::vector<int64_t> ts;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    ts.push_back(1600000000000L + i * 10 - (i % 3 == 0 ? 5000000000L : 0));
+  }
+
+  srand(0);
+  std::random_shuffle(ts.begin(), ts.end());
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    *(int32_t*)(data + i * sizeof(int32_t)) = i;
+    *(int64_t*)(data + numOfRows * sizeof(int32_t) + i * sizeof(int64_t)) = ts[i];
+
+    char*       v = data + numOfRows * (sizeof(int32_t) + sizeof(int64_t)) + i * fields[2].bytes;
+    std::string s = std::to_string(ts[i] % 100000);
+    STR_WITH_SIZE_TO_VARSTR(v, s.c_str(), (VarDataLenT)s.size());
+  }
+
+  int32_t orderColIdx = 1;
+  checkRadixSort(pModel, &orderColIdx, 1, TSDB_ORDER_ASC, TSDB_ORDER_ASC, data, numOfRows, 0, numOfRows - 1);
+  checkRadixSort(pModel, &orderColIdx, 1, TSDB_ORDER_DESC, TSDB_ORDER_ASC, data, numOfRows, 0, numOfRows - 1);
+  checkRadixSort(pModel, &orderColIdx, 1, TSDB_ORDER_ASC, TSDB_ORDER_DESC, data, numOfRows, 100, numOfRows - 200);
+
+  // the sorted rows keep the rows together
+  tOrderDescriptor* pDesc = tOrderDesCreate(&orderColIdx, 1, pModel, TSDB_ORDER_ASC);
+  ASSERT_EQ(tColDataRadixSort(pDesc, numOfRows, 0, numOfRows - 1, data, TSDB_ORDER_ASC), 0);
+
+  std::sort(ts.begin(), ts.end());
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t k = *(int64_t*)(data + numOfRows * sizeof(int32_t) + i * sizeof(int64_t));
+    ASSERT_EQ(k, ts[i]);
+
+    char* v = data + numOfRows * (sizeof(int32_t) + sizeof(int64_t)) + i * fields[2].bytes;
+    ASSERT_EQ(std::string((char*)varDataVal(v), varDataLen(v)), std::to_string(k % 100000));
+  }
+
+  free(pDesc);
+  free(data);
+  destroyColumnModel(pModel);
+}
+
+TEST(testCase, radix_sort_multi_order_cols_test) {
+  const int32_t numOfRows = 6000;
+  const int32_t numOfKeys = 40;
+
+  SSchema fields[2] = {createSchema(TSDB_DATA_TYPE_BINARY, 8 + VARSTR_HEADER_SIZE, 1),
+                       createSchema(TSDB_DATA_TYPE_SMALLINT, sizeof(int16_t), 2)};
+
+  SColumnModel* pModel = createColumnModel(fields, 2, numOfRows);
+  char*         data = (char*)calloc(numOfRows, pModel->rowSize);
+
+  // the leading keys have many duplicates, including NULL and negative values, and the pairs are unique
+  std::vector<int32_t> rows;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    rows.push_back(i);
+  }
+
+  srand(1);
+  std::random_shuffle(rows.begin(), rows.end());
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char*       v = data + i * fields[0].bytes;
+    std::string s = std::to_string(rows[i] / numOfKeys);
+    STR_WITH_SIZE_TO_VARSTR(v, s.c_str(), (VarDataLenT)s.size());
+
+    int16_t k = (int16_t)(rows[i] % numOfKeys - numOfKeys / 2);
+    if (k == 0) {
+      k = TSDB_DATA_SMALLINT_NULL;
+    }
+    *(int16_t*)(data + numOfRows * fields[0].bytes + i * sizeof(int16_t)) = k;
+  }
+
+  int32_t orderColIdx[2] = {1, 0};
+  checkRadixSort(pModel, orderColIdx, 2, TSDB_ORDER_ASC, TSDB_ORDER_ASC, data, numOfRows, 0, numOfRows - 1);
+  checkRadixSort(pModel, orderColIdx, 2, TSDB_ORDER_ASC, TSDB_ORDER_DESC, data, numOfRows, 0, numOfRows - 1);
+
+  // the leading column of binary type is not supported
+  int32_t           binaryColIdx = 0;
+  tOrderDescriptor* pDesc = tOrderDesCreate(&binaryColIdx, 1, pModel, TSDB_ORDER_ASC);
+  ASSERT_EQ(tColDataRadixSort(pDesc, numOfRows, 0, numOfRows - 1, data, TSDB_ORDER_ASC), -1);
+
+  free(pDesc);
+  free(data);
+  destroyColumnModel(pModel);
+}
+
+TEST(testCase, radix_sort_unsigned_test) {
+  const int32_t numOfRows = 3000;
+
+  SSchema       field = createSchema(TSDB_DATA_TYPE_UBIGINT, sizeof(uint64_t), 1);
+  SColumnModel* pModel = createColumnModel(&field, 1, numOfRows);
+  uint64_t*     data = (uint64_t*)calloc(numOfRows, sizeof(uint64_t));
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    data[i] = (i % 2 == 0) ? UINT64_MAX - i : (uint64_t)i * 7919;
+  }
+
+  int32_t orderColIdx = 0;
+  checkRadixSort(pModel, &orderColIdx, 1, TSDB_ORDER_ASC, TSDB_ORDER_ASC, (char*)data, numOfRows, 0, numOfRows - 1);
+  checkRadixSort(pModel, &orderColIdx, 1, TSDB_ORDER_ASC, TSDB_ORDER_DESC, (char*)data, numOfRows, 0, numOfRows - 1);
+
+  free(data);
+  destroyColumnModel(pModel);
+}
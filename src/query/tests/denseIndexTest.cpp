@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+
+extern "C" {
+#include "qExecutor.h"
+#include "qUtil.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+// charge the counter and build the dense index the way initDenseWindowIndex does
+void setDenseIndex(SResultRowInfo* pResultRowInfo, int64_t* pCharged, int32_t numOfWindows) {
+  int64_t size = sizeof(int32_t) * numOfWindows;
+  atomic_add_fetch_64(pCharged, size);
+
+  pResultRowInfo->pDenseIndex = (int32_t*)malloc(size);
+  memset(pResultRowInfo->pDenseIndex, -1, size);
+  pResultRowInfo->denseSize = numOfWindows;
+  pResultRowInfo->pDenseCharged = pCharged;
+}
+
+// an interval query over one table: the result row of each time window a row falls in counts the row,
+// the windows are located through doSetResultOutBufByKey as hashIntervalAgg does
+class IntervalQuery {
+ public:
+  IntervalQuery(int64_t interval, int64_t sliding, TSKEY skey, TSKEY ekey, int32_t order) {
+    memset(&attr, 0, sizeof(attr));
+    attr.interval.interval = interval;
+    attr.interval.sliding = sliding;
+    attr.interval.intervalUnit = 'a';
+    attr.interval.slidingUnit = 'a';
+    attr.window.skey = skey;
+    attr.window.ekey = ekey;
+    attr.order.order = order;
+
+    memset(&env, 0, sizeof(env));
+    env.pQueryAttr = &attr;
+    env.pResultRowHashTable = taosHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true, HASH_NO_LOCK);
+    env.pResultRowListSet = taosHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+    env.keyBuf = (char*)malloc(sizeof(int64_t) * 2 + POINTER_BYTES);
+    env.pool = initResultRowPool(getResultRowSize(&env));
+
+    memset(&info, 0, sizeof(info));
+    initResultRowInfo(&info, 8, TSDB_DATA_TYPE_TIMESTAMP);
+  }
+
+  ~IntervalQuery() {
+    cleanupResultRowInfo(&info);
+    destroyResultRowPool(env.pool);
+    taosHashCleanup(env.pResultRowHashTable);
+    taosHashCleanup(env.pResultRowListSet);
+    free(env.keyBuf);
+  }
+
+  // the rows are given in the scan order
+  void run(const std::vector<TSKEY>& keys) {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      TSKEY ts = keys[i];
+      TSKEY w = ts - ((ts % attr.interval.sliding) + attr.interval.sliding) % attr.interval.sliding;
+      for (; w + attr.interval.interval > ts; w -= attr.interval.sliding) {
+        SResultRow* pRow = doSetResultOutBufByKey(&env, &info, 1, (char*)&w, TSDB_KEYSIZE, true, 1);
+        ASSERT_TRUE(pRow != NULL);
+        if (pRow->numOfRows == 0) {
+          pRow->win.skey = w;
+          pRow->win.ekey = w + attr.interval.interval - 1;
+        }
+
+        ASSERT_EQ(pRow->win.skey, w);
+        ASSERT_EQ(info.pResult[info.curPos], pRow);
+        pRow->numOfRows += 1;
+      }
+    }
+  }
+
+  // start key and number of rows of each time window, in the order the windows are created
+  std::vector<std::pair<TSKEY, uint32_t>> result() const {
+    std::vector<std::pair<TSKEY, uint32_t>> res;
+    for (int32_t i = 0; i < info.size; ++i) {
+      res.push_back(std::make_pair(info.pResult[i]->win.skey, info.pResult[i]->numOfRows));
+    }
+    return res;
+  }
+
+  SQueryAttr       attr;
+  SQueryRuntimeEnv env;
+  SResultRowInfo   info;
+};
+
+// the same rows through the dense index and through the hash tables alone give the same result
+void checkDenseAndHash(IntervalQuery& dense, IntervalQuery& hash, const std::vector<TSKEY>& keys) {
+  hash.info.denseSize = -1;
+
+  dense.run(keys);
+  hash.run(keys);
+
+  EXPECT_TRUE(hash.info.pDenseIndex == NULL);
+  EXPECT_EQ(dense.result(), hash.result());
+}
+
+}  // namespace
+
+TEST(testCase, dense_index_free_test) {
+  int64_t        charged = 0;
+  SResultRowInfo info = {0};
+  ASSERT_EQ(initResultRowInfo(&info, 8, TSDB_DATA_TYPE_INT), TSDB_CODE_SUCCESS);
+
+  setDenseIndex(&info, &charged, 100);
+  EXPECT_EQ(charged, 100 * sizeof(int32_t));
+
+  // the index of another table or group is dropped, its bytes are given back
+  freeDenseWindowIndex(&info);
+  info.denseSize = -1;
+  EXPECT_EQ(charged, 0);
+  EXPECT_TRUE(info.pDenseIndex == NULL);
+
+  // nothing is given back twice
+  freeDenseWindowIndex(&info);
+  EXPECT_EQ(charged, 0);
+
+  cleanupResultRowInfo(&info);
+  EXPECT_EQ(charged, 0);
+}
+
+TEST(testCase, dense_index_cleanup_test) {
+  int64_t        charged = 0;
+  SResultRowInfo info1 = {0};
+  SResultRowInfo info2 = {0};
+  ASSERT_EQ(initResultRowInfo(&info1, 8, TSDB_DATA_TYPE_INT), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(initResultRowInfo(&info2, 8, TSDB_DATA_TYPE_INT), TSDB_CODE_SUCCESS);
+
+  setDenseIndex(&info1, &charged, 10);
+  setDenseIndex(&info2, &charged, 1000);
+  EXPECT_EQ(charged, 1010 * sizeof(int32_t));
+
+  cleanupResultRowInfo(&info1);
+  EXPECT_EQ(charged, 1000 * sizeof(int32_t));
+
+  cleanupResultRowInfo(&info2);
+  EXPECT_EQ(charged, 0);
+}
+
+TEST(testCase, dense_index_interval_result_test) {
+  const TSKEY skey = 1600000000000L;
+
+  // regular rows, each window is looked up once for each of its rows
+  {
+    std::vector<TSKEY> keys;
+    for (int32_t i = 0; i < 10000; ++i) keys.push_back(skey + i * 100);
+
+    IntervalQuery dense(1000, 1000, skey, skey + 10000 * 100, TSDB_ORDER_ASC);
+    IntervalQuery hash(1000, 1000, skey, skey + 10000 * 100, TSDB_ORDER_ASC);
+    checkDenseAndHash(dense, hash, keys);
+    EXPECT_GT(dense.info.denseSize, 0);
+    EXPECT_EQ(dense.info.size, 1000);
+  }
+
+  // sparse windows: the rows skip many windows, and a window of the index may be never added
+  {
+    std::vector<TSKEY> keys;
+    for (int32_t i = 0; i < 1000; ++i) keys.push_back(skey + (int64_t)i * i * 10 + i % 3);
+
+    IntervalQuery dense(1000, 1000, skey, skey + 1000L * 1000 * 10, TSDB_ORDER_ASC);
+    IntervalQuery hash(1000, 1000, skey, skey + 1000L * 1000 * 10, TSDB_ORDER_ASC);
+    checkDenseAndHash(dense, hash, keys);
+    EXPECT_GT(dense.info.denseSize, 0);
+  }
+
+  // sliding windows overlap, each row falls in interval/sliding windows
+  {
+    std::vector<TSKEY> keys;
+    for (int32_t i = 0; i < 5000; ++i) keys.push_back(skey + i * 70);
+
+    IntervalQuery dense(1000, 250, skey, skey + 5000 * 70, TSDB_ORDER_ASC);
+    IntervalQuery hash(1000, 250, skey, skey + 5000 * 70, TSDB_ORDER_ASC);
+    checkDenseAndHash(dense, hash, keys);
+    EXPECT_GT(dense.info.denseSize, 0);
+  }
+
+  // descending scan, the index ends at the window of the first row
+  {
+    std::vector<TSKEY> keys;
+    for (int32_t i = 4999; i >= 0; --i) keys.push_back(skey + i * 130);
+
+    IntervalQuery dense(1000, 500, skey + 5000 * 130, skey, TSDB_ORDER_DESC);
+    IntervalQuery hash(1000, 500, skey + 5000 * 130, skey, TSDB_ORDER_DESC);
+    checkDenseAndHash(dense, hash, keys);
+    EXPECT_GT(dense.info.denseSize, 0);
+  }
+}
+
+TEST(testCase, dense_index_fallback_test) {
+  const TSKEY skey = 1600000000000L;
+
+  // the query range has more windows than the index holds, the windows after it are found by the hash tables
+  {
+    std::vector<TSKEY> keys;
+    for (int32_t i = 0; i < 3 * MAX_DENSE_TIME_WINDOW; ++i) keys.push_back(skey + i * 1000L + (i % 7));
+    for (int32_t i = 0; i < 3 * MAX_DENSE_TIME_WINDOW; ++i) keys.push_back(skey + i * 1000L + 500);
+
+    IntervalQuery dense(1000, 1000, skey, INT64_MAX, TSDB_ORDER_ASC);
+    IntervalQuery hash(1000, 1000, skey, INT64_MAX, TSDB_ORDER_ASC);
+    checkDenseAndHash(dense, hash, keys);
+    EXPECT_EQ(dense.info.denseSize, MAX_DENSE_TIME_WINDOW);
+    EXPECT_EQ(dense.info.size, 3 * MAX_DENSE_TIME_WINDOW);
+  }
+
+  // the index of the query is over its size limit, all windows are found by the hash tables
+  {
+    std::vector<TSKEY> keys;
+    for (int32_t i = 0; i < 1000; ++i) keys.push_back(skey + i * 300);
+
+    IntervalQuery dense(1000, 1000, skey, skey + 1000 * 300, TSDB_ORDER_ASC);
+    IntervalQuery hash(1000, 1000, skey, skey + 1000 * 300, TSDB_ORDER_ASC);
+    dense.env.denseIndexSize = MAX_DENSE_INDEX_SIZE;
+    checkDenseAndHash(dense, hash, keys);
+    EXPECT_EQ(dense.info.denseSize, -1);
+    EXPECT_TRUE(dense.info.pDenseIndex == NULL);
+    EXPECT_EQ(dense.env.denseIndexSize, MAX_DENSE_INDEX_SIZE);
+  }
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <cassert>
+#include <iostream>
+
+#include "os.h"
+#include "taosdef.h"
+#include "ttype.h"
+
+extern "C" {
+#include "qExecutor.h"
+#include "qUtil.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+// the row by row evaluation of the filters of one column
+void filterColumnByRow(SSingleColumnFilterInfo* pInfo, int32_t numOfRows, int8_t* p) {
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char* pElem = (char*)pInfo->pData + pInfo->info.bytes * i;
+    bool  isnull = isNull(pElem, pInfo->info.type);
+    bool  qualified = false;
+
+    for (int32_t j = 0; j < pInfo->numOfFilters; ++j) {
+      SColumnFilterElem* pFilterElem = &pInfo->pFilters[j];
+      if (isnull) {
+        if (pFilterElem->fp == isNullOperator) {
+          qualified = true;
+          break;
+        }
+        continue;
+      }
+
+      if (pFilterElem->fp == notNullOperator) {
+        qualified = true;
+        break;
+      } else if (pFilterElem->fp == isNullOperator) {
+        continue;
+      }
+
+      if (pFilterElem->fp(pFilterElem, pElem, pElem, pInfo->info.type)) {
+        qualified = true;
+        break;
+      }
+    }
+
+    p[i] &= qualified;
+  }
+}
+
+void setFilter(SColumnFilterElem* pElem, int16_t type, int32_t lower, int32_t upper, const char* lowerVal,
+               const char* upperVal) {
+  memset(pElem, 0, sizeof(SColumnFilterElem));
+  pElem->filterInfo.lowerRelOptr = lower;
+  pElem->filterInfo.upperRelOptr = upper;
+  if (IS_FLOAT_TYPE(type)) {
+    GET_TYPED_DATA(pElem->filterInfo.lowerBndd, double, type, lowerVal);
+    GET_TYPED_DATA(pElem->filterInfo.upperBndd, double, type, upperVal);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    uint64_t lv = 0, uv = 0;
+    GET_TYPED_DATA(lv, uint64_t, type, lowerVal);
+    GET_TYPED_DATA(uv, uint64_t, type, upperVal);
+    pElem->filterInfo.lowerBndi = (int64_t)lv;
+    pElem->filterInfo.upperBndi = (int64_t)uv;
+  } else {
+    GET_TYPED_DATA(pElem->filterInfo.lowerBndi, int64_t, type, lowerVal);
+    GET_TYPED_DATA(pElem->filterInfo.upperBndi, int64_t, type, upperVal);
+  }
+
+  pElem->fp = getFilterOperator(lower, upper);
+  pElem->bfp = getFilterBatchOperator(lower, upper, type);
+  pElem->bytes = tDataTypes[type].bytes;
+}
+
+void fillColumn(char* pData, int16_t type, int32_t numOfRows) {
+  int32_t bytes = tDataTypes[type].bytes;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    char* v = pData + bytes * i;
+    if (rand() % 10 == 0) {
+      setNull(v, type, bytes);
+      continue;
+    }
+
+    int64_t r = rand() % 64 - ((IS_UNSIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) ? 0 : 32);
+    switch (type) {
+      case TSDB_DATA_TYPE_BOOL: *(int8_t*)v = (int8_t)(r & 1); break;
+      case TSDB_DATA_TYPE_TINYINT: *(int8_t*)v = (int8_t)r; break;
+      case TSDB_DATA_TYPE_UTINYINT: *(uint8_t*)v = (uint8_t)r; break;
+      case TSDB_DATA_TYPE_SMALLINT: *(int16_t*)v = (int16_t)r; break;
+      case TSDB_DATA_TYPE_USMALLINT: *(uint16_t*)v = (uint16_t)r; break;
+      case TSDB_DATA_TYPE_INT: *(int32_t*)v = (int32_t)r; break;
+      case TSDB_DATA_TYPE_UINT: *(uint32_t*)v = (uint32_t)r; break;
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_TIMESTAMP: *(int64_t*)v = r; break;
+      case TSDB_DATA_TYPE_UBIGINT: *(uint64_t*)v = (uint64_t)r; break;
+      case TSDB_DATA_TYPE_FLOAT: *(float*)v = (float)r / 4; break;
+      case TSDB_DATA_TYPE_DOUBLE: *(double*)v = (double)r / 4; break;
+      default: assert(0);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(testCase, filter_batch_test) {
+  const int16_t types[] = {TSDB_DATA_TYPE_BOOL,     TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_UTINYINT,
+                           TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_USMALLINT, TSDB_DATA_TYPE_INT,
+                           TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_BIGINT,    TSDB_DATA_TYPE_UBIGINT,
+                           TSDB_DATA_TYPE_FLOAT,    TSDB_DATA_TYPE_DOUBLE,    TSDB_DATA_TYPE_TIMESTAMP};
+  const int32_t ops[][2] = {
+      {TSDB_RELATION_LESS, TSDB_RELATION_INVALID},          {TSDB_RELATION_GREATER, TSDB_RELATION_INVALID},
+      {TSDB_RELATION_EQUAL, TSDB_RELATION_INVALID},         {TSDB_RELATION_LESS_EQUAL, TSDB_RELATION_INVALID},
+      {TSDB_RELATION_GREATER_EQUAL, TSDB_RELATION_INVALID}, {TSDB_RELATION_NOT_EQUAL, TSDB_RELATION_INVALID},
+      {TSDB_RELATION_ISNULL, TSDB_RELATION_INVALID},        {TSDB_RELATION_NOTNULL, TSDB_RELATION_INVALID},
+      {TSDB_RELATION_GREATER, TSDB_RELATION_LESS},          {TSDB_RELATION_GREATER_EQUAL, TSDB_RELATION_LESS},
+      {TSDB_RELATION_GREATER, TSDB_RELATION_LESS_EQUAL},    {TSDB_RELATION_GREATER_EQUAL, TSDB_RELATION_LESS_EQUAL},
+  };
+
+  const int32_t numOfRows = 1000;
+  char*         pData = (char*)malloc(sizeof(int64_t) * numOfRows);
+  int8_t*       expect = (int8_t*)malloc(numOfRows);
+  int8_t*       result = (int8_t*)malloc(numOfRows);
+  int8_t*       buf = (int8_t*)malloc(numOfRows * 2);
+
+  srand(0);
+  for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+    int16_t type = types[t];
+    fillColumn(pData, type, numOfRows);
+
+    SSingleColumnFilterInfo info = {0};
+    info.pData = pData;
+    info.info.type = type;
+    info.info.bytes = tDataTypes[type].bytes;
+
+    for (size_t o = 0; o < sizeof(ops) / sizeof(ops[0]); ++o) {
+      for (int32_t round = 0; round < 8; ++round) {
+        // one or two filters of the same column are or-ed
+        SColumnFilterElem elems[2];
+        int32_t           lo = rand() % numOfRows, hi = rand() % numOfRows;
+        setFilter(&elems[0], type, ops[o][0], ops[o][1], pData + info.info.bytes * lo, pData + info.info.bytes * hi);
+        setFilter(&elems[1], type, ops[(o + round) % 12][0], ops[(o + round) % 12][1], pData + info.info.bytes * hi,
+                  pData + info.info.bytes * lo);
+        if (elems[0].fp == NULL || elems[1].fp == NULL) continue;
+
+        info.pFilters = elems;
+        info.numOfFilters = (round % 2) + 1;
+
+        memset(expect, 1, numOfRows);
+        filterColumnByRow(&info, numOfRows, expect);
+
+        memset(result, 1, numOfRows);
+        int32_t numOfQualified = doFilterColumnBatch(&info, numOfRows, result, buf);
+
+        int32_t count = 0;
+        for (int32_t i = 0; i < numOfRows; ++i) {
+          ASSERT_EQ(expect[i], result[i]) << "type:" << type << " op:" << o << " round:" << round << " row:" << i;
+          count += expect[i];
+        }
+        ASSERT_EQ(count, numOfQualified);
+      }
+    }
+  }
+
+  free(pData);
+  free(expect);
+  free(result);
+  free(buf);
+}
+
+TEST(testCase, filter_batch_multi_column_test) {
+  const int32_t numOfRows = 4096;
+  int32_t*      pInt = (int32_t*)malloc(sizeof(int32_t) * numOfRows);
+  double*       pDouble = (double*)malloc(sizeof(double) * numOfRows);
+  int8_t*       p = (int8_t*)malloc(numOfRows);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pInt[i] = (i % 100 == 0) ? (int32_t)TSDB_DATA_INT_NULL : i;
+    pDouble[i] = i * 0.5;
+  }
+
+  int32_t           i1 = 1000, i2 = 2000;
+  double            d1 = 700.0;
+  SColumnFilterElem intFilter, doubleFilter;
+  setFilter(&intFilter, TSDB_DATA_TYPE_INT, TSDB_RELATION_GREATER_EQUAL, TSDB_RELATION_LESS, (char*)&i1, (char*)&i2);
+  setFilter(&doubleFilter, TSDB_DATA_TYPE_DOUBLE, TSDB_RELATION_LESS, TSDB_RELATION_INVALID, (char*)&d1, (char*)&d1);
+
+  SSingleColumnFilterInfo info[2] = {{0}};
+  info[0].pData = pInt;
+  info[0].info.type = TSDB_DATA_TYPE_INT;
+  info[0].info.bytes = sizeof(int32_t);
+  info[0].numOfFilters = 1;
+  info[0].pFilters = &intFilter;
+  info[1].pData = pDouble;
+  info[1].info.type = TSDB_DATA_TYPE_DOUBLE;
+  info[1].info.bytes = sizeof(double);
+  info[1].numOfFilters = 1;
+  info[1].pFilters = &doubleFilter;
+
+  // 1000 <= i < 2000 and i * 0.5 < 700, NULL on every 100th row
+  bool all = true;
+  EXPECT_EQ(doFilterDataBlock(info, 2, numOfRows, p, &all), TSDB_CODE_SUCCESS);
+  EXPECT_FALSE(all);
+  int32_t count = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    bool expect = (i % 100 != 0) && i >= 1000 && i < 1400;
+    EXPECT_EQ(expect, p[i] == 1) << "row:" << i;
+    count += p[i];
+  }
+  EXPECT_EQ(count, 396);
+
+  free(pInt);
+  free(pDouble);
+  free(p);
+}
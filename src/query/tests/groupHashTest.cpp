@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "os.h"
+#include "taosdef.h"
+#include "tdataformat.h"
+#include "ttype.h"
+
+extern "C" {
+#include "qGroupHash.h"
+}
+
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+
+namespace {
+
+// check the groups of one block against the group id of each distinct key
+template <typename T>
+void checkAssignedGroups(SGroupHashInfo* pHashInfo, T* pData, int32_t numOfRows, std::map<T, int32_t>& ids, T nullVal) {
+  int32_t* pRowGroup = (int32_t*)malloc(sizeof(int32_t) * numOfRows);
+  int32_t* pGroups = (int32_t*)malloc(sizeof(int32_t) * numOfRows);
+
+  int32_t numOfGroups = tGroupHashAssign(pHashInfo, (char*)pData, numOfRows, pRowGroup, pGroups);
+  ASSERT_GE(numOfGroups, 0);
+
+  std::map<T, int32_t> local;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    if (pData[i] == nullVal) {
+      ASSERT_EQ(pRowGroup[i], -1);
+      continue;
+    }
+
+    ASSERT_GE(pRowGroup[i], 0);
+    ASSERT_LT(pRowGroup[i], numOfGroups);
+
+    // groups are numbered in the order of first appearance in the block
+    if (local.find(pData[i]) == local.end()) {
+      ASSERT_EQ(pRowGroup[i], (int32_t)local.size());
+      local[pData[i]] = pRowGroup[i];
+    }
+    ASSERT_EQ(local[pData[i]], pRowGroup[i]);
+
+    int32_t groupId = pGroups[pRowGroup[i]];
+    if (ids.find(pData[i]) == ids.end()) {
+      ids[pData[i]] = groupId;
+    }
+    ASSERT_EQ(ids[pData[i]], groupId);
+    ASSERT_EQ(*(T*)tGroupHashGetKey(pHashInfo, groupId), pData[i]);
+  }
+
+  ASSERT_EQ(numOfGroups, (int32_t)local.size());
+  ASSERT_EQ(tGroupHashGetSize(pHashInfo), (int32_t)ids.size());
+
+  free(pRowGroup);
+  free(pGroups);
+}
+
+}  // namespace
+
+TEST(testCase, group_hash_int_test) {
+  SGroupHashInfo* pHashInfo = tGroupHashCreate(TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  ASSERT_TRUE(pHashInfo != NULL);
+
+  const int32_t        numOfRows = 4096;
+  int32_t*             pData = (int32_t*)malloc(sizeof(int32_t) * numOfRows);
+  std::map<int32_t, int32_t> ids;
+
+  srand(0);
+  for (int32_t round = 0; round < 20; ++round) {
+    // the number of distinct values grows beyond the initial capacity of the table
+    int32_t range = 16 << (round / 2);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      if (rand() % 20 == 0) {
+        pData[i] = TSDB_DATA_INT_NULL;
+      } else if (i > 0 && rand() % 4 == 0) {
+        pData[i] = pData[i - 1];
+      } else {
+        pData[i] = rand() % range - range / 2;
+      }
+    }
+
+    checkAssignedGroups<int32_t>(pHashInfo, pData, numOfRows, ids, TSDB_DATA_INT_NULL);
+  }
+
+  tGroupHashClear(pHashInfo);
+  ids.clear();
+  checkAssignedGroups<int32_t>(pHashInfo, pData, numOfRows, ids, TSDB_DATA_INT_NULL);
+
+  free(pData);
+  tGroupHashDestroy(pHashInfo);
+}
+
+TEST(testCase, group_hash_tinyint_test) {
+  SGroupHashInfo* pHashInfo = tGroupHashCreate(TSDB_DATA_TYPE_TINYINT, sizeof(int8_t));
+  ASSERT_TRUE(pHashInfo != NULL);
+
+  const int32_t numOfRows = 1000;
+  int8_t        pData[numOfRows];
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pData[i] = (int8_t)(i * 7);  // covers the NULL value -128
+  }
+
+  std::map<int8_t, int32_t> ids;
+  checkAssignedGroups<int8_t>(pHashInfo, pData, numOfRows, ids, (int8_t)TSDB_DATA_TINYINT_NULL);
+  EXPECT_EQ(tGroupHashGetSize(pHashInfo), 255);
+
+  tGroupHashDestroy(pHashInfo);
+}
+
+TEST(testCase, group_hash_binary_test) {
+  const int16_t   bytes = 16 + VARSTR_HEADER_SIZE;
+  SGroupHashInfo* pHashInfo = tGroupHashCreate(TSDB_DATA_TYPE_BINARY, bytes);
+  ASSERT_TRUE(pHashInfo != NULL);
+
+  const int32_t numOfRows = 3000;
+  char*         pData = (char*)calloc(numOfRows, bytes);
+  int32_t*      pRowGroup = (int32_t*)malloc(sizeof(int32_t) * numOfRows);
+  int32_t*      pGroups = (int32_t*)malloc(sizeof(int32_t) * numOfRows);
+
+  std::map<std::string, int32_t> ids;
+  for (int32_t round = 0; round < 3; ++round) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      char* v = pData + bytes * i;
+      if (i % 50 == 0) {
+        setNull(v, TSDB_DATA_TYPE_BINARY, bytes);
+      } else {
+        // the keys of different length share the same prefix
+        std::string s = std::string("dev_") + std::to_string((i * 31 + round * 7) % 1500);
+        STR_WITH_SIZE_TO_VARSTR(v, s.c_str(), (VarDataLenT)s.size());
+      }
+    }
+
+    int32_t numOfGroups = tGroupHashAssign(pHashInfo, pData, numOfRows, pRowGroup, pGroups);
+    ASSERT_GT(numOfGroups, 0);
+
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      char* v = pData + bytes * i;
+      if (i % 50 == 0) {
+        ASSERT_EQ(pRowGroup[i], -1);
+        continue;
+      }
+
+      std::string s((char*)varDataVal(v), varDataLen(v));
+      int32_t     groupId = pGroups[pRowGroup[i]];
+      if (ids.find(s) == ids.end()) {
+        ids[s] = groupId;
+      }
+      ASSERT_EQ(ids[s], groupId);
+
+      char* key = tGroupHashGetKey(pHashInfo, groupId);
+      ASSERT_EQ(std::string((char*)varDataVal(key), varDataLen(key)), s);
+    }
+
+    ASSERT_EQ(tGroupHashGetSize(pHashInfo), (int32_t)ids.size());
+  }
+
+  free(pData);
+  free(pRowGroup);
+  free(pGroups);
+  tGroupHashDestroy(pHashInfo);
+}
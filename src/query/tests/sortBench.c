@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Elapsed time of sorting one page of rows of (ts, int, double, binary(16)) by ts, i.e. "order by ts", with the quick
+// sort and the radix sort of tColDataQSort. Usage: sortBench [rows ...], 1M and 10M rows by default
+
+#include "os.h"
+#include "qExtbuffer.h"
+#include "taosdef.h"
+#include "taosmsg.h"
+
+#define BENCH_NUM_OF_TABLES 64
+
+typedef void (*__sort_fn_t)(tOrderDescriptor *, int32_t, int32_t, int32_t, char *, int32_t);
+
+static void radixSort(tOrderDescriptor *pDesc, int32_t numOfRows, int32_t start, int32_t end, char *data,
+                      int32_t order) {
+  if (tColDataRadixSort(pDesc, numOfRows, start, end, data, order) != 0) {
+    printf("radix sort failed\n");
+    exit(1);
+  }
+}
+
+static void benchSort(const char *mode, __sort_fn_t sortFn, SColumnModel *pModel, char *src, int32_t numOfRows) {
+  size_t size = (size_t)pModel->rowSize * numOfRows;
+  char * data = malloc(size);
+  memcpy(data, src, size);
+
+  int32_t           orderColIdx = 0;
+  tOrderDescriptor *pDesc = tOrderDesCreate(&orderColIdx, 1, pModel, TSDB_ORDER_ASC);
+
+  int64_t st = taosGetTimestampUs();
+  (*sortFn)(pDesc, numOfRows, 0, numOfRows - 1, data, TSDB_ORDER_ASC);
+  int64_t el = taosGetTimestampUs() - st;
+
+  int64_t *ts = (int64_t *)data;
+  for (int32_t i = 1; i < numOfRows; ++i) {
+    if (ts[i - 1] > ts[i]) {
+      printf("%s: rows are not sorted at %d\n", mode, i);
+      exit(1);
+    }
+  }
+
+  printf("%-6s rows:%d elapsed:%" PRId64 "us throughput:%.3f Mrows/s\n", mode, numOfRows, el,
+         (double)numOfRows / (el > 0 ? el : 1));
+
+  free(pDesc);
+  free(data);
+}
+
+static void benchRows(int32_t numOfRows) {
+  SSchema fields[4] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .name = "ts", .colId = 1, .bytes = sizeof(int64_t)},
+                       {.type = TSDB_DATA_TYPE_INT, .name = "c1", .colId = 2, .bytes = sizeof(int32_t)},
+                       {.type = TSDB_DATA_TYPE_DOUBLE, .name = "c2", .colId = 3, .bytes = sizeof(double)},
+                       {.type = TSDB_DATA_TYPE_BINARY, .name = "c3", .colId = 4, .bytes = 16 + VARSTR_HEADER_SIZE}};
+
+  SColumnModel *pModel = createColumnModel(fields, 4, numOfRows);
+  char *        data = calloc(numOfRows, pModel->rowSize);
+
+  // the rows of one page come from the child tables of the same time range, each in the ts order
+  int32_t rowsPerTable = numOfRows / BENCH_NUM_OF_TABLES + 1;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t tid = i / rowsPerTable;
+    int32_t row = i % rowsPerTable;
+
+    ((int64_t *)data)[i] = 1600000000000L + (int64_t)row * 1000 + tid;
+    ((int32_t *)(data + (size_t)numOfRows * 8))[i] = i;
+    ((double *)(data + (size_t)numOfRows * 12))[i] = i * 0.5;
+
+    char *v = data + (size_t)numOfRows * 20 + (size_t)i * fields[3].bytes;
+    varDataSetLen(v, sprintf(varDataVal(v), "t%d", tid));
+  }
+
+  benchSort("quick", tColDataQuickSort, pModel, data, numOfRows);
+  benchSort("radix", radixSort, pModel, data, numOfRows);
+
+  free(data);
+  destroyColumnModel(pModel);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc <= 1) {
+    benchRows(1000000);
+    benchRows(10000000);
+    return 0;
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    benchRows(atoi(argv[i]));
+  }
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_RPC_BUF_H
+#define TDENGINE_RPC_BUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffers of the messages received and of the contents built by the app. A buffer of at most 64KB is taken from the
+// free list of its power of two size class, and is put back there when it is freed, until the free lists hold
+// rpcBufPoolSize MB. A buffer must be freed by rpcBufFree, whatever it is allocated by.
+void  rpcBufInit(void);
+void  rpcBufCleanup(void);
+void *rpcBufMalloc(int32_t size);
+void *rpcBufCalloc(int32_t size);
+void *rpcBufRealloc(void *ptr, int32_t size);
+void  rpcBufFree(void *ptr);
+
+// Number of the free buffers kept by the class of the size, -1 if the size has no class
+int32_t rpcBufFreeNum(int32_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // TDENGINE_RPC_BUF_H
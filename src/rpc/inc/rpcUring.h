@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _rpc_uring_header_
+#define _rpc_uring_header_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// TCP connections served by io_uring instead of epoll, with the same interface as rpcTcp.h
+bool  taosCheckUring(void);
+
+void *taosInitUringServer(uint32_t ip, uint16_t port, char *label, int numOfThreads, void *fp, void *shandle);
+void  taosStopUringServer(void *param);
+void  taosCleanUpUringServer(void *param);
+
+void *taosInitUringClient(uint32_t ip, uint16_t port, char *label, int num, void *fp, void *shandle);
+void  taosStopUringClient(void *chandle);
+void  taosCleanUpUringClient(void *chandle);
+void *taosOpenUringClientConnection(void *shandle, void *thandle, uint32_t ip, uint16_t port);
+
+void  taosCloseUringConnection(void *chandle);
+int   taosSendUringData(uint32_t ip, uint16_t port, void *data, int len, void *chandle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tglobal.h"
+#include "rpcLog.h"
+#include "rpcBuf.h"
+
+#define RPC_BUF_MIN_SHIFT 8  // 256 bytes
+#define RPC_BUF_CLASSES 9    // 256 bytes to 64KB
+#define RPC_BUF_NO_CLASS -1  // allocated and freed by malloc and free
+
+// Head before each buffer, which keeps the buffer aligned to 16 bytes
+typedef struct SRpcBuf {
+  int32_t         cls;   // size class, or RPC_BUF_NO_CLASS
+  int32_t         size;  // usable size of the buffer
+  struct SRpcBuf *next;  // next free buffer of the class
+} SRpcBuf;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  SRpcBuf *       pHead;
+  int32_t         num;     // free buffers in the list
+  int32_t         maxNum;  // free buffers kept at most, 0 if the class is not pooled
+} SRpcBufClass;
+
+static SRpcBufClass   tsRpcBufClasses[RPC_BUF_CLASSES];
+static pthread_once_t tsRpcBufInit = PTHREAD_ONCE_INIT;
+
+static void rpcBufInitImpl(void) {
+  for (int32_t cls = 0; cls < RPC_BUF_CLASSES; ++cls) {
+    pthread_mutex_init(&tsRpcBufClasses[cls].mutex, NULL);
+  }
+}
+
+static int32_t rpcBufClassOf(int32_t size) {
+  int32_t cls = 0;
+  while (cls < RPC_BUF_CLASSES && (1 << (RPC_BUF_MIN_SHIFT + cls)) < size) cls++;
+  return (cls < RPC_BUF_CLASSES) ? cls : RPC_BUF_NO_CLASS;
+}
+
+// Each class may keep an equal share of the pool
+void rpcBufInit(void) {
+  pthread_once(&tsRpcBufInit, rpcBufInitImpl);
+
+  int64_t share = (int64_t)tsRpcBufPoolSize * 1024 * 1024 / RPC_BUF_CLASSES;
+  for (int32_t cls = 0; cls < RPC_BUF_CLASSES; ++cls) {
+    SRpcBufClass *pClass = tsRpcBufClasses + cls;
+    pthread_mutex_lock(&pClass->mutex);
+    pClass->maxNum = (int32_t)(share / (1 << (RPC_BUF_MIN_SHIFT + cls)));
+    pthread_mutex_unlock(&pClass->mutex);
+  }
+
+  tDebug("rpc buffer pool is initialized, size:%dMB", tsRpcBufPoolSize);
+}
+
+// The buffers in use go back to malloc when they are freed
+void rpcBufCleanup(void) {
+  pthread_once(&tsRpcBufInit, rpcBufInitImpl);
+
+  for (int32_t cls = 0; cls < RPC_BUF_CLASSES; ++cls) {
+    SRpcBufClass *pClass = tsRpcBufClasses + cls;
+
+    pthread_mutex_lock(&pClass->mutex);
+    SRpcBuf *pBuf = pClass->pHead;
+    pClass->pHead = NULL;
+    pClass->num = 0;
+    pClass->maxNum = 0;
+    pthread_mutex_unlock(&pClass->mutex);
+
+    while (pBuf) {
+      SRpcBuf *pNext = pBuf->next;
+      free(pBuf);
+      pBuf = pNext;
+    }
+  }
+}
+
+void *rpcBufMalloc(int32_t size) {
+  int32_t  cls = rpcBufClassOf(size);
+  SRpcBuf *pBuf = NULL;
+
+  if (cls != RPC_BUF_NO_CLASS) {
+    SRpcBufClass *pClass = tsRpcBufClasses + cls;
+    if (pClass->maxNum > 0) {
+      pthread_mutex_lock(&pClass->mutex);
+      pBuf = pClass->pHead;
+      if (pBuf) {
+        pClass->pHead = pBuf->next;
+        pClass->num--;
+      }
+      pthread_mutex_unlock(&pClass->mutex);
+    }
+
+    if (pBuf == NULL) {
+      int32_t csize = 1 << (RPC_BUF_MIN_SHIFT + cls);
+      pBuf = malloc(sizeof(SRpcBuf) + csize);
+      if (pBuf == NULL) return NULL;
+      pBuf->cls = cls;
+      pBuf->size = csize;
+    }
+  } else {
+    pBuf = malloc(sizeof(SRpcBuf) + size);
+    if (pBuf == NULL) return NULL;
+    pBuf->cls = RPC_BUF_NO_CLASS;
+    pBuf->size = size;
+  }
+
+  pBuf->next = NULL;
+  return pBuf + 1;
+}
+
+void *rpcBufCalloc(int32_t size) {
+  void *ptr = rpcBufMalloc(size);
+  if (ptr) memset(ptr, 0, size);
+  return ptr;
+}
+
+void *rpcBufRealloc(void *ptr, int32_t size) {
+  if (ptr == NULL) return rpcBufMalloc(size);
+
+  SRpcBuf *pBuf = (SRpcBuf *)ptr - 1;
+  if (size <= pBuf->size) return ptr;
+
+  void *pNew = rpcBufMalloc(size);
+  if (pNew == NULL) return NULL;
+
+  memcpy(pNew, ptr, pBuf->size);
+  rpcBufFree(ptr);
+  return pNew;
+}
+
+void rpcBufFree(void *ptr) {
+  if (ptr == NULL) return;
+
+  SRpcBuf *pBuf = (SRpcBuf *)ptr - 1;
+  if (pBuf->cls != RPC_BUF_NO_CLASS) {
+    SRpcBufClass *pClass = tsRpcBufClasses + pBuf->cls;
+    if (pClass->maxNum > 0) {
+      pthread_mutex_lock(&pClass->mutex);
+      if (pClass->num < pClass->maxNum) {
+        pBuf->next = pClass->pHead;
+        pClass->pHead = pBuf;
+        pClass->num++;
+        pBuf = NULL;
+      }
+      pthread_mutex_unlock(&pClass->mutex);
+    }
+  }
+
+  free(pBuf);
+}
+
+int32_t rpcBufFreeNum(int32_t size) {
+  pthread_once(&tsRpcBufInit, rpcBufInitImpl);
+
+  int32_t cls = rpcBufClassOf(size);
+  if (cls == RPC_BUF_NO_CLASS) return -1;
+
+  SRpcBufClass *pClass = tsRpcBufClasses + cls;
+  pthread_mutex_lock(&pClass->mutex);
+  int32_t num = pClass->num;
+  pthread_mutex_unlock(&pClass->mutex);
+  return num;
+}
@@ -30,7 +30,9 @@
 #include "rpcLog.h"
 #include "rpcUdp.h"
 #include "rpcCache.h"
+#include "rpcBuf.h"
 #include "rpcTcp.h"
+#include "rpcUring.h"
 #include "rpcHead.h"
 
 #define RPC_MSG_OVERHEAD (sizeof(SRpcReqContext) + sizeof(SRpcHead) + sizeof(SRpcDigest)) 
@@ -217,7 +219,30 @@ static void  rpcDecRef(SRpcInfo *pRpc);
 
 static void rpcFree(void *p) {
   tTrace("free mem: %p", p);
-  free(p);
+  rpcBufFree(p);
+}
+
+// TCP connections are served by io_uring if it is configured and the kernel supports it, otherwise by epoll
+static void rpcSelectTcpBackend(void) {
+  bool uring = false;
+  if (tsRpcIoUring) {
+    uring = taosCheckUring();
+    if (!uring) tWarn("io_uring is not supported, TCP connections are served by epoll");
+  }
+
+  taosInitConn[RPC_CONN_TCPS] = uring ? taosInitUringServer : taosInitTcpServer;
+  taosInitConn[RPC_CONN_TCPC] = uring ? taosInitUringClient : taosInitTcpClient;
+  taosCleanUpConn[RPC_CONN_TCPS] = uring ? taosCleanUpUringServer : taosCleanUpTcpServer;
+  taosCleanUpConn[RPC_CONN_TCPC] = uring ? taosCleanUpUringClient : taosCleanUpTcpClient;
+  taosStopConn[RPC_CONN_TCPS] = uring ? taosStopUringServer : taosStopTcpServer;
+  taosStopConn[RPC_CONN_TCPC] = uring ? taosStopUringClient : taosStopTcpClient;
+  taosSendData[RPC_CONN_TCPS] = uring ? taosSendUringData : taosSendTcpData;
+  taosSendData[RPC_CONN_TCPC] = uring ? taosSendUringData : taosSendTcpData;
+  taosOpenConn[RPC_CONN_TCPC] = uring ? taosOpenUringClientConnection : taosOpenTcpClientConnection;
+  taosCloseConn[RPC_CONN_TCPS] = uring ? taosCloseUringConnection : taosCloseTcpConnection;
+  taosCloseConn[RPC_CONN_TCPC] = uring ? taosCloseUringConnection : taosCloseTcpConnection;
+
+  tDebug("TCP connections are served by %s", uring ? "io_uring" : "epoll");
 }
 
 int32_t rpcInit(void) {
@@ -227,6 +252,8 @@ int32_t rpcInit(void) {
   tsRpcOverhead = sizeof(SRpcReqContext);
 
   tsRpcRefId = taosOpenRef(200, rpcFree);
+  rpcBufInit();
+  rpcSelectTcpBackend();
 
   return 0;
 }
@@ -234,6 +261,7 @@ int32_t rpcInit(void) {
 void rpcCleanup(void) {
   taosCloseRef(tsRpcRefId);
   tsRpcRefId = -1;
+  rpcBufCleanup();
 }
  
 void *rpcOpen(const SRpcInit *pInit) {
@@ -346,7 +374,7 @@ void rpcClose(void *param) {
 void *rpcMallocCont(int contLen) {
   int size = contLen + RPC_MSG_OVERHEAD;
 
-  char *start = (char *)calloc(1, (size_t)size);
+  char *start = (char *)rpcBufCalloc(size);
   if (start == NULL) {
     tError("failed to malloc msg, size:%d", size);
     return NULL;
@@ -360,7 +388,7 @@ void *rpcMallocCont(int contLen) {
 void rpcFreeCont(void *cont) {
   if (cont) {
     char *temp = ((char *)cont) - sizeof(SRpcHead) - sizeof(SRpcReqContext);
-    free(temp);
+    rpcBufFree(temp);
     tTrace("free mem: %p", temp);
   }
 }
@@ -370,12 +398,12 @@ void *rpcReallocCont(void *ptr, int contLen) {
 
   char *start = ((char *)ptr) - sizeof(SRpcReqContext) - sizeof(SRpcHead);
   if (contLen == 0 ) {
-    free(start); 
+    rpcBufFree(start); 
     return NULL;
   }
 
   int size = contLen + RPC_MSG_OVERHEAD;
-  start = realloc(start, size);
+  start = rpcBufRealloc(start, size);
   if (start == NULL) {
     tError("failed to realloc cont, size:%d", size);
     return NULL;
@@ -571,7 +599,7 @@ void rpcCancelRequest(int64_t rid) {
 static void rpcFreeMsg(void *msg) {
   if ( msg ) {
     char *temp = (char *)msg - sizeof(SRpcReqContext);
-    free(temp);
+    rpcBufFree(temp);
     tTrace("free mem: %p", temp);
   }
 }
@@ -1500,10 +1528,10 @@ static SRpcHead *rpcDecompressRpcMsg(SRpcHead *pHead) {
     int contLen = htonl(pComp->contLen);
   
     // prepare the temporary buffer to decompress message
-    char *temp = (char *)malloc(contLen + RPC_MSG_OVERHEAD);
-    pNewHead = (SRpcHead *)(temp + sizeof(SRpcReqContext)); // reserve SRpcReqContext
+    char *temp = (char *)rpcBufMalloc(contLen + RPC_MSG_OVERHEAD);
   
-    if (pNewHead) {
+    if (temp) {
+      pNewHead = (SRpcHead *)(temp + sizeof(SRpcReqContext)); // reserve SRpcReqContext
       int compLen = rpcContLenFromMsg(pHead->msgLen) - overhead;
       int origLen = LZ4_decompress_safe((char*)(pCont + overhead), (char *)pNewHead->content, compLen, contLen);
       assert(origLen == contLen);
@@ -20,8 +20,21 @@
 #include "taoserror.h"
 #include "rpcLog.h"
 #include "rpcHead.h"
+#include "rpcBuf.h"
 #include "rpcTcp.h"
 
+#define RPC_TCP_READ_SIZE 65536  // bytes read from a socket at most by one wakeup
+#define RPC_TCP_MAX_IOV   64     // messages written by one writev at most
+
+// A message waiting in the send queue of a connection, owned by the sending thread
+typedef struct STcpSend {
+  char            *data;
+  int32_t          len;
+  int32_t          ret;   // bytes written, or -1
+  bool             done;
+  struct STcpSend *next;
+} STcpSend;
+
 typedef struct SFdObj {
   void              *signature;
   SOCKET             fd;          // TCP socket FD
@@ -29,6 +42,11 @@ typedef struct SFdObj {
   uint32_t           ip;
   uint16_t           port;
   int16_t            closedByApp; // 1: already closed by App
+  bool               sending;     // a sender is writing the send queue
+  pthread_mutex_t    smutex;
+  pthread_cond_t     scond;
+  STcpSend          *pSendHead;
+  STcpSend          *pSendTail;
   struct SThreadObj *pThreadObj;
   struct SFdObj     *prev;
   struct SFdObj     *next;
@@ -46,6 +64,7 @@ typedef struct SThreadObj {
   char            label[TSDB_LABEL_LEN];
   void           *shandle;  // handle passed by upper layer during server initialization
   void           *(*processData)(SRecvInfo *pPacket);
+  char           *buffer;   // RPC_TCP_READ_SIZE bytes read from a socket
 } SThreadObj;
 
 typedef struct {
@@ -135,6 +154,13 @@ void *taosInitTcpServer(uint32_t ip, uint16_t port, char *label, int numOfThread
       break;
     }
 
+    pThreadObj->buffer = malloc(RPC_TCP_READ_SIZE);
+    if (pThreadObj->buffer == NULL) {
+      tError("%s failed to malloc TCP read buffer", label);
+      code = -1;
+      break;
+    }
+
     pThreadObj->pollFd = (EpollFd)epoll_create(10);  // size does not matter
     if (pThreadObj->pollFd < 0) {
       tError("%s failed to create TCP epoll", label);
@@ -347,6 +373,13 @@ void *taosInitTcpClient(uint32_t ip, uint16_t port, char *label, int numOfThread
       break;
     }
 
+    pThreadObj->buffer = malloc(RPC_TCP_READ_SIZE);
+    if (pThreadObj->buffer == NULL) {
+      tError("%s failed to malloc TCP read buffer", label);
+      code = -1;
+      break;
+    }
+
     pThreadObj->pollFd = (int64_t)epoll_create(10);  // size does not matter
     if (pThreadObj->pollFd < 0) {
       tError("%s failed to create TCP epoll", label);
@@ -435,15 +468,78 @@ void taosCloseTcpConnection(void *chandle) {
   shutdown(pFdObj->fd, SHUT_WR);
 }
 
+static int32_t taosWriteTcpQueue(SFdObj *pFdObj, STcpSend *pList) {
+  struct iovec iov[RPC_TCP_MAX_IOV];
+  int32_t      iovcnt = 0;
+  int32_t      total = 0;
+
+  for (STcpSend *pSend = pList; pSend; pSend = pSend->next) {
+    iov[iovcnt].iov_base = pSend->data;
+    iov[iovcnt].iov_len = pSend->len;
+    total += pSend->len;
+    iovcnt++;
+  }
+
+  int64_t ret = taosWritev(pFdObj->fd, iov, iovcnt);
+  tTrace("%s %p TCP data is sent, FD:%p fd:%d msgs:%d bytes:%" PRId64, pFdObj->pThreadObj->label, pFdObj->thandle,
+         pFdObj, pFdObj->fd, iovcnt, ret);
+
+  return (ret == total) ? 0 : -1;
+}
+
+// The messages queued to one connection by concurrent senders are written together: the sender finding no write in
+// progress writes the whole queue by writev, and the others wait till their messages are written.
 int taosSendTcpData(uint32_t ip, uint16_t port, void *data, int len, void *chandle) {
   SFdObj *pFdObj = chandle;
   if (pFdObj == NULL || pFdObj->signature != pFdObj) return -1;
-  SThreadObj *pThreadObj = pFdObj->pThreadObj;
 
-  int ret = taosWriteMsg(pFdObj->fd, data, len);
-  tTrace("%s %p TCP data is sent, FD:%p fd:%d bytes:%d", pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd, ret);
+  STcpSend send = {.data = data, .len = len, .ret = -1, .done = false, .next = NULL};
+
+  pthread_mutex_lock(&pFdObj->smutex);
+
+  if (pFdObj->pSendTail) {
+    pFdObj->pSendTail->next = &send;
+  } else {
+    pFdObj->pSendHead = &send;
+  }
+  pFdObj->pSendTail = &send;
+
+  while (!send.done && pFdObj->sending) {
+    pthread_cond_wait(&pFdObj->scond, &pFdObj->smutex);
+  }
+
+  if (send.done) {
+    pthread_mutex_unlock(&pFdObj->smutex);
+    return send.ret;
+  }
+
+  pFdObj->sending = true;
+  while (pFdObj->pSendHead) {
+    // take at most RPC_TCP_MAX_IOV messages off the queue
+    STcpSend *pList = pFdObj->pSendHead;
+    STcpSend *pLast = pList;
+    for (int32_t i = 1; i < RPC_TCP_MAX_IOV && pLast->next; ++i) pLast = pLast->next;
+    pFdObj->pSendHead = pLast->next;
+    if (pFdObj->pSendHead == NULL) pFdObj->pSendTail = NULL;
+    pLast->next = NULL;
+    pthread_mutex_unlock(&pFdObj->smutex);
+
+    int32_t code = taosWriteTcpQueue(pFdObj, pList);
+
+    pthread_mutex_lock(&pFdObj->smutex);
+    while (pList) {
+      STcpSend *pNext = pList->next;  // pList belongs to its sender once it is done
+      pList->ret = (code == 0) ? pList->len : -1;
+      pList->done = true;
+      pList = pNext;
+    }
+    pthread_cond_broadcast(&pFdObj->scond);
+  }
+  pFdObj->sending = false;
 
-  return ret;
+  pthread_mutex_unlock(&pFdObj->smutex);
+
+  return send.ret;
 }
 
 static void taosReportBrokenLink(SFdObj *pFdObj) {
@@ -469,54 +565,103 @@ static void taosReportBrokenLink(SFdObj *pFdObj) {
   taosFreeFdObj(pFdObj);
 }
 
-static int taosReadTcpData(SFdObj *pFdObj, SRecvInfo *pInfo) {
+// Read the rest of a message, the first readLen bytes of which have been copied into msg
+static int taosReadTcpMsg(SFdObj *pFdObj, char *msg, int32_t readLen, int32_t msgLen) {
+  int32_t leftLen = msgLen - readLen;
+  if (leftLen <= 0) return 0;
+
+  int32_t retLen = taosReadMsg(pFdObj->fd, msg + readLen, leftLen);
+  if (leftLen != retLen) {
+    tError("%s %p read error, leftLen:%d retLen:%d FD:%p", pFdObj->pThreadObj->label, pFdObj->thandle, leftLen, retLen,
+           pFdObj);
+    return -1;
+  }
+
+  return 0;
+}
+
+// Read what the socket holds, up to RPC_TCP_READ_SIZE bytes, by one call, and pass each message in it to the upper
+// layer. A message not read completely is completed by blocking reads. Return -1 if the link is broken, 1 if the
+// FdObj is freed, otherwise 0.
+static int taosReadTcpData(SFdObj *pFdObj) {
   SRpcHead    rpcHead;
-  int32_t     msgLen, leftLen, retLen, headLen;
+  SRecvInfo   recvInfo;
+  int32_t     msgLen, headLen, copyLen;
   char       *buffer, *msg;
 
   SThreadObj *pThreadObj = pFdObj->pThreadObj;
 
-  headLen = taosReadMsg(pFdObj->fd, &rpcHead, sizeof(SRpcHead));
-  if (headLen != sizeof(SRpcHead)) {
-    tDebug("%s %p read error, FD:%p headLen:%d", pThreadObj->label, pFdObj->thandle, pFdObj, headLen);
+  int32_t dataLen = (int32_t)taosReadSocket(pFdObj->fd, pThreadObj->buffer, RPC_TCP_READ_SIZE);
+  if (dataLen <= 0) {
+    if (dataLen < 0 && errno == EINTR) return 0;
+    tDebug("%s %p read error, FD:%p dataLen:%d", pThreadObj->label, pFdObj->thandle, pFdObj, dataLen);
     return -1;
   }
 
-  msgLen = (int32_t)htonl((uint32_t)rpcHead.msgLen);
-  int32_t size = msgLen + tsRpcOverhead;
-  buffer = malloc(size);
-  if (NULL == buffer) {
-    tError("%s %p TCP malloc(size:%d) fail", pThreadObj->label, pFdObj->thandle, msgLen);
-    return -1;
-  } else {
-    tTrace("%s %p read data, FD:%p fd:%d TCP malloc mem:%p", pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd, buffer);
-  }
+  int32_t offset = 0;
+  while (offset < dataLen) {
+    char *data = pThreadObj->buffer + offset;
 
-  msg = buffer + tsRpcOverhead;
-  leftLen = msgLen - headLen;
-  retLen = taosReadMsg(pFdObj->fd, msg + headLen, leftLen);
+    headLen = MIN(dataLen - offset, (int32_t)sizeof(SRpcHead));
+    memcpy(&rpcHead, data, headLen);
+    if (headLen < sizeof(SRpcHead)) {
+      int32_t retLen = taosReadMsg(pFdObj->fd, (char *)&rpcHead + headLen, sizeof(SRpcHead) - headLen);
+      if (retLen != sizeof(SRpcHead) - headLen) {
+        tDebug("%s %p read error, FD:%p headLen:%d", pThreadObj->label, pFdObj->thandle, pFdObj, headLen + retLen);
+        return -1;
+      }
+    }
 
-  if (leftLen != retLen) {
-    tError("%s %p read error, leftLen:%d retLen:%d FD:%p",
-            pThreadObj->label, pFdObj->thandle, leftLen, retLen, pFdObj);
-    free(buffer);
-    return -1;
-  }
+    msgLen = (int32_t)htonl((uint32_t)rpcHead.msgLen);
+    if (msgLen < (int32_t)sizeof(SRpcHead)) {
+      tError("%s %p invalid msgLen:%d, FD:%p", pThreadObj->label, pFdObj->thandle, msgLen, pFdObj);
+      return -1;
+    }
 
-  memcpy(msg, &rpcHead, sizeof(SRpcHead));
+    int32_t size = msgLen + tsRpcOverhead;
+    buffer = rpcBufMalloc(size);
+    if (NULL == buffer) {
+      tError("%s %p TCP malloc(size:%d) fail", pThreadObj->label, pFdObj->thandle, msgLen);
+      return -1;
+    } else {
+      tTrace("%s %p read data, FD:%p fd:%d TCP malloc mem:%p", pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd,
+             buffer);
+    }
+
+    msg = buffer + tsRpcOverhead;
+    memcpy(msg, &rpcHead, sizeof(SRpcHead));
+    copyLen = MIN(dataLen - offset, msgLen);
+    if (copyLen > (int32_t)sizeof(SRpcHead)) {
+      memcpy(msg + sizeof(SRpcHead), data + sizeof(SRpcHead), copyLen - sizeof(SRpcHead));
+    } else {
+      copyLen = sizeof(SRpcHead);
+    }
 
-  pInfo->msg = msg;
-  pInfo->msgLen = msgLen;
-  pInfo->ip = pFdObj->ip;
-  pInfo->port = pFdObj->port;
-  pInfo->shandle = pThreadObj->shandle;
-  pInfo->thandle = pFdObj->thandle;
-  pInfo->chandle = pFdObj;
-  pInfo->connType = RPC_CONN_TCP;
+    if (taosReadTcpMsg(pFdObj, msg, copyLen, msgLen) < 0) {
+      rpcBufFree(buffer);
+      return -1;
+    }
+    offset += MIN(dataLen - offset, msgLen);
 
-  if (pFdObj->closedByApp) {
-    free(buffer);
-    return -1;
+    if (pFdObj->closedByApp) {
+      rpcBufFree(buffer);
+      return -1;
+    }
+
+    recvInfo.msg = msg;
+    recvInfo.msgLen = msgLen;
+    recvInfo.ip = pFdObj->ip;
+    recvInfo.port = pFdObj->port;
+    recvInfo.shandle = pThreadObj->shandle;
+    recvInfo.thandle = pFdObj->thandle;
+    recvInfo.chandle = pFdObj;
+    recvInfo.connType = RPC_CONN_TCP;
+
+    pFdObj->thandle = (*(pThreadObj->processData))(&recvInfo);
+    if (pFdObj->thandle == NULL) {
+      taosFreeFdObj(pFdObj);
+      return 1;
+    }
   }
 
   return 0;
@@ -528,7 +673,6 @@ static void *taosProcessTcpData(void *param) {
   SThreadObj        *pThreadObj = param;
   SFdObj            *pFdObj;
   struct epoll_event events[maxEvents];
-  SRecvInfo          recvInfo;
   char               name[16];
 
   memset(name, 0, sizeof(name));
@@ -564,13 +708,9 @@ static void *taosProcessTcpData(void *param) {
         continue;
       }
 
-      if (taosReadTcpData(pFdObj, &recvInfo) < 0) {
+      if (taosReadTcpData(pFdObj) < 0) {
         shutdown(pFdObj->fd, SHUT_WR);
-        continue;
       }
-
-      pFdObj->thandle = (*(pThreadObj->processData))(&recvInfo);
-      if (pFdObj->thandle == NULL) taosFreeFdObj(pFdObj);
     }
 
     if (pThreadObj->stop) break;
@@ -588,6 +728,7 @@ static void *taosProcessTcpData(void *param) {
   }
 
   pthread_mutex_destroy(&(pThreadObj->mutex));
+  tfree(pThreadObj->buffer);
   tDebug("%s TCP thread exits ...", pThreadObj->label);
   tfree(pThreadObj);
 
@@ -606,10 +747,14 @@ static SFdObj *taosMallocFdObj(SThreadObj *pThreadObj, SOCKET fd) {
   pFdObj->fd = fd;
   pFdObj->pThreadObj = pThreadObj;
   pFdObj->signature = pFdObj;
+  pthread_mutex_init(&pFdObj->smutex, NULL);
+  pthread_cond_init(&pFdObj->scond, NULL);
 
   event.events = EPOLLIN | EPOLLRDHUP;
   event.data.ptr = pFdObj;
   if (epoll_ctl(pThreadObj->pollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    pthread_mutex_destroy(&pFdObj->smutex);
+    pthread_cond_destroy(&pFdObj->scond);
     tfree(pFdObj);
     terrno = TAOS_SYSTEM_ERROR(errno);
     return NULL;
@@ -663,5 +808,7 @@ static void taosFreeFdObj(SFdObj *pFdObj) {
   tDebug("%s %p TCP connection is closed, FD:%p fd:%d numOfFds:%d",
           pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd, pThreadObj->numOfFds);
 
+  pthread_mutex_destroy(&pFdObj->smutex);
+  pthread_cond_destroy(&pFdObj->scond);
   tfree(pFdObj);
 }
@@ -0,0 +1,1078 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "tsocket.h"
+#include "tutil.h"
+#include "taosdef.h"
+#include "taoserror.h"
+#include "rpcLog.h"
+#include "rpcHead.h"
+#include "rpcBuf.h"
+#include "rpcUring.h"
+
+#if defined(_TD_LINUX) && __has_include(<linux/io_uring.h>)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <linux/io_uring.h>
+#endif
+
+#if defined(_TD_LINUX) && defined(IORING_RECV_MULTISHOT)
+
+#define RPC_URING_ENTRIES  1024  // submission queue entries of a ring
+#define RPC_URING_BUF_NUM  256   // receive buffers provided to a ring, a power of 2
+#define RPC_URING_BUF_SIZE 4096
+#define RPC_URING_BGID     0     // buffer group of the receive buffers
+#define RPC_URING_WAKE     0     // user_data of the NOP which wakes up the thread
+#define RPC_URING_SEND     1     // tag of the user_data of a send, the other bits point to the FdObj
+#define RPC_URING_ARM      2     // tag of the user_data of a NOP asking the thread to arm the receive of the FdObj
+#define RPC_URING_TAGS     3
+#define RPC_URING_WAIT_MS  1000  // longest wait for completions, a thread whose ring is broken gets no NOP to wake it up
+
+typedef struct SFdObj {
+  void              *signature;
+  SOCKET             fd;          // TCP socket FD
+  void              *thandle;     // handle from upper layer, like TAOS
+  uint32_t           ip;
+  uint16_t           port;
+  int16_t            closedByApp; // 1: already closed by App
+  int32_t            refCount;    // one for the armed receive, one for each sender
+  SRpcHead           head;        // head of the message being received
+  int32_t            headLen;     // bytes of head received
+  char              *buffer;      // buffer of the message being received
+  int32_t            msgLen;
+  int32_t            readLen;     // bytes of the message received
+  pthread_mutex_t    smutex;      // senders of a connection send one after another
+  tsem_t             sendSem;
+  int32_t            sendRet;
+  struct SThreadObj *pThreadObj;
+  struct SFdObj     *prev;
+  struct SFdObj     *next;
+  struct SFdObj     *nextFailed;  // in the list of connections whose receive could not be armed
+} SFdObj;
+
+typedef struct SThreadObj {
+  pthread_t       thread;
+  SFdObj *        pHead;
+  pthread_mutex_t mutex;
+  uint32_t        ip;
+  bool            stop;
+  int             numOfFds;
+  int             threadId;
+  char            label[TSDB_LABEL_LEN];
+  void           *shandle;  // handle passed by upper layer during server initialization
+  void           *(*processData)(SRecvInfo *pPacket);
+
+  int32_t              ringFd;
+  void                *sqPtr;
+  size_t               sqSize;
+  void                *cqPtr;
+  size_t               cqSize;
+  uint32_t             sqEntries;
+  uint32_t            *sqHead;
+  uint32_t            *sqTail;
+  uint32_t            *sqMask;
+  uint32_t            *sqArray;
+  struct io_uring_sqe *sqes;
+  uint32_t            *cqHead;
+  uint32_t            *cqTail;
+  uint32_t            *cqMask;
+  struct io_uring_cqe *cqes;
+  pthread_mutex_t      sqMutex;
+  pthread_cond_t       sqCond;      // signaled when a thread is done submitting
+  bool                 submitting;  // a thread is submitting the queued entries
+  bool                 broken;      // io_uring_enter failed, no entries are taken any more
+  SFdObj              *pFailed;     // connections whose receive, or the NOP for it, was dropped by the broken ring
+
+  struct io_uring_buf_ring *bufRing;
+  char                     *bufs;
+  uint16_t                  bufTail;
+} SThreadObj;
+
+typedef struct {
+  char    label[TSDB_LABEL_LEN];
+  int32_t index;
+  int numOfThreads;
+  SThreadObj **pThreadObj;
+} SClientObj;
+
+typedef struct {
+  SOCKET      fd;
+  uint32_t    ip;
+  uint16_t    port;
+  int8_t      stop;
+  int8_t      reserve;
+  char        label[TSDB_LABEL_LEN];
+  int         numOfThreads;
+  void *      shandle;
+  SThreadObj **pThreadObj;
+  pthread_t   thread;
+} SServerObj;
+
+static void   *taosProcessUringData(void *param);
+static SFdObj *taosMallocFdObj(SThreadObj *pThreadObj, SOCKET fd);
+static int     taosArmUringRecv(SFdObj *pFdObj);
+static void    taosDecFdObjRef(SFdObj *pFdObj);
+static void    taosReportBrokenLink(SFdObj *pFdObj);
+static void   *taosAcceptUringConnection(void *arg);
+
+static int taosSetupUring(uint32_t entries, struct io_uring_params *p) {
+  return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int taosEnterUring(int ringFd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags) {
+  return (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, NULL, 0);
+}
+
+// Wait for a completion, or until RPC_URING_WAIT_MS has passed
+static int taosWaitUring(int ringFd) {
+  struct __kernel_timespec     ts = {.tv_sec = RPC_URING_WAIT_MS / 1000, .tv_nsec = (RPC_URING_WAIT_MS % 1000) * 1000000L};
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.ts = (uint64_t)(uintptr_t)&ts;
+
+  int ret = (int)syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg,
+                         sizeof(arg));
+  if (ret < 0 && (errno == EINTR || errno == ETIME)) return 0;
+  return ret;
+}
+
+static int taosRegisterUring(int ringFd, uint32_t opcode, void *arg, uint32_t nrArgs) {
+  return (int)syscall(__NR_io_uring_register, ringFd, opcode, arg, nrArgs);
+}
+
+static void taosCloseUring(SThreadObj *pThreadObj) {
+  if (pThreadObj->ringFd >= 0) {
+    close(pThreadObj->ringFd);
+    pThreadObj->ringFd = -1;
+  }
+  if (pThreadObj->sqes) munmap(pThreadObj->sqes, pThreadObj->sqEntries * sizeof(struct io_uring_sqe));
+  if (pThreadObj->cqPtr && pThreadObj->cqPtr != pThreadObj->sqPtr) munmap(pThreadObj->cqPtr, pThreadObj->cqSize);
+  if (pThreadObj->sqPtr) munmap(pThreadObj->sqPtr, pThreadObj->sqSize);
+  if (pThreadObj->bufRing) munmap(pThreadObj->bufRing, RPC_URING_BUF_NUM * sizeof(struct io_uring_buf));
+  tfree(pThreadObj->bufs);
+
+  pThreadObj->sqes = NULL;
+  pThreadObj->cqPtr = NULL;
+  pThreadObj->sqPtr = NULL;
+  pThreadObj->bufRing = NULL;
+}
+
+// Hand receive buffer bid to the kernel
+static void taosProvideUringBuf(SThreadObj *pThreadObj, uint16_t bid) {
+  struct io_uring_buf *pBuf = &pThreadObj->bufRing->bufs[pThreadObj->bufTail & (RPC_URING_BUF_NUM - 1)];
+  pBuf->addr = (uint64_t)(uintptr_t)(pThreadObj->bufs + (size_t)bid * RPC_URING_BUF_SIZE);
+  pBuf->len = RPC_URING_BUF_SIZE;
+  pBuf->bid = bid;
+  pThreadObj->bufTail++;
+  __atomic_store_n(&pThreadObj->bufRing->tail, pThreadObj->bufTail, __ATOMIC_RELEASE);
+}
+
+// Set up the ring of a thread and register its receive buffers, which the multishot receives pick up
+static int taosInitUring(SThreadObj *pThreadObj) {
+  struct io_uring_params p;
+  memset(&p, 0, sizeof(p));
+
+  pThreadObj->ringFd = taosSetupUring(RPC_URING_ENTRIES, &p);
+  if (pThreadObj->ringFd < 0) return -1;
+  if (!(p.features & IORING_FEAT_EXT_ARG)) {
+    errno = ENOTSUP;
+    goto _err;
+  }
+
+  pThreadObj->sqEntries = p.sq_entries;
+  pThreadObj->sqSize = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+  pThreadObj->cqSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    pThreadObj->sqSize = MAX(pThreadObj->sqSize, pThreadObj->cqSize);
+    pThreadObj->cqSize = pThreadObj->sqSize;
+  }
+
+  void *ptr = mmap(NULL, pThreadObj->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pThreadObj->ringFd,
+                   IORING_OFF_SQ_RING);
+  if (ptr == MAP_FAILED) goto _err;
+  pThreadObj->sqPtr = ptr;
+
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    pThreadObj->cqPtr = pThreadObj->sqPtr;
+  } else {
+    ptr = mmap(NULL, pThreadObj->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pThreadObj->ringFd,
+               IORING_OFF_CQ_RING);
+    if (ptr == MAP_FAILED) goto _err;
+    pThreadObj->cqPtr = ptr;
+  }
+
+  ptr = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+             pThreadObj->ringFd, IORING_OFF_SQES);
+  if (ptr == MAP_FAILED) goto _err;
+  pThreadObj->sqes = ptr;
+
+  char *sq = pThreadObj->sqPtr;
+  char *cq = pThreadObj->cqPtr;
+  pThreadObj->sqHead = (uint32_t *)(sq + p.sq_off.head);
+  pThreadObj->sqTail = (uint32_t *)(sq + p.sq_off.tail);
+  pThreadObj->sqMask = (uint32_t *)(sq + p.sq_off.ring_mask);
+  pThreadObj->sqArray = (uint32_t *)(sq + p.sq_off.array);
+  pThreadObj->cqHead = (uint32_t *)(cq + p.cq_off.head);
+  pThreadObj->cqTail = (uint32_t *)(cq + p.cq_off.tail);
+  pThreadObj->cqMask = (uint32_t *)(cq + p.cq_off.ring_mask);
+  pThreadObj->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+  // the buffer ring must be page aligned
+  ptr = mmap(NULL, RPC_URING_BUF_NUM * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) goto _err;
+  pThreadObj->bufRing = ptr;
+
+  pThreadObj->bufs = malloc((size_t)RPC_URING_BUF_NUM * RPC_URING_BUF_SIZE);
+  if (pThreadObj->bufs == NULL) goto _err;
+
+  struct io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = (uint64_t)(uintptr_t)pThreadObj->bufRing;
+  reg.ring_entries = RPC_URING_BUF_NUM;
+  reg.bgid = RPC_URING_BGID;
+  if (taosRegisterUring(pThreadObj->ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) goto _err;
+
+  pThreadObj->bufTail = 0;
+  for (int32_t bid = 0; bid < RPC_URING_BUF_NUM; ++bid) {
+    taosProvideUringBuf(pThreadObj, (uint16_t)bid);
+  }
+
+  return 0;
+
+_err:
+  taosCloseUring(pThreadObj);
+  return -1;
+}
+
+// Multishot receives need Linux 6.0
+bool taosCheckUring(void) {
+  struct utsname name;
+  int            major = 0, minor = 0;
+  if (uname(&name) != 0 || sscanf(name.release, "%d.%d", &major, &minor) != 2) return false;
+  if (major < 6) return false;
+
+  SThreadObj threadObj;
+  memset(&threadObj, 0, sizeof(threadObj));
+  threadObj.ringFd = -1;
+  if (taosInitUring(&threadObj) < 0) {
+    tDebug("io_uring is not available(%s)", strerror(errno));
+    return false;
+  }
+
+  taosCloseUring(&threadObj);
+  return true;
+}
+
+// Entries queued but not consumed by the kernel yet, called with sqMutex locked. The kernel advances the SQ head as
+// it consumes them, so the count is what is really left, whatever io_uring_enter returned before.
+static uint32_t taosUringQueued(SThreadObj *pThreadObj) {
+  return *pThreadObj->sqTail - __atomic_load_n(pThreadObj->sqHead, __ATOMIC_ACQUIRE);
+}
+
+// The ring takes no entries any more. The queued ones are never consumed, so the senders waiting for them are
+// completed with -1 here, and the connections whose receive is not armed are left to the data thread to report broken.
+// Called with sqMutex locked, when no one is submitting.
+static void taosFailUringSq(SThreadObj *pThreadObj) {
+  uint32_t head = __atomic_load_n(pThreadObj->sqHead, __ATOMIC_ACQUIRE);
+
+  for (uint32_t i = head; i != *pThreadObj->sqTail; ++i) {
+    struct io_uring_sqe *sqe = &pThreadObj->sqes[pThreadObj->sqArray[i & *pThreadObj->sqMask]];
+    SFdObj              *pFdObj = (SFdObj *)(uintptr_t)(sqe->user_data & ~(uint64_t)RPC_URING_TAGS);
+    if ((sqe->user_data & RPC_URING_TAGS) == RPC_URING_SEND) {
+      pFdObj->sendRet = -1;
+      tsem_post(&pFdObj->sendSem);
+    } else if (pFdObj != NULL) {  // the receive, or the NOP asking for it
+      pFdObj->nextFailed = pThreadObj->pFailed;
+      pThreadObj->pFailed = pFdObj;
+    }
+  }
+
+  __atomic_store_n(pThreadObj->sqTail, head, __ATOMIC_RELEASE);
+}
+
+// Submit the entries queued by all threads, called by other threads than the data thread with sqMutex locked, when no
+// one is submitting. sqMutex is released during io_uring_enter, so the entries other threads queue meanwhile are
+// submitted together in the next round. What the kernel can't take for now(EAGAIN, or EBUSY until completions are
+// reaped) is left to the data thread, which submits the queued entries before each wait.
+static void taosFlushUringSq(SThreadObj *pThreadObj) {
+  pThreadObj->submitting = true;
+
+  while (!pThreadObj->broken) {
+    uint32_t toSubmit = taosUringQueued(pThreadObj);
+    if (toSubmit == 0) break;
+
+    pthread_mutex_unlock(&pThreadObj->sqMutex);
+    int ret = taosEnterUring(pThreadObj->ringFd, toSubmit, 0, 0);
+    int err = errno;
+    pthread_mutex_lock(&pThreadObj->sqMutex);
+
+    if (ret > 0 || (ret < 0 && err == EINTR)) continue;
+    if (ret == 0 || err == EAGAIN || err == EBUSY) break;
+
+    tError("%s failed to submit to io_uring(%s)", pThreadObj->label, strerror(err));
+    pThreadObj->broken = true;
+  }
+
+  pThreadObj->submitting = false;
+  if (pThreadObj->broken) taosFailUringSq(pThreadObj);
+  pthread_cond_broadcast(&pThreadObj->sqCond);
+}
+
+// Submit the queued entries by the data thread itself, with sqMutex locked. It never waits for the thread submitting
+// for others, which may be off the CPU while the data thread is the one to reap the completions.
+static void taosFlushUringSqNow(SThreadObj *pThreadObj) {
+  while (!pThreadObj->broken) {
+    uint32_t toSubmit = taosUringQueued(pThreadObj);
+    if (toSubmit == 0) break;
+
+    int ret = taosEnterUring(pThreadObj->ringFd, toSubmit, 0, 0);
+    if (ret > 0 || (ret < 0 && errno == EINTR)) continue;
+    if (ret == 0 || errno == EAGAIN || errno == EBUSY) break;
+
+    tError("%s failed to submit to io_uring(%s)", pThreadObj->label, strerror(errno));
+    pThreadObj->broken = true;
+  }
+
+  // else the thread submitting fails them once its io_uring_enter returns
+  if (pThreadObj->broken && !pThreadObj->submitting) taosFailUringSq(pThreadObj);
+  pthread_cond_broadcast(&pThreadObj->sqCond);
+}
+
+// Return a free submission entry, or NULL if the ring is broken, called with sqMutex locked. If the queue is full, the
+// queued entries are submitted first. The data thread reaps the completions, so it can't wait for the kernel to take
+// them and gets NULL instead.
+static struct io_uring_sqe *taosGetUringSqe(SThreadObj *pThreadObj) {
+  bool inThread = taosComparePthread(pThreadObj->thread, pthread_self());
+
+  while (!pThreadObj->broken && taosUringQueued(pThreadObj) >= pThreadObj->sqEntries) {
+    if (inThread) {
+      taosFlushUringSqNow(pThreadObj);
+      if (taosUringQueued(pThreadObj) < pThreadObj->sqEntries) break;
+      return NULL;
+    }
+    if (!pThreadObj->submitting) {
+      taosFlushUringSq(pThreadObj);
+      if (taosUringQueued(pThreadObj) < pThreadObj->sqEntries) break;
+    }
+    pthread_cond_wait(&pThreadObj->sqCond, &pThreadObj->sqMutex);
+  }
+  if (pThreadObj->broken) return NULL;
+
+  uint32_t             index = *pThreadObj->sqTail & *pThreadObj->sqMask;
+  struct io_uring_sqe *sqe = &pThreadObj->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  pThreadObj->sqArray[index] = index;
+  return sqe;
+}
+
+// Publish the entry got by taosGetUringSqe, called with sqMutex locked. It is submitted at once unless another thread
+// is submitting, which submits it in its next round.
+static void taosSubmitUringSqe(SThreadObj *pThreadObj) {
+  __atomic_store_n(pThreadObj->sqTail, *pThreadObj->sqTail + 1, __ATOMIC_RELEASE);
+  if (taosComparePthread(pThreadObj->thread, pthread_self())) {
+    taosFlushUringSqNow(pThreadObj);
+  } else if (!pThreadObj->submitting) {
+    taosFlushUringSq(pThreadObj);
+  }
+}
+
+static void taosWakeUpUringThread(SThreadObj *pThreadObj) {
+  pthread_mutex_lock(&pThreadObj->sqMutex);
+  struct io_uring_sqe *sqe = taosGetUringSqe(pThreadObj);
+  if (sqe != NULL) {
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = RPC_URING_WAKE;
+    taosSubmitUringSqe(pThreadObj);
+  }
+  pthread_mutex_unlock(&pThreadObj->sqMutex);
+}
+
+static void taosStopUringThread(SThreadObj *pThreadObj) {
+  if (pThreadObj == NULL) return;
+  pthread_t thread = pThreadObj->thread;
+  if (!taosCheckPthreadValid(thread)) {
+    return;
+  }
+  pThreadObj->stop = true;
+  if (taosComparePthread(thread, pthread_self())) {
+    pthread_detach(pthread_self());
+    return;
+  }
+  taosWakeUpUringThread(pThreadObj);
+  pthread_join(thread, NULL);
+}
+
+static SThreadObj *taosInitUringThread(char *label, uint32_t ip, void *fp, void *shandle, int threadId) {
+  SThreadObj *pThreadObj = (SThreadObj *)calloc(sizeof(SThreadObj), 1);
+  if (pThreadObj == NULL) return NULL;
+
+  pThreadObj->ringFd = -1;
+  pThreadObj->ip = ip;
+  pThreadObj->processData = fp;
+  pThreadObj->shandle = shandle;
+  pThreadObj->threadId = threadId;
+  tstrncpy(pThreadObj->label, label, sizeof(pThreadObj->label));
+  taosResetPthread(&pThreadObj->thread);
+  pthread_mutex_init(&pThreadObj->mutex, NULL);
+  pthread_mutex_init(&pThreadObj->sqMutex, NULL);
+  pthread_cond_init(&pThreadObj->sqCond, NULL);
+
+  if (taosInitUring(pThreadObj) < 0) {
+    tError("%s failed to init io_uring(%s)", label, strerror(errno));
+    goto _err;
+  }
+
+  pthread_attr_t thattr;
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+  int code = pthread_create(&pThreadObj->thread, &thattr, taosProcessUringData, (void *)pThreadObj);
+  pthread_attr_destroy(&thattr);
+  if (code != 0) {
+    tError("%s failed to create io_uring process data thread(%s)", label, strerror(code));
+    taosCloseUring(pThreadObj);
+    goto _err;
+  }
+
+  return pThreadObj;
+
+_err:
+  pthread_mutex_destroy(&pThreadObj->mutex);
+  pthread_mutex_destroy(&pThreadObj->sqMutex);
+  pthread_cond_destroy(&pThreadObj->sqCond);
+  free(pThreadObj);
+  return NULL;
+}
+
+void *taosInitUringServer(uint32_t ip, uint16_t port, char *label, int numOfThreads, void *fp, void *shandle) {
+  SServerObj *pServerObj = (SServerObj *)calloc(sizeof(SServerObj), 1);
+  if (pServerObj == NULL) {
+    tError("io_uring:%s no enough memory", label);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return NULL;
+  }
+
+  pServerObj->fd = -1;
+  taosResetPthread(&pServerObj->thread);
+  pServerObj->ip = ip;
+  pServerObj->port = port;
+  tstrncpy(pServerObj->label, label, sizeof(pServerObj->label));
+  pServerObj->shandle = shandle;
+
+  pServerObj->pThreadObj = (SThreadObj **)calloc(sizeof(SThreadObj *), numOfThreads);
+  if (pServerObj->pThreadObj == NULL) {
+    tError("io_uring:%s no enough memory", label);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    free(pServerObj);
+    return NULL;
+  }
+
+  for (int i = 0; i < numOfThreads; ++i) {
+    pServerObj->pThreadObj[i] = taosInitUringThread(label, 0, fp, shandle, i);
+    if (pServerObj->pThreadObj[i] == NULL) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      taosCleanUpUringServer(pServerObj);
+      return NULL;
+    }
+    pServerObj->numOfThreads++;
+  }
+
+  pServerObj->fd = taosOpenTcpServerSocket(pServerObj->ip, pServerObj->port);
+  if (pServerObj->fd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    taosCleanUpUringServer(pServerObj);
+    return NULL;
+  }
+
+  pthread_attr_t thattr;
+  pthread_attr_init(&thattr);
+  pthread_attr_setdetachstate(&thattr, PTHREAD_CREATE_JOINABLE);
+  int code = pthread_create(&pServerObj->thread, &thattr, taosAcceptUringConnection, (void *)pServerObj);
+  pthread_attr_destroy(&thattr);
+  if (code != 0) {
+    tError("%s failed to create io_uring accept thread(%s)", label, strerror(code));
+    terrno = TAOS_SYSTEM_ERROR(code);
+    taosCloseSocket(pServerObj->fd);
+    pServerObj->fd = -1;
+    taosCleanUpUringServer(pServerObj);
+    return NULL;
+  }
+
+  tDebug("%s io_uring server is initialized, ip:0x%x port:%hu numOfThreads:%d", label, ip, port, numOfThreads);
+  return pServerObj;
+}
+
+void taosStopUringServer(void *handle) {
+  SServerObj *pServerObj = handle;
+
+  if (pServerObj == NULL) return;
+  pServerObj->stop = 1;
+
+  if (pServerObj->fd >= 0) {
+    shutdown(pServerObj->fd, SHUT_RD);
+  }
+  if (taosCheckPthreadValid(pServerObj->thread)) {
+    if (taosComparePthread(pServerObj->thread, pthread_self())) {
+      pthread_detach(pthread_self());
+    } else {
+      pthread_join(pServerObj->thread, NULL);
+    }
+  }
+
+  tDebug("%s io_uring server is stopped", pServerObj->label);
+}
+
+void taosCleanUpUringServer(void *handle) {
+  SServerObj *pServerObj = handle;
+  if (pServerObj == NULL) return;
+
+  for (int i = 0; i < pServerObj->numOfThreads; ++i) {
+    taosStopUringThread(pServerObj->pThreadObj[i]);
+  }
+
+  tDebug("%s io_uring server is cleaned up", pServerObj->label);
+
+  tfree(pServerObj->pThreadObj);
+  tfree(pServerObj);
+}
+
+static void *taosAcceptUringConnection(void *arg) {
+  SOCKET             connFd = -1;
+  struct sockaddr_in caddr;
+  int                threadId = 0;
+  SThreadObj        *pThreadObj;
+  SServerObj        *pServerObj;
+
+  pServerObj = (SServerObj *)arg;
+  tDebug("%s io_uring server is ready, ip:0x%x:%hu", pServerObj->label, pServerObj->ip, pServerObj->port);
+  setThreadName("acceptUringConn");
+
+  while (1) {
+    socklen_t addrlen = sizeof(caddr);
+    connFd = accept(pServerObj->fd, (struct sockaddr *)&caddr, &addrlen);
+    if (pServerObj->stop) {
+      tDebug("%s io_uring server stop accepting new connections", pServerObj->label);
+      break;
+    }
+
+    if (connFd == -1) {
+      if (errno == EINVAL) {
+        tDebug("%s io_uring server stop accepting new connections, exiting", pServerObj->label);
+        break;
+      }
+
+      tError("%s io_uring accept failure(%s)", pServerObj->label, strerror(errno));
+      continue;
+    }
+
+    taosKeepTcpAlive(connFd);
+
+    // pick up the thread to handle this connection
+    pThreadObj = pServerObj->pThreadObj[threadId];
+
+    SFdObj *pFdObj = taosMallocFdObj(pThreadObj, connFd);
+    if (pFdObj == NULL) {
+      taosCloseSocket(connFd);
+      tError("%s failed to malloc FdObj(%s) for connection from:%s:%hu", pServerObj->label, strerror(errno),
+             taosInetNtoa(caddr.sin_addr), htons(caddr.sin_port));
+    } else {
+      pFdObj->ip = caddr.sin_addr.s_addr;
+      pFdObj->port = htons(caddr.sin_port);
+      if (taosArmUringRecv(pFdObj) == 0) {
+        tDebug("%s new io_uring connection from %s:%hu, fd:%d FD:%p numOfFds:%d", pServerObj->label,
+               taosInetNtoa(caddr.sin_addr), pFdObj->port, connFd, pFdObj, pThreadObj->numOfFds);
+      } else {
+        // no one knows the connection yet, it is closed quietly
+        pFdObj->closedByApp = 1;
+        taosReportBrokenLink(pFdObj);
+      }
+    }
+
+    // pick up next thread for next connection
+    threadId++;
+    threadId = threadId % pServerObj->numOfThreads;
+  }
+
+  taosCloseSocket(pServerObj->fd);
+  return NULL;
+}
+
+void *taosInitUringClient(uint32_t ip, uint16_t port, char *label, int numOfThreads, void *fp, void *shandle) {
+  SClientObj *pClientObj = (SClientObj *)calloc(1, sizeof(SClientObj));
+  if (pClientObj == NULL) {
+    tError("io_uring:%s no enough memory", label);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return NULL;
+  }
+
+  tstrncpy(pClientObj->label, label, sizeof(pClientObj->label));
+  pClientObj->pThreadObj = (SThreadObj **)calloc(numOfThreads, sizeof(SThreadObj *));
+  if (pClientObj->pThreadObj == NULL) {
+    tError("io_uring:%s no enough memory", label);
+    tfree(pClientObj);
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return NULL;
+  }
+
+  for (int i = 0; i < numOfThreads; ++i) {
+    pClientObj->pThreadObj[i] = taosInitUringThread(label, ip, fp, shandle, i);
+    if (pClientObj->pThreadObj[i] == NULL) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      taosCleanUpUringClient(pClientObj);
+      return NULL;
+    }
+    pClientObj->numOfThreads++;
+  }
+
+  return pClientObj;
+}
+
+void taosStopUringClient(void *chandle) {
+  SClientObj *pClientObj = chandle;
+
+  if (pClientObj == NULL) return;
+
+  tDebug("%s io_uring client is stopped", pClientObj->label);
+}
+
+void taosCleanUpUringClient(void *chandle) {
+  SClientObj *pClientObj = chandle;
+  if (pClientObj == NULL) return;
+  for (int i = 0; i < pClientObj->numOfThreads; ++i) {
+    taosStopUringThread(pClientObj->pThreadObj[i]);
+  }
+
+  tDebug("%s io_uring client is cleaned up", pClientObj->label);
+  tfree(pClientObj->pThreadObj);
+  tfree(pClientObj);
+}
+
+void *taosOpenUringClientConnection(void *shandle, void *thandle, uint32_t ip, uint16_t port) {
+  SClientObj *pClientObj = shandle;
+  int32_t     index = atomic_load_32(&pClientObj->index) % pClientObj->numOfThreads;
+  atomic_store_32(&pClientObj->index, index + 1);
+  SThreadObj *pThreadObj = pClientObj->pThreadObj[index];
+
+  SOCKET fd = taosOpenTcpClientSocket(ip, port, pThreadObj->ip);
+  if (fd <= 0) return NULL;
+
+  SFdObj *pFdObj = taosMallocFdObj(pThreadObj, fd);
+
+  if (pFdObj) {
+    pFdObj->thandle = thandle;
+    pFdObj->port = port;
+    pFdObj->ip = ip;
+    if (taosArmUringRecv(pFdObj) < 0) {
+      // no one knows the connection yet, it is closed quietly
+      pFdObj->closedByApp = 1;
+      taosReportBrokenLink(pFdObj);
+      return NULL;
+    }
+    tDebug("%s %p io_uring connection to 0x%x:%hu is created, FD:%p numOfFds:%d", pThreadObj->label, thandle, ip,
+           port, pFdObj, pThreadObj->numOfFds);
+  } else {
+    tError("%s failed to malloc client FdObj(%s)", pThreadObj->label, strerror(errno));
+    taosCloseSocket(fd);
+  }
+
+  return pFdObj;
+}
+
+void taosCloseUringConnection(void *chandle) {
+  SFdObj *pFdObj = chandle;
+  if (pFdObj == NULL || pFdObj->signature != pFdObj) return;
+
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+  tDebug("%s %p io_uring connection will be closed, FD:%p", pThreadObj->label, pFdObj->thandle, pFdObj);
+
+  pFdObj->closedByApp = 1;
+  shutdown(pFdObj->fd, SHUT_WR);
+}
+
+// A message is sent by one or more IORING_OP_SEND, each submitted together with the entries other senders have
+// queued meanwhile. The data thread can not wait for its own completions, so it sends by a blocking write.
+int taosSendUringData(uint32_t ip, uint16_t port, void *data, int len, void *chandle) {
+  SFdObj *pFdObj = chandle;
+  if (pFdObj == NULL || pFdObj->signature != pFdObj) return -1;
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+
+  if (taosComparePthread(pThreadObj->thread, pthread_self())) {
+    int ret = taosWriteMsg(pFdObj->fd, data, len);
+    tTrace("%s %p io_uring data is written, FD:%p fd:%d bytes:%d", pThreadObj->label, pFdObj->thandle, pFdObj,
+           pFdObj->fd, ret);
+    return ret;
+  }
+
+  atomic_add_fetch_32(&pFdObj->refCount, 1);
+  pthread_mutex_lock(&pFdObj->smutex);
+
+  int32_t sentLen = 0;
+  while (sentLen < len) {
+    pthread_mutex_lock(&pThreadObj->sqMutex);
+    struct io_uring_sqe *sqe = taosGetUringSqe(pThreadObj);
+    if (sqe == NULL) {
+      pthread_mutex_unlock(&pThreadObj->sqMutex);
+      break;
+    }
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = pFdObj->fd;
+    sqe->addr = (uint64_t)(uintptr_t)((char *)data + sentLen);
+    sqe->len = len - sentLen;
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    sqe->user_data = (uint64_t)(uintptr_t)pFdObj | RPC_URING_SEND;
+    taosSubmitUringSqe(pThreadObj);
+    pthread_mutex_unlock(&pThreadObj->sqMutex);
+
+    tsem_wait(&pFdObj->sendSem);
+    if (pFdObj->sendRet <= 0) break;
+    sentLen += pFdObj->sendRet;
+  }
+
+  pthread_mutex_unlock(&pFdObj->smutex);
+  tTrace("%s %p io_uring data is sent, FD:%p fd:%d bytes:%d", pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd,
+         sentLen);
+  taosDecFdObjRef(pFdObj);
+
+  return (sentLen == len) ? len : -1;
+}
+
+// One receive keeps delivering what arrives on the connection into the provided buffers, until it fails or the
+// connection is closed. The kernel cancels the requests of a thread when it exits, so the receive is always submitted
+// by the data thread itself, which other threads ask for by a NOP. Return -1 if the ring takes no more entries.
+static int taosArmUringRecv(SFdObj *pFdObj) {
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+  bool        inThread = taosComparePthread(pThreadObj->thread, pthread_self());
+
+  pthread_mutex_lock(&pThreadObj->sqMutex);
+  struct io_uring_sqe *sqe = taosGetUringSqe(pThreadObj);
+  if (sqe == NULL) {
+    pthread_mutex_unlock(&pThreadObj->sqMutex);
+    tError("%s %p failed to arm io_uring recv, FD:%p fd:%d", pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd);
+    return -1;
+  }
+
+  if (inThread) {
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = pFdObj->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = RPC_URING_BGID;
+    sqe->user_data = (uint64_t)(uintptr_t)pFdObj;
+  } else {
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = (uint64_t)(uintptr_t)pFdObj | RPC_URING_ARM;
+  }
+  taosSubmitUringSqe(pThreadObj);
+  pthread_mutex_unlock(&pThreadObj->sqMutex);
+
+  return 0;
+}
+
+// Pass data received on a connection to the upper layer message by message. Return -1 if the connection shall be
+// closed.
+static int taosProcessUringMsg(SFdObj *pFdObj, char *data, int32_t dataLen) {
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+
+  while (dataLen > 0) {
+    if (pFdObj->buffer == NULL) {
+      int32_t len = MIN(dataLen, (int32_t)sizeof(SRpcHead) - pFdObj->headLen);
+      memcpy((char *)&pFdObj->head + pFdObj->headLen, data, len);
+      pFdObj->headLen += len;
+      data += len;
+      dataLen -= len;
+      if (pFdObj->headLen < sizeof(SRpcHead)) break;
+
+      pFdObj->msgLen = (int32_t)htonl((uint32_t)pFdObj->head.msgLen);
+      if (pFdObj->msgLen < (int32_t)sizeof(SRpcHead)) {
+        tError("%s %p invalid msgLen:%d, FD:%p", pThreadObj->label, pFdObj->thandle, pFdObj->msgLen, pFdObj);
+        return -1;
+      }
+
+      pFdObj->buffer = rpcBufMalloc(pFdObj->msgLen + tsRpcOverhead);
+      if (pFdObj->buffer == NULL) {
+        tError("%s %p io_uring malloc(size:%d) fail", pThreadObj->label, pFdObj->thandle, pFdObj->msgLen);
+        return -1;
+      }
+
+      memcpy(pFdObj->buffer + tsRpcOverhead, &pFdObj->head, sizeof(SRpcHead));
+      pFdObj->readLen = sizeof(SRpcHead);
+      pFdObj->headLen = 0;
+    }
+
+    char   *msg = pFdObj->buffer + tsRpcOverhead;
+    int32_t len = MIN(dataLen, pFdObj->msgLen - pFdObj->readLen);
+    memcpy(msg + pFdObj->readLen, data, len);
+    pFdObj->readLen += len;
+    data += len;
+    dataLen -= len;
+    if (pFdObj->readLen < pFdObj->msgLen) break;
+
+    pFdObj->buffer = NULL;
+    if (pFdObj->closedByApp) {
+      rpcBufFree(msg - tsRpcOverhead);
+      continue;
+    }
+
+    SRecvInfo recvInfo;
+    recvInfo.msg = msg;
+    recvInfo.msgLen = pFdObj->msgLen;
+    recvInfo.ip = pFdObj->ip;
+    recvInfo.port = pFdObj->port;
+    recvInfo.shandle = pThreadObj->shandle;
+    recvInfo.thandle = pFdObj->thandle;
+    recvInfo.chandle = pFdObj;
+    recvInfo.connType = RPC_CONN_TCP;
+
+    pFdObj->thandle = (*(pThreadObj->processData))(&recvInfo);
+    if (pFdObj->thandle == NULL) {
+      pFdObj->closedByApp = 1;
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// The receive of the connection is over, notify the upper layer unless the App has closed it
+static void taosReportBrokenLink(SFdObj *pFdObj) {
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+
+  if (pFdObj->closedByApp == 0) {
+    shutdown(pFdObj->fd, SHUT_WR);
+
+    SRecvInfo recvInfo;
+    recvInfo.msg = NULL;
+    recvInfo.msgLen = 0;
+    recvInfo.ip = 0;
+    recvInfo.port = 0;
+    recvInfo.shandle = pThreadObj->shandle;
+    recvInfo.thandle = pFdObj->thandle;
+    recvInfo.chandle = NULL;
+    recvInfo.connType = RPC_CONN_TCP;
+    (*(pThreadObj->processData))(&recvInfo);
+  }
+
+  pthread_mutex_lock(&pThreadObj->mutex);
+
+  pFdObj->signature = NULL;
+  pThreadObj->numOfFds--;
+  if (pFdObj->prev) {
+    (pFdObj->prev)->next = pFdObj->next;
+  } else {
+    pThreadObj->pHead = pFdObj->next;
+  }
+
+  if (pFdObj->next) {
+    (pFdObj->next)->prev = pFdObj->prev;
+  }
+
+  pthread_mutex_unlock(&pThreadObj->mutex);
+
+  tDebug("%s %p io_uring connection is closed, FD:%p fd:%d numOfFds:%d", pThreadObj->label, pFdObj->thandle, pFdObj,
+         pFdObj->fd, pThreadObj->numOfFds);
+
+  taosDecFdObjRef(pFdObj);
+}
+
+static void taosProcessUringRecv(SFdObj *pFdObj, int32_t res, uint32_t flags) {
+  SThreadObj *pThreadObj = pFdObj->pThreadObj;
+  int         code = 0;
+
+  if (res > 0) {
+    uint16_t bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+    code = taosProcessUringMsg(pFdObj, pThreadObj->bufs + (size_t)bid * RPC_URING_BUF_SIZE, res);
+    taosProvideUringBuf(pThreadObj, bid);
+  } else if (flags & IORING_CQE_F_BUFFER) {
+    taosProvideUringBuf(pThreadObj, (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT));
+  }
+
+  if (code < 0) {
+    // ends the receive, whose last completion closes the connection
+    shutdown(pFdObj->fd, SHUT_RDWR);
+  }
+
+  if (flags & IORING_CQE_F_MORE) return;
+
+  // the receive may stop while the connection is fine, e.g. all buffers are in use
+  if (res > 0 || res == -ENOBUFS) {
+    if (code == 0 && !pThreadObj->stop && taosArmUringRecv(pFdObj) == 0) return;
+  } else if (res < 0) {
+    tDebug("%s %p io_uring recv error, FD:%p fd:%d reason:%s", pThreadObj->label, pFdObj->thandle, pFdObj, pFdObj->fd,
+           strerror(-res));
+  }
+
+  taosReportBrokenLink(pFdObj);
+}
+
+static void taosProcessUringCqes(SThreadObj *pThreadObj) {
+  uint32_t head = *pThreadObj->cqHead;
+
+  while (head != __atomic_load_n(pThreadObj->cqTail, __ATOMIC_ACQUIRE)) {
+    struct io_uring_cqe *cqe = &pThreadObj->cqes[head & *pThreadObj->cqMask];
+    uint64_t             userData = cqe->user_data;
+    int32_t              res = cqe->res;
+    uint32_t             flags = cqe->flags;
+    __atomic_store_n(pThreadObj->cqHead, ++head, __ATOMIC_RELEASE);
+
+    if (userData == RPC_URING_WAKE) continue;
+
+    SFdObj *pFdObj = (SFdObj *)(uintptr_t)(userData & ~(uint64_t)RPC_URING_TAGS);
+    if (userData & RPC_URING_SEND) {
+      pFdObj->sendRet = res;
+      tsem_post(&pFdObj->sendSem);
+    } else if (userData & RPC_URING_ARM) {
+      if (taosArmUringRecv(pFdObj) < 0) taosReportBrokenLink(pFdObj);
+    } else {
+      taosProcessUringRecv(pFdObj, res, flags);
+    }
+  }
+}
+
+// The connections whose receive the broken ring dropped can't get one any more
+static void taosReportFailedRecvs(SThreadObj *pThreadObj) {
+  pthread_mutex_lock(&pThreadObj->sqMutex);
+  SFdObj *pFdObj = pThreadObj->pFailed;
+  pThreadObj->pFailed = NULL;
+  pthread_mutex_unlock(&pThreadObj->sqMutex);
+
+  while (pFdObj) {
+    SFdObj *pNext = pFdObj->nextFailed;
+    taosReportBrokenLink(pFdObj);
+    pFdObj = pNext;
+  }
+}
+
+static void *taosProcessUringData(void *param) {
+  SThreadObj *pThreadObj = param;
+  char        name[16];
+
+  memset(name, 0, sizeof(name));
+  snprintf(name, 16, "%s-uring", pThreadObj->label);
+  setThreadName(name);
+
+  while (1) {
+    // the entries the kernel could not take when queued
+    uint32_t tail = __atomic_load_n(pThreadObj->sqTail, __ATOMIC_ACQUIRE);
+    if (tail != __atomic_load_n(pThreadObj->sqHead, __ATOMIC_ACQUIRE)) {
+      pthread_mutex_lock(&pThreadObj->sqMutex);
+      taosFlushUringSqNow(pThreadObj);
+      pthread_mutex_unlock(&pThreadObj->sqMutex);
+    }
+
+    if (taosWaitUring(pThreadObj->ringFd) < 0) {
+      tError("%s failed to wait for io_uring(%s)", pThreadObj->label, strerror(errno));
+    }
+
+    taosProcessUringCqes(pThreadObj);
+    taosReportFailedRecvs(pThreadObj);
+    if (pThreadObj->stop) {
+      tDebug("%s io_uring thread get stop event, exiting...", pThreadObj->label);
+      break;
+    }
+  }
+
+  // end the receives, their last completions close the connections
+  pthread_mutex_lock(&pThreadObj->mutex);
+  for (SFdObj *pFdObj = pThreadObj->pHead; pFdObj; pFdObj = pFdObj->next) {
+    shutdown(pFdObj->fd, SHUT_RDWR);
+  }
+  pthread_mutex_unlock(&pThreadObj->mutex);
+
+  while (pThreadObj->pHead) {
+    if (taosWaitUring(pThreadObj->ringFd) < 0) {
+      tError("%s failed to wait for io_uring(%s)", pThreadObj->label, strerror(errno));
+      break;
+    }
+    taosProcessUringCqes(pThreadObj);
+    taosReportFailedRecvs(pThreadObj);
+  }
+
+  // the thread waking it up may not be back from io_uring_enter yet
+  pthread_mutex_lock(&pThreadObj->sqMutex);
+  while (pThreadObj->submitting) {
+    pthread_cond_wait(&pThreadObj->sqCond, &pThreadObj->sqMutex);
+  }
+  pthread_mutex_unlock(&pThreadObj->sqMutex);
+
+  taosCloseUring(pThreadObj);
+  pthread_mutex_destroy(&pThreadObj->mutex);
+  pthread_mutex_destroy(&pThreadObj->sqMutex);
+  pthread_cond_destroy(&pThreadObj->sqCond);
+  tDebug("%s io_uring thread exits ...", pThreadObj->label);
+  tfree(pThreadObj);
+
+  return NULL;
+}
+
+static SFdObj *taosMallocFdObj(SThreadObj *pThreadObj, SOCKET fd) {
+  SFdObj *pFdObj = (SFdObj *)calloc(sizeof(SFdObj), 1);
+  if (pFdObj == NULL) {
+    return NULL;
+  }
+
+  pFdObj->closedByApp = 0;
+  pFdObj->fd = fd;
+  pFdObj->pThreadObj = pThreadObj;
+  pFdObj->signature = pFdObj;
+  pFdObj->refCount = 1;
+  pthread_mutex_init(&pFdObj->smutex, NULL);
+  tsem_init(&pFdObj->sendSem, 0, 0);
+
+  pthread_mutex_lock(&(pThreadObj->mutex));
+  pFdObj->next = pThreadObj->pHead;
+  if (pThreadObj->pHead) (pThreadObj->pHead)->prev = pFdObj;
+  pThreadObj->pHead = pFdObj;
+  pThreadObj->numOfFds++;
+  pthread_mutex_unlock(&(pThreadObj->mutex));
+
+  return pFdObj;
+}
+
+// The socket is closed once the receive is over and no sender uses it
+static void taosDecFdObjRef(SFdObj *pFdObj) {
+  if (atomic_sub_fetch_32(&pFdObj->refCount, 1) > 0) return;
+
+  taosCloseSocket(pFdObj->fd);
+  if (pFdObj->buffer) rpcBufFree(pFdObj->buffer);
+  pthread_mutex_destroy(&pFdObj->smutex);
+  tsem_destroy(&pFdObj->sendSem);
+  tfree(pFdObj);
+}
+
+#else
+
+bool taosCheckUring(void) { return false; }
+
+void *taosInitUringServer(uint32_t ip, uint16_t port, char *label, int numOfThreads, void *fp, void *shandle) {
+  terrno = TSDB_CODE_COM_OPS_NOT_SUPPORT;
+  return NULL;
+}
+void taosStopUringServer(void *param) {}
+void taosCleanUpUringServer(void *param) {}
+
+void *taosInitUringClient(uint32_t ip, uint16_t port, char *label, int num, void *fp, void *shandle) {
+  terrno = TSDB_CODE_COM_OPS_NOT_SUPPORT;
+  return NULL;
+}
+void  taosStopUringClient(void *chandle) {}
+void  taosCleanUpUringClient(void *chandle) {}
+void *taosOpenUringClientConnection(void *shandle, void *thandle, uint32_t ip, uint16_t port) { return NULL; }
+
+void taosCloseUringConnection(void *chandle) {}
+int  taosSendUringData(uint32_t ip, uint16_t port, void *data, int len, void *chandle) { return -1; }
+
+#endif
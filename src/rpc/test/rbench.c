@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Request throughput of the TCP backends of RPC on loopback. Each backend runs in a child process with a server and a
+// client, and the client threads send requests one after another. Usage: rbench [-p port] [-t threads] [-a threads]
+// [-n requests] [-m msgSize]
+
+#include "os.h"
+#include <sys/wait.h>
+#include "tutil.h"
+#include "tglobal.h"
+#include "tqueue.h"
+#include "rpcLog.h"
+#include "rpcUring.h"
+#include "trpc.h"
+
+typedef struct {
+  SRpcEpSet epSet;
+  void     *pRpc;
+  int       numOfReqs;
+  int       msgSize;
+  tsem_t    rspSem;
+  pthread_t thread;
+} SBenchInfo;
+
+static taos_queue qhandle;
+static taos_qset  qset;
+static int        msgSize = 128;
+
+static void processRequest(SRpcMsg *pMsg, SRpcEpSet *pEpSet) {
+  SRpcMsg *pTemp = taosAllocateQitem(sizeof(SRpcMsg));
+  memcpy(pTemp, pMsg, sizeof(SRpcMsg));
+  taosWriteQitem(qhandle, TAOS_QTYPE_RPC, pTemp);
+}
+
+// Respond from a worker thread, as a dnode does
+static void *processRequests(void *param) {
+  taos_qall qall = taosAllocateQall();
+  SRpcMsg  *pMsg;
+  void     *ahandle;
+  int       type;
+
+  while (1) {
+    int numOfMsgs = taosReadAllQitemsFromQset(qset, qall, &ahandle);
+    if (numOfMsgs <= 0) break;
+
+    for (int i = 0; i < numOfMsgs; ++i) {
+      taosGetQitem(qall, &type, (void **)&pMsg);
+      rpcFreeCont(pMsg->pCont);
+
+      SRpcMsg rpcMsg = {0};
+      rpcMsg.pCont = rpcMallocCont(msgSize);
+      rpcMsg.contLen = msgSize;
+      rpcMsg.handle = pMsg->handle;
+      rpcSendResponse(&rpcMsg);
+      taosFreeQitem(pMsg);
+    }
+  }
+
+  taosFreeQall(qall);
+  return NULL;
+}
+
+static void processResponse(SRpcMsg *pMsg, SRpcEpSet *pEpSet) {
+  SBenchInfo *pInfo = pMsg->ahandle;
+  if (pMsg->code != 0) printf("request failed, code:0x%x\n", pMsg->code);
+  rpcFreeCont(pMsg->pCont);
+  tsem_post(&pInfo->rspSem);
+}
+
+static void *sendRequests(void *param) {
+  SBenchInfo *pInfo = param;
+
+  for (int i = 0; i < pInfo->numOfReqs; ++i) {
+    SRpcMsg rpcMsg = {0};
+    rpcMsg.pCont = rpcMallocCont(pInfo->msgSize);
+    rpcMsg.contLen = pInfo->msgSize;
+    rpcMsg.ahandle = pInfo;
+    rpcMsg.msgType = 1;
+    rpcSendRequest(pInfo->pRpc, &pInfo->epSet, &rpcMsg, NULL);
+    tsem_wait(&pInfo->rspSem);
+  }
+
+  return NULL;
+}
+
+static int runBench(const char *backend, uint16_t port, int rpcThreads, int appThreads, int numOfReqs) {
+  tsRpcForceTcp = 1;
+  tsRpcIoUring = (strcmp(backend, "io_uring") == 0);
+  if (tsRpcIoUring && !taosCheckUring()) {
+    printf("%-8s is not supported\n", backend);
+    return 0;
+  }
+  rpcInit();
+
+  SRpcInit rpcInit;
+  memset(&rpcInit, 0, sizeof(rpcInit));
+  rpcInit.localPort = port;
+  rpcInit.label = "SER";
+  rpcInit.numOfThreads = rpcThreads;
+  rpcInit.cfp = processRequest;
+  rpcInit.sessions = appThreads * 2 + 10;
+  rpcInit.idleTime = tsShellActivityTimer * 1500;
+  rpcInit.connType = TAOS_CONN_SERVER;
+
+  qhandle = taosOpenQueue();
+  qset = taosOpenQset();
+  taosAddIntoQset(qset, qhandle, NULL);
+
+  void *pServer = rpcOpen(&rpcInit);
+  if (pServer == NULL) {
+    printf("failed to start server, port:%d\n", port);
+    return -1;
+  }
+
+  pthread_t worker;
+  pthread_create(&worker, NULL, processRequests, NULL);
+
+  memset(&rpcInit, 0, sizeof(rpcInit));
+  rpcInit.label = "APP";
+  rpcInit.numOfThreads = rpcThreads;
+  rpcInit.cfp = processResponse;
+  rpcInit.sessions = appThreads * 2 + 10;
+  rpcInit.idleTime = tsShellActivityTimer * 1000;
+  rpcInit.user = "michael";
+  rpcInit.connType = TAOS_CONN_CLIENT;
+
+  void *pClient = rpcOpen(&rpcInit);
+  if (pClient == NULL) {
+    printf("failed to start client\n");
+    return -1;
+  }
+
+  SBenchInfo *pInfo = calloc(appThreads, sizeof(SBenchInfo));
+  for (int i = 0; i < appThreads; ++i) {
+    pInfo[i].epSet.inUse = 0;
+    pInfo[i].epSet.numOfEps = 1;
+    pInfo[i].epSet.port[0] = port;
+    tstrncpy(pInfo[i].epSet.fqdn[0], "127.0.0.1", sizeof(pInfo[i].epSet.fqdn[0]));
+    pInfo[i].pRpc = pClient;
+    pInfo[i].numOfReqs = numOfReqs;
+    pInfo[i].msgSize = msgSize;
+    tsem_init(&pInfo[i].rspSem, 0, 0);
+  }
+
+  int64_t st = taosGetTimestampUs();
+  for (int i = 0; i < appThreads; ++i) {
+    pthread_create(&pInfo[i].thread, NULL, sendRequests, pInfo + i);
+  }
+  for (int i = 0; i < appThreads; ++i) {
+    pthread_join(pInfo[i].thread, NULL);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  int64_t total = (int64_t)appThreads * numOfReqs;
+  printf("%-8s rpcThreads:%d appThreads:%d msgSize:%d requests:%" PRId64 " elapsed:%" PRId64
+         "us throughput:%.0f req/s\n",
+         backend, rpcThreads, appThreads, msgSize, total, el, (double)total * 1000000 / (el > 0 ? el : 1));
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int port = 7300;
+  int rpcThreads = 1;
+  int appThreads = 8;
+  int numOfReqs = 20000;
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      port = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      rpcThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-a") == 0 && i < argc - 1) {
+      appThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfReqs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
+      msgSize = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-p port]: first port number, default is:%d\n", port);
+      printf("  [-t threads]: number of rpc threads, default is:%d\n", rpcThreads);
+      printf("  [-a threads]: number of app threads, default is:%d\n", appThreads);
+      printf("  [-n requests]: number of requests per thread, default is:%d\n", numOfReqs);
+      printf("  [-m msgSize]: message body size, default is:%d\n", msgSize);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  taosBlockSIGPIPE();
+  rpcDebugFlag = 131;
+  tsAsyncLog = 0;  // the children have no log thread
+  taosInitLog("rbench.log", 100000, 10);
+
+  const char *backends[] = {"epoll", "io_uring"};
+  for (int i = 0; i < tListLen(backends); ++i) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+      int code = runBench(backends[i], (uint16_t)(port + i), rpcThreads, appThreads, numOfReqs);
+      fflush(stdout);
+      _exit(code == 0 ? 0 : 1);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+  }
+
+  return 0;
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "os.h"
+
+extern "C" {
+#include "tglobal.h"
+#include "rpcBuf.h"
+}
+
+namespace {
+
+// the pool of the size, each of the 9 classes may keep a ninth of it
+void initPool(int32_t sizeInMB) {
+  rpcBufCleanup();
+  tsRpcBufPoolSize = sizeInMB;
+  rpcBufInit();
+}
+
+void fill(void *ptr, int32_t size) {
+  for (int32_t i = 0; i < size; ++i) ((uint8_t *)ptr)[i] = (uint8_t)(i * 7 + 1);
+}
+
+bool check(void *ptr, int32_t size) {
+  for (int32_t i = 0; i < size; ++i) {
+    if (((uint8_t *)ptr)[i] != (uint8_t)(i * 7 + 1)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(rpcBufTest, reuse_in_class) {
+  initPool(9);
+
+  void *p1 = rpcBufMalloc(300);
+  ASSERT_TRUE(p1 != NULL);
+  EXPECT_EQ(rpcBufFreeNum(300), 0);
+
+  rpcBufFree(p1);
+  EXPECT_EQ(rpcBufFreeNum(300), 1);
+
+  // any size of the same class (257 to 512 bytes) takes the buffer freed
+  void *p2 = rpcBufMalloc(512);
+  EXPECT_EQ(p2, p1);
+  EXPECT_EQ(rpcBufFreeNum(300), 0);
+
+  // the buffer is as large as its class
+  fill(p2, 512);
+  EXPECT_EQ(rpcBufRealloc(p2, 512), p2);
+  EXPECT_TRUE(check(p2, 512));
+
+  // a buffer of another class is not taken
+  rpcBufFree(p2);
+  void *p3 = rpcBufCalloc(100);
+  EXPECT_NE(p3, p1);
+  EXPECT_EQ(rpcBufFreeNum(300), 1);
+
+  rpcBufFree(p3);
+  rpcBufCleanup();
+}
+
+TEST(rpcBufTest, no_class_over_64KB) {
+  initPool(9);
+
+  int32_t size = 64 * 1024 + 1;
+  EXPECT_EQ(rpcBufFreeNum(64 * 1024), 0);
+  EXPECT_EQ(rpcBufFreeNum(size), -1);
+
+  void *p = rpcBufMalloc(size);
+  ASSERT_TRUE(p != NULL);
+  fill(p, size);
+
+  // the buffer is exactly as large as asked
+  EXPECT_EQ(rpcBufRealloc(p, size), p);
+  void *q = rpcBufRealloc(p, size + 1);
+  ASSERT_TRUE(q != NULL);
+  EXPECT_NE(q, p);
+  EXPECT_TRUE(check(q, size));
+
+  // it goes back to malloc, no class keeps it
+  rpcBufFree(q);
+  EXPECT_EQ(rpcBufFreeNum(64 * 1024), 0);
+  EXPECT_EQ(rpcBufFreeNum(size), -1);
+
+  rpcBufCleanup();
+}
+
+TEST(rpcBufTest, realloc_across_classes) {
+  initPool(9);
+
+  void *p = rpcBufMalloc(200);
+  fill(p, 200);
+
+  void *q = rpcBufRealloc(p, 1000);
+  ASSERT_TRUE(q != NULL);
+  EXPECT_NE(q, p);
+  EXPECT_TRUE(check(q, 200));
+  EXPECT_EQ(rpcBufFreeNum(200), 1);  // the buffer of the smaller class is freed into its class
+  EXPECT_EQ(rpcBufFreeNum(1000), 0);
+
+  fill(q, 1024);
+  void *r = rpcBufRealloc(q, 100 * 1024);
+  ASSERT_TRUE(r != NULL);
+  EXPECT_TRUE(check(r, 1024));
+  EXPECT_EQ(rpcBufFreeNum(1000), 1);
+
+  // shrinking keeps the buffer
+  EXPECT_EQ(rpcBufRealloc(r, 10), r);
+
+  // realloc of NULL allocates
+  void *s = rpcBufRealloc(NULL, 1000);
+  EXPECT_EQ(s, q);
+  EXPECT_EQ(rpcBufFreeNum(1000), 0);
+
+  rpcBufFree(r);
+  rpcBufFree(s);
+  rpcBufCleanup();
+}
+
+TEST(rpcBufTest, pool_cap) {
+  // a ninth of 1MB holds one buffer of 64KB, and 455 of 256 bytes
+  initPool(1);
+
+  const int32_t num = 500;
+  void *        bufs[num];
+
+  for (int32_t i = 0; i < 3; ++i) bufs[i] = rpcBufMalloc(64 * 1024);
+  for (int32_t i = 0; i < 3; ++i) rpcBufFree(bufs[i]);
+  EXPECT_EQ(rpcBufFreeNum(64 * 1024), 1);
+
+  for (int32_t i = 0; i < num; ++i) bufs[i] = rpcBufMalloc(256);
+  for (int32_t i = 0; i < num; ++i) rpcBufFree(bufs[i]);
+  EXPECT_EQ(rpcBufFreeNum(256), 1024 * 1024 / 9 / 256);
+
+  // no buffers are kept without a pool
+  initPool(0);
+  void *p = rpcBufMalloc(256);
+  rpcBufFree(p);
+  EXPECT_EQ(rpcBufFreeNum(256), 0);
+
+  rpcBufCleanup();
+}
@@ -0,0 +1,345 @@
+#include <gtest/gtest.h>
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <sys/syscall.h>
+#include <vector>
+
+#include "os.h"
+
+extern "C" {
+#include "tglobal.h"
+#include "tsocket.h"
+#include "ttimer.h"
+#include "trpc.h"
+#include "rpcHead.h"
+#include "rpcBuf.h"
+#include "rpcUring.h"
+}
+
+namespace {
+
+// the failures of io_uring are injected by the syscall below
+volatile bool failSetup = false;   // io_uring_setup fails, as on a kernel without io_uring
+volatile bool failSubmit = false;  // io_uring_enter fails to submit, the ring is broken
+int32_t       setupCalls = 0;
+
+const uint16_t port = 7410;
+
+struct SRecvMsg {
+  void             *thandle;
+  std::vector<char> msg;  // empty for a broken link
+};
+
+pthread_mutex_t       recvMutex = PTHREAD_MUTEX_INITIALIZER;
+std::vector<SRecvMsg> recvMsgs;
+
+void *processData(SRecvInfo *pRecv) {
+  SRecvMsg recv;
+  recv.thandle = pRecv->thandle;
+  if (pRecv->msg != NULL) {
+    char *msg = (char *)pRecv->msg;
+    recv.msg.assign(msg, msg + pRecv->msgLen);
+    rpcBufFree(msg - tsRpcOverhead);
+  }
+
+  pthread_mutex_lock(&recvMutex);
+  recvMsgs.push_back(recv);
+  pthread_mutex_unlock(&recvMutex);
+
+  // the thandle of a server connection is set by the first message
+  return (pRecv->thandle != NULL) ? pRecv->thandle : (void *)1;
+}
+
+size_t numOfRecvMsgs() {
+  pthread_mutex_lock(&recvMutex);
+  size_t num = recvMsgs.size();
+  pthread_mutex_unlock(&recvMutex);
+  return num;
+}
+
+bool waitForRecvMsgs(size_t num, int32_t ms = 5000) {
+  for (int32_t i = 0; i < ms && numOfRecvMsgs() < num; ++i) taosMsleep(1);
+  return numOfRecvMsgs() >= num;
+}
+
+std::vector<char> buildMsg(int32_t len, int32_t seed) {
+  std::vector<char> msg(len);
+  for (int32_t i = 0; i < len; ++i) msg[i] = (char)(i * 31 + seed);
+  ((SRpcHead *)msg.data())->msgLen = (int32_t)htonl(len);
+  return msg;
+}
+
+SOCKET connectTo(uint16_t toPort) {
+  SOCKET fd = taosOpenTcpClientSocket(inet_addr("127.0.0.1"), toPort, 0);
+  if (fd > 0) {
+    int32_t nodelay = 1;
+    taosSetSockOpt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+  }
+  return fd;
+}
+
+class RpcUringTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!taosCheckUring()) GTEST_SKIP() << "io_uring is not supported";
+
+    recvMsgs.clear();
+    rpcInit();
+  }
+
+  void TearDown() override {
+    failSubmit = false;
+    rpcCleanup();
+  }
+};
+
+}  // namespace
+
+extern "C" long int syscall(long int number, ...) __THROW {
+  static long (*realSyscall)(long, ...) = (long (*)(long, ...))dlsym(RTLD_NEXT, "syscall");
+
+  va_list ap;
+  long    a[6];
+  va_start(ap, number);
+  for (int32_t i = 0; i < 6; ++i) a[i] = va_arg(ap, long);
+  va_end(ap);
+
+  if (number == __NR_io_uring_setup) {
+    atomic_add_fetch_32(&setupCalls, 1);
+    if (failSetup) {
+      errno = ENOSYS;
+      return -1;
+    }
+  } else if (number == __NR_io_uring_enter && failSubmit && a[1] > 0) {
+    errno = EBADF;
+    return -1;
+  }
+
+  return realSyscall(number, a[0], a[1], a[2], a[3], a[4], a[5]);
+}
+
+TEST_F(RpcUringTest, reassemble_msgs) {
+  void *pServer = taosInitUringServer(0, port, (char *)"SER", 1, (void *)processData, NULL);
+  ASSERT_TRUE(pServer != NULL);
+
+  SOCKET fd = connectTo(port);
+  ASSERT_GT(fd, 0);
+
+  std::vector<std::vector<char>> msgs;
+
+  // one byte a time, the head and the body are received in pieces
+  msgs.push_back(buildMsg(200, 1));
+  for (size_t i = 0; i < msgs.back().size(); ++i) {
+    ASSERT_EQ(taosWriteMsg(fd, msgs.back().data() + i, 1), 1);
+    taosMsleep(1);
+  }
+  ASSERT_TRUE(waitForRecvMsgs(1));
+
+  // several messages in one write, the last one ends in the middle of the next write
+  std::vector<char> data;
+  msgs.push_back(buildMsg(sizeof(SRpcHead), 2));
+  msgs.push_back(buildMsg(100, 3));
+  msgs.push_back(buildMsg(5000, 4));
+  for (size_t i = 1; i < msgs.size(); ++i) data.insert(data.end(), msgs[i].begin(), msgs[i].end());
+  ASSERT_EQ(taosWriteMsg(fd, data.data(), (int)data.size() - 10), (int)data.size() - 10);
+  taosMsleep(50);
+  ASSERT_EQ(taosWriteMsg(fd, data.data() + data.size() - 10, 10), 10);
+
+  // a message over many receive buffers
+  msgs.push_back(buildMsg(4 * 1024 * 1024 + 3, 5));
+  ASSERT_EQ(taosWriteMsg(fd, msgs.back().data(), (int)msgs.back().size()), (int)msgs.back().size());
+
+  ASSERT_TRUE(waitForRecvMsgs(msgs.size()));
+  ASSERT_EQ(numOfRecvMsgs(), msgs.size());
+  for (size_t i = 0; i < msgs.size(); ++i) {
+    EXPECT_TRUE(recvMsgs[i].msg == msgs[i]) << "msg:" << i;
+  }
+
+  taosCloseSocket(fd);
+  ASSERT_TRUE(waitForRecvMsgs(msgs.size() + 1));
+  EXPECT_TRUE(recvMsgs.back().msg.empty());
+
+  taosStopUringServer(pServer);
+  taosCleanUpUringServer(pServer);
+}
+
+TEST_F(RpcUringTest, invalid_msg_len) {
+  void *pServer = taosInitUringServer(0, port + 1, (char *)"SER", 1, (void *)processData, NULL);
+  ASSERT_TRUE(pServer != NULL);
+
+  SOCKET fd = connectTo(port + 1);
+  ASSERT_GT(fd, 0);
+
+  // a message shorter than its head closes the connection
+  std::vector<char> msg = buildMsg(sizeof(SRpcHead), 1);
+  ((SRpcHead *)msg.data())->msgLen = (int32_t)htonl(4);
+  ASSERT_EQ(taosWriteMsg(fd, msg.data(), (int)msg.size()), (int)msg.size());
+
+  ASSERT_TRUE(waitForRecvMsgs(1));
+  EXPECT_TRUE(recvMsgs[0].msg.empty());
+
+  char buf[16];
+  EXPECT_LE(taosReadSocket(fd, buf, sizeof(buf)), 0);
+
+  taosCloseSocket(fd);
+  taosStopUringServer(pServer);
+  taosCleanUpUringServer(pServer);
+}
+
+TEST_F(RpcUringTest, broken_ring) {
+  SOCKET server = taosOpenTcpServerSocket(0, port + 2);
+  ASSERT_GT(server, 0);
+
+  void *pClient = taosInitUringClient(0, port + 2, (char *)"APP", 1, (void *)processData, NULL);
+  ASSERT_TRUE(pClient != NULL);
+
+  void *pConn1 = taosOpenUringClientConnection(pClient, (void *)1, inet_addr("127.0.0.1"), port + 2);
+  ASSERT_TRUE(pConn1 != NULL);
+  SOCKET fd1 = accept(server, NULL, NULL);
+  ASSERT_GT(fd1, 0);
+
+  std::vector<char> msg = buildMsg(1000, 1);
+  std::vector<char> buf(msg.size());
+  ASSERT_EQ(taosSendUringData(0, 0, msg.data(), (int)msg.size(), pConn1), (int)msg.size());
+  ASSERT_EQ(taosReadMsg(fd1, buf.data(), (int)buf.size()), (int)buf.size());
+  EXPECT_TRUE(buf == msg);
+
+  // the ring breaks while the receive of a new connection is queued, the data thread reports the connection broken
+  failSubmit = true;
+  void *pConn2 = taosOpenUringClientConnection(pClient, (void *)2, inet_addr("127.0.0.1"), port + 2);
+  ASSERT_TRUE(pConn2 != NULL);
+  SOCKET fd2 = accept(server, NULL, NULL);
+  ASSERT_TRUE(waitForRecvMsgs(1));
+  EXPECT_EQ(recvMsgs[0].thandle, (void *)2);
+  EXPECT_TRUE(recvMsgs[0].msg.empty());
+
+  // no sender waits for the broken ring, and no new connection gets a receive
+  EXPECT_EQ(taosSendUringData(0, 0, msg.data(), (int)msg.size(), pConn1), -1);
+  EXPECT_TRUE(taosOpenUringClientConnection(pClient, (void *)3, inet_addr("127.0.0.1"), port + 2) == NULL);
+
+  // the receive armed before still reports the peer closing the connection
+  taosCloseSocket(fd1);
+  ASSERT_TRUE(waitForRecvMsgs(2));
+  EXPECT_EQ(recvMsgs[1].thandle, (void *)1);
+  EXPECT_TRUE(recvMsgs[1].msg.empty());
+
+  // the data thread stops without a NOP to wake it up
+  taosStopUringClient(pClient);
+  taosCleanUpUringClient(pClient);
+  EXPECT_EQ(numOfRecvMsgs(), 2);
+
+  taosCloseSocket(fd2);
+  taosCloseSocket(server);
+}
+
+namespace {
+
+tsem_t  rspSem;
+int32_t rspCode;
+
+void processRequest(SRpcMsg *pMsg, SRpcEpSet *pEpSet) {
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.pCont = rpcMallocCont(pMsg->contLen);
+  rpcMsg.contLen = pMsg->contLen;
+  memcpy(rpcMsg.pCont, pMsg->pCont, pMsg->contLen);
+  rpcMsg.handle = pMsg->handle;
+  rpcFreeCont(pMsg->pCont);
+  rpcSendResponse(&rpcMsg);
+}
+
+void processResponse(SRpcMsg *pMsg, SRpcEpSet *pEpSet) {
+  rspCode = pMsg->code;
+  rpcFreeCont(pMsg->pCont);
+  tsem_post(&rspSem);
+}
+
+// a request over TCP to a server of the same process, return the code of the response
+int32_t sendRequest(uint16_t serverPort) {
+  // the timer module stops with its last controller and is not initialized again, one is kept for all the tests
+  static void *tmrCtrl = taosTmrInit(1, 100, 1000, "TST");
+  if (tmrCtrl == NULL) return -1;
+
+  SRpcInit rpcInit;
+  memset(&rpcInit, 0, sizeof(rpcInit));
+  rpcInit.localPort = serverPort;
+  rpcInit.label = (char *)"SER";
+  rpcInit.numOfThreads = 1;
+  rpcInit.cfp = processRequest;
+  rpcInit.sessions = 10;
+  rpcInit.idleTime = tsShellActivityTimer * 1500;
+  rpcInit.connType = TAOS_CONN_SERVER;
+  void *pServer = rpcOpen(&rpcInit);
+  if (pServer == NULL) return -1;
+
+  memset(&rpcInit, 0, sizeof(rpcInit));
+  rpcInit.label = (char *)"APP";
+  rpcInit.numOfThreads = 1;
+  rpcInit.cfp = processResponse;
+  rpcInit.sessions = 10;
+  rpcInit.idleTime = tsShellActivityTimer * 1000;
+  rpcInit.user = (char *)"michael";
+  rpcInit.connType = TAOS_CONN_CLIENT;
+  void *pClient = rpcOpen(&rpcInit);
+  if (pClient == NULL) {
+    rpcClose(pServer);
+    return -1;
+  }
+
+  SRpcEpSet epSet;
+  memset(&epSet, 0, sizeof(epSet));
+  epSet.numOfEps = 1;
+  epSet.port[0] = serverPort;
+  tstrncpy(epSet.fqdn[0], "127.0.0.1", sizeof(epSet.fqdn[0]));
+
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.pCont = rpcMallocCont(2000);
+  rpcMsg.contLen = 2000;
+  rpcMsg.msgType = 1;
+
+  tsem_init(&rspSem, 0, 0);
+  rspCode = -1;
+  rpcSendRequest(pClient, &epSet, &rpcMsg, NULL);
+  tsem_wait(&rspSem);
+  tsem_destroy(&rspSem);
+
+  rpcClose(pClient);
+  rpcClose(pServer);
+  return rspCode;
+}
+
+}  // namespace
+
+TEST(RpcBackendTest, request_by_uring) {
+  if (!taosCheckUring()) GTEST_SKIP() << "io_uring is not supported";
+
+  tsRpcForceTcp = 1;
+  tsRpcIoUring = 1;
+  rpcInit();
+
+  // a ring for each thread of the server and the client
+  setupCalls = 0;
+  EXPECT_EQ(sendRequest(port + 3), 0);
+  EXPECT_EQ(setupCalls, 2);
+
+  rpcCleanup();
+  tsRpcIoUring = 0;
+  tsRpcForceTcp = 0;
+}
+
+TEST(RpcBackendTest, fallback_to_epoll) {
+  tsRpcForceTcp = 1;
+  tsRpcIoUring = 1;
+  failSetup = true;
+  setupCalls = 0;
+
+  // io_uring is tried once, the connections are served by epoll
+  rpcInit();
+  EXPECT_EQ(setupCalls, 1);
+  EXPECT_EQ(sendRequest(port + 4), 0);
+  EXPECT_EQ(setupCalls, 1);
+
+  rpcCleanup();
+  failSetup = false;
+  tsRpcIoUring = 0;
+  tsRpcForceTcp = 0;
+}
@@ -40,6 +40,7 @@ extern "C" {
 #define SYNC_ROLE_TIMER 15000             // ms
 #define SYNC_CHECK_INTERVAL 1000          // ms
 #define SYNC_WAIT_AFTER_CHOOSE_MASTER 10  // ms
+#define SYNC_PROGRESS_INTERVAL 10000      // ms
 
 #define nodeRole    pNode->peerInfo[pNode->selfIndex]->role
 #define nodeVersion pNode->peerInfo[pNode->selfIndex]->version
@@ -59,6 +60,7 @@ typedef struct {
   int8_t    acks;
   int8_t    nacks;
   int8_t    confirmed;
+  uint8_t   peers;  // bits of the peers which have answered the forward, by index in peerInfo
   int32_t   code;
   int64_t   time;
 } SFwdInfo;
@@ -89,6 +91,9 @@ typedef struct SsyncPeer {
   int32_t  refCount;
   int8_t   isArb;
   int64_t  rid;
+  char *   fwdBuf;          // forwards accumulated to be sent by one write, if syncFwdBatchSize is set
+  int32_t  fwdLen;          // bytes accumulated in fwdBuf
+  int64_t  fwdTime;         // us, when the first forward in fwdBuf is accumulated
   void *   timer;
   void *   pConn;
   struct   SSyncNode *pSyncNode;
@@ -106,6 +111,7 @@ typedef struct SSyncNode {
   SSyncPeer *  pMaster;
   SRecvBuffer *pRecv;
   SSyncFwds *  pSyncFwds;  // saved forward info if quorum >1
+  uint64_t     ackVersion; // highest forward written but not acknowledged to master yet
   void *       pFwdTimer;
   void *       pRoleTimer;
   void *       pTsdb;
@@ -130,6 +136,7 @@ extern char *  syncStatus[];
 void *     syncRetrieveData(void *param);
 void *     syncRestoreData(void *param);
 int32_t    syncSaveIntoBuffer(SSyncPeer *pPeer, SWalHead *pHead);
+void       syncProcessFwdResponse(SFwdRsp *pFwdRsp, SSyncPeer *pPeer);
 void       syncRestartConnection(SSyncPeer *pPeer);
 void       syncBroadcastStatus(SSyncNode *pNode);
 uint32_t   syncResolvePeerFqdn(SSyncPeer *pPeer);
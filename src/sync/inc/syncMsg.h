@@ -38,7 +38,8 @@ typedef enum {
   TAOS_SMSG_SYNC_FILE     = 13,
   TAOS_SMSG_SYNC_FILE_RSP = 14,
   TAOS_SMSG_TEST          = 15,
-  TAOS_SMSG_END           = 16
+  TAOS_SMSG_SYNC_FWD_ACK  = 16,  // all the forwards up to the version are written
+  TAOS_SMSG_END           = 17
 } ESyncMsgType;
 
 typedef enum {
@@ -125,6 +126,7 @@ int32_t  syncCheckHead(SSyncHead *pHead);
 
 void syncBuildSyncFwdMsg(SSyncHead *pHead, int32_t vgId, int32_t len);
 void syncBuildSyncFwdRsp(SFwdRsp *pMsg, int32_t vgId, uint64_t version, int32_t code);
+void syncBuildSyncFwdAck(SFwdRsp *pMsg, int32_t vgId, uint64_t version);
 void syncBuildSyncReqMsg(SSyncMsg *pMsg, int32_t vgId);
 void syncBuildSyncDataMsg(SSyncMsg *pMsg, int32_t vgId);
 void syncBuildSyncSetupMsg(SSyncMsg *pMsg, int32_t vgId);
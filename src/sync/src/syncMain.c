@@ -57,6 +57,9 @@ static void    syncProcessFwdAck(SSyncNode *pNode, SFwdInfo *pFwdInfo, int32_t c
 static int32_t syncSaveFwdInfo(SSyncNode *pNode, uint64_t version, void *mhandle);
 static void    syncRestartPeer(SSyncPeer *pPeer);
 static int32_t syncForwardToPeerImpl(SSyncNode *pNode, void *data, void *mhandle, int32_t qtype, bool force);
+static void    syncBatchForward(SSyncPeer *pPeer, SSyncHead *pSyncHead, int32_t fwdLen);
+static void    syncFlushPeerForwards(SSyncPeer *pPeer);
+static void    syncSendFwdAck(SSyncNode *pNode);
 
 static SSyncPeer *syncAddPeer(SSyncNode *pNode, const SNodeInfo *pInfo);
 static void       syncStartCheckPeerConn(SSyncPeer *pPeer);
@@ -395,20 +398,46 @@ void syncConfirmForward(int64_t rid, uint64_t _version, int32_t code, bool force
 
   SSyncPeer *pPeer = pNode->pMaster;
   if (pPeer && (pNode->quorum > 1 || force)) {
-    SFwdRsp rsp;
-    syncBuildSyncFwdRsp(&rsp, pNode->vgId, _version, code);
-
-    if (taosWriteMsg(pPeer->peerFd, &rsp, sizeof(SFwdRsp)) == sizeof(SFwdRsp)) {
-      sTrace("%s, forward-rsp is sent, code:0x%x hver:%" PRIu64, pPeer->id, code, _version);
+    if (tsSyncFwdBatchSize > 0 && code == 0) {
+      // the forwards are written in order by one thread, so the acks up to the version are sent by syncFlushForwards
+      if (_version > atomic_load_64(&pNode->ackVersion)) atomic_store_64(&pNode->ackVersion, _version);
     } else {
-      sDebug("%s, failed to send forward-rsp, restart", pPeer->id);
-      syncRestartConnection(pPeer);
+      // the forwards written before are acknowledged first, so the master gets the answers in version order
+      if (tsSyncFwdBatchSize > 0) syncSendFwdAck(pNode);
+
+      SFwdRsp rsp;
+      syncBuildSyncFwdRsp(&rsp, pNode->vgId, _version, code);
+
+      if (taosWriteMsg(pPeer->peerFd, &rsp, sizeof(SFwdRsp)) == sizeof(SFwdRsp)) {
+        sTrace("%s, forward-rsp is sent, code:0x%x hver:%" PRIu64, pPeer->id, code, _version);
+      } else {
+        sDebug("%s, failed to send forward-rsp, restart", pPeer->id);
+        syncRestartConnection(pPeer);
+      }
     }
   }
 
   syncReleaseNode(pNode);
 }
 
+void syncFlushForwards(int64_t rid) {
+  if (tsSyncFwdBatchSize <= 0 || rid <= 0) return;
+
+  SSyncNode *pNode = syncAcquireNode(rid);
+  if (pNode == NULL) return;
+
+  syncSendFwdAck(pNode);
+
+  pthread_mutex_lock(&pNode->mutex);
+  for (int32_t i = 0; i < pNode->replica; ++i) {
+    SSyncPeer *pPeer = pNode->peerInfo[i];
+    if (pPeer != NULL) syncFlushPeerForwards(pPeer);
+  }
+  pthread_mutex_unlock(&pNode->mutex);
+
+  syncReleaseNode(pNode);
+}
+
 void syncRecover(int64_t rid) {
   SSyncPeer *pPeer;
 
@@ -519,6 +548,7 @@ static void syncFreePeer(void *param) {
   sDebug("%s, peer is freed, refCount:%d", pPeer->id, pPeer->refCount);
 
   syncReleaseNode(pPeer->pSyncNode);
+  tfree(pPeer->fwdBuf);
   tfree(pPeer);
 }
 
@@ -546,6 +576,7 @@ static void syncClosePeerConn(SSyncPeer *pPeer) {
 
   taosTmrStopA(&pPeer->timer);
   taosCloseSocket(pPeer->syncFd);
+  pPeer->fwdLen = 0;
   if (pPeer->peerFd >= 0) {
     pPeer->peerFd = -1;
     void *pConn = pPeer->pConn;
@@ -985,24 +1016,48 @@ static void syncRecoverFromMaster(SSyncPeer *pPeer) {
   }
 }
 
-static void syncProcessFwdResponse(SFwdRsp *pFwdRsp, SSyncPeer *pPeer) {
+void syncProcessFwdResponse(SFwdRsp *pFwdRsp, SSyncPeer *pPeer) {
   SSyncNode *pNode = pPeer->pSyncNode;
   SSyncFwds *pSyncFwds = pNode->pSyncFwds;
   SFwdInfo * pFwdInfo;
+  bool       range = (pFwdRsp->head.type == TAOS_SMSG_SYNC_FWD_ACK);
+  uint8_t    peerBit = 0;
+
+  for (int32_t i = 0; i <= TAOS_SYNC_MAX_REPLICA; ++i) {
+    if (pNode->peerInfo[i] == pPeer) peerBit = (uint8_t)(1 << i);
+  }
+
+  // the peer is no longer a replica of the node, its response counts for none
+  if (peerBit == 0) {
+    sDebug("%s, forward-%s is discarded since peer is not in the node", pPeer->id, range ? "ack" : "rsp");
+    return;
+  }
 
-  sTrace("%s, forward-rsp is received, code:%x hver:%" PRIu64, pPeer->id, pFwdRsp->code, pFwdRsp->version);
+  sTrace("%s, forward-%s is received, code:%x hver:%" PRIu64, pPeer->id, range ? "ack" : "rsp", pFwdRsp->code,
+         pFwdRsp->version);
   SFwdInfo *pFirst = pSyncFwds->fwdInfo + pSyncFwds->first;
 
   if (pFirst->version <= pFwdRsp->version && pSyncFwds->fwds > 0) {
     // find the forwardInfo from first
     for (int32_t i = 0; i < pSyncFwds->fwds; ++i) {
       pFwdInfo = pSyncFwds->fwdInfo + (i + pSyncFwds->first) % SYNC_MAX_FWDS;
-      if (pFwdRsp->version == pFwdInfo->version) {
-        syncProcessFwdAck(pNode, pFwdInfo, pFwdRsp->code);
-        syncRemoveConfirmedFwdInfo(pNode);
-        return;
+      if (range) {
+        // an ack confirms all the forwards up to its version, except those the peer has answered before, such as
+        // the failed ones answered by forward-rsp
+        if (pFwdInfo->version > pFwdRsp->version) break;
+        if (pFwdInfo->peers & peerBit) continue;
+        pFwdInfo->peers |= peerBit;
+        syncProcessFwdAck(pNode, pFwdInfo, TSDB_CODE_SUCCESS);
+      } else if (pFwdRsp->version == pFwdInfo->version) {
+        if ((pFwdInfo->peers & peerBit) == 0) {
+          pFwdInfo->peers |= peerBit;
+          syncProcessFwdAck(pNode, pFwdInfo, pFwdRsp->code);
+        }
+        break;
       }
     }
+
+    syncRemoveConfirmedFwdInfo(pNode);
   }
 }
 
@@ -1016,7 +1071,8 @@ static void syncProcessForwardFromPeer(char *cont, SSyncPeer *pPeer) {
   if (nodeRole == TAOS_SYNC_ROLE_SLAVE) {
     // nodeVersion = pHead->version;
     code = (*pNode->writeToCacheFp)(pNode->vgId, pHead, TAOS_QTYPE_FWD, NULL);
-    syncConfirmForward(pNode->rid, pHead->version, code, false);
+    // in batch mode, the forward is acknowledged after the app has written it
+    if (tsSyncFwdBatchSize <= 0 || code != 0) syncConfirmForward(pNode->rid, pHead->version, code, false);
   } else {
     if (nodeSStatus != TAOS_SYNC_STATUS_INIT) {
       code = syncSaveIntoBuffer(pPeer, pHead);
@@ -1086,7 +1142,7 @@ static int32_t syncProcessPeerMsg(int64_t rid, void *buffer) {
   if (code == 0) {
     if (pHead->type == TAOS_SMSG_SYNC_FWD) {
       syncProcessForwardFromPeer(buffer, pPeer);
-    } else if (pHead->type == TAOS_SMSG_SYNC_FWD_RSP) {
+    } else if (pHead->type == TAOS_SMSG_SYNC_FWD_RSP || pHead->type == TAOS_SMSG_SYNC_FWD_ACK) {
       syncProcessFwdResponse(buffer, pPeer);
     } else if (pHead->type == TAOS_SMSG_SYNC_REQ) {
       syncProcessSyncRequest(buffer, pPeer);
@@ -1426,6 +1482,9 @@ static void syncMonitorFwdInfos(void *param, void *tmrId) {
   if (pSyncFwds) {
     int64_t time = taosGetTimestampMs();
 
+    // the forwards and acks not flushed by the app, such as those of a write stalled, are sent here
+    syncFlushForwards(rid);
+
     if (pSyncFwds->fwds > 0) {
       pthread_mutex_lock(&pNode->mutex);
       for (int32_t i = 0; i < pSyncFwds->fwds; ++i) {
@@ -1501,6 +1560,11 @@ static int32_t syncForwardToPeerImpl(SSyncNode *pNode, void *data, void *mhandle
       }
     }
 
+    if (tsSyncFwdBatchSize > 0) {
+      syncBatchForward(pPeer, pSyncHead, fwdLen);
+      continue;
+    }
+
     int32_t retLen = taosWriteMsg(pPeer->peerFd, pSyncHead, fwdLen);
     if (retLen == fwdLen) {
       sTrace("%s, forward is sent, role:%s sstatus:%s hver:%" PRIu64 " contLen:%d", pPeer->id, syncRole[pPeer->role],
@@ -1516,3 +1580,75 @@ static int32_t syncForwardToPeerImpl(SSyncNode *pNode, void *data, void *mhandle
 
   return code;
 }
+
+static void syncFlushPeerForwards(SSyncPeer *pPeer) {
+  int32_t fwdLen = pPeer->fwdLen;
+  if (fwdLen <= 0) return;
+
+  pPeer->fwdLen = 0;
+  if (pPeer->peerFd < 0) return;
+
+  int32_t retLen = taosWriteMsg(pPeer->peerFd, pPeer->fwdBuf, fwdLen);
+  if (retLen == fwdLen) {
+    sTrace("%s, forwards are sent, role:%s sstatus:%s len:%d", pPeer->id, syncRole[pPeer->role],
+           syncStatus[pPeer->sstatus], fwdLen);
+  } else {
+    sError("%s, failed to forward, role:%s sstatus:%s len:%d retLen:%d", pPeer->id, syncRole[pPeer->role],
+           syncStatus[pPeer->sstatus], fwdLen, retLen);
+    syncRestartConnection(pPeer);
+  }
+}
+
+static void syncBatchForward(SSyncPeer *pPeer, SSyncHead *pSyncHead, int32_t fwdLen) {
+  int32_t batchSize = tsSyncFwdBatchSize * 1024;
+  int64_t time = taosGetTimestampUs();
+
+  if (pPeer->fwdBuf == NULL) {
+    pPeer->fwdBuf = malloc(batchSize);
+    if (pPeer->fwdBuf == NULL) {
+      sError("%s, no memory to allocate forward buffer, restart", pPeer->id);
+      syncRestartConnection(pPeer);
+      return;
+    }
+  }
+
+  if (pPeer->fwdLen + fwdLen > batchSize) syncFlushPeerForwards(pPeer);
+  if (pPeer->peerFd < 0) return;
+
+  if (fwdLen > batchSize) {
+    // a forward larger than the batch is sent alone
+    int32_t retLen = taosWriteMsg(pPeer->peerFd, pSyncHead, fwdLen);
+    if (retLen != fwdLen) {
+      sError("%s, failed to forward, role:%s sstatus:%s len:%d retLen:%d", pPeer->id, syncRole[pPeer->role],
+             syncStatus[pPeer->sstatus], fwdLen, retLen);
+      syncRestartConnection(pPeer);
+    }
+    return;
+  }
+
+  if (pPeer->fwdLen == 0) pPeer->fwdTime = time;
+  memcpy(pPeer->fwdBuf + pPeer->fwdLen, pSyncHead, fwdLen);
+  pPeer->fwdLen += fwdLen;
+
+  if (pPeer->fwdLen >= batchSize || time - pPeer->fwdTime >= tsSyncFwdBatchTime) {
+    syncFlushPeerForwards(pPeer);
+  }
+}
+
+static void syncSendFwdAck(SSyncNode *pNode) {
+  if (atomic_load_64(&pNode->ackVersion) == 0) return;
+
+  uint64_t   ackVersion = atomic_exchange_64(&pNode->ackVersion, 0);
+  SSyncPeer *pPeer = pNode->pMaster;
+  if (ackVersion == 0 || pPeer == NULL) return;
+
+  SFwdRsp rsp;
+  syncBuildSyncFwdAck(&rsp, pNode->vgId, ackVersion);
+
+  if (taosWriteMsg(pPeer->peerFd, &rsp, sizeof(SFwdRsp)) == sizeof(SFwdRsp)) {
+    sTrace("%s, forward-ack is sent, hver:%" PRIu64, pPeer->id, ackVersion);
+  } else {
+    sDebug("%s, failed to send forward-ack, restart", pPeer->id);
+    syncRestartConnection(pPeer);
+  }
+}
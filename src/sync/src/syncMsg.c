@@ -71,6 +71,16 @@ void syncBuildSyncFwdRsp(SFwdRsp *pMsg, int32_t vgId, uint64_t _version, int32_t
   pMsg->code = code;
 }
 
+void syncBuildSyncFwdAck(SFwdRsp *pMsg, int32_t vgId, uint64_t _version) {
+  pMsg->head.type = TAOS_SMSG_SYNC_FWD_ACK;
+  pMsg->head.vgId = vgId;
+  pMsg->head.len = sizeof(SFwdRsp) - sizeof(SSyncHead);
+  syncBuildHead(&pMsg->head);
+
+  pMsg->version = _version;
+  pMsg->code = 0;
+}
+
 static void syncBuildMsg(SSyncMsg *pMsg, int32_t vgId, ESyncMsgType type) {
   pMsg->head.type = type;
   pMsg->head.vgId = vgId;
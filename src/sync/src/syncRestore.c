@@ -69,6 +69,10 @@ static int32_t syncRestoreWal(SSyncPeer *pPeer, uint64_t *wver) {
   SSyncNode *pNode = pPeer->pSyncNode;
   int32_t    ret, code = -1;
   uint64_t   lastVer = 0;
+  int64_t    records = 0;
+  int64_t    bytes = 0;
+  int64_t    startMs = taosGetTimestampMs();
+  int64_t    reportMs = startMs;
 
   SWalHead *pHead = calloc(SYNC_MAX_SIZE, 1);  // size for one record
   if (pHead == NULL) return -1;
@@ -81,11 +85,14 @@ static int32_t syncRestoreWal(SSyncPeer *pPeer, uint64_t *wver) {
     }
 
     if (pHead->len == 0) {
-      sDebug("%s, wal is synced over, last wver:%" PRIu64, pPeer->id, lastVer);
+      sInfo("%s, wal is synced over, last wver:%" PRIu64 ", %" PRId64 " records %" PRId64 " bytes in %" PRId64 " ms",
+            pPeer->id, lastVer, records, bytes, taosGetTimestampMs() - startMs);
       code = 0;
       break;
     }  // wal sync over
 
+    taosThrottleRecv(sizeof(SWalHead) + pHead->len);
+
     ret = taosReadMsg(pPeer->syncFd, pHead->cont, pHead->len);
     if (ret != pHead->len) {
       sError("%s, failed to read walcont, len:%d while restore wal since %s", pPeer->id, pHead->len, strerror(errno));
@@ -105,6 +112,14 @@ static int32_t syncRestoreWal(SSyncPeer *pPeer, uint64_t *wver) {
       sError("%s, failed to restore record since %s, hver:%" PRIu64, pPeer->id, tstrerror(ret), pHead->version);
       break;
     }
+
+    records++;
+    bytes += sizeof(SWalHead) + pHead->len;
+    if (taosGetTimestampMs() - reportMs >= SYNC_PROGRESS_INTERVAL) {
+      reportMs = taosGetTimestampMs();
+      sInfo("%s, %" PRId64 " records %" PRId64 " bytes of wal are restored in %" PRId64 " ms, hver:%" PRIu64,
+            pPeer->id, records, bytes, reportMs - startMs, lastVer);
+    }
   }
 
   if (code < 0) {
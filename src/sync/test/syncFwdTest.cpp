@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "os.h"
+
+extern "C" {
+#include "taoserror.h"
+#include "syncInt.h"
+}
+
+namespace {
+
+struct SConfirm {
+  uint64_t version;
+  int32_t  code;
+};
+
+std::vector<SConfirm> confirms;
+
+// mhandle of a forward is its version
+void confirmForward(int32_t vgId, void *mhandle, int32_t code) {
+  confirms.push_back({(uint64_t)(uintptr_t)mhandle, code});
+}
+
+// a master of 3 replicas, the forwards are answered by peer 1 and 2
+class SyncFwdTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    confirms.clear();
+    memset(&node, 0, sizeof(node));
+    memset(peers, 0, sizeof(peers));
+
+    node.replica = 3;
+    node.quorum = 3;
+    node.vgId = 2;
+    node.confirmForward = confirmForward;
+    node.pSyncFwds = (SSyncFwds *)calloc(1, sizeof(SSyncFwds) + SYNC_MAX_FWDS * sizeof(SFwdInfo));
+    for (int32_t i = 0; i < 3; ++i) {
+      peers[i].pSyncNode = &node;
+      snprintf(peers[i].id, sizeof(peers[i].id), "vgId:2, nodeId:%d", i + 1);
+      node.peerInfo[i] = peers + i;
+    }
+  }
+
+  void TearDown() override { free(node.pSyncFwds); }
+
+  // as syncSaveFwdInfo does
+  void forward(uint64_t version) {
+    SSyncFwds *pSyncFwds = node.pSyncFwds;
+    if (pSyncFwds->fwds > 0) pSyncFwds->last = (pSyncFwds->last + 1) % SYNC_MAX_FWDS;
+
+    SFwdInfo *pFwdInfo = pSyncFwds->fwdInfo + pSyncFwds->last;
+    memset(pFwdInfo, 0, sizeof(SFwdInfo));
+    pFwdInfo->version = version;
+    pFwdInfo->mhandle = (void *)(uintptr_t)version;
+    pSyncFwds->fwds++;
+  }
+
+  void ack(int32_t peer, uint64_t version) {
+    SFwdRsp rsp;
+    syncBuildSyncFwdAck(&rsp, node.vgId, version);
+    syncProcessFwdResponse(&rsp, peers + peer);
+  }
+
+  void rsp(int32_t peer, uint64_t version, int32_t code) {
+    SFwdRsp rsp;
+    syncBuildSyncFwdRsp(&rsp, node.vgId, version, code);
+    syncProcessFwdResponse(&rsp, peers + peer);
+  }
+
+  SFwdInfo *fwdInfo(uint64_t version) {
+    SSyncFwds *pSyncFwds = node.pSyncFwds;
+    for (int32_t i = 0; i < pSyncFwds->fwds; ++i) {
+      SFwdInfo *pFwdInfo = pSyncFwds->fwdInfo + (i + pSyncFwds->first) % SYNC_MAX_FWDS;
+      if (pFwdInfo->version == version) return pFwdInfo;
+    }
+    return NULL;
+  }
+
+  SSyncNode node;
+  SSyncPeer peers[3];
+};
+
+}  // namespace
+
+TEST_F(SyncFwdTest, ack_confirms_range) {
+  node.quorum = 2;
+  for (uint64_t version = 1; version <= 5; ++version) forward(version);
+
+  ack(1, 3);
+  ASSERT_EQ(confirms.size(), 3);
+  EXPECT_EQ(node.pSyncFwds->fwds, 2);
+
+  // an ack of the versions answered before confirms no more
+  ack(1, 3);
+  EXPECT_EQ(confirms.size(), 3);
+
+  ack(2, 5);
+  ASSERT_EQ(confirms.size(), 5);
+  for (uint64_t version = 1; version <= 5; ++version) {
+    EXPECT_EQ(confirms[version - 1].version, version);
+    EXPECT_EQ(confirms[version - 1].code, 0);
+  }
+  EXPECT_EQ(node.pSyncFwds->fwds, 0);
+}
+
+TEST_F(SyncFwdTest, failed_forward_in_range) {
+  for (uint64_t version = 1; version <= 4; ++version) forward(version);
+
+  // version 3 fails on peer 1, the ack sent after still covers it
+  ack(1, 2);
+  rsp(1, 3, TSDB_CODE_SYN_INVALID_VERSION);
+  ack(1, 4);
+
+  // none is confirmed by peer 1 alone, except the failed one
+  ASSERT_EQ(confirms.size(), 1);
+  ASSERT_EQ(node.pSyncFwds->fwds, 4);
+  EXPECT_EQ(fwdInfo(1)->acks, 1);
+  EXPECT_EQ(fwdInfo(2)->acks, 1);
+  EXPECT_EQ(fwdInfo(3)->acks, 0);
+  EXPECT_EQ(fwdInfo(3)->nacks, 1);
+  EXPECT_EQ(fwdInfo(4)->acks, 1);
+
+  ack(2, 4);
+  ASSERT_EQ(confirms.size(), 4);
+  EXPECT_EQ(node.pSyncFwds->fwds, 0);
+  for (size_t i = 0; i < confirms.size(); ++i) {
+    EXPECT_EQ(confirms[i].code, confirms[i].version == 3 ? TSDB_CODE_SYN_INVALID_VERSION : 0);
+  }
+}
+
+TEST_F(SyncFwdTest, rsp_before_ack_of_earlier_versions) {
+  for (uint64_t version = 1; version <= 4; ++version) forward(version);
+
+  // the forward-rsp of version 3 overtakes the ack of versions 1 and 2
+  rsp(1, 3, 0);
+  ack(1, 2);
+  ack(1, 4);
+
+  ASSERT_EQ(node.pSyncFwds->fwds, 4);
+  for (uint64_t version = 1; version <= 4; ++version) {
+    EXPECT_EQ(fwdInfo(version)->acks, 1) << "version:" << version;
+  }
+
+  rsp(2, 3, 0);
+  ack(2, 4);
+  EXPECT_EQ(confirms.size(), 4);
+  EXPECT_EQ(node.pSyncFwds->fwds, 0);
+}
+
+TEST_F(SyncFwdTest, response_of_removed_peer) {
+  node.quorum = 2;
+  for (uint64_t version = 1; version <= 2; ++version) forward(version);
+
+  // peer 2 is no longer a replica, its responses are not counted
+  node.peerInfo[2] = NULL;
+  ack(2, 2);
+  rsp(2, 1, 0);
+
+  EXPECT_EQ(confirms.size(), 0);
+  ASSERT_EQ(node.pSyncFwds->fwds, 2);
+  EXPECT_EQ(fwdInfo(1)->acks, 0);
+  EXPECT_EQ(fwdInfo(2)->acks, 0);
+
+  ack(1, 2);
+  EXPECT_EQ(confirms.size(), 2);
+  EXPECT_EQ(node.pSyncFwds->fwds, 0);
+}
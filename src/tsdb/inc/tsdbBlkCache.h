@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_BLK_CACHE_H_
+#define _TD_TSDB_BLK_CACHE_H_
+
+// Size of the decoded block cache of each vnode in MB, 0 to disable it
+extern int32_t tsBlockCacheSize;
+
+// A decoded column of a data block. The file magic and size change whenever commit or compaction
+// writes the .data/.last file, so entries of an old file version can never be hit again, even if a
+// rolled back file gets other blocks at the same offsets.
+typedef struct {
+  int32_t  fid;
+  uint32_t magic;
+  uint64_t size;    // size of the .data/.last file
+  int64_t  offset;  // block offset in the .data/.last file
+  int16_t  colId;
+  int8_t   last;
+  int8_t   reserve;
+} SBlkCacheKey;
+
+typedef struct SBlkCacheEntry {
+  SBlkCacheKey           key;
+  struct SBlkCacheEntry *prev;
+  struct SBlkCacheEntry *next;
+  int8_t                 type;
+  int32_t                numOfRows;
+  int32_t                len;
+  char                   data[];
+} SBlkCacheEntry;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  int64_t         capacity;
+  int64_t         size;
+  SHashObj*       pHash;  // SBlkCacheKey -> SBlkCacheEntry*
+  SBlkCacheEntry* head;   // most recently used
+  SBlkCacheEntry* tail;   // least recently used
+  int64_t         hits;
+  int64_t         misses;
+  int64_t         evictions;
+} SBlkCache;
+
+SBlkCache* tsdbNewBlkCache(int64_t capacity);
+void       tsdbFreeBlkCache(SBlkCache* pCache);
+bool       tsdbBlkCacheGet(SBlkCache* pCache, SBlkCacheKey* pKey, SDataCol* pDataCol, int numOfRows);
+void       tsdbBlkCachePut(SBlkCache* pCache, SBlkCacheKey* pKey, SDataCol* pDataCol, int numOfRows);
+void       tsdbBlkCacheInvalidate(SBlkCache* pCache, int fid);
+
+static FORCE_INLINE void tsdbInitBlkCacheKey(SBlkCacheKey* pKey, int fid, SDFile* pDFile, SBlock* pBlock,
+                                             int16_t colId) {
+  memset(pKey, 0, sizeof(*pKey));
+  pKey->fid = fid;
+  pKey->magic = pDFile->info.magic;
+  pKey->size = pDFile->info.size;
+  pKey->offset = pBlock->offset;
+  pKey->colId = colId;
+  pKey->last = (int8_t)pBlock->last;
+}
+
+#endif /* _TD_TSDB_BLK_CACHE_H_ */
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_BLOOM_H_
+#define _TD_TSDB_BLOOM_H_
+
+// Bits of bloom filter per row written for each block column, 0 to disable it
+extern int32_t tsBlockBloomBits;
+
+#define TSDB_BLOOM_NHASH 4
+#define TSDB_BLOOM_MIN_LOG2 6   // 64 bytes
+#define TSDB_BLOOM_MAX_LOG2 20  // 1 MB
+
+// A bloom filter of (1 << log2) bytes follows the column data with its own checksum. The log2 is kept in
+// SBlockCol, and 0 there means the column has no filter.
+#define TSDB_BLOOM_SIZE(log2) (((log2) == 0) ? 0 : ((1u << (log2)) + sizeof(TSCKSUM)))
+
+bool    tsdbBloomSupportType(int8_t type);
+uint8_t tsdbBloomLog2(int numOfRows, int bitsPerRow);
+void    tsdbBloomBuild(SDataCol *pDataCol, int numOfRows, uint8_t *pBloom, uint8_t log2);
+bool    tsdbBloomMayContain(const uint8_t *pBloom, uint8_t log2, int8_t type, const void *pVal, int32_t len);
+
+#endif /* _TD_TSDB_BLOOM_H_ */
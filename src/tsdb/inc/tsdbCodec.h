@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_CODEC_H_
+#define _TD_TSDB_CODEC_H_
+
+// 1 to let the commit pick the codec of each block column by its data, 0 to use the codec of the data type only
+extern int32_t tsAdaptiveCodec;
+
+// Codec of the data of a block column, kept in SBlockCol. The default one is the compression function of the data
+// type with the algorithm of the block. The key column always uses the default one.
+#define TSDB_CODEC_DEFAULT 0
+#define TSDB_CODEC_RLE 1   // run lengths and values, for constant and slowly changing columns
+#define TSDB_CODEC_DICT 2  // distinct values and bit-packed indexes into them, for low cardinality columns
+#define TSDB_CODEC_FOR 3   // minimum value and bit-packed offsets from it, for integers of a narrow range
+#define TSDB_CODEC_DOD 4   // first value and varint delta-of-deltas, for counters and integers of regular steps
+#define TSDB_CODEC_MAX 5
+
+uint8_t tsdbCodecChoose(SDataCol *pDataCol, int numOfRows, int32_t *pSize);
+int32_t tsdbCodecEncode(uint8_t codec, SDataCol *pDataCol, int numOfRows, void *output);
+int32_t tsdbCodecDecode(uint8_t codec, SDataCol *pDataCol, const void *input, int32_t len, int numOfRows);
+
+#endif /* _TD_TSDB_CODEC_H_ */
@@ -18,6 +18,8 @@
 
 typedef enum { COMMIT_REQ, COMPACT_REQ,COMMIT_CONFIG_REQ } TSDB_REQ_T;
 
-int tsdbScheduleCommit(STsdbRepo *pRepo, TSDB_REQ_T req);
+int   tsdbScheduleCommit(STsdbRepo *pRepo, TSDB_REQ_T req);
+void *tsdbGetFsetCommitSched();
+bool  tsdbCommitQueueBusy();
 
 #endif /* _TD_TSDB_COMMIT_QUEUE_H_ */
\ No newline at end of file
@@ -19,7 +19,11 @@
 extern "C" {
 #endif
 
+extern int32_t tsCompactInterval;
+extern int32_t tsCompactIoRate;
+
 void *tsdbCompactImpl(STsdbRepo *pRepo);
+void  tsdbBgCompact(STsdbRepo *pRepo);
 
 #ifdef __cplusplus
 }
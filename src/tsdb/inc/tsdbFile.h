@@ -23,6 +23,12 @@
 #define TSDB_FILE_STATE_OK 0
 #define TSDB_FILE_STATE_BAD 1
 
+// Version of .head/.data/.last files, files of older versions are still readable
+#define TSDB_DFILE_VER_0 0
+#define TSDB_DFILE_VER_BLOOM 1  // SBlockCol may be followed by a bloom filter
+#define TSDB_DFILE_VER_CODEC 2  // SBlockCol.codec may be other than TSDB_CODEC_DEFAULT
+#define TSDB_LATEST_DFILE_VER TSDB_DFILE_VER_CODEC
+
 #define TSDB_FILE_INFO(tf) (&((tf)->info))
 #define TSDB_FILE_F(tf) (&((tf)->f))
 #define TSDB_FILE_FD(tf) ((tf)->fd)
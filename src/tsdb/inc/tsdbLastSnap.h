@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_LAST_SNAP_H_
+#define _TD_TSDB_LAST_SNAP_H_
+
+// The last key, last row and last columns of each table are saved to the snapshot file by the commit of closing
+// the repository, when the cache holds committed data only. It is stamped with the FS meta of that commit, so any
+// later commit, sync or compaction makes the whole snapshot invalid, and it is removed as soon as it is loaded.
+#define TSDB_LAST_SNAP_VERSION 0
+#define TSDB_LAST_SNAP_FNAME "lastcache"
+#define TSDB_LAST_SNAP_TEMP_FNAME "lastcache.t"
+
+int tsdbSaveLastSnapshot(STsdbRepo *pRepo);
+int tsdbLoadLastSnapshot(STsdbRepo *pRepo, uint8_t *restored);
+
+#endif /* _TD_TSDB_LAST_SNAP_H_ */
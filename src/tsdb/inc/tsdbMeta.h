@@ -29,6 +29,7 @@ typedef struct STable {
   STSchema*      tagSchema;
   SKVRow         tagVal;
   SSkipList*     pIndex;         // For TSDB_SUPER_TABLE, it is the skiplist index
+  struct STagIndex* pTagIndex;   // For TSDB_SUPER_TABLE, it is the inverted index of tag values if enabled
   void*          eventHandler;   // TODO
   void*          streamHandler;  // TODO
   TSKEY          lastKey;
@@ -50,6 +50,7 @@ typedef struct {
 
 typedef struct {
   int16_t  colId;
+  uint8_t  codec;  // TSDB_CODEC_XXX, in the padding after colId which is 0 in the blocks of old versions
   int32_t  len;
   uint32_t type : 8;
   uint32_t offset : 24;
@@ -60,7 +61,7 @@ typedef struct {
   int16_t  minIndex;
   int16_t  numOfNull;
   uint8_t  offsetH;
-  char     padding[1];
+  uint8_t  blmLog2;  // log2 of the bloom filter bytes following the column data, 0 if no filter
 } SBlockCol;
 
 // Code here just for back-ward compatibility
@@ -94,6 +95,7 @@ struct SReadH {
   SDataCols * pDCols[2];
   void *      pBuf;   // buffer
   void *      pCBuf;  // compression buffer
+  void *      pBlmBuf;  // bloom filter buffer
 };
 
 #define TSDB_READ_REPO(rh) ((rh)->pRepo)
@@ -118,6 +120,7 @@ int   tsdbLoadBlockInfo(SReadH *pReadh, void *pTarget);
 int   tsdbLoadBlockData(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlockInfo);
 int   tsdbLoadBlockDataCols(SReadH *pReadh, SBlock *pBlock, SBlockInfo *pBlkInfo, int16_t *colIds, int numOfColsIds);
 int   tsdbLoadBlockStatis(SReadH *pReadh, SBlock *pBlock);
+int   tsdbBlockMayContain(SReadH *pReadh, SBlock *pBlock, int16_t colId, int8_t type, const void *pVal, int32_t len);
 int   tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx);
 void *tsdbDecodeSBlockIdx(void *buf, SBlockIdx *pIdx);
 void  tsdbGetBlockStatis(SReadH *pReadh, SDataStatis *pStatis, int numOfCols);
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_TSDB_TAG_INDEX_H_
+#define _TD_TSDB_TAG_INDEX_H_
+
+extern int32_t tsTagInvertedIndex;
+
+// The inverted index of a super table maps each distinct value of each tag to the tids of the child tables with
+// that value. It is maintained together with the skiplist index under the meta write lock, and it is rebuilt from
+// the skiplist index when the tag schema version changes.
+typedef struct {
+  SArray *tids;  // tids of the child tables with the value, sorted
+  char    val[];
+} STagPosting;
+
+typedef struct {
+  int16_t   colId;
+  int8_t    type;
+  SHashObj *postings;  // tag value -> STagPosting *
+  SArray *  missing;   // tids of the child tables without a value of the tag, sorted
+} STagIndexCol;
+
+typedef struct STagIndex {
+  int           version;  // version of the tag schema the index is built for
+  int           numOfCols;
+  STagIndexCol *cols;
+} STagIndex;
+
+void          tsdbAddTableIntoTagIndex(STable *pSTable, STable *pTable);
+void          tsdbRemoveTableFromTagIndex(STable *pSTable, STable *pTable);
+void          tsdbFreeTagIndex(STagIndex *pTagIndex);
+STagIndexCol *tsdbGetTagIndexCol(STagIndex *pTagIndex, int16_t colId);
+
+struct tExprNode;
+
+// Query the child tables of the super table qualified by the filter expression, through the tag index if it is built
+// and the skiplist index does not answer the expression alone. The expression is destroyed.
+int32_t tsdbQueryTableList(STsdbMeta *pMeta, STable *pSTable, SArray *pRes, struct tExprNode *pExpr);
+
+#endif /* _TD_TSDB_TAG_INDEX_H_ */
@@ -52,6 +52,8 @@ extern "C" {
 #include "tsdbLog.h"
 // Meta
 #include "tsdbMeta.h"
+// Inverted index of tag values
+#include "tsdbTagIndex.h"
 // Buffer
 #include "tsdbBuffer.h"
 // MemTable
@@ -62,12 +64,20 @@ extern "C" {
 #include "tsdbFS.h"
 // ReadImpl
 #include "tsdbReadImpl.h"
+// Decoded block cache
+#include "tsdbBlkCache.h"
+// Bloom filter of block columns
+#include "tsdbBloom.h"
+// Adaptive codecs of block columns
+#include "tsdbCodec.h"
 // Commit
 #include "tsdbCommit.h"
 // Compact
 #include "tsdbCompact.h"
 // Commit Queue
 #include "tsdbCommitQueue.h"
+// Last cache snapshot
+#include "tsdbLastSnap.h"
 // Main definitions
 struct STsdbRepo {
   uint8_t state;
@@ -87,12 +97,15 @@ struct STsdbRepo {
   SMemTable*      mem;
   SMemTable*      imem;
   STsdbFS*        fs;
+  SBlkCache*      pBlkCache;  // decoded block cache, NULL if disabled
   SRtn            rtn;
   tsem_t          readyToCommit;
   pthread_mutex_t mutex;
   bool            repoLocked;
   int32_t         code;  // Commit code
   bool            inCompact;  // is in compact process?
+  int32_t         commitWaiting;    // # of threads waiting for readyToCommit, the background compaction yields to
+  int64_t         lastBgCompactMs;  // last time the background compaction checked the file sets
 };
 
 #define REPO_ID(r) (r)->config.tsdbId
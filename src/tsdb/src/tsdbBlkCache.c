@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+
+#define TSDB_BLK_CACHE_ENTRY_SIZE(e) (sizeof(SBlkCacheEntry) + (e)->len)
+
+// Totals over the caches of all vnodes in this process, reported by the monitor module
+static STsdbBlkCacheStat tsdbBlkCacheStat = {0};
+
+static void tsdbBlkCacheUnlink(SBlkCache *pCache, SBlkCacheEntry *pEntry);
+static void tsdbBlkCachePushHead(SBlkCache *pCache, SBlkCacheEntry *pEntry);
+static void tsdbBlkCacheRemoveEntry(SBlkCache *pCache, SBlkCacheEntry *pEntry);
+
+SBlkCache *tsdbNewBlkCache(int64_t capacity) {
+  SBlkCache *pCache = (SBlkCache *)calloc(1, sizeof(*pCache));
+  if (pCache == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  int code = pthread_mutex_init(&(pCache->mutex), NULL);
+  if (code != 0) {
+    terrno = TAOS_SYSTEM_ERROR(code);
+    free(pCache);
+    return NULL;
+  }
+
+  pCache->capacity = capacity;
+  pCache->pHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pCache->pHash == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    tsdbFreeBlkCache(pCache);
+    return NULL;
+  }
+
+  return pCache;
+}
+
+void tsdbFreeBlkCache(SBlkCache *pCache) {
+  if (pCache == NULL) return;
+
+  while (pCache->head) {
+    tsdbBlkCacheRemoveEntry(pCache, pCache->head);
+  }
+
+  taosHashCleanup(pCache->pHash);
+  pthread_mutex_destroy(&(pCache->mutex));
+  free(pCache);
+}
+
+bool tsdbBlkCacheGet(SBlkCache *pCache, SBlkCacheKey *pKey, SDataCol *pDataCol, int numOfRows) {
+  bool found = false;
+
+  pthread_mutex_lock(&(pCache->mutex));
+
+  SBlkCacheEntry **ppEntry = (SBlkCacheEntry **)taosHashGet(pCache->pHash, pKey, sizeof(*pKey));
+  if (ppEntry != NULL) {
+    SBlkCacheEntry *pEntry = *ppEntry;
+    if (pEntry->type == pDataCol->type && pEntry->numOfRows == numOfRows && pEntry->len <= pDataCol->spaceSize) {
+      memcpy(pDataCol->pData, pEntry->data, pEntry->len);
+      pDataCol->len = pEntry->len;
+      tsdbBlkCacheUnlink(pCache, pEntry);
+      tsdbBlkCachePushHead(pCache, pEntry);
+      found = true;
+    }
+  }
+
+  if (found) {
+    pCache->hits++;
+  } else {
+    pCache->misses++;
+  }
+
+  pthread_mutex_unlock(&(pCache->mutex));
+
+  if (found) {
+    atomic_add_fetch_64(&tsdbBlkCacheStat.hits, 1);
+    if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+      dataColSetOffset(pDataCol, numOfRows);
+    }
+  } else {
+    atomic_add_fetch_64(&tsdbBlkCacheStat.misses, 1);
+  }
+
+  return found;
+}
+
+void tsdbBlkCachePut(SBlkCache *pCache, SBlkCacheKey *pKey, SDataCol *pDataCol, int numOfRows) {
+  int64_t esize = sizeof(SBlkCacheEntry) + pDataCol->len;
+  if (esize > pCache->capacity) return;
+
+  SBlkCacheEntry *pEntry = (SBlkCacheEntry *)malloc(esize);
+  if (pEntry == NULL) return;
+
+  pEntry->key = *pKey;
+  pEntry->prev = NULL;
+  pEntry->next = NULL;
+  pEntry->type = pDataCol->type;
+  pEntry->numOfRows = numOfRows;
+  pEntry->len = pDataCol->len;
+  memcpy(pEntry->data, pDataCol->pData, pDataCol->len);
+
+  int64_t nevicted = 0;
+
+  pthread_mutex_lock(&(pCache->mutex));
+
+  // Another reader may have loaded the same column meanwhile
+  if (taosHashGet(pCache->pHash, pKey, sizeof(*pKey)) != NULL) {
+    pthread_mutex_unlock(&(pCache->mutex));
+    free(pEntry);
+    return;
+  }
+
+  while (pCache->tail && pCache->size + esize > pCache->capacity) {
+    tsdbBlkCacheRemoveEntry(pCache, pCache->tail);
+    nevicted++;
+  }
+
+  if (taosHashPut(pCache->pHash, pKey, sizeof(*pKey), (void *)(&pEntry), sizeof(pEntry)) < 0) {
+    pthread_mutex_unlock(&(pCache->mutex));
+    free(pEntry);
+    return;
+  }
+  tsdbBlkCachePushHead(pCache, pEntry);
+  pCache->size += esize;
+  pCache->evictions += nevicted;
+
+  pthread_mutex_unlock(&(pCache->mutex));
+
+  atomic_add_fetch_64(&tsdbBlkCacheStat.size, esize);
+  atomic_add_fetch_64(&tsdbBlkCacheStat.evictions, nevicted);
+}
+
+void tsdbBlkCacheInvalidate(SBlkCache *pCache, int fid) {
+  if (pCache == NULL) return;
+
+  pthread_mutex_lock(&(pCache->mutex));
+
+  SBlkCacheEntry *pEntry = pCache->head;
+  while (pEntry) {
+    SBlkCacheEntry *pNext = pEntry->next;
+    if (pEntry->key.fid == fid) {
+      tsdbBlkCacheRemoveEntry(pCache, pEntry);
+    }
+    pEntry = pNext;
+  }
+
+  pthread_mutex_unlock(&(pCache->mutex));
+}
+
+void tsdbGetBlkCacheStat(STsdbBlkCacheStat *pStat) {
+  pStat->hits = atomic_load_64(&tsdbBlkCacheStat.hits);
+  pStat->misses = atomic_load_64(&tsdbBlkCacheStat.misses);
+  pStat->evictions = atomic_load_64(&tsdbBlkCacheStat.evictions);
+  pStat->size = atomic_load_64(&tsdbBlkCacheStat.size);
+}
+
+static void tsdbBlkCacheUnlink(SBlkCache *pCache, SBlkCacheEntry *pEntry) {
+  if (pEntry->prev) {
+    pEntry->prev->next = pEntry->next;
+  } else {
+    pCache->head = pEntry->next;
+  }
+
+  if (pEntry->next) {
+    pEntry->next->prev = pEntry->prev;
+  } else {
+    pCache->tail = pEntry->prev;
+  }
+
+  pEntry->prev = NULL;
+  pEntry->next = NULL;
+}
+
+static void tsdbBlkCachePushHead(SBlkCache *pCache, SBlkCacheEntry *pEntry) {
+  pEntry->prev = NULL;
+  pEntry->next = pCache->head;
+  if (pCache->head) {
+    pCache->head->prev = pEntry;
+  } else {
+    pCache->tail = pEntry;
+  }
+  pCache->head = pEntry;
+}
+
+// Caller should hold the cache mutex
+static void tsdbBlkCacheRemoveEntry(SBlkCache *pCache, SBlkCacheEntry *pEntry) {
+  int64_t esize = TSDB_BLK_CACHE_ENTRY_SIZE(pEntry);
+
+  tsdbBlkCacheUnlink(pCache, pEntry);
+  taosHashRemove(pCache->pHash, &(pEntry->key), sizeof(pEntry->key));
+  pCache->size -= esize;
+  atomic_sub_fetch_64(&tsdbBlkCacheStat.size, esize);
+  free(pEntry);
+}
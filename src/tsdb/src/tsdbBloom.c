@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+#include "hashfunc.h"
+
+static FORCE_INLINE uint64_t tsdbBloomMix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Integer values are hashed as int64 so that the query side can probe with the int64 filter bound directly
+static FORCE_INLINE uint64_t tsdbBloomHash(int8_t type, const void *pVal, int32_t len) {
+  int64_t v = 0;
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BINARY:
+    case TSDB_DATA_TYPE_NCHAR:
+      return tsdbBloomMix(MurmurHash3_32((const char *)pVal, (uint32_t)len) | ((uint64_t)len << 32));
+    case TSDB_DATA_TYPE_TINYINT:
+      v = *(int8_t *)pVal;
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      v = *(uint8_t *)pVal;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      v = *(int16_t *)pVal;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      v = *(uint16_t *)pVal;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      v = *(int32_t *)pVal;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      v = *(uint32_t *)pVal;
+      break;
+    default:
+      v = *(int64_t *)pVal;
+      break;
+  }
+
+  return tsdbBloomMix((uint64_t)v);
+}
+
+static FORCE_INLINE void tsdbBloomSet(uint8_t *pBloom, uint32_t mask, uint64_t h) {
+  uint32_t h1 = (uint32_t)h;
+  uint32_t h2 = (uint32_t)(h >> 32) | 1;
+  for (int i = 0; i < TSDB_BLOOM_NHASH; i++) {
+    uint32_t bit = (h1 + i * h2) & mask;
+    pBloom[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+  }
+}
+
+bool tsdbBloomSupportType(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_BINARY:
+    case TSDB_DATA_TYPE_NCHAR:
+      return true;
+    default:
+      return false;
+  }
+}
+
+uint8_t tsdbBloomLog2(int numOfRows, int bitsPerRow) {
+  uint64_t nbytes = ((uint64_t)numOfRows * bitsPerRow + 7) / 8;
+  uint8_t  log2 = TSDB_BLOOM_MIN_LOG2;
+
+  while (log2 < TSDB_BLOOM_MAX_LOG2 && ((uint64_t)1 << log2) < nbytes) {
+    log2++;
+  }
+
+  return log2;
+}
+
+void tsdbBloomBuild(SDataCol *pDataCol, int numOfRows, uint8_t *pBloom, uint8_t log2) {
+  uint32_t mask = (1u << (log2 + 3)) - 1;
+
+  memset(pBloom, 0, 1u << log2);
+
+  for (int row = 0; row < numOfRows; row++) {
+    const void *value = tdGetColDataOfRow(pDataCol, row);
+    if (isNull(value, pDataCol->type)) continue;
+
+    if (IS_VAR_DATA_TYPE(pDataCol->type)) {
+      tsdbBloomSet(pBloom, mask, tsdbBloomHash(pDataCol->type, varDataVal(value), varDataLen(value)));
+    } else {
+      tsdbBloomSet(pBloom, mask, tsdbBloomHash(pDataCol->type, value, pDataCol->bytes));
+    }
+  }
+}
+
+bool tsdbBloomMayContain(const uint8_t *pBloom, uint8_t log2, int8_t type, const void *pVal, int32_t len) {
+  uint32_t mask = (1u << (log2 + 3)) - 1;
+  uint64_t h = tsdbBloomHash(IS_VAR_DATA_TYPE(type) ? type : TSDB_DATA_TYPE_BIGINT, pVal, len);
+  uint32_t h1 = (uint32_t)h;
+  uint32_t h2 = (uint32_t)(h >> 32) | 1;
+
+  for (int i = 0; i < TSDB_BLOOM_NHASH; i++) {
+    uint32_t bit = (h1 + i * h2) & mask;
+    if ((pBloom[bit >> 3] & (1u << (bit & 7))) == 0) return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "tsdbint.h"
+#include "hashfunc.h"
+
+#define TSDB_CODEC_DICT_MAX 256
+#define TSDB_CODEC_DICT_SLOTS 512  // power of 2 and twice the max entries, so a probe always ends at an empty slot
+
+// Values are compared byte by byte, so NULL and each bit pattern of a float is a value of its own
+typedef struct {
+  int     size;
+  int32_t bytes;                         // total bytes of the values of the entries
+  int16_t slots[TSDB_CODEC_DICT_SLOTS];  // index of the entry + 1, 0 if empty
+  int32_t rows[TSDB_CODEC_DICT_MAX];     // row of the first occurrence of the value of each entry
+} SCodecDict;
+
+typedef struct {
+  uint8_t *p;
+  uint64_t acc;
+  int      nacc;
+} SBitWriter;
+
+typedef struct {
+  const uint8_t *p;
+  uint64_t       acc;
+  int            nacc;
+} SBitReader;
+
+static int32_t tsdbEncodeRLE(SDataCol *pDataCol, int numOfRows, void *output);
+static int32_t tsdbDecodeRLE(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows);
+static int32_t tsdbEncodeDict(SDataCol *pDataCol, int numOfRows, void *output);
+static int32_t tsdbDecodeDict(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows);
+static int32_t tsdbEncodeFOR(SDataCol *pDataCol, int numOfRows, void *output);
+static int32_t tsdbDecodeFOR(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows);
+static int32_t tsdbEncodeDOD(SDataCol *pDataCol, int numOfRows, void *output);
+static int32_t tsdbDecodeDOD(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows);
+static int     tsdbCodecDictPut(SCodecDict *pDict, SDataCol *pDataCol, int row);
+
+static FORCE_INLINE bool tsdbCodecIsInteger(int8_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Integers are sign or zero extended to 64 bits, and all the arithmetic on them wraps around
+static FORCE_INLINE uint64_t tsdbCodecGetInt(int8_t type, const void *val) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return (uint64_t)(int64_t)(*(int8_t *)val);
+    case TSDB_DATA_TYPE_UTINYINT:
+      return *(uint8_t *)val;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (uint64_t)(int64_t)(*(int16_t *)val);
+    case TSDB_DATA_TYPE_USMALLINT:
+      return *(uint16_t *)val;
+    case TSDB_DATA_TYPE_INT:
+      return (uint64_t)(int64_t)(*(int32_t *)val);
+    case TSDB_DATA_TYPE_UINT:
+      return *(uint32_t *)val;
+    default:
+      return *(uint64_t *)val;
+  }
+}
+
+static FORCE_INLINE void tsdbCodecSetInt(int8_t type, void *val, uint64_t v) {
+  switch (TYPE_BYTES[type]) {
+    case 1:
+      *(uint8_t *)val = (uint8_t)v;
+      break;
+    case 2:
+      *(uint16_t *)val = (uint16_t)v;
+      break;
+    case 4:
+      *(uint32_t *)val = (uint32_t)v;
+      break;
+    default:
+      *(uint64_t *)val = v;
+      break;
+  }
+}
+
+static FORCE_INLINE bool tsdbCodecIntLess(int8_t type, uint64_t v1, uint64_t v2) {
+  return IS_UNSIGNED_NUMERIC_TYPE(type) ? (v1 < v2) : ((int64_t)v1 < (int64_t)v2);
+}
+
+static FORCE_INLINE int tsdbCodecBits(uint64_t v) {
+  return (v == 0) ? 0 : (int)(sizeof(uint64_t) * 8 - BUILDIN_CLZL(v));
+}
+
+static FORCE_INLINE int32_t tsdbCodecValLen(int8_t type, const void *val) {
+  return IS_VAR_DATA_TYPE(type) ? varDataTLen(val) : TYPE_BYTES[type];
+}
+
+static FORCE_INLINE bool tsdbCodecValEqual(int8_t type, const void *val1, const void *val2) {
+  int32_t len = tsdbCodecValLen(type, val1);
+  return (len == tsdbCodecValLen(type, val2)) && (memcmp(val1, val2, len) == 0);
+}
+
+// At most 32 bits are put each time, so the accumulator never overflows
+static FORCE_INLINE void tsdbCodecPutBitsImpl(SBitWriter *pWriter, uint64_t v, int nbits) {
+  pWriter->acc |= (v & ((((uint64_t)1) << nbits) - 1)) << pWriter->nacc;
+  pWriter->nacc += nbits;
+  while (pWriter->nacc >= 8) {
+    *(pWriter->p++) = (uint8_t)pWriter->acc;
+    pWriter->acc >>= 8;
+    pWriter->nacc -= 8;
+  }
+}
+
+static FORCE_INLINE void tsdbCodecPutBits(SBitWriter *pWriter, uint64_t v, int nbits) {
+  if (nbits > 32) {
+    tsdbCodecPutBitsImpl(pWriter, v, 32);
+    tsdbCodecPutBitsImpl(pWriter, v >> 32, nbits - 32);
+  } else {
+    tsdbCodecPutBitsImpl(pWriter, v, nbits);
+  }
+}
+
+static FORCE_INLINE void tsdbCodecFlushBits(SBitWriter *pWriter) {
+  if (pWriter->nacc > 0) {
+    *(pWriter->p++) = (uint8_t)pWriter->acc;
+    pWriter->acc = 0;
+    pWriter->nacc = 0;
+  }
+}
+
+static FORCE_INLINE uint64_t tsdbCodecGetBitsImpl(SBitReader *pReader, int nbits) {
+  while (pReader->nacc < nbits) {
+    pReader->acc |= ((uint64_t)(*(pReader->p++))) << pReader->nacc;
+    pReader->nacc += 8;
+  }
+
+  uint64_t v = pReader->acc & ((((uint64_t)1) << nbits) - 1);
+  pReader->acc >>= nbits;
+  pReader->nacc -= nbits;
+  return v;
+}
+
+// The caller makes sure the input has all the bits to get
+static FORCE_INLINE uint64_t tsdbCodecGetBits(SBitReader *pReader, int nbits) {
+  if (nbits > 32) {
+    uint64_t lo = tsdbCodecGetBitsImpl(pReader, 32);
+    return lo | (tsdbCodecGetBitsImpl(pReader, nbits - 32) << 32);
+  }
+
+  return tsdbCodecGetBitsImpl(pReader, nbits);
+}
+
+// Returns the codec giving the fewest bytes for the column and the bytes in *pSize. The sizes are exact, so the
+// caller can compare them with the bytes of the default codec before encoding.
+uint8_t tsdbCodecChoose(SDataCol *pDataCol, int numOfRows, int32_t *pSize) {
+  int8_t      type = pDataCol->type;
+  bool        isInt = tsdbCodecIsInteger(type);
+  int64_t     size[TSDB_CODEC_MAX] = {0};
+  SCodecDict  dict;
+  bool        dictFull = false;
+  const void *prevVal = NULL;
+  uint64_t    run = 0;
+  uint64_t    min = 0, max = 0, prev = 0, prevDelta = 0;
+
+  dict.size = 0;
+  dict.bytes = 0;
+  memset(dict.slots, 0, sizeof(dict.slots));
+
+  size[TSDB_CODEC_DOD] = sizeof(uint64_t);
+  for (int row = 0; row < numOfRows; row++) {
+    const void *val = tdGetColDataOfRow(pDataCol, row);
+
+    if (prevVal != NULL && tsdbCodecValEqual(type, val, prevVal)) {
+      run++;
+    } else {
+      if (prevVal != NULL) {
+        size[TSDB_CODEC_RLE] += taosEncodeVariantU64(NULL, run) + tsdbCodecValLen(type, prevVal);
+      }
+      prevVal = val;
+      run = 1;
+    }
+
+    if (!dictFull && tsdbCodecDictPut(&dict, pDataCol, row) < 0) {
+      dictFull = true;
+    }
+
+    if (isInt) {
+      uint64_t v = tsdbCodecGetInt(type, val);
+      if (row == 0) {
+        min = v;
+        max = v;
+      } else {
+        if (tsdbCodecIntLess(type, v, min)) min = v;
+        if (tsdbCodecIntLess(type, max, v)) max = v;
+
+        uint64_t delta = v - prev;
+        size[TSDB_CODEC_DOD] += taosEncodeVariantI64(NULL, (int64_t)(delta - prevDelta));
+        prevDelta = delta;
+      }
+      prev = v;
+    }
+  }
+  if (prevVal != NULL) {
+    size[TSDB_CODEC_RLE] += taosEncodeVariantU64(NULL, run) + tsdbCodecValLen(type, prevVal);
+  }
+
+  size[TSDB_CODEC_DICT] =
+      dictFull ? INT64_MAX
+               : (sizeof(uint16_t) + dict.bytes + ((int64_t)numOfRows * tsdbCodecBits(dict.size - 1) + 7) / 8);
+
+  if (isInt) {
+    size[TSDB_CODEC_FOR] =
+        sizeof(uint64_t) + sizeof(uint8_t) + ((int64_t)numOfRows * tsdbCodecBits(max - min) + 7) / 8;
+  } else {
+    size[TSDB_CODEC_FOR] = INT64_MAX;
+    size[TSDB_CODEC_DOD] = INT64_MAX;
+  }
+
+  uint8_t codec = TSDB_CODEC_RLE;
+  for (uint8_t i = TSDB_CODEC_RLE + 1; i < TSDB_CODEC_MAX; i++) {
+    if (size[i] < size[codec]) codec = i;
+  }
+
+  *pSize = (int32_t)size[codec];
+  return codec;
+}
+
+// The output must have room for the bytes given by tsdbCodecChoose
+int32_t tsdbCodecEncode(uint8_t codec, SDataCol *pDataCol, int numOfRows, void *output) {
+  switch (codec) {
+    case TSDB_CODEC_RLE:
+      return tsdbEncodeRLE(pDataCol, numOfRows, output);
+    case TSDB_CODEC_DICT:
+      return tsdbEncodeDict(pDataCol, numOfRows, output);
+    case TSDB_CODEC_FOR:
+      return tsdbEncodeFOR(pDataCol, numOfRows, output);
+    case TSDB_CODEC_DOD:
+      return tsdbEncodeDOD(pDataCol, numOfRows, output);
+    default:
+      ASSERT(0);
+      return -1;
+  }
+}
+
+// Returns the bytes decoded into the column, -1 if the input is broken
+int32_t tsdbCodecDecode(uint8_t codec, SDataCol *pDataCol, const void *input, int32_t len, int numOfRows) {
+  switch (codec) {
+    case TSDB_CODEC_RLE:
+      return tsdbDecodeRLE(pDataCol, input, len, numOfRows);
+    case TSDB_CODEC_DICT:
+      return tsdbDecodeDict(pDataCol, input, len, numOfRows);
+    case TSDB_CODEC_FOR:
+      return tsdbCodecIsInteger(pDataCol->type) ? tsdbDecodeFOR(pDataCol, input, len, numOfRows) : -1;
+    case TSDB_CODEC_DOD:
+      return tsdbCodecIsInteger(pDataCol->type) ? tsdbDecodeDOD(pDataCol, input, len, numOfRows) : -1;
+    default:
+      return -1;
+  }
+}
+
+static int tsdbCodecDictPut(SCodecDict *pDict, SDataCol *pDataCol, int row) {
+  const void *val = tdGetColDataOfRow(pDataCol, row);
+  int32_t     len = tsdbCodecValLen(pDataCol->type, val);
+  uint32_t    slot = MurmurHash3_32((const char *)val, (uint32_t)len) & (TSDB_CODEC_DICT_SLOTS - 1);
+
+  while (pDict->slots[slot] != 0) {
+    int idx = pDict->slots[slot] - 1;
+    if (tsdbCodecValEqual(pDataCol->type, val, tdGetColDataOfRow(pDataCol, pDict->rows[idx]))) return idx;
+    slot = (slot + 1) & (TSDB_CODEC_DICT_SLOTS - 1);
+  }
+
+  if (pDict->size >= TSDB_CODEC_DICT_MAX) return -1;
+
+  pDict->rows[pDict->size] = row;
+  pDict->bytes += len;
+  pDict->slots[slot] = (int16_t)(++pDict->size);
+  return pDict->size - 1;
+}
+
+// ---------------- RLE: (varint run length, value) ...
+static int32_t tsdbEncodeRLE(SDataCol *pDataCol, int numOfRows, void *output) {
+  void *ptr = output;
+  int   row = 0;
+
+  while (row < numOfRows) {
+    const void *val = tdGetColDataOfRow(pDataCol, row);
+    int         run = 1;
+
+    while (row + run < numOfRows && tsdbCodecValEqual(pDataCol->type, val, tdGetColDataOfRow(pDataCol, row + run))) {
+      run++;
+    }
+
+    int32_t len = tsdbCodecValLen(pDataCol->type, val);
+    taosEncodeVariantU64(&ptr, run);
+    memcpy(ptr, val, len);
+    ptr = POINTER_SHIFT(ptr, len);
+    row += run;
+  }
+
+  return (int32_t)POINTER_DISTANCE(ptr, output);
+}
+
+static int32_t tsdbDecodeRLE(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows) {
+  const char *ptr = (const char *)input;
+  const char *end = ptr + len;
+  char *      out = (char *)pDataCol->pData;
+  int32_t     olen = 0;
+  int         row = 0;
+
+  while (row < numOfRows) {
+    uint64_t run = 0;
+
+    if (ptr >= end) return -1;
+    ptr = taosDecodeVariantU64((void *)ptr, &run);
+    if (ptr == NULL || ptr > end || run == 0 || run > (uint64_t)(numOfRows - row)) return -1;
+
+    if (IS_VAR_DATA_TYPE(pDataCol->type) && ptr + sizeof(VarDataLenT) > end) return -1;
+    int32_t vlen = tsdbCodecValLen(pDataCol->type, ptr);
+    if (ptr + vlen > end || olen + (int64_t)run * vlen > pDataCol->spaceSize) return -1;
+
+    for (uint64_t i = 0; i < run; i++) {
+      memcpy(out + olen, ptr, vlen);
+      olen += vlen;
+    }
+
+    ptr += vlen;
+    row += (int)run;
+  }
+
+  return olen;
+}
+
+// ---------------- DICT: u16 # of entries, values of the entries, bit-packed index of the entry of each row
+static int32_t tsdbEncodeDict(SDataCol *pDataCol, int numOfRows, void *output) {
+  SCodecDict dict;
+  void *     ptr = output;
+
+  dict.size = 0;
+  dict.bytes = 0;
+  memset(dict.slots, 0, sizeof(dict.slots));
+
+  for (int row = 0; row < numOfRows; row++) {
+    if (tsdbCodecDictPut(&dict, pDataCol, row) < 0) {
+      ASSERT(0);
+      return -1;
+    }
+  }
+
+  taosEncodeFixedU16(&ptr, (uint16_t)dict.size);
+  for (int i = 0; i < dict.size; i++) {
+    const void *val = tdGetColDataOfRow(pDataCol, dict.rows[i]);
+    int32_t     len = tsdbCodecValLen(pDataCol->type, val);
+    memcpy(ptr, val, len);
+    ptr = POINTER_SHIFT(ptr, len);
+  }
+
+  int        nbits = (dict.size > 1) ? tsdbCodecBits(dict.size - 1) : 0;
+  SBitWriter writer = {.p = (uint8_t *)ptr, .acc = 0, .nacc = 0};
+  if (nbits > 0) {
+    for (int row = 0; row < numOfRows; row++) {
+      tsdbCodecPutBits(&writer, (uint64_t)tsdbCodecDictPut(&dict, pDataCol, row), nbits);
+    }
+    tsdbCodecFlushBits(&writer);
+  }
+
+  return (int32_t)POINTER_DISTANCE(writer.p, output);
+}
+
+static int32_t tsdbDecodeDict(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows) {
+  const char *vals[TSDB_CODEC_DICT_MAX];
+  int32_t     vlens[TSDB_CODEC_DICT_MAX];
+  const char *ptr = (const char *)input;
+  const char *end = ptr + len;
+  char *      out = (char *)pDataCol->pData;
+  int32_t     olen = 0;
+  uint16_t    size = 0;
+
+  if (len < sizeof(uint16_t)) return -1;
+  ptr = taosDecodeFixedU16((void *)ptr, &size);
+  if ((size == 0 && numOfRows > 0) || size > TSDB_CODEC_DICT_MAX) return -1;
+
+  for (int i = 0; i < size; i++) {
+    if (IS_VAR_DATA_TYPE(pDataCol->type) && ptr + sizeof(VarDataLenT) > end) return -1;
+    vals[i] = ptr;
+    vlens[i] = tsdbCodecValLen(pDataCol->type, ptr);
+    ptr += vlens[i];
+    if (ptr > end) return -1;
+  }
+
+  int        nbits = (size > 1) ? tsdbCodecBits(size - 1) : 0;
+  SBitReader reader = {.p = (const uint8_t *)ptr, .acc = 0, .nacc = 0};
+  if (ptr + ((int64_t)numOfRows * nbits + 7) / 8 > end) return -1;
+
+  for (int row = 0; row < numOfRows; row++) {
+    uint64_t idx = tsdbCodecGetBits(&reader, nbits);
+    if (idx >= size || olen + vlens[idx] > pDataCol->spaceSize) return -1;
+    memcpy(out + olen, vals[idx], vlens[idx]);
+    olen += vlens[idx];
+  }
+
+  return olen;
+}
+
+// ---------------- FOR: u64 minimum, u8 bits, bit-packed offset of each row from the minimum
+static int32_t tsdbEncodeFOR(SDataCol *pDataCol, int numOfRows, void *output) {
+  int8_t   type = pDataCol->type;
+  void *   ptr = output;
+  uint64_t min = (numOfRows > 0) ? tsdbCodecGetInt(type, tdGetColDataOfRow(pDataCol, 0)) : 0;
+  uint64_t max = min;
+
+  for (int row = 1; row < numOfRows; row++) {
+    uint64_t v = tsdbCodecGetInt(type, tdGetColDataOfRow(pDataCol, row));
+    if (tsdbCodecIntLess(type, v, min)) min = v;
+    if (tsdbCodecIntLess(type, max, v)) max = v;
+  }
+
+  int nbits = tsdbCodecBits(max - min);
+  taosEncodeFixedU64(&ptr, min);
+  taosEncodeFixedU8(&ptr, (uint8_t)nbits);
+
+  SBitWriter writer = {.p = (uint8_t *)ptr, .acc = 0, .nacc = 0};
+  if (nbits > 0) {
+    for (int row = 0; row < numOfRows; row++) {
+      tsdbCodecPutBits(&writer, tsdbCodecGetInt(type, tdGetColDataOfRow(pDataCol, row)) - min, nbits);
+    }
+    tsdbCodecFlushBits(&writer);
+  }
+
+  return (int32_t)POINTER_DISTANCE(writer.p, output);
+}
+
+static int32_t tsdbDecodeFOR(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows) {
+  int8_t   type = pDataCol->type;
+  int32_t  bytes = TYPE_BYTES[type];
+  void *   ptr = (void *)input;
+  uint64_t min = 0;
+  uint8_t  nbits = 0;
+
+  if (len < sizeof(uint64_t) + sizeof(uint8_t) || numOfRows * bytes > pDataCol->spaceSize) return -1;
+  ptr = taosDecodeFixedU64(ptr, &min);
+  ptr = taosDecodeFixedU8(ptr, &nbits);
+  if (nbits > 64 || POINTER_SHIFT(ptr, ((int64_t)numOfRows * nbits + 7) / 8) > POINTER_SHIFT(input, len)) return -1;
+
+  SBitReader reader = {.p = (const uint8_t *)ptr, .acc = 0, .nacc = 0};
+  for (int row = 0; row < numOfRows; row++) {
+    tsdbCodecSetInt(type, POINTER_SHIFT(pDataCol->pData, row * bytes), min + tsdbCodecGetBits(&reader, nbits));
+  }
+
+  return numOfRows * bytes;
+}
+
+// ---------------- DOD: u64 first value, varint delta-of-delta of each following row
+static int32_t tsdbEncodeDOD(SDataCol *pDataCol, int numOfRows, void *output) {
+  int8_t   type = pDataCol->type;
+  void *   ptr = output;
+  uint64_t prev = (numOfRows > 0) ? tsdbCodecGetInt(type, tdGetColDataOfRow(pDataCol, 0)) : 0;
+  uint64_t prevDelta = 0;
+
+  taosEncodeFixedU64(&ptr, prev);
+  for (int row = 1; row < numOfRows; row++) {
+    uint64_t v = tsdbCodecGetInt(type, tdGetColDataOfRow(pDataCol, row));
+    uint64_t delta = v - prev;
+    taosEncodeVariantI64(&ptr, (int64_t)(delta - prevDelta));
+    prevDelta = delta;
+    prev = v;
+  }
+
+  return (int32_t)POINTER_DISTANCE(ptr, output);
+}
+
+static int32_t tsdbDecodeDOD(SDataCol *pDataCol, const void *input, int32_t len, int numOfRows) {
+  int8_t      type = pDataCol->type;
+  int32_t     bytes = TYPE_BYTES[type];
+  const char *ptr = (const char *)input;
+  const char *end = ptr + len;
+  uint64_t    prev = 0;
+  uint64_t    prevDelta = 0;
+
+  if (len < sizeof(uint64_t) || numOfRows * bytes > pDataCol->spaceSize) return -1;
+  ptr = taosDecodeFixedU64((void *)ptr, &prev);
+  if (numOfRows > 0) tsdbCodecSetInt(type, pDataCol->pData, prev);
+
+  for (int row = 1; row < numOfRows; row++) {
+    int64_t dod = 0;
+
+    if (ptr >= end) return -1;
+    ptr = taosDecodeVariantI64((void *)ptr, &dod);
+    if (ptr == NULL || ptr > end) return -1;
+
+    prevDelta += (uint64_t)dod;
+    prev += prevDelta;
+    tsdbCodecSetInt(type, POINTER_SHIFT(pDataCol->pData, row * bytes), prev);
+  }
+
+  return numOfRows * bytes;
+}
@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include "tsdbint.h"
+#include "tsched.h"
 
 #define TSDB_MAX_SUBBLOCKS 8
 static FORCE_INLINE int TSDB_KEY_FID(TSKEY key, int32_t days, int8_t precision) {
@@ -42,6 +43,23 @@ typedef struct {
   SDataCols *  pDataCols;
 } SCommitH;
 
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+  int32_t         nrunning;
+} SCommitFSetLatch;
+
+typedef struct {
+  STsdbRepo *       pRepo;
+  SRtn *            pRtn;
+  SDFileSet *       pSet;        // existing FSET, NULL if a new FSET is created
+  int               fid;
+  bool              hasMemData;  // false if only the retention is applied on pSet
+  SDFileSet         wSet;        // FSET written by the commit
+  int               code;
+  SCommitFSetLatch *pLatch;
+} SCommitFSetJob;
+
 #define TSDB_COMMIT_REPO(ch) TSDB_READ_REPO(&(ch->readh))
 #define TSDB_COMMIT_REPO_ID(ch) REPO_ID(TSDB_READ_REPO(&(ch->readh)))
 #define TSDB_COMMIT_WRITE_FSET(ch) (&((ch)->wSet))
@@ -61,10 +79,11 @@ static int  tsdbCommitTSData(STsdbRepo *pRepo);
 static void tsdbStartCommit(STsdbRepo *pRepo);
 static void tsdbEndCommit(STsdbRepo *pRepo, int eno);
 static int  tsdbCommitToFile(SCommitH *pCommith, SDFileSet *pSet, int fid);
-static int  tsdbCreateCommitIters(SCommitH *pCommith);
+static int  tsdbCommitFSetsInParallel(SCommitH *pCommith, SDFileSet *pSet);
+static int  tsdbCreateCommitIters(SCommitH *pCommith, TSKEY skey);
 static void tsdbDestroyCommitIters(SCommitH *pCommith);
 static void tsdbSeekCommitIter(SCommitH *pCommith, TSKEY key);
-static int  tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo);
+static int  tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo, TSKEY skey);
 static void tsdbDestroyCommitH(SCommitH *pCommith);
 static int  tsdbGetFidLevel(int fid, SRtn *pRtn);
 static int  tsdbNextCommitFid(SCommitH *pCommith);
@@ -460,7 +479,7 @@ static int tsdbCommitTSData(STsdbRepo *pRepo) {
   }
 
   // Resource initialization
-  if (tsdbInitCommitH(&commith, pRepo) < 0) {
+  if (tsdbInitCommitH(&commith, pRepo, TSKEY_INITIAL_VAL) < 0) {
     return -1;
   }
 
@@ -475,6 +494,12 @@ static int tsdbCommitTSData(STsdbRepo *pRepo) {
     }
   }
 
+  if (tsdbGetFsetCommitSched() != NULL) {
+    int code = tsdbCommitFSetsInParallel(&commith, pSet);
+    tsdbDestroyCommitH(&commith);
+    return code;
+  }
+
   // Loop to commit to each file
   fid = tsdbNextCommitFid(&(commith));
   while (true) {
@@ -511,6 +536,11 @@ static int tsdbCommitTSData(STsdbRepo *pRepo) {
         return -1;
       }
 
+      if (tsdbUpdateDFileSet(REPO_FS(pRepo), TSDB_COMMIT_WRITE_FSET(&commith)) < 0) {
+        tsdbDestroyCommitH(&commith);
+        return -1;
+      }
+
       fid = tsdbNextCommitFid(&commith);
     }
   }
@@ -548,6 +578,11 @@ static void tsdbEndCommit(STsdbRepo *pRepo, int eno) {
   pRepo->imem = NULL;
   (void)tsdbUnlockRepo(pRepo);
   tsdbUnRefMemTable(pRepo, pIMem);
+
+  if (eno == TSDB_CODE_SUCCESS) {
+    tsdbBgCompact(pRepo);
+  }
+
   tsem_post(&(pRepo->readyToCommit));
 }
 
@@ -609,14 +644,189 @@ static int tsdbCommitToFile(SCommitH *pCommith, SDFileSet *pSet, int fid) {
   // Close commit file
   tsdbCloseCommitFile(pCommith, false);
 
-  if (tsdbUpdateDFileSet(REPO_FS(pRepo), &(pCommith->wSet)) < 0) {
+  return 0;
+}
+
+static int tsdbCommitFSetJob(SCommitFSetJob *pJob) {
+  STsdbCfg *pCfg = REPO_CFG(pJob->pRepo);
+  SCommitH  commith;
+  TSKEY     minKey, maxKey;
+
+  // Each job owns a commit handle whose memory iterators start at the FSET key range
+  tsdbGetFidKeyRange(pCfg->daysPerFile, pCfg->precision, pJob->fid, &minKey, &maxKey);
+  if (tsdbInitCommitH(&commith, pJob->pRepo, MAX(minKey, pJob->pRtn->minKey)) < 0) {
+    return -1;
+  }
+
+  commith.rtn = *(pJob->pRtn);
+
+  if (tsdbCommitToFile(&commith, pJob->pSet, pJob->fid) < 0) {
+    tsdbDestroyCommitH(&commith);
     return -1;
   }
 
+  pJob->wSet = commith.wSet;
+  tsdbDestroyCommitH(&commith);
   return 0;
 }
 
-static int tsdbCreateCommitIters(SCommitH *pCommith) {
+static void tsdbCommitFSetTask(SSchedMsg *pMsg) {
+  SCommitFSetJob *  pJob = (SCommitFSetJob *)pMsg->ahandle;
+  SCommitFSetLatch *pLatch = pJob->pLatch;
+
+  pJob->code = (tsdbCommitFSetJob(pJob) < 0) ? terrno : TSDB_CODE_SUCCESS;
+
+  pthread_mutex_lock(&(pLatch->mutex));
+  if (--pLatch->nrunning == 0) {
+    pthread_cond_signal(&(pLatch->cond));
+  }
+  pthread_mutex_unlock(&(pLatch->mutex));
+}
+
+// Commit the FSETs with memory data on the FSET commit threads. The FSETs have distinct fids and are
+// written to distinct files, so they are independent of each other. The FS changes are applied in fid
+// order after all jobs are over, and no change is applied if any job fails.
+static int tsdbCommitFSetsInParallel(SCommitH *pCommith, SDFileSet *pSet) {
+  STsdbRepo *      pRepo = TSDB_COMMIT_REPO(pCommith);
+  STsdbCfg *       pCfg = REPO_CFG(pRepo);
+  SCommitFSetLatch latch;
+  SArray *         aJob;
+  int              nMemJobs = 0;
+  int              code = TSDB_CODE_SUCCESS;
+  int              fid;
+
+  aJob = taosArrayInit(16, sizeof(SCommitFSetJob));
+  if (aJob == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  latch.nrunning = 0;
+  pthread_mutex_init(&(latch.mutex), NULL);
+  pthread_cond_init(&(latch.cond), NULL);
+
+  // Build the jobs in the same order as the serial commit loop
+  fid = tsdbNextCommitFid(pCommith);
+  while (true) {
+    if (pSet == NULL && fid == TSDB_IVLD_FID) break;
+
+    SCommitFSetJob job = {0};
+    job.pRepo = pRepo;
+    job.pRtn = &(pCommith->rtn);
+    job.pLatch = &latch;
+    TSDB_FSET_SET_CLOSED(&(job.wSet));
+
+    if (pSet && (fid == TSDB_IVLD_FID || pSet->fid < fid)) {
+      job.pSet = pSet;
+      job.fid = pSet->fid;
+      job.hasMemData = false;
+      pSet = tsdbFSIterNext(&(pCommith->fsIter));
+    } else {
+      TSKEY minKey, maxKey;
+
+      if (pSet == NULL || pSet->fid > fid) {
+        job.pSet = NULL;
+        job.fid = fid;
+      } else {
+        job.pSet = pSet;
+        job.fid = pSet->fid;
+        pSet = tsdbFSIterNext(&(pCommith->fsIter));
+      }
+      job.hasMemData = true;
+      nMemJobs++;
+
+      tsdbGetFidKeyRange(pCfg->daysPerFile, pCfg->precision, job.fid, &minKey, &maxKey);
+      tsdbSeekCommitIter(pCommith, maxKey + 1);
+      fid = tsdbNextCommitFid(pCommith);
+    }
+
+    if (taosArrayPush(aJob, &job) == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      code = terrno;
+      break;
+    }
+  }
+
+  // Run the jobs, inline if there is nothing to parallelize
+  if (code == TSDB_CODE_SUCCESS) {
+    size_t njobs = taosArrayGetSize(aJob);
+
+    if (nMemJobs > 1) {
+      latch.nrunning = nMemJobs;
+      tsdbDebug("vgId:%d commit %d FSETs in parallel", REPO_ID(pRepo), nMemJobs);
+    }
+
+    for (size_t i = 0; i < njobs; i++) {
+      SCommitFSetJob *pJob = taosArrayGet(aJob, i);
+      if (!pJob->hasMemData) continue;
+
+      if (nMemJobs > 1) {
+        SSchedMsg schedMsg = {0};
+        schedMsg.fp = tsdbCommitFSetTask;
+        schedMsg.ahandle = pJob;
+        taosScheduleTask(tsdbGetFsetCommitSched(), &schedMsg);
+      } else {
+        pJob->code = (tsdbCommitFSetJob(pJob) < 0) ? terrno : TSDB_CODE_SUCCESS;
+      }
+    }
+
+    pthread_mutex_lock(&(latch.mutex));
+    while (latch.nrunning > 0) {
+      pthread_cond_wait(&(latch.cond), &(latch.mutex));
+    }
+    pthread_mutex_unlock(&(latch.mutex));
+
+    for (size_t i = 0; i < njobs; i++) {
+      SCommitFSetJob *pJob = taosArrayGet(aJob, i);
+      if (pJob->hasMemData && pJob->code != TSDB_CODE_SUCCESS) {
+        tsdbError("vgId:%d failed to commit FSET %d since %s", REPO_ID(pRepo), pJob->fid, tstrerror(pJob->code));
+        if (code == TSDB_CODE_SUCCESS) code = pJob->code;
+      }
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      // revert the file change of the succeeded jobs
+      for (size_t i = 0; i < njobs; i++) {
+        SCommitFSetJob *pJob = taosArrayGet(aJob, i);
+        if (pJob->hasMemData && pJob->code == TSDB_CODE_SUCCESS) {
+          tsdbApplyDFileSetChange(&(pJob->wSet), pJob->pSet);
+        }
+      }
+    }
+  }
+
+  // Apply the FS changes in fid order
+  if (code == TSDB_CODE_SUCCESS) {
+    for (size_t i = 0; i < taosArrayGetSize(aJob); i++) {
+      SCommitFSetJob *pJob = taosArrayGet(aJob, i);
+
+      if (pJob->hasMemData) {
+        if (tsdbUpdateDFileSet(REPO_FS(pRepo), &(pJob->wSet)) < 0) {
+          code = terrno;
+          break;
+        }
+      } else {
+        if (tsdbApplyRtnOnFSet(pRepo, pJob->pSet, &(pCommith->rtn)) < 0) {
+          code = terrno;
+          break;
+        }
+      }
+    }
+  }
+
+  pthread_cond_destroy(&(latch.cond));
+  pthread_mutex_destroy(&(latch.mutex));
+  taosArrayDestroy(aJob);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    return -1;
+  }
+
+  return 0;
+}
+
+static int tsdbCreateCommitIters(SCommitH *pCommith, TSKEY skey) {
   STsdbRepo *pRepo = TSDB_COMMIT_REPO(pCommith);
   SMemTable *pMem = pRepo->imem;
   STsdbMeta *pMeta = pRepo->tsdbMeta;
@@ -643,7 +853,15 @@ static int tsdbCreateCommitIters(SCommitH *pCommith) {
   for (int i = 0; i < pMem->maxTables; i++) {
     if ((pCommith->iters[i].pTable != NULL) && (pMem->tData[i] != NULL) &&
         (TABLE_UID(pCommith->iters[i].pTable) == pMem->tData[i]->uid)) {
-      if ((pCommith->iters[i].pIter = tSkipListCreateIter(pMem->tData[i]->pData)) == NULL) {
+      if (skey == TSKEY_INITIAL_VAL) {
+        pCommith->iters[i].pIter = tSkipListCreateIter(pMem->tData[i]->pData);
+      } else {
+        TKEY tkey = keyToTkey(skey);
+        pCommith->iters[i].pIter =
+            tSkipListCreateIterFromVal(pMem->tData[i]->pData, (const char *)&tkey, TSDB_DATA_TYPE_TIMESTAMP, TSDB_ORDER_ASC);
+      }
+
+      if (pCommith->iters[i].pIter == NULL) {
         terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
         return -1;
       }
@@ -680,7 +898,7 @@ static void tsdbSeekCommitIter(SCommitH *pCommith, TSKEY key) {
   }
 }
 
-static int tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo) {
+static int tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo, TSKEY skey) {
   STsdbCfg *pCfg = REPO_CFG(pRepo);
 
   memset(pCommith, 0, sizeof(*pCommith));
@@ -696,7 +914,7 @@ static int tsdbInitCommitH(SCommitH *pCommith, STsdbRepo *pRepo) {
   // Init file iterator
   tsdbFSIterInit(&(pCommith->fsIter), REPO_FS(pRepo), TSDB_FS_ITER_FORWARD);
 
-  if (tsdbCreateCommitIters(pCommith) < 0) {
+  if (tsdbCreateCommitIters(pCommith, skey) < 0) {
     tsdbDestroyCommitH(pCommith);
     return -1;
   }
@@ -981,6 +1199,18 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDataCo
       memcpy(tptr, pDataCol->pData, flen);
     }
 
+    // Replace the default codec by the one chosen for the data if it gives fewer bytes. The header of the file
+    // written is updated to TSDB_DFILE_VER_CODEC at the end of the commit or compaction, so the binaries which
+    // don't know the codecs refuse the file instead of reading the column data as the default codec.
+    if (pCfg->compression && tsAdaptiveCodec && ncol != 0) {
+      int32_t csize = 0;
+      uint8_t codec = tsdbCodecChoose(pDataCol, rowsToWrite, &csize);
+      if (csize < flen) {
+        flen = tsdbCodecEncode(codec, pDataCol, rowsToWrite, tptr);
+        pBlockCol->codec = codec;
+      }
+    }
+
     // Add checksum
     ASSERT(flen > 0);
     flen += sizeof(TSCKSUM);
@@ -997,6 +1227,28 @@ int tsdbWriteBlockImpl(STsdbRepo *pRepo, STable *pTable, SDFile *pDFile, SDataCo
 
     toffset += flen;
     lsize += flen;
+
+    // Append the bloom filter right after the column data, readers locate column data by offset so the
+    // filter is invisible to them
+    if (ncol != 0 && tsBlockBloomBits > 0 && tsdbBloomSupportType(pDataCol->type)) {
+      uint8_t blmLog2 = tsdbBloomLog2(rowsToWrite, tsBlockBloomBits);
+      int32_t blen = TSDB_BLOOM_SIZE(blmLog2);
+
+      if (tsdbMakeRoom(ppBuf, lsize + blen) < 0) {
+        return -1;
+      }
+      pBlockData = (SBlockData *)(*ppBuf);
+      pBlockCol = pBlockData->cols + tcol - 1;
+      tptr = POINTER_SHIFT(pBlockData, lsize);
+
+      tsdbBloomBuild(pDataCol, rowsToWrite, (uint8_t *)tptr, blmLog2);
+      taosCalcChecksumAppend(0, (uint8_t *)tptr, blen);
+      tsdbUpdateDFileMagic(pDFile, POINTER_SHIFT(tptr, blen - sizeof(TSCKSUM)));
+      pBlockCol->blmLog2 = blmLog2;
+
+      toffset += blen;
+      lsize += blen;
+    }
   }
 
   pBlockData->delimiter = TSDB_FILE_DELIMITER;
@@ -14,6 +14,7 @@
  */
 
 #include "tsdbint.h"
+#include "tsched.h"
 
 typedef struct {
   bool            stop;
@@ -33,6 +34,7 @@ typedef struct {
 static void *tsdbLoopCommit(void *arg);
 
 static SCommitQueue tsCommitQueue = {0};
+static void *       tsFsetCommitSched = NULL;
 
 int tsdbInitCommitQueue() {
   int nthreads = tsNumOfCommitThreads;
@@ -63,6 +65,13 @@ int tsdbInitCommitQueue() {
     pthread_create(pQueue->threads + i, NULL, tsdbLoopCommit, NULL);
   }
 
+  if (tsNumOfFsetCommitThreads > 1) {
+    tsFsetCommitSched = taosInitScheduler(1024, tsNumOfFsetCommitThreads, "tsdbFset");
+    if (tsFsetCommitSched == NULL) {
+      tsdbWarn("failed to init FSET commit threads, commit FSETs one by one");
+    }
+  }
+
   return 0;
 }
 
@@ -85,6 +94,11 @@ void tsdbDestroyCommitQueue() {
     pthread_join(pQueue->threads[i], NULL);
   }
 
+  if (tsFsetCommitSched != NULL) {
+    taosCleanUpScheduler(tsFsetCommitSched);
+    tsFsetCommitSched = NULL;
+  }
+
   free(pQueue->threads);
   tdListFree(pQueue->queue);
   pthread_cond_destroy(&(pQueue->queueNotEmpty));
@@ -114,6 +128,18 @@ int tsdbScheduleCommit(STsdbRepo *pRepo, TSDB_REQ_T req) {
   return 0;
 }
 
+void *tsdbGetFsetCommitSched() { return tsFsetCommitSched; }
+
+bool tsdbCommitQueueBusy() {
+  SCommitQueue *pQueue = &tsCommitQueue;
+
+  pthread_mutex_lock(&(pQueue->lock));
+  bool busy = (listNEles(pQueue->queue) > 0);
+  pthread_mutex_unlock(&(pQueue->lock));
+
+  return busy;
+}
+
 static void tsdbApplyRepoConfig(STsdbRepo *pRepo) {
   pthread_mutex_lock(&pRepo->save_mutex);
 
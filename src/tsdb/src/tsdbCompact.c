@@ -19,8 +19,18 @@ typedef struct {
   SBlockIdx * pBlkIdx;
   SBlockIdx   bindex;
   SBlockInfo *pInfo;
+  bool        toMerge;  // the blocks of the table are merged, or moved to the compacted file set as they are
 } STableCompactH;
 
+typedef struct {
+  int     tblocks;       // total blocks
+  int     nSubBlocks;    // # of blocks with sub-blocks
+  int     nSmallBlocks;  // # of blocks with rows < defaultRows
+  int64_t tsize;         // total bytes of the blocks
+  int64_t msize;         // total bytes of the blocks of the tables to merge, which turn dead after the merge
+  int64_t fsize;         // total bytes of the data and last files, excluding the file heads
+} SCompactStat;
+
 typedef struct {
   SRtn       rtn;
   SFSIter    fsIter;
@@ -30,8 +40,17 @@ typedef struct {
   SArray *   aBlkIdx;
   SArray *   aSupBlk;
   SDataCols *pDataCols;
+  bool       isDFileSame;  // the blocks are appended to the data file of the file set instead of a new one
+  bool       background;   // compacted after a commit, throttled and yielding to the commits
+  bool       yielded;      // the background compaction gives up the file set for a commit
+  int64_t    startMs;      // start time of the background compaction
+  int64_t    ioBytes;      // bytes read and written by the background compaction
 } SCompactH;
 
+#define TSDB_COMPACT_FRAG_RATIO 0.33  // ratio of the blocks with sub-blocks or small rows to compact a file set
+#define TSDB_COMPACT_LIVE_RATIO 0.85  // ratio of the live bytes below which the whole file set is rewritten
+#define TSDB_COMPACT_THROTTLE_MS 100
+
 #define TSDB_COMPACT_WSET(pComph) (&((pComph)->wSet))
 #define TSDB_COMPACT_REPO(pComph) TSDB_READ_REPO(&((pComph)->readh))
 #define TSDB_COMPACT_HEAD_FILE(pComph) TSDB_DFILE_IN_SET(TSDB_COMPACT_WSET(pComph), TSDB_FILE_HEAD)
@@ -47,6 +66,16 @@ static int  tsdbCompactMeta(STsdbRepo *pRepo);
 static int  tsdbCompactTSData(STsdbRepo *pRepo);
 static int  tsdbCompactFSet(SCompactH *pComph, SDFileSet *pSet);
 static bool tsdbShouldCompact(SCompactH *pComph);
+static void tsdbGetCompactStat(SCompactH *pComph, SCompactStat *pStat);
+static int  tsdbBgCompactTSData(STsdbRepo *pRepo);
+static int  tsdbPickFSetToCompact(SCompactH *pComph, int *fid);
+static int  tsdbBgCompactFSet(SCompactH *pComph, SDFileSet *pSet);
+static int  tsdbSetAndOpenCompactFSet(SCompactH *pComph, SDFileSet *pSet);
+static void tsdbCloseCompactFSet(SCompactH *pComph, bool hasError);
+static bool tsdbCompactShouldYield(STsdbRepo *pRepo);
+static int  tsdbCompactThrottle(SCompactH *pComph, int64_t bytes);
+static int  tsdbMergeTableBlocks(SCompactH *pComph, STableCompactH *pTh);
+static int  tsdbMoveTableBlocks(SCompactH *pComph, STableCompactH *pTh);
 static int  tsdbInitCompactH(SCompactH *pComph, STsdbRepo *pRepo);
 static void tsdbDestroyCompactH(SCompactH *pComph);
 static int  tsdbInitCompTbArray(SCompactH *pComph);
@@ -88,8 +117,30 @@ _err:
   return NULL;
 }
 
+// The background compaction runs on the commit thread at the end of a commit, which still holds readyToCommit, and it
+// compacts the most fragmented file set only, so it holds up the next commit for one file set at most, or rather
+// not at all, since it gives up the file set as soon as a commit is waiting.
+void tsdbBgCompact(STsdbRepo *pRepo) {
+  STsdbFS *pfs = REPO_FS(pRepo);
+
+  if (tsCompactInterval <= 0 || pRepo->code != TSDB_CODE_SUCCESS) return;
+
+  int64_t now = taosGetTimestampMs();
+  if (now - pRepo->lastBgCompactMs < (int64_t)tsCompactInterval * 1000) return;
+  pRepo->lastBgCompactMs = now;
+
+  if (pfs->cstatus->pmf == NULL || taosArrayGetSize(pfs->cstatus->df) <= 0) return;
+  if (tsdbCompactShouldYield(pRepo)) return;
+
+  if (tsdbBgCompactTSData(pRepo) < 0) {
+    tsdbWarn("vgId:%d failed to compact TS data in background since %s", REPO_ID(pRepo), tstrerror(terrno));
+  }
+}
+
 static int tsdbAsyncCompact(STsdbRepo *pRepo) {
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
   return tsdbScheduleCommit(pRepo, COMPACT_REQ);
 }
 
@@ -160,6 +211,154 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
     return 0;
   }
 
+  static int tsdbBgCompactTSData(STsdbRepo *pRepo) {
+    STsdbFS *  pfs = REPO_FS(pRepo);
+    SCompactH  compactH;
+    SDFileSet *pSet = NULL;
+    int        fid = TSDB_IVLD_FID;
+
+    if (tsdbInitCompactH(&compactH, pRepo) < 0) {
+      return -1;
+    }
+
+    compactH.background = true;
+    compactH.startMs = taosGetTimestampMs();
+
+    if (tsdbPickFSetToCompact(&compactH, &fid) < 0) {
+      tsdbDestroyCompactH(&compactH);
+      if (compactH.yielded) {
+        tsdbDebug("vgId:%d background compaction yields to commit", REPO_ID(pRepo));
+        return 0;
+      }
+      return -1;
+    }
+
+    if (fid == TSDB_IVLD_FID) {
+      tsdbDestroyCompactH(&compactH);
+      return 0;
+    }
+
+    tsdbStartFSTxn(pRepo, 0, 0);
+    pRepo->inCompact = true;
+    tsdbUpdateMFile(pfs, pfs->cstatus->pmf);
+
+    while ((pSet = tsdbFSIterNext(&(compactH.fsIter)))) {
+      if (pSet->fid != fid) {
+        if (tsdbUpdateDFileSet(pfs, pSet) < 0) {
+          goto _err;
+        }
+        continue;
+      }
+
+      if (tsdbBgCompactFSet(&compactH, pSet) < 0) {
+        goto _err;
+      }
+    }
+
+    tsdbDestroyCompactH(&compactH);
+    pRepo->inCompact = false;
+    if (tsdbEndFSTxn(pRepo) < 0) {
+      return -1;
+    }
+
+    tsdbInfo("vgId:%d FSET %d is compacted in background, %" PRId64 " bytes read and written in %" PRId64 "ms",
+             REPO_ID(pRepo), fid, compactH.ioBytes, taosGetTimestampMs() - compactH.startMs);
+    return 0;
+
+  _err:
+    tsdbDestroyCompactH(&compactH);
+    tsdbEndFSTxnWithError(pfs);
+    pRepo->inCompact = false;
+
+    if (compactH.yielded) {
+      tsdbInfo("vgId:%d background compaction of FSET %d yields to commit", REPO_ID(pRepo), fid);
+      return 0;
+    }
+    return -1;
+  }
+
+  // Scores the file sets by the block statistics in their head files, and picks the one most over the thresholds
+  static int tsdbPickFSetToCompact(SCompactH *pComph, int *fid) {
+    STsdbRepo *  pRepo = TSDB_COMPACT_REPO(pComph);
+    SFSIter      fsIter;
+    SDFileSet *  pSet = NULL;
+    SCompactStat stat;
+    double       maxScore = 1.0;
+
+    *fid = TSDB_IVLD_FID;
+
+    tsdbFSIterInit(&fsIter, REPO_FS(pRepo), TSDB_FS_ITER_FORWARD);
+    while ((pSet = tsdbFSIterNext(&fsIter))) {
+      if (pSet->fid < pComph->rtn.minFid || TSDB_FSET_LEVEL(pSet) == TFS_MAX_LEVEL) continue;
+
+      if (tsdbCompactFSetInit(pComph, pSet) < 0) {
+        return -1;
+      }
+
+      tsdbGetCompactStat(pComph, &stat);
+      int64_t headSize = TSDB_FILE_INFO(TSDB_READ_HEAD_FILE(&(pComph->readh)))->size;
+      tsdbCompactFSetEnd(pComph);
+
+      double score = (stat.fsize > 0) ? (1.0 - stat.tsize * 1.0 / stat.fsize) / (1.0 - TSDB_COMPACT_LIVE_RATIO) : 0;
+      if (stat.tblocks > 0) {
+        score = MAX(score, stat.nSubBlocks * 1.0 / stat.tblocks / TSDB_COMPACT_FRAG_RATIO);
+        score = MAX(score, stat.nSmallBlocks * 1.0 / stat.tblocks / TSDB_COMPACT_FRAG_RATIO);
+      }
+
+      tsdbDebug("vgId:%d FSET %d has %d blocks, %d with sub-blocks, %d small ones, %" PRId64 " of %" PRId64
+                " bytes live, compact score %.2f",
+                REPO_ID(pRepo), pSet->fid, stat.tblocks, stat.nSubBlocks, stat.nSmallBlocks, stat.tsize, stat.fsize,
+                score);
+
+      if (score > maxScore) {
+        maxScore = score;
+        *fid = pSet->fid;
+      }
+
+      if (tsdbCompactThrottle(pComph, headSize) < 0) {
+        return -1;
+      }
+    }
+
+    return 0;
+  }
+
+  // Dead bytes in the data file are only reclaimed by rewriting the whole file set, otherwise the tables to merge
+  // are merged into blocks appended to the data file, and the other tables keep their data blocks
+  static int tsdbBgCompactFSet(SCompactH *pComph, SDFileSet *pSet) {
+    STsdbRepo *  pRepo = TSDB_COMPACT_REPO(pComph);
+    SCompactStat stat;
+
+    if (tsdbCompactFSetInit(pComph, pSet) < 0) {
+      return -1;
+    }
+
+    tsdbGetCompactStat(pComph, &stat);
+    pComph->isDFileSame =
+        (stat.fsize <= 0 || (stat.tsize - stat.msize) * 1.0 / stat.fsize >= TSDB_COMPACT_LIVE_RATIO);
+
+    tsdbDebug("vgId:%d start to compact FSET %d on level %d id %d in background, %s", REPO_ID(pRepo), pSet->fid,
+              TSDB_FSET_LEVEL(pSet), TSDB_FSET_ID(pSet), pComph->isDFileSame ? "merge tables" : "rewrite files");
+
+    if (tsdbSetAndOpenCompactFSet(pComph, pSet) < 0) {
+      tsdbCompactFSetEnd(pComph);
+      return -1;
+    }
+
+    if (tsdbCompactFSetImpl(pComph) < 0 || tsdbUpdateDFileSetHeader(TSDB_COMPACT_WSET(pComph)) < 0) {
+      tsdbCloseCompactFSet(pComph, true);
+      // revert the file change
+      tsdbApplyDFileSetChange(TSDB_COMPACT_WSET(pComph), pSet);
+      tsdbCompactFSetEnd(pComph);
+      return -1;
+    }
+
+    tsdbCloseCompactFSet(pComph, false);
+    tsdbCompactFSetEnd(pComph);
+
+    return tsdbUpdateDFileSet(REPO_FS(pRepo), TSDB_COMPACT_WSET(pComph));
+  }
+
   static int tsdbCompactFSet(SCompactH *pComph, SDFileSet *pSet) {
     STsdbRepo *pRepo = TSDB_COMPACT_REPO(pComph);
     SDiskID    did;
@@ -212,6 +411,17 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
   }
 
   static bool tsdbShouldCompact(SCompactH *pComph) {
+    SCompactStat stat;
+
+    tsdbGetCompactStat(pComph, &stat);
+
+    return (((stat.nSubBlocks * 1.0 / stat.tblocks) > TSDB_COMPACT_FRAG_RATIO) ||
+            ((stat.nSmallBlocks * 1.0 / stat.tblocks) > TSDB_COMPACT_FRAG_RATIO) ||
+            (stat.tsize * 1.0 / stat.fsize < TSDB_COMPACT_LIVE_RATIO));
+  }
+
+  // A table is to merge if it has blocks with sub-blocks or more than one small block
+  static void tsdbGetCompactStat(SCompactH *pComph, SCompactStat *pStat) {
     STsdbRepo *     pRepo = TSDB_COMPACT_REPO(pComph);
     STsdbCfg *      pCfg = REPO_CFG(pRepo);
     SReadH *        pReadh = &(pComph->readh);
@@ -221,18 +431,21 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
     SDFile *        pDataF = TSDB_READ_DATA_FILE(pReadh);
     SDFile *        pLastF = TSDB_READ_LAST_FILE(pReadh);
 
-    int     tblocks = 0;       // total blocks
-    int     nSubBlocks = 0;    // # of blocks with sub-blocks
-    int     nSmallBlocks = 0;  // # of blocks with rows < defaultRows
-    int64_t tsize = 0;
+    memset(pStat, 0, sizeof(*pStat));
+    pStat->fsize = pDataF->info.size + pLastF->info.size - 2 * TSDB_FILE_HEAD_SIZE;
 
     for (size_t i = 0; i < taosArrayGetSize(pComph->tbArray); i++) {
       pTh = (STableCompactH *)taosArrayGet(pComph->tbArray, i);
+      pTh->toMerge = false;
 
       if (pTh->pTable == NULL || pTh->pBlkIdx == NULL) continue;
 
+      int     nSubBlocks = 0;
+      int     nSmallBlocks = 0;
+      int64_t size = 0;
+
       for (size_t bidx = 0; bidx < pTh->pBlkIdx->numOfBlocks; bidx++) {
-        tblocks++;
+        pStat->tblocks++;
         pBlock = pTh->pInfo->blocks + bidx;
 
         if (pBlock->numOfRows < defaultRows) {
@@ -243,18 +456,21 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
           nSubBlocks++;
           for (int k = 0; k < pBlock->numOfSubBlocks; k++) {
             SBlock *iBlock = ((SBlock *)POINTER_SHIFT(pTh->pInfo, pBlock->offset)) + k;
-            tsize = tsize + iBlock->len;
+            size += iBlock->len;
           }
         } else if (pBlock->numOfSubBlocks == 1) {
-          tsize += pBlock->len;
+          size += pBlock->len;
         } else {
           ASSERT(0);
         }
       }
-    }
 
-    return (((nSubBlocks * 1.0 / tblocks) > 0.33) || ((nSmallBlocks * 1.0 / tblocks) > 0.33) ||
-            (tsize * 1.0 / (pDataF->info.size + pLastF->info.size - 2 * TSDB_FILE_HEAD_SIZE) < 0.85));
+      pStat->nSubBlocks += nSubBlocks;
+      pStat->nSmallBlocks += nSmallBlocks;
+      pStat->tsize += size;
+      pTh->toMerge = (nSubBlocks > 0 || nSmallBlocks > 1);
+      if (pTh->toMerge) pStat->msize += size;
+    }
   }
 
   static int tsdbInitCompactH(SCompactH *pComph, STsdbRepo *pRepo) {
@@ -409,13 +625,9 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
   static void tsdbCompactFSetEnd(SCompactH *pComph) { tsdbCloseAndUnsetFSet(&(pComph->readh)); }
 
   static int tsdbCompactFSetImpl(SCompactH *pComph) {
-    STsdbRepo *pRepo = TSDB_COMPACT_REPO(pComph);
-    STsdbCfg * pCfg = REPO_CFG(pRepo);
-    SReadH *   pReadh = &(pComph->readh);
-    SBlockIdx  blkIdx;
-    void **    ppBuf = &(TSDB_COMPACT_BUF(pComph));
-    void **    ppCBuf = &(TSDB_COMPACT_COMP_BUF(pComph));
-    int        defaultRows = TSDB_DEFAULT_BLOCK_ROWS(pCfg->maxRowsPerFileBlock);
+    SReadH *  pReadh = &(pComph->readh);
+    SBlockIdx blkIdx;
+    void **   ppBuf = &(TSDB_COMPACT_BUF(pComph));
 
     taosArrayClear(pComph->aBlkIdx);
 
@@ -434,61 +646,122 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
       }
       tdFreeSchema(pSchema);
 
-      // Loop to compact each block data
-      for (int i = 0; i < pTh->pBlkIdx->numOfBlocks; i++) {
-        SBlock *pBlock = pTh->pInfo->blocks + i;
+      if (pComph->isDFileSame && !pTh->toMerge) {
+        if (tsdbMoveTableBlocks(pComph, pTh) < 0) {
+          return -1;
+        }
+      } else if (tsdbMergeTableBlocks(pComph, pTh) < 0) {
+        return -1;
+      }
+
+      if (tsdbWriteBlockInfoImpl(TSDB_COMPACT_HEAD_FILE(pComph), pTh->pTable, pComph->aSupBlk, NULL, ppBuf, &blkIdx) <
+          0) {
+        return -1;
+      }
+
+      if ((blkIdx.numOfBlocks > 0) && (taosArrayPush(pComph->aBlkIdx, (void *)(&blkIdx)) == NULL)) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        return -1;
+      }
+    }
+
+    if (tsdbWriteBlockIdx(TSDB_COMPACT_HEAD_FILE(pComph), pComph->aBlkIdx, ppBuf) < 0) {
+      return -1;
+    }
+
+    return 0;
+  }
+
+  static int tsdbMergeTableBlocks(SCompactH *pComph, STableCompactH *pTh) {
+    STsdbRepo *pRepo = TSDB_COMPACT_REPO(pComph);
+    STsdbCfg * pCfg = REPO_CFG(pRepo);
+    SReadH *   pReadh = &(pComph->readh);
+    void **    ppBuf = &(TSDB_COMPACT_BUF(pComph));
+    void **    ppCBuf = &(TSDB_COMPACT_COMP_BUF(pComph));
+    int        defaultRows = TSDB_DEFAULT_BLOCK_ROWS(pCfg->maxRowsPerFileBlock);
+
+    // Loop to compact each block data
+    for (int i = 0; i < pTh->pBlkIdx->numOfBlocks; i++) {
+      SBlock *pBlock = pTh->pInfo->blocks + i;
 
-        // Load the block data
-        if (tsdbLoadBlockData(pReadh, pBlock, pTh->pInfo) < 0) {
+      // Load the block data
+      if (tsdbLoadBlockData(pReadh, pBlock, pTh->pInfo) < 0) {
+        return -1;
+      }
+
+      if (tsdbCompactThrottle(pComph, pBlock->len) < 0) {
+        return -1;
+      }
+
+      // Merge pComph->pDataCols and pReadh->pDCols[0] and write data to file
+      if (pComph->pDataCols->numOfRows == 0 && pBlock->numOfRows >= defaultRows) {
+        if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pReadh->pDCols[0], ppBuf, ppCBuf) < 0) {
           return -1;
         }
+      } else {
+        int ridx = 0;
+
+        while (true) {
+          if (pReadh->pDCols[0]->numOfRows - ridx == 0) break;
+          int rowsToMerge = MIN(pReadh->pDCols[0]->numOfRows - ridx, defaultRows - pComph->pDataCols->numOfRows);
+
+          tdMergeDataCols(pComph->pDataCols, pReadh->pDCols[0], rowsToMerge, &ridx);
 
-        // Merge pComph->pDataCols and pReadh->pDCols[0] and write data to file
-        if (pComph->pDataCols->numOfRows == 0 && pBlock->numOfRows >= defaultRows) {
-          if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pReadh->pDCols[0], ppBuf, ppCBuf) < 0) {
+          if (pComph->pDataCols->numOfRows < defaultRows) {
+            break;
+          }
+
+          if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, ppBuf, ppCBuf) < 0) {
             return -1;
           }
-        } else {
-          int ridx = 0;
+          tdResetDataCols(pComph->pDataCols);
+        }
+      }
+    }
+
+    if (pComph->pDataCols->numOfRows > 0 &&
+        tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, ppBuf, ppCBuf) < 0) {
+      return -1;
+    }
 
-          while (true) {
-            if (pReadh->pDCols[0]->numOfRows - ridx == 0) break;
-            int rowsToMerge = MIN(pReadh->pDCols[0]->numOfRows - ridx, defaultRows - pComph->pDataCols->numOfRows);
+    return 0;
+  }
 
-            tdMergeDataCols(pComph->pDataCols, pReadh->pDCols[0], rowsToMerge, &ridx);
+  // The blocks of a table not to merge stay where they are in the data file, and only its block in the last file is
+  // copied to the new last file
+  static int tsdbMoveTableBlocks(SCompactH *pComph, STableCompactH *pTh) {
+    SReadH *pReadh = &(pComph->readh);
+    void ** ppBuf = &(TSDB_COMPACT_BUF(pComph));
+    void ** ppCBuf = &(TSDB_COMPACT_COMP_BUF(pComph));
 
-            if (pComph->pDataCols->numOfRows < defaultRows) {
-              break;
-            }
+    ASSERT(pComph->isDFileSame);
 
-            if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, ppBuf, ppCBuf) < 0) {
-              return -1;
-            }
-            tdResetDataCols(pComph->pDataCols);
-          }
+    for (int i = 0; i < pTh->pBlkIdx->numOfBlocks; i++) {
+      SBlock *pBlock = pTh->pInfo->blocks + i;
+
+      ASSERT(pBlock->numOfSubBlocks == 1);
+
+      if (!pBlock->last) {
+        if (taosArrayPush(pComph->aSupBlk, (void *)pBlock) == NULL) {
+          terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+          return -1;
         }
+        continue;
       }
 
-      if (pComph->pDataCols->numOfRows > 0 &&
-          tsdbWriteBlockToRightFile(pComph, pTh->pTable, pComph->pDataCols, ppBuf, ppCBuf) < 0) {
+      if (tsdbLoadBlockData(pReadh, pBlock, pTh->pInfo) < 0) {
         return -1;
       }
 
-      if (tsdbWriteBlockInfoImpl(TSDB_COMPACT_HEAD_FILE(pComph), pTh->pTable, pComph->aSupBlk, NULL, ppBuf, &blkIdx) <
-          0) {
+      if (tsdbCompactThrottle(pComph, pBlock->len) < 0) {
         return -1;
       }
 
-      if ((blkIdx.numOfBlocks > 0) && (taosArrayPush(pComph->aBlkIdx, (void *)(&blkIdx)) == NULL)) {
-        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      if (tsdbWriteBlockToRightFile(pComph, pTh->pTable, pReadh->pDCols[0], ppBuf, ppCBuf) < 0) {
         return -1;
       }
     }
 
-    if (tsdbWriteBlockIdx(TSDB_COMPACT_HEAD_FILE(pComph), pComph->aBlkIdx, ppBuf) < 0) {
-      return -1;
-    }
-
     return 0;
   }
 
@@ -519,6 +792,82 @@ static int tsdbCompactMeta(STsdbRepo *pRepo) {
       return -1;
     }
 
-    return 0;
+    return tsdbCompactThrottle(pComph, block.len);
 }
 
+  static int tsdbSetAndOpenCompactFSet(SCompactH *pComph, SDFileSet *pSet) {
+    STsdbRepo *pRepo = TSDB_COMPACT_REPO(pComph);
+    SDFileSet *pWSet = TSDB_COMPACT_WSET(pComph);
+    SDiskID    did;
+
+    if (!pComph->isDFileSame) {
+      tfsAllocDisk(tsdbGetFidLevel(pSet->fid, &(pComph->rtn)), &(did.level), &(did.id));
+      if (did.level == TFS_UNDECIDED_LEVEL) {
+        terrno = TSDB_CODE_TDB_NO_AVAIL_DISK;
+        return -1;
+      }
+
+      tsdbInitDFileSet(pWSet, did, REPO_ID(pRepo), TSDB_FSET_FID(pSet), FS_TXN_VERSION(REPO_FS(pRepo)));
+      return tsdbCreateDFileSet(pWSet, true);
+    }
+
+    did.level = TSDB_FSET_LEVEL(pSet);
+    did.id = TSDB_FSET_ID(pSet);
+
+    pWSet->fid = TSDB_FSET_FID(pSet);
+    pWSet->state = 0;
+
+    SDFile *pWHeadf = TSDB_COMPACT_HEAD_FILE(pComph);
+    SDFile *pWDataf = TSDB_COMPACT_DATA_FILE(pComph);
+    SDFile *pWLastf = TSDB_COMPACT_LAST_FILE(pComph);
+
+    tsdbInitDFile(pWHeadf, did, REPO_ID(pRepo), pWSet->fid, FS_TXN_VERSION(REPO_FS(pRepo)), TSDB_FILE_HEAD);
+    tsdbInitDFileEx(pWDataf, TSDB_READ_DATA_FILE(&(pComph->readh)));
+    tsdbInitDFile(pWLastf, did, REPO_ID(pRepo), pWSet->fid, FS_TXN_VERSION(REPO_FS(pRepo)), TSDB_FILE_LAST);
+
+    if (tsdbCreateDFile(pWHeadf, true) < 0) {
+      return -1;
+    }
+
+    if (tsdbOpenDFile(pWDataf, O_WRONLY) < 0 || tsdbCreateDFile(pWLastf, true) < 0) {
+      tsdbCloseDFileSet(pWSet);
+      (void)tsdbRemoveDFile(pWHeadf);
+      return -1;
+    }
+
+    return 0;
+  }
+
+  static void tsdbCloseCompactFSet(SCompactH *pComph, bool hasError) {
+    if (!hasError) {
+      TSDB_FSET_FSYNC(TSDB_COMPACT_WSET(pComph));
+    }
+    tsdbCloseDFileSet(TSDB_COMPACT_WSET(pComph));
+  }
+
+  static bool tsdbCompactShouldYield(STsdbRepo *pRepo) {
+    return atomic_load_32(&pRepo->commitWaiting) > 0 || tsdbCommitQueueBusy();
+  }
+
+  // The background compaction keeps its reads and writes within compactIoRate MB per second, and gives up the file
+  // set as soon as a commit is waiting
+  static int tsdbCompactThrottle(SCompactH *pComph, int64_t bytes) {
+    if (!pComph->background) return 0;
+
+    pComph->ioBytes += bytes;
+
+    while (true) {
+      if (tsdbCompactShouldYield(TSDB_COMPACT_REPO(pComph))) {
+        pComph->yielded = true;
+        return -1;
+      }
+
+      if (tsCompactIoRate <= 0) return 0;
+
+      int64_t elapsed = taosGetTimestampMs() - pComph->startMs;
+      int64_t expected = pComph->ioBytes * 1000 / ((int64_t)tsCompactIoRate * 1024 * 1024);
+      if (elapsed >= expected) return 0;
+
+      taosMsleep((int32_t)MIN(expected - elapsed, TSDB_COMPACT_THROTTLE_MS));
+    }
+  }
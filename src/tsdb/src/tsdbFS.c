@@ -25,6 +25,8 @@ static int  tsdbComparFidFSet(const void *arg1, const void *arg2);
 static void tsdbResetFSStatus(SFSStatus *pStatus);
 static int  tsdbSaveFSStatus(SFSStatus *pStatus, int vid);
 static void tsdbApplyFSTxnOnDisk(SFSStatus *pFrom, SFSStatus *pTo);
+static void tsdbInvalidateBlkCache(STsdbRepo *pRepo, SFSStatus *pFrom, SFSStatus *pTo);
+static bool tsdbIsDFileChanged(SDFile *pFrom, SDFile *pTo);
 static void tsdbGetTxnFname(int repoid, TSDB_TXN_FILE_T ftype, char fname[]);
 static int  tsdbOpenFSFromCurrent(STsdbRepo *pRepo);
 static int  tsdbScanAndTryFixFS(STsdbRepo *pRepo);
@@ -379,6 +381,7 @@ int tsdbEndFSTxn(STsdbRepo *pRepo) {
 
   // Apply actual change to each file and SDFileSet
   tsdbApplyFSTxnOnDisk(pfs->nstatus, pfs->cstatus);
+  tsdbInvalidateBlkCache(pRepo, pfs->nstatus, pfs->cstatus);
 
   pfs->intxn = false;
   return 0;
@@ -537,6 +540,30 @@ static void tsdbApplyFSTxnOnDisk(SFSStatus *pFrom, SFSStatus *pTo) {
   }
 }
 
+// Drop decoded blocks of the file sets rewritten or removed by the transaction. Their keys carry the
+// file magic and size so they could not be hit anyway, this just gives the memory back early.
+static void tsdbInvalidateBlkCache(STsdbRepo *pRepo, SFSStatus *pFrom, SFSStatus *pTo) {
+  if (pRepo->pBlkCache == NULL) return;
+
+  size_t sizeFrom = taosArrayGetSize(pFrom->df);
+  for (size_t i = 0; i < sizeFrom; i++) {
+    SDFileSet *pSetFrom = taosArrayGet(pFrom->df, i);
+    SDFileSet *pSetTo = taosArraySearch(pTo->df, (void *)(&pSetFrom->fid), tsdbComparFidFSet, TD_EQ);
+
+    if (pSetTo == NULL || tsdbIsDFileChanged(TSDB_DFILE_IN_SET(pSetFrom, TSDB_FILE_DATA),
+                                             TSDB_DFILE_IN_SET(pSetTo, TSDB_FILE_DATA)) ||
+        tsdbIsDFileChanged(TSDB_DFILE_IN_SET(pSetFrom, TSDB_FILE_LAST), TSDB_DFILE_IN_SET(pSetTo, TSDB_FILE_LAST))) {
+      tsdbBlkCacheInvalidate(pRepo->pBlkCache, pSetFrom->fid);
+    }
+  }
+}
+
+// A file of a new version has another name, a file written in place another magic and size
+static bool tsdbIsDFileChanged(SDFile *pFrom, SDFile *pTo) {
+  return !tfsIsSameFile(TSDB_FILE_F(pFrom), TSDB_FILE_F(pTo)) || pFrom->info.magic != pTo->info.magic ||
+         pFrom->info.size != pTo->info.size;
+}
+
 // ================== SFSIter
 // ASSUMPTIONS: the FS Should be read locked when calling these functions
 void tsdbFSIterInit(SFSIter *pIter, STsdbFS *pfs, int direction) {
@@ -913,8 +940,9 @@ static int tsdbScanRootDir(STsdbRepo *pRepo) {
   while ((pf = tfsReaddir(tdir))) {
     tfsbasename(pf, bname);
 
-    if (strcmp(bname, tsdbTxnFname[TSDB_TXN_CURR_FILE]) == 0 || strcmp(bname, "data") == 0) {
-      // Skip current file and data directory
+    if (strcmp(bname, tsdbTxnFname[TSDB_TXN_CURR_FILE]) == 0 || strcmp(bname, "data") == 0 ||
+        strcmp(bname, TSDB_LAST_SNAP_FNAME) == 0) {
+      // Skip current file, data directory and last cache snapshot
       continue;
     }
 
@@ -397,7 +397,7 @@ int tsdbUpdateDFileHeader(SDFile *pDFile) {
   }
 
   void *ptr = buf;
-  taosEncodeFixedU32(&ptr, TSDB_FS_VERSION);
+  taosEncodeFixedU32(&ptr, TSDB_LATEST_DFILE_VER);
   tsdbEncodeDFInfo(&ptr, &(pDFile->info));
 
   taosCalcChecksumAppend(0, (uint8_t *)buf, TSDB_FILE_HEAD_SIZE);
@@ -429,6 +429,11 @@ int tsdbLoadDFileHeader(SDFile *pDFile, SDFInfo *pInfo) {
 
   void *pBuf = buf;
   pBuf = taosDecodeFixedU32(pBuf, &_version);
+  if (_version > TSDB_LATEST_DFILE_VER) {
+    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+    return -1;
+  }
+
   pBuf = tsdbDecodeDFInfo(pBuf, pInfo);
   return 0;
 }
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsdbint.h"
+
+// File layout:
+// | version | FS version | total points | total storage | numOfTables | entry ... | checksum |
+// entry:
+// | tid | uid | lastKey | row length | row | numOfCols(-1 if not cached) | schema version | col ... |
+// col:
+// | colId | bytes | ts | data |
+#define TSDB_LAST_SNAP_HEAD_SIZE (sizeof(uint32_t) * 3 + sizeof(int64_t) * 2)
+
+static void tsdbGetLastSnapFname(int repoid, const char *bname, char fname[]);
+static int  tsdbEncodeLastSnapEntry(void **buf, STable *pTable, bool cacheCols);
+static int  tsdbEncodeBytes(void **buf, const void *value, int32_t len);
+static bool tsdbRestoreTableFromLastSnap(STsdbRepo *pRepo, STable *pTable, TSKEY lastKey, SMemRow row,
+                                         int16_t numOfCols, int32_t sversion, void *pCols);
+
+int tsdbSaveLastSnapshot(STsdbRepo *pRepo) {
+  STsdbMeta *  pMeta = pRepo->tsdbMeta;
+  STsdbFSMeta *pFSMeta = &(REPO_FS(pRepo)->cstatus->meta);
+  bool         cacheCols = atomic_load_8(&pRepo->hasCachedLastColumn) != 0;
+  uint32_t     numOfTables = 0;
+  char         tfname[TSDB_FILENAME_LEN] = "\0";
+  char         cfname[TSDB_FILENAME_LEN] = "\0";
+
+  int64_t size = TSDB_LAST_SNAP_HEAD_SIZE + sizeof(TSCKSUM);
+  for (int i = 1; i < pMeta->maxTables; i++) {
+    STable *pTable = pMeta->tables[i];
+    if (pTable == NULL) continue;
+    size += tsdbEncodeLastSnapEntry(NULL, pTable, cacheCols);
+    numOfTables++;
+  }
+
+  void *pBuf = malloc((size_t)size);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  void *ptr = pBuf;
+  taosEncodeFixedU32(&ptr, TSDB_LAST_SNAP_VERSION);
+  taosEncodeFixedU32(&ptr, pFSMeta->version);
+  taosEncodeFixedI64(&ptr, pFSMeta->totalPoints);
+  taosEncodeFixedI64(&ptr, pFSMeta->totalStorage);
+  taosEncodeFixedU32(&ptr, numOfTables);
+  for (int i = 1; i < pMeta->maxTables; i++) {
+    STable *pTable = pMeta->tables[i];
+    if (pTable == NULL) continue;
+    tsdbEncodeLastSnapEntry(&ptr, pTable, cacheCols);
+  }
+
+  ASSERT(POINTER_DISTANCE(ptr, pBuf) + sizeof(TSCKSUM) == size);
+  taosCalcChecksumAppend(0, (uint8_t *)pBuf, (uint32_t)size);
+
+  tsdbGetLastSnapFname(REPO_ID(pRepo), TSDB_LAST_SNAP_TEMP_FNAME, tfname);
+  tsdbGetLastSnapFname(REPO_ID(pRepo), TSDB_LAST_SNAP_FNAME, cfname);
+
+  int fd = open(tfname, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0755);
+  if (fd < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    free(pBuf);
+    return -1;
+  }
+
+  if (taosWrite(fd, pBuf, size) < size || taosFsync(fd) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    close(fd);
+    remove(tfname);
+    free(pBuf);
+    return -1;
+  }
+
+  (void)close(fd);
+  free(pBuf);
+
+  if (taosRename(tfname, cfname) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    remove(tfname);
+    return -1;
+  }
+
+  tsdbInfo("vgId:%d last cache snapshot of %u tables is saved, FS version %u size %" PRId64, REPO_ID(pRepo),
+           numOfTables, pFSMeta->version, size);
+  return 0;
+}
+
+// Restore the tables in the snapshot with one read of the file, and mark them in restored[tid]. The tables not in the
+// snapshot, or whose entry does not match the current schema or cache option, are left to the block scan. Return the
+// number of restored tables.
+int tsdbLoadLastSnapshot(STsdbRepo *pRepo, uint8_t *restored) {
+  STsdbMeta *  pMeta = pRepo->tsdbMeta;
+  STsdbFSMeta *pFSMeta = &(REPO_FS(pRepo)->cstatus->meta);
+  char         fname[TSDB_FILENAME_LEN] = "\0";
+  int64_t      size = 0;
+  void *       pBuf = NULL;
+  int          nRestored = 0;
+
+  tsdbGetLastSnapFname(REPO_ID(pRepo), TSDB_LAST_SNAP_FNAME, fname);
+  if (access(fname, F_OK) != 0) {
+    return 0;
+  }
+
+  struct stat fst;
+  int         fd = open(fname, O_RDONLY | O_BINARY);
+  if (fd < 0 || fstat(fd, &fst) < 0) {
+    tsdbWarn("vgId:%d failed to open last cache snapshot %s since %s", REPO_ID(pRepo), fname, strerror(errno));
+    goto _over;
+  }
+  size = fst.st_size;
+
+  if (size < (int64_t)(TSDB_LAST_SNAP_HEAD_SIZE + sizeof(TSCKSUM)) || size > UINT32_MAX ||
+      (pBuf = malloc((size_t)size)) == NULL || taosRead(fd, pBuf, size) < size ||
+      !taosCheckChecksumWhole((uint8_t *)pBuf, (uint32_t)size)) {
+    tsdbWarn("vgId:%d last cache snapshot %s is corrupted, size %" PRId64, REPO_ID(pRepo), fname, size);
+    goto _over;
+  }
+
+  uint32_t snapVersion, fsVersion, numOfTables;
+  int64_t  totalPoints, totalStorage;
+  void *   ptr = pBuf;
+  ptr = taosDecodeFixedU32(ptr, &snapVersion);
+  ptr = taosDecodeFixedU32(ptr, &fsVersion);
+  ptr = taosDecodeFixedI64(ptr, &totalPoints);
+  ptr = taosDecodeFixedI64(ptr, &totalStorage);
+  ptr = taosDecodeFixedU32(ptr, &numOfTables);
+
+  if (snapVersion != TSDB_LAST_SNAP_VERSION || fsVersion != pFSMeta->version || totalPoints != pFSMeta->totalPoints ||
+      totalStorage != pFSMeta->totalStorage) {
+    tsdbInfo("vgId:%d last cache snapshot is out of date, version %u FS version %u, current FS version %u",
+             REPO_ID(pRepo), snapVersion, fsVersion, pFSMeta->version);
+    goto _over;
+  }
+
+  for (uint32_t n = 0; n < numOfTables; n++) {
+    int32_t  tid, sversion;
+    uint64_t uid;
+    TSKEY    lastKey;
+    uint32_t rowLen;
+    int16_t  numOfCols;
+
+    ptr = taosDecodeFixedI32(ptr, &tid);
+    ptr = taosDecodeFixedU64(ptr, &uid);
+    ptr = taosDecodeFixedI64(ptr, &lastKey);
+    ptr = taosDecodeFixedU32(ptr, &rowLen);
+    SMemRow row = (rowLen > 0) ? ptr : NULL;
+    ptr = POINTER_SHIFT(ptr, rowLen);
+    ptr = taosDecodeFixedI16(ptr, &numOfCols);
+    ptr = taosDecodeFixedI32(ptr, &sversion);
+    void *pCols = ptr;
+    for (int16_t i = 0; i < numOfCols; i++) {
+      int32_t bytes;
+      ptr = POINTER_SHIFT(ptr, sizeof(int16_t));
+      ptr = taosDecodeFixedI32(ptr, &bytes);
+      ptr = POINTER_SHIFT(ptr, sizeof(TSKEY) + bytes);
+    }
+
+    if (tid <= 0 || tid >= pMeta->maxTables) continue;
+    STable *pTable = pMeta->tables[tid];
+    if (pTable == NULL || TABLE_UID(pTable) != uid) continue;
+
+    if (tsdbRestoreTableFromLastSnap(pRepo, pTable, lastKey, row, numOfCols, sversion, pCols)) {
+      restored[tid] = 1;
+      nRestored++;
+    }
+  }
+
+  tsdbInfo("vgId:%d %d of %u tables are restored from last cache snapshot", REPO_ID(pRepo), nRestored, numOfTables);
+
+_over:
+  if (fd >= 0) close(fd);
+  tfree(pBuf);
+
+  // The snapshot is only valid for the FS version it is saved with, so never load it twice
+  (void)remove(fname);
+  return nRestored;
+}
+
+static void tsdbGetLastSnapFname(int repoid, const char *bname, char fname[]) {
+  snprintf(fname, TSDB_FILENAME_LEN, "%s/vnode/vnode%d/tsdb/%s", TFS_PRIMARY_PATH(), repoid, bname);
+}
+
+static int tsdbEncodeBytes(void **buf, const void *value, int32_t len) {
+  if (buf != NULL) {
+    memcpy(*buf, value, len);
+    *buf = POINTER_SHIFT(*buf, len);
+  }
+
+  return len;
+}
+
+static int tsdbEncodeLastSnapEntry(void **buf, STable *pTable, bool cacheCols) {
+  int      tlen = 0;
+  uint32_t rowLen = (pTable->lastRow != NULL) ? memRowTLen(pTable->lastRow) : 0;
+
+  tlen += taosEncodeFixedI32(buf, TABLE_TID(pTable));
+  tlen += taosEncodeFixedU64(buf, TABLE_UID(pTable));
+  tlen += taosEncodeFixedI64(buf, pTable->lastKey);
+  tlen += taosEncodeFixedU32(buf, rowLen);
+  tlen += tsdbEncodeBytes(buf, pTable->lastRow, rowLen);
+
+  if (!cacheCols || pTable->lastCols == NULL) {
+    tlen += taosEncodeFixedI16(buf, -1);
+    tlen += taosEncodeFixedI32(buf, -1);
+    return tlen;
+  }
+
+  tlen += taosEncodeFixedI16(buf, pTable->maxColNum);
+  tlen += taosEncodeFixedI32(buf, pTable->lastColSVersion);
+  for (int16_t i = 0; i < pTable->maxColNum; i++) {
+    SDataCol *pDataCol = pTable->lastCols + i;
+    tlen += taosEncodeFixedI16(buf, pDataCol->colId);
+    tlen += taosEncodeFixedI32(buf, pDataCol->bytes);
+    tlen += taosEncodeFixedI64(buf, (pDataCol->bytes > 0) ? pDataCol->ts : TSKEY_INITIAL_VAL);
+    tlen += tsdbEncodeBytes(buf, pDataCol->pData, pDataCol->bytes);
+  }
+
+  return tlen;
+}
+
+static bool tsdbRestoreTableFromLastSnap(STsdbRepo *pRepo, STable *pTable, TSKEY lastKey, SMemRow row,
+                                         int16_t numOfCols, int32_t sversion, void *pCols) {
+  STsdbCfg *pCfg = REPO_CFG(pRepo);
+  STSchema *pSchema = tsdbGetTableLatestSchema(pTable);
+  bool      hasData = (lastKey != TSKEY_INITIAL_VAL);
+
+  ASSERT(pTable->lastRow == NULL && pTable->lastCols == NULL);
+  if (pSchema == NULL) return false;
+
+  // the entry must hold everything the cache option asks for, or the table goes to the block scan
+  if (hasData && CACHE_LAST_ROW(pCfg)) {
+    if (row == NULL || memRowKey(row) != lastKey || tsdbGetTableSchemaByVersion(pTable, memRowVersion(row)) == NULL) {
+      return false;
+    }
+  }
+
+  if (hasData && CACHE_LAST_NULL_COLUMN(pCfg)) {
+    if (numOfCols != schemaNCols(pSchema) || sversion != schemaVersion(pSchema)) {
+      return false;
+    }
+
+    void *ptr = pCols;
+    for (int16_t i = 0; i < numOfCols; i++) {
+      int16_t colId;
+      int32_t bytes;
+      ptr = taosDecodeFixedI16(ptr, &colId);
+      ptr = taosDecodeFixedI32(ptr, &bytes);
+      ptr = POINTER_SHIFT(ptr, sizeof(TSKEY) + bytes);
+      if (colId != schemaColAt(pSchema, i)->colId) return false;
+    }
+  }
+
+  if (hasData && CACHE_LAST_ROW(pCfg)) {
+    uint32_t rowLen = memRowTLen(row);
+    pTable->lastRow = taosTMalloc(rowLen);
+    if (pTable->lastRow == NULL) return false;
+    memcpy(pTable->lastRow, row, rowLen);
+  }
+
+  if (hasData && CACHE_LAST_NULL_COLUMN(pCfg)) {
+    if (tsdbInitColIdCacheWithSchema(pTable, pSchema) < 0) {
+      taosTZfree(pTable->lastRow);
+      pTable->lastRow = NULL;
+      return false;
+    }
+
+    void *ptr = pCols;
+    for (int16_t i = 0; i < numOfCols; i++) {
+      SDataCol *pDataCol = pTable->lastCols + i;
+      int32_t   bytes;
+      ptr = POINTER_SHIFT(ptr, sizeof(int16_t));
+      ptr = taosDecodeFixedI32(ptr, &bytes);
+      ptr = taosDecodeFixedI64(ptr, &(pDataCol->ts));
+      if (bytes > 0) {
+        if ((pDataCol->pData = malloc(bytes)) == NULL) {
+          tsdbFreeLastColumns(pTable);
+          taosTZfree(pTable->lastRow);
+          pTable->lastRow = NULL;
+          return false;
+        }
+        memcpy(pDataCol->pData, ptr, bytes);
+        pDataCol->bytes = bytes;
+        pTable->restoreColumnNum += 1;
+      }
+      ptr = POINTER_SHIFT(ptr, bytes);
+    }
+  }
+
+  if (CACHE_LAST_NULL_COLUMN(pCfg)) {
+    // columns never written are not searched again, the snapshot is saved after the scan of all file sets
+    pTable->hasRestoreLastColumn = true;
+  }
+  pTable->lastKey = lastKey;
+
+  return true;
+}
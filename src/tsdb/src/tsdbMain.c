@@ -124,11 +124,17 @@ int tsdbCloseRepo(STsdbRepo *repo, int toCommit) {
 
   tsdbStopStream(pRepo);
 
-  if (toCommit) {
-    tsdbSyncCommit(repo);
+  if (toCommit && tsdbSyncCommit(repo) == 0 && pRepo->mem == NULL) {
+    // all writes are committed and stopped, so the cached last data is the committed one
+    if (tsdbSaveLastSnapshot(pRepo) < 0) {
+      tsdbWarn("vgId:%d failed to save last cache snapshot since %s", vgId, tstrerror(terrno));
+      terrno = TSDB_CODE_SUCCESS;
+    }
   }
 
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
 
   tsdbUnRefMemTable(pRepo, pRepo->mem);
   tsdbUnRefMemTable(pRepo, pRepo->imem);
@@ -589,11 +595,21 @@ static STsdbRepo *tsdbNewRepo(STsdbCfg *pCfg, STsdbAppH *pAppH) {
     return NULL;
   }
 
+  if (tsBlockCacheSize > 0) {
+    pRepo->pBlkCache = tsdbNewBlkCache((int64_t)tsBlockCacheSize * 1024 * 1024);
+    if (pRepo->pBlkCache == NULL) {
+      tsdbError("vgId:%d failed to create block cache since %s", REPO_ID(pRepo), tstrerror(terrno));
+      tsdbFreeRepo(pRepo);
+      return NULL;
+    }
+  }
+
   return pRepo;
 }
 
 static void tsdbFreeRepo(STsdbRepo *pRepo) {
   if (pRepo) {
+    tsdbFreeBlkCache(pRepo->pBlkCache);
     tsdbFreeFS(pRepo->fs);
     tsdbFreeBufPool(pRepo->pPool);
     tsdbFreeMeta(pRepo->tsdbMeta);
@@ -804,41 +820,58 @@ int tsdbRestoreInfo(STsdbRepo *pRepo) {
   SDFileSet *pSet;
   STsdbMeta *pMeta = pRepo->tsdbMeta;
   STsdbCfg * pCfg = REPO_CFG(pRepo);
+  int        numOfTables = 0;
 
-  if (tsdbInitReadH(&readh, pRepo) < 0) {
+  for (int i = 1; i < pMeta->maxTables; i++) {
+    STable *pTable = pMeta->tables[i];
+    if (pTable == NULL) continue;
+    numOfTables++;
+    if (CACHE_LAST_NULL_COLUMN(pCfg)) {
+      pTable->restoreColumnNum = 0;  
+      pTable->hasRestoreLastColumn = false;
+    }
+  }
+
+  // tables restored from the last cache snapshot skip the block scan
+  uint8_t *restored = calloc(pMeta->maxTables, sizeof(uint8_t));
+  if (restored == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
     return -1;
   }
 
-  tsdbFSIterInit(&fsiter, REPO_FS(pRepo), TSDB_FS_ITER_BACKWARD);
+  if (tsdbLoadLastSnapshot(pRepo, restored) >= numOfTables) {
+    goto _over;
+  }
 
-  if (CACHE_LAST_NULL_COLUMN(pCfg)) {
-    for (int i = 1; i < pMeta->maxTables; i++) {
-      STable *pTable = pMeta->tables[i];
-      if (pTable == NULL) continue;
-      pTable->restoreColumnNum = 0;  
-      pTable->hasRestoreLastColumn = false;
-    }
+  if (tsdbInitReadH(&readh, pRepo) < 0) {
+    free(restored);
+    return -1;
   }
 
+  tsdbFSIterInit(&fsiter, REPO_FS(pRepo), TSDB_FS_ITER_BACKWARD);
+
   while ((pSet = tsdbFSIterNext(&fsiter)) != NULL) {
     if (tsdbSetAndOpenReadFSet(&readh, pSet) < 0) {
       tsdbDestroyReadH(&readh);
+      free(restored);
       return -1;
     }
 
     if (tsdbLoadBlockIdx(&readh) < 0) {
       tsdbDestroyReadH(&readh);
+      free(restored);
       return -1;
     }
 
     for (int i = 1; i < pMeta->maxTables; i++) {
       STable *pTable = pMeta->tables[i];
-      if (pTable == NULL) continue;
+      if (pTable == NULL || restored[i]) continue;
 
       //tsdbInfo("tsdbRestoreInfo restore vgId:%d,table:%s", REPO_ID(pRepo), pTable->name->data);
 
       if (tsdbSetReadTable(&readh, pTable) < 0) {
         tsdbDestroyReadH(&readh);
+        free(restored);
         return -1;
       }
 
@@ -849,6 +882,7 @@ int tsdbRestoreInfo(STsdbRepo *pRepo) {
 
         if (CACHE_LAST_ROW(pCfg) && tsdbRestoreLastRow(pRepo, pTable, &readh, pIdx) != 0) {
           tsdbDestroyReadH(&readh);
+          free(restored);
           return -1;
         }
       }
@@ -857,6 +891,7 @@ int tsdbRestoreInfo(STsdbRepo *pRepo) {
       if (pIdx && CACHE_LAST_NULL_COLUMN(pCfg) && !pTable->hasRestoreLastColumn) {
         if (tsdbRestoreLastColumns(pRepo, pTable, &readh) != 0) {
           tsdbDestroyReadH(&readh);
+          free(restored);
           return -1;
         }
       }
@@ -865,6 +900,9 @@ int tsdbRestoreInfo(STsdbRepo *pRepo) {
 
   tsdbDestroyReadH(&readh);
 
+_over:
+  free(restored);
+
   if (CACHE_LAST_NULL_COLUMN(pCfg)) {
     atomic_store_8(&pRepo->hasCachedLastColumn, 1);
   }
@@ -30,6 +30,13 @@ typedef struct {
   void *  pMsg;
 } SSubmitMsgIter;
 
+// Bytes reserved from the current TSDB buffer block for the rows of one SSubmitBlk
+typedef struct {
+  char *  ptr;     // next free byte of the reservation
+  int32_t remain;  // reserved bytes not used yet
+  int32_t left;    // bytes of the rows not copied yet
+} SMemRowArena;
+
 static SMemTable * tsdbNewMemTable(STsdbRepo *pRepo);
 static void        tsdbFreeMemTable(SMemTable *pMemTable);
 static STableData *tsdbNewTableData(STsdbCfg *pCfg, STable *pTable);
@@ -41,15 +48,20 @@ static int          tsdbInitSubmitBlkIter(SSubmitBlk *pBlock, SSubmitBlkIter *pI
 static SMemRow          tsdbGetSubmitBlkNext(SSubmitBlkIter *pIter);
 static int          tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg);
 static int          tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows);
-static int              tsdbCopyRowToMem(STsdbRepo *pRepo, SMemRow row, STable *pTable, void **ppRow);
+static int              tsdbCopyRowToMem(STsdbRepo *pRepo, SMemRowArena *pArena, SMemRow row, STable *pTable,
+                                         void **ppRow);
+static void *           tsdbAllocRowBytes(STsdbRepo *pRepo, SMemRowArena *pArena, int bytes);
+static void             tsdbReleaseRowArena(STsdbRepo *pRepo, SMemRowArena *pArena);
 static int          tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter);
 static int          tsdbGetSubmitMsgNext(SSubmitMsgIter *pIter, SSubmitBlk **pPBlock);
 static int          tsdbCheckTableSchema(STsdbRepo *pRepo, SSubmitBlk *pBlock, STable *pTable);
 static int          tsdbInsertDataToTableImpl(STsdbRepo *pRepo, STable *pTable, void **rows, int rowCounter);
 static void         tsdbFreeRows(STsdbRepo *pRepo, void **rows, int rowCounter);
-static int              tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, SMemRow row);
-static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMemRow row, TSKEY minKey, TSKEY maxKey,
+static int              tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, void **rows, int rowCounter);
+static FORCE_INLINE int tsdbCheckKeyRange(STsdbRepo *pRepo, STable *pTable, TSKEY key, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now);
+static int              tsdbLocateColBlkCols(SSubmitBlk *pBlock, STSchema *pSchema, char **pCols);
+static int              tsdbInsertColDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows);
 
 int32_t tsdbInsertData(STsdbRepo *repo, SSubmitMsg *pMsg, SShellSubmitRspMsg *pRsp) {
   STsdbRepo *    pRepo = repo;
@@ -272,7 +284,9 @@ void *tsdbAllocBytes(STsdbRepo *pRepo, int bytes) {
 
 int tsdbSyncCommitConfig(STsdbRepo* pRepo) {
   ASSERT(pRepo->config_changed == true);
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
 
   if (pRepo->code != TSDB_CODE_SUCCESS) {
     tsdbWarn("vgId:%d try to commit config when TSDB not in good state: %s", REPO_ID(pRepo), tstrerror(terrno));
@@ -295,7 +309,9 @@ int tsdbSyncCommitConfig(STsdbRepo* pRepo) {
 }
 
 int tsdbAsyncCommit(STsdbRepo *pRepo) {
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
 
   ASSERT(pRepo->imem == NULL);
   if (pRepo->mem == NULL) {
@@ -321,7 +337,9 @@ int tsdbSyncCommit(STsdbRepo *repo) {
   STsdbRepo *pRepo = repo;
 
   tsdbAsyncCommit(pRepo);
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
   tsem_post(&(pRepo->readyToCommit));
 
   if (pRepo->code != TSDB_CODE_SUCCESS) {
@@ -609,9 +627,8 @@ static SMemRow tsdbGetSubmitBlkNext(SSubmitBlkIter *pIter) {
   return row;
 }
 
-static FORCE_INLINE int tsdbCheckRowRange(STsdbRepo *pRepo, STable *pTable, SMemRow row, TSKEY minKey, TSKEY maxKey,
+static FORCE_INLINE int tsdbCheckKeyRange(STsdbRepo *pRepo, STable *pTable, TSKEY rowKey, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now) {
-  TSKEY rowKey = memRowKey(row);
   if (rowKey < minKey || rowKey > maxKey) {
     tsdbError("vgId:%d table %s tid %d uid %" PRIu64 " timestamp is out of range! now %" PRId64 " minKey %" PRId64
               " maxKey %" PRId64 " row key %" PRId64,
@@ -646,6 +663,7 @@ static int tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg) {
 
     pBlock->uid = htobe64(pBlock->uid);
     pBlock->tid = htonl(pBlock->tid);
+    pBlock->flag = htonl(pBlock->flag);
     pBlock->sversion = htonl(pBlock->sversion);
     pBlock->dataLen = htonl(pBlock->dataLen);
     pBlock->schemaLen = htonl(pBlock->schemaLen);
@@ -681,9 +699,27 @@ static int tsdbScanAndConvertSubmitMsg(STsdbRepo *pRepo, SSubmitMsg *pMsg) {
       }
     }
 
+    if (SUBMIT_BLK_IS_COLUMNAR(pBlock)) {
+      STSchema *pSchema = tsdbGetTableSchemaByVersion(pTable, pBlock->sversion);
+      if (pSchema == NULL || tsdbLocateColBlkCols(pBlock, pSchema, NULL) < 0) {
+        tsdbError("vgId:%d invalid columnar submit block of table %s tid %d, rows %d dataLen %d", REPO_ID(pRepo),
+                  TABLE_CHAR_NAME(pTable), TABLE_TID(pTable), pBlock->numOfRows, pBlock->dataLen);
+        terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
+        return -1;
+      }
+
+      TSKEY *keys = (TSKEY *)(pBlock->data + pBlock->schemaLen);
+      for (int i = 0; i < pBlock->numOfRows; i++) {
+        if (tsdbCheckKeyRange(pRepo, pTable, keys[i], minKey, maxKey, now) < 0) {
+          return -1;
+        }
+      }
+      continue;
+    }
+
     tsdbInitSubmitBlkIter(pBlock, &blkIter);
     while ((row = tsdbGetSubmitBlkNext(&blkIter)) != NULL) {
-      if (tsdbCheckRowRange(pRepo, pTable, row, minKey, maxKey, now) < 0) {
+      if (tsdbCheckKeyRange(pRepo, pTable, memRowKey(row), minKey, maxKey, now) < 0) {
         return -1;
       }
     }
@@ -701,14 +737,21 @@ static int tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *
   SMemRow        row = NULL;
   void *         rows[TSDB_MAX_INSERT_BATCH] = {0};
   int            rowCounter = 0;
+  SMemRowArena   arena = {0};
+
+  if (SUBMIT_BLK_IS_COLUMNAR(pBlock)) {
+    return tsdbInsertColDataToTable(pRepo, pBlock, affectedrows);
+  }
 
   ASSERT(pBlock->tid < pMeta->maxTables);
   pTable = pMeta->tables[pBlock->tid];
   ASSERT(pTable != NULL && TABLE_UID(pTable) == pBlock->uid);
 
   tsdbInitSubmitBlkIter(pBlock, &blkIter);
+  arena.left = pBlock->dataLen;
   while ((row = tsdbGetSubmitBlkNext(&blkIter)) != NULL) {
-    if (tsdbCopyRowToMem(pRepo, row, pTable, &(rows[rowCounter])) < 0) {
+    if (tsdbCopyRowToMem(pRepo, &arena, row, pTable, &(rows[rowCounter])) < 0) {
+      tsdbReleaseRowArena(pRepo, &arena);
       tsdbFreeRows(pRepo, rows, rowCounter);
       goto _err;
     }
@@ -721,6 +764,7 @@ static int tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *
     }
 
     if (rowCounter == TSDB_MAX_INSERT_BATCH) {
+      tsdbReleaseRowArena(pRepo, &arena);
       if (tsdbInsertDataToTableImpl(pRepo, pTable, rows, rowCounter) < 0) {
         goto _err;
       }
@@ -730,6 +774,7 @@ static int tsdbInsertDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *
     }
   }
 
+  tsdbReleaseRowArena(pRepo, &arena);
   if (rowCounter > 0 && tsdbInsertDataToTableImpl(pRepo, pTable, rows, rowCounter) < 0) {
     goto _err;
   }
@@ -744,7 +789,188 @@ _err:
   return -1;
 }
 
-static int tsdbCopyRowToMem(STsdbRepo *pRepo, SMemRow row, STable *pTable, void **ppRow) {
+// Check the column chunks of a columnar submit block against the schema and save the start of each chunk to pCols
+// if pCols is not NULL. Return the total bytes of the var length values, or -1 if the block is malformed.
+static int tsdbLocateColBlkCols(SSubmitBlk *pBlock, STSchema *pSchema, char **pCols) {
+  int32_t nrows = pBlock->numOfRows;
+  char *  ptr = pBlock->data + pBlock->schemaLen;
+  char *  pEnd = ptr + pBlock->dataLen;
+  int     varBytes = 0;
+
+  if (nrows <= 0 || colType(schemaColAt(pSchema, 0)) != TSDB_DATA_TYPE_TIMESTAMP) return -1;
+
+  for (int j = 0; j < schemaNCols(pSchema); j++) {
+    STColumn *pCol = schemaColAt(pSchema, j);
+
+    if (pCols) pCols[j] = ptr;
+    if (!IS_VAR_DATA_TYPE(colType(pCol))) {
+      ptr += (int64_t)TYPE_BYTES[colType(pCol)] * nrows;
+      if (ptr > pEnd) return -1;
+      continue;
+    }
+
+    int32_t *offsets = (int32_t *)ptr;
+    if (ptr + sizeof(int32_t) * (nrows + 1) > pEnd) return -1;
+    int32_t len = offsets[nrows];
+    char *  pVar = ptr + sizeof(int32_t) * (nrows + 1);
+    if (len < 0 || pVar + len > pEnd) return -1;
+
+    for (int i = 0; i < nrows; i++) {
+      if (offsets[i] < 0 || offsets[i] > len - (int32_t)VARSTR_HEADER_SIZE) return -1;
+      void *value = pVar + offsets[i];
+      if (varDataLen(value) < 0 || varDataLen(value) > colBytes(pCol) - VARSTR_HEADER_SIZE ||
+          offsets[i] + (int32_t)varDataTLen(value) > len) {
+        return -1;
+      }
+    }
+
+    varBytes += len;
+    ptr = pVar + len;
+  }
+
+  return (ptr == pEnd) ? varBytes : -1;
+}
+
+typedef struct {
+  TSKEY   key;
+  int32_t idx;
+} SColBlkKey;
+
+static int tsdbCompareColBlkKey(const void *p1, const void *p2) {
+  const SColBlkKey *pKey1 = (const SColBlkKey *)p1;
+  const SColBlkKey *pKey2 = (const SColBlkKey *)p2;
+
+  if (pKey1->key != pKey2->key) return (pKey1->key < pKey2->key) ? -1 : 1;
+  return (pKey1->idx < pKey2->idx) ? -1 : ((pKey1->idx > pKey2->idx) ? 1 : 0);
+}
+
+// Insert a columnar submit block. The rows are built in the TSDB buffer directly from the column chunks, in key
+// order, so the columns are copied only once.
+static int tsdbInsertColDataToTable(STsdbRepo *pRepo, SSubmitBlk *pBlock, int32_t *affectedrows) {
+  STsdbMeta *  pMeta = pRepo->tsdbMeta;
+  STable *     pTable = NULL;
+  STSchema *   pSchema = NULL;
+  char **      pCols = NULL;
+  SColBlkKey * pKeys = NULL;
+  void *       rows[TSDB_MAX_INSERT_BATCH] = {0};
+  int          rowCounter = 0;
+  SMemRowArena arena = {0};
+  int32_t      nrows = pBlock->numOfRows;
+
+  ASSERT(pBlock->tid < pMeta->maxTables);
+  pTable = pMeta->tables[pBlock->tid];
+  ASSERT(pTable != NULL && TABLE_UID(pTable) == pBlock->uid);
+
+  pSchema = tsdbGetTableSchemaByVersion(pTable, pBlock->sversion);
+  ASSERT(pSchema != NULL);
+  int ncols = schemaNCols(pSchema);
+
+  pCols = (char **)malloc(sizeof(char *) * ncols);
+  if (pCols == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int varBytes = tsdbLocateColBlkCols(pBlock, pSchema, pCols);
+  ASSERT(varBytes >= 0);
+
+  // rows are put to the skiplist in batches which must be sorted by key. Like the rows deduplicated by the client in
+  // tscSortRemoveDataBlockDupRows, only one row of a key is inserted, the first one bound.
+  TSKEY *tsCol = (TSKEY *)pCols[0];
+  int    numOfRows = nrows;
+  for (int i = 1; i < nrows; i++) {
+    if (tsCol[i] <= tsCol[i - 1]) {
+      pKeys = (SColBlkKey *)malloc(sizeof(SColBlkKey) * nrows);
+      if (pKeys == NULL) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        goto _err;
+      }
+
+      for (int k = 0; k < nrows; k++) {
+        pKeys[k].key = tsCol[k];
+        pKeys[k].idx = k;
+      }
+      qsort(pKeys, nrows, sizeof(SColBlkKey), tsdbCompareColBlkKey);
+
+      numOfRows = 1;
+      for (int k = 1; k < nrows; k++) {
+        if (pKeys[k].key != pKeys[numOfRows - 1].key) pKeys[numOfRows++] = pKeys[k];
+      }
+      break;
+    }
+  }
+
+  int32_t flen = TD_MEM_ROW_DATA_HEAD_SIZE + schemaFLen(pSchema);
+  arena.left = flen * numOfRows + varBytes;
+  for (int i = 0; i < numOfRows; i++) {
+    int idx = (pKeys == NULL) ? i : pKeys[i].idx;
+
+    int32_t tlen = flen;
+    for (int j = 0; j < ncols; j++) {
+      STColumn *pCol = schemaColAt(pSchema, j);
+      if (IS_VAR_DATA_TYPE(colType(pCol))) {
+        char *pVar = pCols[j] + sizeof(int32_t) * (nrows + 1);
+        tlen += varDataTLen(pVar + ((int32_t *)pCols[j])[idx]);
+      }
+    }
+
+    SMemRow row = tsdbAllocRowBytes(pRepo, &arena, tlen);
+    if (row == NULL) {
+      tsdbError("vgId:%d failed to insert row with key %" PRId64 " to table %s while allocate %d bytes since %s",
+                REPO_ID(pRepo), tsCol[idx], TABLE_CHAR_NAME(pTable), tlen, tstrerror(terrno));
+      tsdbReleaseRowArena(pRepo, &arena);
+      tsdbFreeRows(pRepo, rows, rowCounter);
+      goto _err;
+    }
+
+    memRowSetType(row, SMEM_ROW_DATA);
+    SDataRow trow = memRowDataBody(row);
+    dataRowSetLen(trow, (TDRowLenT)(TD_DATA_ROW_HEAD_SIZE + schemaFLen(pSchema)));
+    dataRowSetVersion(trow, pBlock->sversion);
+    for (int j = 0; j < ncols; j++) {
+      STColumn *pCol = schemaColAt(pSchema, j);
+      void *    value = NULL;
+      if (IS_VAR_DATA_TYPE(colType(pCol))) {
+        value = pCols[j] + sizeof(int32_t) * (nrows + 1) + ((int32_t *)pCols[j])[idx];
+      } else {
+        value = pCols[j] + TYPE_BYTES[colType(pCol)] * idx;
+      }
+      tdAppendColVal(trow, value, colType(pCol), colOffset(pCol));
+    }
+
+    rows[rowCounter++] = row;
+    (*affectedrows)++;
+
+    if (rowCounter == TSDB_MAX_INSERT_BATCH) {
+      tsdbReleaseRowArena(pRepo, &arena);
+      if (tsdbInsertDataToTableImpl(pRepo, pTable, rows, rowCounter) < 0) {
+        goto _err;
+      }
+
+      rowCounter = 0;
+      memset(rows, 0, sizeof(rows));
+    }
+  }
+
+  tsdbReleaseRowArena(pRepo, &arena);
+  if (rowCounter > 0 && tsdbInsertDataToTableImpl(pRepo, pTable, rows, rowCounter) < 0) {
+    goto _err;
+  }
+
+  pRepo->stat.pointsWritten += (int64_t)numOfRows * ncols;
+  pRepo->stat.totalStorage += (int64_t)numOfRows * schemaVLen(pSchema);
+
+  tfree(pKeys);
+  tfree(pCols);
+  return 0;
+
+_err:
+  tfree(pKeys);
+  tfree(pCols);
+  return -1;
+}
+
+static int tsdbCopyRowToMem(STsdbRepo *pRepo, SMemRowArena *pArena, SMemRow row, STable *pTable, void **ppRow) {
   STsdbCfg *  pCfg = &pRepo->config;
   TKEY        tkey = memRowTKey(row);
   TSKEY       key = memRowKey(row);
@@ -761,11 +987,12 @@ static int tsdbCopyRowToMem(STsdbRepo *pRepo, SMemRow row, STable *pTable, void
     if (key > lastKey) {
       tsdbTrace("vgId:%d skip to delete row key %" PRId64 " which is larger than table lastKey %" PRId64,
                 REPO_ID(pRepo), key, lastKey);
+      pArena->left -= memRowTLen(row);
       return 0;
     }
   }
 
-  void *pRow = tsdbAllocBytes(pRepo, memRowTLen(row));
+  void *pRow = tsdbAllocRowBytes(pRepo, pArena, memRowTLen(row));
   if (pRow == NULL) {
     tsdbError("vgId:%d failed to insert row with key %" PRId64 " to table %s while allocate %" PRIu32 " bytes since %s",
               REPO_ID(pRepo), key, TABLE_CHAR_NAME(pTable), memRowTLen(row), tstrerror(terrno));
@@ -782,6 +1009,55 @@ static int tsdbCopyRowToMem(STsdbRepo *pRepo, SMemRow row, STable *pTable, void
   return 0;
 }
 
+// Allocate a row from the arena. When the arena runs out, the row is allocated by tsdbAllocBytes and the arena is
+// refilled with the bytes of the rows left, as many as the current TSDB buffer block holds, so the rows of one
+// SSubmitBlk take one reservation per buffer block and the layout is the same as allocating row by row.
+static void *tsdbAllocRowBytes(STsdbRepo *pRepo, SMemRowArena *pArena, int bytes) {
+  void *ptr = NULL;
+
+  if (pArena->remain >= bytes) {
+    ptr = pArena->ptr;
+    pArena->ptr += bytes;
+    pArena->remain -= bytes;
+    pArena->left -= bytes;
+    return ptr;
+  }
+
+  tsdbReleaseRowArena(pRepo, pArena);
+
+  ptr = tsdbAllocBytes(pRepo, bytes);
+  if (ptr == NULL) return NULL;
+  pArena->left -= bytes;
+
+  // rows allocated from SYSTEM buffer are not batched
+  if (pRepo->mem->extraBuffList == NULL && pArena->left > 0) {
+    STsdbBufBlock *pBufBlock = tsdbGetCurrBufBlock(pRepo);
+    int32_t        reserve = MIN(pArena->left, pBufBlock->remain);
+
+    ASSERT(POINTER_SHIFT(ptr, bytes) == POINTER_SHIFT(pBufBlock->data, pBufBlock->offset));
+    pArena->ptr = POINTER_SHIFT(ptr, bytes);
+    pArena->remain = reserve;
+    pBufBlock->offset += reserve;
+    pBufBlock->remain -= reserve;
+  }
+
+  return ptr;
+}
+
+// Give the unused bytes of the arena back to the current TSDB buffer block
+static void tsdbReleaseRowArena(STsdbRepo *pRepo, SMemRowArena *pArena) {
+  if (pArena->remain <= 0) return;
+
+  STsdbBufBlock *pBufBlock = tsdbGetCurrBufBlock(pRepo);
+  ASSERT(pBufBlock != NULL && POINTER_SHIFT(pArena->ptr, pArena->remain) ==
+                                  POINTER_SHIFT(pBufBlock->data, pBufBlock->offset));
+
+  pBufBlock->offset -= pArena->remain;
+  pBufBlock->remain += pArena->remain;
+  pArena->ptr = NULL;
+  pArena->remain = 0;
+}
+
 static int tsdbInitSubmitMsgIter(SSubmitMsg *pMsg, SSubmitMsgIter *pIter) {
   if (pMsg == NULL) {
     terrno = TSDB_CODE_TDB_SUBMIT_MSG_MSSED_UP;
@@ -944,7 +1220,7 @@ static int tsdbInsertDataToTableImpl(STsdbRepo *pRepo, STable *pTable, void **ro
   pTableData->numOfRows += dsize;
 
   // update table latest info
-  if (tsdbUpdateTableLatestInfo(pRepo, pTable, rows[rowCounter - 1]) < 0) {
+  if (tsdbUpdateTableLatestInfo(pRepo, pTable, rows, rowCounter) < 0) {
     return -1;
   }
 
@@ -1047,8 +1323,10 @@ static void updateTableLatestColumn(STsdbRepo *pRepo, STable *pTable, SMemRow ro
   }
 }
 
-static int tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, SMemRow row) {
+static int tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, void **rows, int rowCounter) {
   STsdbCfg *pCfg = &pRepo->config;
+  SMemRow   row = rows[rowCounter - 1];
+  TSKEY     lastKey = tsdbGetTableLastKeyImpl(pTable);
 
   // if cacheLastRow config has been reset, free the lastRow
   if (!pCfg->cacheLastRow && pTable->lastRow != NULL) {
@@ -1058,7 +1336,7 @@ static int tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, SMemRow r
     TSDB_WUNLOCK_TABLE(pTable);
   }
 
-  if (tsdbGetTableLastKeyImpl(pTable) < memRowKey(row)) {
+  if (lastKey < memRowKey(row)) {
     if (CACHE_LAST_ROW(pCfg) || pTable->lastRow != NULL) {
       SMemRow nrow = pTable->lastRow;
       if (taosTSizeof(nrow) < memRowTLen(row)) {
@@ -1086,7 +1364,10 @@ static int tsdbUpdateTableLatestInfo(STsdbRepo *pRepo, STable *pTable, SMemRow r
     }
 
     if (CACHE_LAST_NULL_COLUMN(pCfg)) {
-      updateTableLatestColumn(pRepo, pTable, row);
+      // the last non-NULL value of a column may come from any new row of the sorted rows, not only the last one
+      for (int i = 0; i < rowCounter; i++) {
+        if (memRowKey(rows[i]) > lastKey) updateTableLatestColumn(pRepo, pTable, rows[i]);
+      }
     }
   }
   return 0;
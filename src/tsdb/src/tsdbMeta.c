@@ -395,9 +395,14 @@ int tsdbUpdateTableTagValue(STsdbRepo *repo, SUpdateTableTagValMsg *pMsg) {
   // STColumn *pCol = bsearch(&(pMsg->colId), pMsg->data, pMsg->numOfTags, sizeof(STColumn), colIdCompar);
   // ASSERT(pCol != NULL);
 
+  bool      hasTagIndex = (pTable->pSuper->pTagIndex != NULL);
+
   if (isChangeIndexCol) {
     tsdbWLockRepoMeta(pRepo);
     tsdbRemoveTableFromIndex(pMeta, pTable);
+  } else if (hasTagIndex) {
+    tsdbWLockRepoMeta(pRepo);
+    tsdbRemoveTableFromTagIndex(pTable->pSuper, pTable);
   }
   TSDB_WLOCK_TABLE(pTable);
   tdSetKVRowDataOfCol(&(pTable->tagVal), pMsg->colId, pMsg->type, POINTER_SHIFT(pMsg->data, pMsg->schemaLen));
@@ -405,6 +410,9 @@ int tsdbUpdateTableTagValue(STsdbRepo *repo, SUpdateTableTagValMsg *pMsg) {
   if (isChangeIndexCol) {
     tsdbAddTableIntoIndex(pMeta, pTable, false);
     tsdbUnlockRepoMeta(pRepo);
+  } else if (hasTagIndex) {
+    tsdbAddTableIntoTagIndex(pTable->pSuper, pTable);
+    tsdbUnlockRepoMeta(pRepo);
   }
 
   // Update on file
@@ -919,6 +927,7 @@ static void tsdbFreeTable(STable *pTable) {
     kvRowFree(pTable->tagVal);
 
     tSkipListDestroy(pTable->pIndex);
+    tsdbFreeTagIndex(pTable->pTagIndex);
     taosTZfree(pTable->lastRow);    
     tfree(pTable->sql);
 
@@ -1049,6 +1058,7 @@ static int tsdbAddTableIntoIndex(STsdbMeta *pMeta, STable *pTable, bool refSuper
   pTable->pSuper = pSTable;
 
   tSkipListPut(pSTable->pIndex, (void *)pTable);
+  tsdbAddTableIntoTagIndex(pSTable, pTable);
 
   if (refSuper) T_REF_INC(pSTable);
   return 0;
@@ -1060,6 +1070,8 @@ static int tsdbRemoveTableFromIndex(STsdbMeta *pMeta, STable *pTable) {
   STable *pSTable = pTable->pSuper;
   ASSERT(pSTable != NULL);
 
+  tsdbRemoveTableFromTagIndex(pSTable, pTable);
+
   char* key = getTagIndexKey(pTable);
   SArray *res = tSkipListGet(pSTable->pIndex, key);
 
@@ -2380,6 +2380,39 @@ int32_t tsdbGetFileBlocksDistInfo(TsdbQueryHandleT* queryHandle, STableBlockDist
   return code;
 }
 
+int64_t tsdbEstimateScanBytes(STsdbRepo* tsdb, STimeWindow* pWindow, int32_t numOfTables) {
+  STsdbCfg*  pCfg = &tsdb->config;
+  STsdbMeta* pMeta = tsdb->tsdbMeta;
+  STsdbFS*   pfs = REPO_FS(tsdb);
+  SFSIter    fsiter;
+  TSKEY      skey = MIN(pWindow->skey, pWindow->ekey);
+  TSKEY      ekey = MAX(pWindow->skey, pWindow->ekey);
+  TSKEY      minKey = 0, maxKey = 0;
+  int64_t    bytes = 0;
+
+  tsdbRLockFS(pfs);
+  tsdbFSIterInit(&fsiter, pfs, TSDB_FS_ITER_FORWARD);
+  tsdbFSIterSeek(&fsiter, getFileIdFromKey(skey, pCfg->daysPerFile, pCfg->precision));
+
+  SDFileSet* pSet = NULL;
+  while ((pSet = tsdbFSIterNext(&fsiter)) != NULL) {
+    tsdbGetFidKeyRange(pCfg->daysPerFile, pCfg->precision, pSet->fid, &minKey, &maxKey);
+    if (minKey > ekey) break;
+
+    bytes += TSDB_FILE_INFO(TSDB_DFILE_IN_SET(pSet, TSDB_FILE_DATA))->size;
+    bytes += TSDB_FILE_INFO(TSDB_DFILE_IN_SET(pSet, TSDB_FILE_LAST))->size;
+  }
+  tsdbUnLockFS(pfs);
+
+  // the data of the queried tables is assumed to take its share of the files
+  int32_t nTables = MAX(pMeta->nTables, 1);
+  if (numOfTables < nTables) {
+    bytes = (int64_t)((double)bytes * numOfTables / nTables);
+  }
+
+  return bytes;
+}
+
 static int32_t getDataBlocksInFiles(STsdbQueryHandle* pQueryHandle, bool* exists) {
   STsdbFS*       pFileHandle = REPO_FS(pQueryHandle->pTsdb);
   SQueryFilePos* cur = &pQueryHandle->cur;
@@ -3267,6 +3300,23 @@ int32_t tsdbRetrieveDataBlockStatisInfo(TsdbQueryHandleT* pQueryHandle, SDataSta
   return TSDB_CODE_SUCCESS;
 }
 
+bool tsdbDataBlockMayContain(TsdbQueryHandleT* pQueryHandle, int16_t colId, int8_t type, const void* pVal, int32_t len) {
+  STsdbQueryHandle* pHandle = (STsdbQueryHandle*) pQueryHandle;
+
+  SQueryFilePos* c = &pHandle->cur;
+  if (c->mixBlock || pHandle->rhelper.pBlkData == NULL) {
+    return true;
+  }
+
+  STableBlockInfo* pBlockInfo = &pHandle->pDataBlockInfo[c->slot];
+  if (pBlockInfo->compBlock->numOfSubBlocks > 1) {
+    return true;
+  }
+
+  // failed to load the bloom filter, just load the data block
+  return tsdbBlockMayContain(&pHandle->rhelper, pBlockInfo->compBlock, colId, type, pVal, len) != 0;
+}
+
 SArray* tsdbRetrieveDataBlock(TsdbQueryHandleT* pQueryHandle, SArray* pIdList) {
   /**
    * In the following two cases, the data has been loaded to SColumnInfoData.
@@ -3502,18 +3552,7 @@ SArray* createTableGroup(SArray* pTableList, STSchema* pTagSchema, SColIndex* pC
   return pTableGroup;
 }
 
-static bool tableFilterFp(const void* pNode, void* param) {
-  tQueryInfo* pInfo = (tQueryInfo*) param;
-
-  STable* pTable = (STable*)(SL_GET_NODE_DATA((SSkipListNode*)pNode));
-
-  char* val = NULL;
-  if (pInfo->sch.colId == TSDB_TBNAME_COLUMN_INDEX) {
-    val = (char*) TABLE_NAME(pTable);
-  } else {
-    val = tdGetKVRowValOfCol(pTable->tagVal, pInfo->sch.colId);
-  }
-
+static bool tagValFilter(const char* val, tQueryInfo* pInfo) {
   if (pInfo->optr == TSDB_RELATION_ISNULL || pInfo->optr == TSDB_RELATION_NOTNULL) {
     if (pInfo->optr == TSDB_RELATION_ISNULL) {
       return (val == NULL) || isNull(val, pInfo->sch.type);
@@ -3522,6 +3561,10 @@ static bool tableFilterFp(const void* pNode, void* param) {
     }
   } else if (pInfo->optr == TSDB_RELATION_IN) {
      int type = pInfo->sch.type;
+     if (val == NULL) {
+       return false;
+     }
+
      if (type == TSDB_DATA_TYPE_BOOL || IS_SIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_TIMESTAMP) {
        int64_t v;
        GET_TYPED_DATA(v, int64_t, pInfo->sch.type, val);
@@ -3581,9 +3624,27 @@ static bool tableFilterFp(const void* pNode, void* param) {
   return true;
 }
 
+static bool tableFilterFp(const void* pNode, void* param) {
+  tQueryInfo* pInfo = (tQueryInfo*) param;
+
+  STable* pTable = (STable*)(SL_GET_NODE_DATA((SSkipListNode*)pNode));
+
+  char* val = NULL;
+  if (pInfo->sch.colId == TSDB_TBNAME_COLUMN_INDEX) {
+    val = (char*) TABLE_NAME(pTable);
+  } else {
+    val = tdGetKVRowValOfCol(pTable->tagVal, pInfo->sch.colId);
+  }
+
+  return tagValFilter(val, pInfo);
+}
+
 static void getTableListfromSkipList(tExprNode *pExpr, SSkipList *pSkipList, SArray *result, SExprTraverseSupp *param);
+static bool useTagIndex(STable* pSTable, tExprNode* pExpr);
+static int32_t getTableListfromTagIndex(STsdbMeta* pMeta, STable* pSTable, tExprNode* pExpr, SArray* result,
+                                        SExprTraverseSupp* param);
 
-static int32_t doQueryTableList(STable* pSTable, SArray* pRes, tExprNode* pExpr) {
+int32_t tsdbQueryTableList(STsdbMeta* pMeta, STable* pSTable, SArray* pRes, tExprNode* pExpr) {
   // query according to the expression tree
   SExprTraverseSupp supp = {
       .nodeFilterFn = (__result_filter_fn_t) tableFilterFp,
@@ -3591,7 +3652,11 @@ static int32_t doQueryTableList(STable* pSTable, SArray* pRes, tExprNode* pExpr)
       .pExtInfo = pSTable->tagSchema,
       };
 
-  getTableListfromSkipList(pExpr, pSTable->pIndex, pRes, &supp);
+  if (!useTagIndex(pSTable, pExpr) || getTableListfromTagIndex(pMeta, pSTable, pExpr, pRes, &supp) != TSDB_CODE_SUCCESS) {
+    taosArrayClear(pRes);
+    getTableListfromSkipList(pExpr, pSTable->pIndex, pRes, &supp);
+  }
+
   tExprTreeDestroy(pExpr, destroyHelper);
   return TSDB_CODE_SUCCESS;
 }
@@ -3676,7 +3741,7 @@ int32_t tsdbQuerySTableByTagCond(STsdbRepo* tsdb, uint64_t uid, TSKEY skey, cons
     // TODO: more error handling
   } END_TRY
 
-  doQueryTableList(pTable, res, expr);
+  tsdbQueryTableList(tsdbGetMeta(tsdb), pTable, res, expr);
   pGroupInfo->numOfTables = (uint32_t)taosArrayGetSize(res);
   pGroupInfo->pGroupList  = createTableGroup(res, pTagSchema, pColIndex, numOfCols, skey);
 
@@ -4111,3 +4176,164 @@ void getTableListfromSkipList(tExprNode *pExpr, SSkipList *pSkipList, SArray *re
   //apply the hierarchical filter expression to every node in skiplist to find the qualified nodes
   applyFilterToSkipListNode(pSkipList, pExpr, result, param);
 }
+
+#define TAG_INDEX_BITMAP_WORDS(_n) (((_n) + 63) / 64)
+
+// The inverted index of tag values is used unless the filter is a single condition that the skiplist index answers
+// as well, i.e. a range or equal condition of the first tag, or a condition of the table name.
+static bool useTagIndex(STable* pSTable, tExprNode* pExpr) {
+  STagIndex* pTagIndex = pSTable->pTagIndex;
+  if (pExpr == NULL || pTagIndex == NULL || pTagIndex->version != schemaVersion(pSTable->tagSchema)) {
+    return false;
+  }
+
+  tExprNode* pLeft = pExpr->_node.pLeft;
+  tExprNode* pRight = pExpr->_node.pRight;
+  if (pLeft->nodeType == TSQL_NODE_EXPR || pRight->nodeType == TSQL_NODE_EXPR) {
+    return true;
+  }
+
+  int16_t colId = pLeft->pSchema->colId;
+  uint8_t optr = pExpr->_node.optr;
+  if (colId == TSDB_TBNAME_COLUMN_INDEX) {
+    return false;
+  }
+
+  return colId != colColId(schemaColAt(pSTable->tagSchema, 0)) || optr == TSDB_RELATION_LIKE ||
+         optr == TSDB_RELATION_IN;
+}
+
+static void setTagIndexBitmap(uint64_t* bitmap, SArray* tids) {
+  size_t size = taosArrayGetSize(tids);
+  for (size_t i = 0; i < size; ++i) {
+    int32_t tid = *(int32_t*)taosArrayGet(tids, i);
+    bitmap[tid >> 6] |= (1ULL << (tid & 63));
+  }
+}
+
+// An equal condition finds its posting list directly if equal values have the same bytes in the index
+static bool tagIndexLookupSupported(tQueryInfo* pInfo, STagIndexCol* pCol) {
+  int32_t type = pInfo->sch.type;
+  if (pInfo->optr != TSDB_RELATION_EQUAL || type != pCol->type || pInfo->q == NULL) {
+    return false;
+  }
+
+  if (type == TSDB_DATA_TYPE_BINARY) {  // binary values are compared by strncmp
+    return memchr(varDataVal(pInfo->q), 0, varDataLen(pInfo->q)) == NULL;
+  }
+
+  return type == TSDB_DATA_TYPE_BOOL || type == TSDB_DATA_TYPE_TIMESTAMP || IS_SIGNED_NUMERIC_TYPE(type) ||
+         IS_UNSIGNED_NUMERIC_TYPE(type);
+}
+
+static void tagIndexFilterLeaf(STable* pSTable, tExprNode* pExpr, uint64_t* bitmap, SExprTraverseSupp* param) {
+  param->setupInfoFn(pExpr, param->pExtInfo);
+  tQueryInfo* pInfo = pExpr->_node.info;
+
+  STagIndexCol* pCol = NULL;
+  if (pInfo->sch.colId != TSDB_TBNAME_COLUMN_INDEX) {
+    pCol = tsdbGetTagIndexCol(pSTable->pTagIndex, pInfo->sch.colId);
+  }
+
+  // the table name is not indexed, check each child table
+  if (pCol == NULL) {
+    SSkipListIterator* iter = tSkipListCreateIter(pSTable->pIndex);
+    while (tSkipListIterNext(iter)) {
+      SSkipListNode* pNode = tSkipListIterGet(iter);
+      if (param->nodeFilterFn(pNode, pInfo)) {
+        int32_t tid = TABLE_TID((STable*)SL_GET_NODE_DATA(pNode));
+        bitmap[tid >> 6] |= (1ULL << (tid & 63));
+      }
+    }
+
+    tSkipListDestroyIter(iter);
+    return;
+  }
+
+  if (tagValFilter(NULL, pInfo)) {
+    setTagIndexBitmap(bitmap, pCol->missing);
+  }
+
+  if (tagIndexLookupSupported(pInfo, pCol)) {
+    size_t        len = IS_VAR_DATA_TYPE(pCol->type) ? varDataTLen(pInfo->q) : tDataTypes[pCol->type].bytes;
+    STagPosting** ppPosting = taosHashGet(pCol->postings, pInfo->q, len);
+    if (ppPosting != NULL) {
+      setTagIndexBitmap(bitmap, (*ppPosting)->tids);
+    }
+
+    return;
+  }
+
+  // the condition is checked once for each distinct value of the tag
+  STagPosting** ppPosting = taosHashIterate(pCol->postings, NULL);
+  while (ppPosting != NULL) {
+    if (tagValFilter((*ppPosting)->val, pInfo)) {
+      setTagIndexBitmap(bitmap, (*ppPosting)->tids);
+    }
+
+    ppPosting = taosHashIterate(pCol->postings, ppPosting);
+  }
+}
+
+static int32_t tagIndexFilter(STable* pSTable, tExprNode* pExpr, uint64_t* bitmap, int32_t numOfWords,
+                              SExprTraverseSupp* param) {
+  tExprNode* pLeft = pExpr->_node.pLeft;
+  tExprNode* pRight = pExpr->_node.pRight;
+
+  if (pLeft->nodeType != TSQL_NODE_EXPR || pRight->nodeType != TSQL_NODE_EXPR) {
+    tagIndexFilterLeaf(pSTable, pExpr, bitmap, param);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = tagIndexFilter(pSTable, pLeft, bitmap, numOfWords, param);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  uint64_t* rbitmap = calloc(numOfWords, sizeof(uint64_t));
+  if (rbitmap == NULL) {
+    return TSDB_CODE_TDB_OUT_OF_MEMORY;
+  }
+
+  code = tagIndexFilter(pSTable, pRight, rbitmap, numOfWords, param);
+  if (code == TSDB_CODE_SUCCESS) {
+    if (pExpr->_node.optr == TSDB_RELATION_OR) {
+      for (int32_t i = 0; i < numOfWords; ++i) bitmap[i] |= rbitmap[i];
+    } else {
+      for (int32_t i = 0; i < numOfWords; ++i) bitmap[i] &= rbitmap[i];
+    }
+  }
+
+  free(rbitmap);
+  return code;
+}
+
+// Evaluate the filter expression on the posting lists of the inverted index, each condition gives a bitmap of the
+// tids of qualified child tables, and the bitmaps are combined by the AND/OR of the expression. The qualified
+// tables are returned in the order of tid.
+static int32_t getTableListfromTagIndex(STsdbMeta* pMeta, STable* pSTable, tExprNode* pExpr, SArray* result,
+                                        SExprTraverseSupp* param) {
+  int32_t   numOfWords = TAG_INDEX_BITMAP_WORDS(pMeta->maxTables);
+  uint64_t* bitmap = calloc(numOfWords, sizeof(uint64_t));
+  if (bitmap == NULL) {
+    return TSDB_CODE_TDB_OUT_OF_MEMORY;
+  }
+
+  int32_t code = tagIndexFilter(pSTable, pExpr, bitmap, numOfWords, param);
+  if (code == TSDB_CODE_SUCCESS) {
+    for (int32_t i = 0; i < numOfWords; ++i) {
+      uint64_t w = bitmap[i];
+      while (w != 0) {
+        STable* pTable = pMeta->tables[i * 64 + BUILDIN_CTZL(w)];
+        assert(pTable != NULL && pTable->pSuper == pSTable);
+
+        STableKeyInfo info = {.pTable = pTable, .lastKey = TSKEY_INITIAL_VAL};
+        taosArrayPush(result, &info);
+        w &= (w - 1);
+      }
+    }
+  }
+
+  free(bitmap);
+  return code;
+}
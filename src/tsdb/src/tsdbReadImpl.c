@@ -20,8 +20,8 @@
 static void tsdbResetReadTable(SReadH *pReadh);
 static void tsdbResetReadFile(SReadH *pReadh);
 static int  tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols);
-static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, int numOfRows,
-                                         int maxPoints, char *buffer, int bufferSize);
+static int  tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, uint8_t codec,
+                                         int numOfRows, int maxPoints, char *buffer, int bufferSize);
 static int  tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDataCols, int16_t *colIds,
                                       int numOfColIds);
 static int  tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, SDataCol *pDataCol);
@@ -64,6 +64,7 @@ void tsdbDestroyReadH(SReadH *pReadh) {
 
   pReadh->pCBuf = taosTZfree(pReadh->pCBuf);
   pReadh->pBuf = taosTZfree(pReadh->pBuf);
+  pReadh->pBlmBuf = taosTZfree(pReadh->pBlmBuf);
   pReadh->pDCols[0] = tdFreeDataCols(pReadh->pDCols[0]);
   pReadh->pDCols[1] = tdFreeDataCols(pReadh->pDCols[1]);
   pReadh->pBlkData = taosTZfree(pReadh->pBlkData);
@@ -333,6 +334,51 @@ int tsdbLoadBlockStatis(SReadH *pReadh, SBlock *pBlock) {
   return 0;
 }
 
+// Check the bloom filter of a block column, the block statis part must be loaded by tsdbLoadBlockStatis first.
+// Return 1 if the column may contain the value, 0 if it does not, -1 on failure.
+int tsdbBlockMayContain(SReadH *pReadh, SBlock *pBlock, int16_t colId, int8_t type, const void *pVal, int32_t len) {
+  ASSERT(pBlock->numOfSubBlocks <= 1);
+
+  SBlockCol *pBlockCol = NULL;
+  for (int i = 0; i < pReadh->pBlkData->numOfCols; i++) {
+    if (pReadh->pBlkData->cols[i].colId == colId) {
+      pBlockCol = pReadh->pBlkData->cols + i;
+      break;
+    }
+  }
+
+  if (pBlockCol == NULL || pBlockCol->blmLog2 == 0 || pBlockCol->type != type) return 1;
+
+  SDFile *pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  int64_t offset =
+      pBlock->offset + TSDB_BLOCK_STATIS_SIZE(pBlock->numOfCols) + tsdbGetBlockColOffset(pBlockCol) + pBlockCol->len;
+  int32_t size = TSDB_BLOOM_SIZE(pBlockCol->blmLog2);
+
+  if (tsdbMakeRoom((void **)(&(pReadh->pBlmBuf)), size) < 0) return -1;
+
+  if (tsdbSeekDFile(pDFile, offset, SEEK_SET) < 0) {
+    tsdbError("vgId:%d failed to load bloom filter while seek file %s to offset %" PRId64 " since %s",
+              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), offset, tstrerror(terrno));
+    return -1;
+  }
+
+  int64_t nread = tsdbReadDFile(pDFile, pReadh->pBlmBuf, size);
+  if (nread < 0) {
+    tsdbError("vgId:%d failed to load bloom filter while read file %s since %s, offset:%" PRId64 " len :%d",
+              TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), offset, size);
+    return -1;
+  }
+
+  if (nread < size || !taosCheckChecksumWhole((uint8_t *)(pReadh->pBlmBuf), (uint32_t)size)) {
+    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+    tsdbError("vgId:%d bloom filter in file %s is corrupted, offset:%" PRId64 " len :%d", TSDB_READ_REPO_ID(pReadh),
+              TSDB_FILE_FULL_NAME(pDFile), offset, size);
+    return -1;
+  }
+
+  return tsdbBloomMayContain(pReadh->pBlmBuf, pBlockCol->blmLog2, type, pVal, len) ? 1 : 0;
+}
+
 int tsdbEncodeSBlockIdx(void **buf, SBlockIdx *pIdx) {
   int tlen = 0;
 
@@ -469,12 +515,14 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
     int16_t  tcolId = 0;
     uint32_t toffset = TSDB_KEY_COL_OFFSET;
     int32_t  tlen = pBlock->keyLen;
+    uint8_t  codec = TSDB_CODEC_DEFAULT;
 
     if (dcol != 0) {
       SBlockCol *pBlockCol = &(pBlockData->cols[ccol]);
       tcolId = pBlockCol->colId;
       toffset = tsdbGetBlockColOffset(pBlockCol);
       tlen = pBlockCol->len;
+      codec = pBlockCol->codec;
     } else {
       ASSERT(pDataCol->colId == tcolId);
     }
@@ -486,7 +534,7 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
       }
 
       if (tsdbCheckAndDecodeColumnData(pDataCol, POINTER_SHIFT(pBlockData, tsize + toffset), tlen, pBlock->algorithm,
-                                       pBlock->numOfRows, pDataCols->maxPoints, TSDB_READ_COMP_BUF(pReadh),
+                                       codec, pBlock->numOfRows, pDataCols->maxPoints, TSDB_READ_COMP_BUF(pReadh),
                                        (int)taosTSizeof(TSDB_READ_COMP_BUF(pReadh))) < 0) {
         tsdbError("vgId:%d file %s is broken at column %d block offset %" PRId64 " column offset %u",
                   TSDB_READ_REPO_ID(pReadh), TSDB_FILE_FULL_NAME(pDFile), tcolId, (int64_t)pBlock->offset, toffset);
@@ -509,15 +557,24 @@ static int tsdbLoadBlockDataImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *pDat
   return 0;
 }
 
-static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, int numOfRows,
-                                        int maxPoints, char *buffer, int bufferSize) {
+static int tsdbCheckAndDecodeColumnData(SDataCol *pDataCol, void *content, int32_t len, int8_t comp, uint8_t codec,
+                                        int numOfRows, int maxPoints, char *buffer, int bufferSize) {
   if (!taosCheckChecksumWhole((uint8_t *)content, len)) {
     terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
     return -1;
   }
 
   // Decode the data
-  if (comp) {
+  if (codec != TSDB_CODEC_DEFAULT) {
+    int tlen = tsdbCodecDecode(codec, pDataCol, content, len - sizeof(TSCKSUM), numOfRows);
+    if (tlen <= 0) {
+      tsdbError("Failed to decode column, file corrupted, len:%d codec:%u numOfRows:%d maxPoints:%d", len, codec,
+                numOfRows, maxPoints);
+      terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+      return -1;
+    }
+    pDataCol->len = tlen;
+  } else if (comp) {
     // Need to decompress
     int tlen = (*(tDataTypes[pDataCol->type].decompFunc))(content, len - sizeof(TSCKSUM), numOfRows, pDataCol->pData,
                                                              pDataCol->spaceSize, comp, buffer, bufferSize);
@@ -620,9 +677,15 @@ static int tsdbLoadBlockDataColsImpl(SReadH *pReadh, SBlock *pBlock, SDataCols *
 static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBlockCol *pBlockCol, SDataCol *pDataCol) {
   ASSERT(pDataCol->colId == pBlockCol->colId);
 
-  STsdbRepo *pRepo = TSDB_READ_REPO(pReadh);
-  STsdbCfg * pCfg = REPO_CFG(pRepo);
-  int        tsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
+  STsdbRepo *  pRepo = TSDB_READ_REPO(pReadh);
+  STsdbCfg *   pCfg = REPO_CFG(pRepo);
+  int          tsize = pDataCol->bytes * pBlock->numOfRows + COMP_OVERFLOW_BYTES;
+  SBlkCacheKey key;
+
+  if (pRepo->pBlkCache) {
+    tsdbInitBlkCacheKey(&key, TSDB_FSET_FID(TSDB_READ_FSET(pReadh)), pDFile, pBlock, pBlockCol->colId);
+    if (tsdbBlkCacheGet(pRepo->pBlkCache, &key, pDataCol, pBlock->numOfRows)) return 0;
+  }
 
   if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlockCol->len) < 0) return -1;
   if (tsdbMakeRoom((void **)(&TSDB_READ_COMP_BUF(pReadh)), tsize) < 0) return -1;
@@ -649,12 +712,17 @@ static int tsdbLoadColData(SReadH *pReadh, SDFile *pDFile, SBlock *pBlock, SBloc
     return -1;
   }
 
-  if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlock->numOfRows,
-                                   pCfg->maxRowsPerFileBlock, pReadh->pCBuf, (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
+  if (tsdbCheckAndDecodeColumnData(pDataCol, pReadh->pBuf, pBlockCol->len, pBlock->algorithm, pBlockCol->codec,
+                                   pBlock->numOfRows, pCfg->maxRowsPerFileBlock, pReadh->pCBuf,
+                                   (int32_t)taosTSizeof(pReadh->pCBuf)) < 0) {
     tsdbError("vgId:%d file %s is broken at column %d offset %" PRId64, REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile),
               pBlockCol->colId, offset);
     return -1;
   }
 
+  if (pRepo->pBlkCache) {
+    tsdbBlkCachePut(pRepo->pBlkCache, &key, pDataCol, pBlock->numOfRows);
+  }
+
   return 0;
 }
\ No newline at end of file
@@ -17,6 +17,31 @@
 #include "os.h"
 #include "taoserror.h"
 #include "tsdbint.h"
+#include "hashfunc.h"
+
+extern int32_t tsSyncDelta;
+
+// Decision of the receiver on a file set or the meta file
+#define TSDB_SYNC_SKIP 0   // the local one is kept
+#define TSDB_SYNC_FILE 1   // the whole files are sent
+#define TSDB_SYNC_DELTA 2  // the head file is sent as a whole, and only the data blocks the receiver misses are sent
+
+// A data block or sub-block in the data or last file of a file set, identified by the digest of its bytes
+typedef struct {
+  uint64_t digest;
+  int64_t  offset;
+  int32_t  len;
+  int8_t   last;
+} SSyncBlock;
+
+#define TSDB_SYNC_BLOCK_ENC_SIZE (sizeof(uint64_t) + sizeof(int64_t) + sizeof(int32_t) + sizeof(int8_t))
+
+typedef struct {
+  uint64_t digest;
+  int64_t  len;
+} SSyncBlockKey;
+
+static STsdbSyncStat tsdbSyncStat = {0};
 
 // Sync handle
 typedef struct {
@@ -29,33 +54,54 @@ typedef struct {
   SMFile     mf;
   SDFileSet  df;
   SDFileSet *pdf;
+  int64_t    recvBytes;  // bytes of files received by taosCopyFds
+  int64_t    startMs;
+  int64_t    reportMs;   // when the progress of the receive is reported last
 } SSyncH;
 
 #define SYNC_BUFFER(sh) ((sh)->pBuf)
+#define TSDB_SYNC_PROGRESS_MS 10000
 
 static void    tsdbInitSyncH(SSyncH *pSyncH, STsdbRepo *pRepo, SOCKET socketFd);
 static void    tsdbDestroySyncH(SSyncH *pSyncH);
+static void    tsdbSyncRecvProgress(void *param, int64_t bytes);
 static int32_t tsdbSyncSendMeta(SSyncH *pSynch);
 static int32_t tsdbSyncRecvMeta(SSyncH *pSynch);
 static int32_t tsdbSendMetaInfo(SSyncH *pSynch);
 static int32_t tsdbRecvMetaInfo(SSyncH *pSynch);
-static int32_t tsdbSendDecision(SSyncH *pSynch, bool toSend);
-static int32_t tsdbRecvDecision(SSyncH *pSynch, bool *toSend);
+static int32_t tsdbSendDecision(SSyncH *pSynch, uint8_t decision);
+static int32_t tsdbRecvDecision(SSyncH *pSynch, uint8_t *decision);
 static int32_t tsdbSyncSendDFileSetArray(SSyncH *pSynch);
 static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch);
 static bool    tsdbIsTowFSetSame(SDFileSet *pSet1, SDFileSet *pSet2);
 static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet);
 static int32_t tsdbSendDFileSetInfo(SSyncH *pSynch, SDFileSet *pSet);
 static int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch);
+static int32_t tsdbSyncSendDFile(SSyncH *pSynch, SDFile *pDFile);
+static int32_t tsdbSyncRecvDFile(SSyncH *pSynch, SDFile *pDFile, SDFile *pRDFile);
+static int32_t tsdbSyncSendDFileSetDelta(SSyncH *pSynch, SDFileSet *pSet);
+static int32_t tsdbSyncRecvDFileSetDelta(SSyncH *pSynch, SDFileSet *pLSet, SDFileSet *pSet);
+static int     tsdbSyncLoadBlocks(SReadH *pReadh, SArray *aBlock);
+static int32_t tsdbSendSyncMsg(SSyncH *pSynch, uint32_t tlen);
+static int32_t tsdbRecvSyncMsg(SSyncH *pSynch, uint32_t *tlen);
+static int     tsdbSyncAddBlock(SReadH *pReadh, SBlock *pBlock, SArray *aBlock);
+static int     tsdbCompSyncBlock(const void *arg1, const void *arg2);
 static int     tsdbReload(STsdbRepo *pRepo, bool isMfChanged);
 
+static FORCE_INLINE uint64_t tsdbSyncDigest(void *buf, int32_t len) {
+  return (((uint64_t)taosCalcChecksum(0, (uint8_t *)buf, (uint32_t)len)) << 32) |
+         MurmurHash3_32((const char *)buf, (uint32_t)len);
+}
+
 int32_t tsdbSyncSend(void *tsdb, SOCKET socketFd) {
   STsdbRepo *pRepo = (STsdbRepo *)tsdb;
   SSyncH     synch = {0};
 
   tsdbInitSyncH(&synch, pRepo, socketFd);
   // Disable TSDB commit
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
 
   if (tsdbSyncSendMeta(&synch) < 0) {
     tsdbError("vgId:%d, failed to send metafile since %s", REPO_ID(pRepo), tstrerror(terrno));
@@ -85,7 +131,9 @@ int32_t tsdbSyncRecv(void *tsdb, SOCKET socketFd) {
   pRepo->state = TSDB_STATE_OK;
 
   tsdbInitSyncH(&synch, pRepo, socketFd);
+  atomic_add_fetch_32(&pRepo->commitWaiting, 1);
   tsem_wait(&(pRepo->readyToCommit));
+  atomic_sub_fetch_32(&pRepo->commitWaiting, 1);
   tsdbStartFSTxn(pRepo, 0, 0);
 
   if (tsdbSyncRecvMeta(&synch) < 0) {
@@ -101,6 +149,8 @@ int32_t tsdbSyncRecv(void *tsdb, SOCKET socketFd) {
   tsdbEndFSTxn(pRepo);
   tsem_post(&(pRepo->readyToCommit));
   tsdbDestroySyncH(&synch);
+  tsdbInfo("vgId:%d, %" PRId64 " bytes of files are received in %" PRId64 " ms", REPO_ID(pRepo), synch.recvBytes,
+           taosGetTimestampMs() - synch.startMs);
 
   // Reload file change
   tsdbReload(pRepo, synch.mfChanged);
@@ -117,14 +167,28 @@ _err:
 static void tsdbInitSyncH(SSyncH *pSyncH, STsdbRepo *pRepo, SOCKET socketFd) {
   pSyncH->pRepo = pRepo;
   pSyncH->socketFd = socketFd;
+  pSyncH->startMs = taosGetTimestampMs();
+  pSyncH->reportMs = pSyncH->startMs;
   tsdbGetRtnSnap(pRepo, &(pSyncH->rtn));
 }
 
 static void tsdbDestroySyncH(SSyncH *pSyncH) { taosTZfree(pSyncH->pBuf); }
 
+static void tsdbSyncRecvProgress(void *param, int64_t bytes) {
+  SSyncH *pSynch = (SSyncH *)param;
+  int64_t nowMs = taosGetTimestampMs();
+
+  pSynch->recvBytes += bytes;
+  if (nowMs - pSynch->reportMs < TSDB_SYNC_PROGRESS_MS) return;
+
+  pSynch->reportMs = nowMs;
+  tsdbInfo("vgId:%d, %" PRId64 " bytes of files are received in %" PRId64 " ms", REPO_ID(pSynch->pRepo),
+           pSynch->recvBytes, nowMs - pSynch->startMs);
+}
+
 static int32_t tsdbSyncSendMeta(SSyncH *pSynch) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  bool       toSendMeta = false;
+  uint8_t    decision = TSDB_SYNC_SKIP;
   SMFile     mf;
 
   // Send meta info to remote
@@ -140,12 +204,12 @@ static int32_t tsdbSyncSendMeta(SSyncH *pSynch) {
     return 0;
   }
 
-  if (tsdbRecvDecision(pSynch, &toSendMeta) < 0) {
+  if (tsdbRecvDecision(pSynch, &decision) < 0) {
     tsdbError("vgId:%d, failed to recv decision while send meta since %s", REPO_ID(pRepo), tstrerror(terrno));
     return -1;
   }
 
-  if (toSendMeta) {
+  if (decision != TSDB_SYNC_SKIP) {
     tsdbInitMFileEx(&mf, pRepo->fs->cstatus->pmf);
     if (tsdbOpenMFile(&mf, O_RDONLY) < 0) {
       tsdbError("vgId:%d, failed to open file while send metafile since %s", REPO_ID(pRepo), tstrerror(terrno));
@@ -164,6 +228,7 @@ static int32_t tsdbSyncSendMeta(SSyncH *pSynch) {
       return -1;
     }
 
+    atomic_add_fetch_64(&tsdbSyncStat.sentBytes, writeLen);
     tsdbCloseMFile(&mf);
     tsdbInfo("vgId:%d, metafile is sent", REPO_ID(pRepo));
   } else {
@@ -199,7 +264,7 @@ static int32_t tsdbSyncRecvMeta(SSyncH *pSynch) {
     // Local has no meta file or has a different meta file, need to copy from remote
     pSynch->mfChanged = true;
 
-    if (tsdbSendDecision(pSynch, true) < 0) {
+    if (tsdbSendDecision(pSynch, TSDB_SYNC_FILE) < 0) {
       tsdbError("vgId:%d, failed to send decision while recv metafile since %s", REPO_ID(pRepo), tstrerror(terrno));
       return -1;
     }
@@ -218,7 +283,7 @@ static int32_t tsdbSyncRecvMeta(SSyncH *pSynch) {
     tsdbInfo("vgId:%d, metafile:%s is created", REPO_ID(pRepo), mf.f.aname);
 
     int64_t readLen = pSynch->pmf->info.size;
-    int64_t ret = taosCopyFds(pSynch->socketFd, TSDB_FILE_FD(&mf), readLen);
+    int64_t ret = taosCopyFds(pSynch->socketFd, TSDB_FILE_FD(&mf), readLen, tsdbSyncRecvProgress, pSynch);
     if (ret != readLen) {
       terrno = TAOS_SYSTEM_ERROR(errno);
       tsdbError("vgId:%d, failed to recv metafile since %s, ret:%" PRId64 " readLen:%" PRId64, REPO_ID(pRepo),
@@ -228,6 +293,7 @@ static int32_t tsdbSyncRecvMeta(SSyncH *pSynch) {
       return -1;
     }
 
+    atomic_add_fetch_64(&tsdbSyncStat.recvBytes, readLen);
     tsdbInfo("vgId:%d, metafile is received, size:%" PRId64, REPO_ID(pRepo), readLen);
 
     mf.info = pSynch->pmf->info;
@@ -236,7 +302,7 @@ static int32_t tsdbSyncRecvMeta(SSyncH *pSynch) {
   } else {
     pSynch->mfChanged = false;
     tsdbInfo("vgId:%d, metafile is same, no need to recv", REPO_ID(pRepo));
-    if (tsdbSendDecision(pSynch, false) < 0) {
+    if (tsdbSendDecision(pSynch, TSDB_SYNC_SKIP) < 0) {
       tsdbError("vgId:%d, failed to send decision while recv metafile since %s", REPO_ID(pRepo), tstrerror(terrno));
       return -1;
     }
@@ -327,9 +393,8 @@ static int32_t tsdbRecvMetaInfo(SSyncH *pSynch) {
   return 0;
 }
 
-static int32_t tsdbSendDecision(SSyncH *pSynch, bool toSend) {
+static int32_t tsdbSendDecision(SSyncH *pSynch, uint8_t decision) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  uint8_t    decision = toSend;
 
   int32_t writeLen = sizeof(uint8_t);
   int32_t ret = taosWriteMsg(pSynch->socketFd, (void *)(&decision), writeLen);
@@ -342,19 +407,17 @@ static int32_t tsdbSendDecision(SSyncH *pSynch, bool toSend) {
   return 0;
 }
 
-static int32_t tsdbRecvDecision(SSyncH *pSynch, bool *toSend) {
+static int32_t tsdbRecvDecision(SSyncH *pSynch, uint8_t *decision) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  uint8_t    decision = 0;
 
   int32_t readLen = sizeof(uint8_t);
-  int32_t ret = taosReadMsg(pSynch->socketFd, (void *)(&decision), readLen);
+  int32_t ret = taosReadMsg(pSynch->socketFd, (void *)decision, readLen);
   if (ret != readLen) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     tsdbError("vgId:%d, failed to recv decison, ret:%d readLen:%d", REPO_ID(pRepo), ret, readLen);
     return -1;
   }
 
-  *toSend = decision;
   return 0;
 }
 
@@ -423,16 +486,17 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           return -1;
         }
 
-        if (tsdbSendDecision(pSynch, false) < 0) {
+        if (tsdbSendDecision(pSynch, TSDB_SYNC_SKIP) < 0) {
           tsdbError("vgId:%d, failed to send decision since %s", REPO_ID(pRepo), tstrerror(terrno));
           return -1;
         }
       } else {
         // Need to copy from remote
-        int fidLevel = tsdbGetFidLevel(pSynch->pdf->fid, &(pSynch->rtn));
+        bool delta = false;
+        int  fidLevel = tsdbGetFidLevel(pSynch->pdf->fid, &(pSynch->rtn));
         if (fidLevel < 0) {  // expired fileset
           tsdbInfo("vgId:%d, fileset:%d will be skipped as expired", REPO_ID(pRepo), pSynch->pdf->fid);
-          if (tsdbSendDecision(pSynch, false) < 0) {
+          if (tsdbSendDecision(pSynch, TSDB_SYNC_SKIP) < 0) {
             tsdbError("vgId:%d, failed to send decision since %s", REPO_ID(pRepo), tstrerror(terrno));
             return -1;
           }
@@ -447,9 +511,13 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           // Next loop
           continue;
         } else {
-          tsdbInfo("vgId:%d, fileset:%d will be received", REPO_ID(pRepo), pSynch->pdf->fid);
+          // An older version of the file set shares most of the data blocks with the remote one, so only the blocks
+          // it misses are received
+          delta = tsSyncDelta && pLSet && pLSet->fid == pSynch->pdf->fid && tsdbFSetIsOk(pLSet);
+          tsdbInfo("vgId:%d, fileset:%d will be received%s", REPO_ID(pRepo), pSynch->pdf->fid,
+                   delta ? " by delta" : "");
           // Notify remote to send there file here
-          if (tsdbSendDecision(pSynch, true) < 0) {
+          if (tsdbSendDecision(pSynch, delta ? TSDB_SYNC_DELTA : TSDB_SYNC_FILE) < 0) {
             tsdbError("vgId:%d, failed to send decision since %s", REPO_ID(pRepo), tstrerror(terrno));
             return -1;
           }
@@ -474,27 +542,22 @@ static int32_t tsdbSyncRecvDFileSetArray(SSyncH *pSynch) {
           return -1;
         }
 
-        for (TSDB_FILE_T ftype = 0; ftype < TSDB_FILE_MAX; ftype++) {
-          SDFile *pDFile = TSDB_DFILE_IN_SET(&fset, ftype);         // local file
-          SDFile *pRDFile = TSDB_DFILE_IN_SET(pSynch->pdf, ftype);  // remote file
-
-          tsdbInfo("vgId:%d, file:%s will be received, osize:%" PRIu64 " rsize:%" PRIu64, REPO_ID(pRepo),
-                   pDFile->f.aname, pDFile->info.size, pRDFile->info.size);
-
-          int64_t writeLen = pRDFile->info.size;
-          int64_t ret = taosCopyFds(pSynch->socketFd, pDFile->fd, writeLen);
-          if (ret != writeLen) {
-            terrno = TAOS_SYSTEM_ERROR(errno);
-            tsdbError("vgId:%d, failed to recv file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
-                      pDFile->f.aname, tstrerror(terrno), ret, writeLen);
+        if (delta) {
+          if (tsdbSyncRecvDFileSetDelta(pSynch, pLSet, &fset) < 0) {
             tsdbCloseDFileSet(&fset);
             tsdbRemoveDFileSet(&fset);
             return -1;
           }
-
-          // Update new file info
-          pDFile->info = pRDFile->info;
-          tsdbInfo("vgId:%d, file:%s is received, size:%" PRId64, REPO_ID(pRepo), pDFile->f.aname, writeLen);
+          atomic_add_fetch_64(&tsdbSyncStat.deltaFSets, 1);
+        } else {
+          for (TSDB_FILE_T ftype = 0; ftype < TSDB_FILE_MAX; ftype++) {
+            if (tsdbSyncRecvDFile(pSynch, TSDB_DFILE_IN_SET(&fset, ftype), TSDB_DFILE_IN_SET(pSynch->pdf, ftype)) < 0) {
+              tsdbCloseDFileSet(&fset);
+              tsdbRemoveDFileSet(&fset);
+              return -1;
+            }
+          }
+          atomic_add_fetch_64(&tsdbSyncStat.fileFSets, 1);
         }
 
         tsdbCloseDFileSet(&fset);
@@ -564,7 +627,7 @@ static bool tsdbIsTowFSetSame(SDFileSet *pSet1, SDFileSet *pSet2) {
 
 static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet) {
   STsdbRepo *pRepo = pSynch->pRepo;
-  bool toSend = false;
+  uint8_t    decision = TSDB_SYNC_SKIP;
 
   // skip expired fileset
   if (pSet && tsdbGetFidLevel(pSet->fid, &(pSynch->rtn)) < 0) {
@@ -583,40 +646,26 @@ static int32_t tsdbSyncSendDFileSet(SSyncH *pSynch, SDFileSet *pSet) {
     return 0;
   }
 
-  if (tsdbRecvDecision(pSynch, &toSend) < 0) {
+  if (tsdbRecvDecision(pSynch, &decision) < 0) {
     tsdbError("vgId:%d, failed to recv decision while send fileset:%d since %s", REPO_ID(pRepo), pSet->fid,
               tstrerror(terrno));
     return -1;
   }
 
-  if (toSend) {
+  if (decision == TSDB_SYNC_FILE) {
     tsdbInfo("vgId:%d, fileset:%d will be sent", REPO_ID(pRepo), pSet->fid);
 
     for (TSDB_FILE_T ftype = 0; ftype < TSDB_FILE_MAX; ftype++) {
-      SDFile df = *TSDB_DFILE_IN_SET(pSet, ftype);
-      
-      if (tsdbOpenDFile(&df, O_RDONLY) < 0) {
-        tsdbError("vgId:%d, failed to file:%s since %s", REPO_ID(pRepo), df.f.aname, tstrerror(terrno));
-        return -1;
-      }
-
-      int64_t writeLen = df.info.size;
-      tsdbInfo("vgId:%d, file:%s will be sent, size:%" PRId64, REPO_ID(pRepo), df.f.aname, writeLen);
-
-      int64_t ret = taosSendFile(pSynch->socketFd, TSDB_FILE_FD(&df), 0, writeLen);
-      if (ret != writeLen) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        tsdbError("vgId:%d, failed to send file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
-                  df.f.aname, tstrerror(terrno), ret, writeLen);
-        tsdbCloseDFile(&df);
-        return -1;
-      }
-
-      tsdbInfo("vgId:%d, file:%s is sent", REPO_ID(pRepo), df.f.aname);
-      tsdbCloseDFile(&df);
+      if (tsdbSyncSendDFile(pSynch, TSDB_DFILE_IN_SET(pSet, ftype)) < 0) return -1;
     }
 
     tsdbInfo("vgId:%d, fileset:%d is sent", REPO_ID(pRepo), pSet->fid);
+  } else if (decision == TSDB_SYNC_DELTA) {
+    tsdbInfo("vgId:%d, fileset:%d will be sent by delta", REPO_ID(pRepo), pSet->fid);
+
+    if (tsdbSyncSendDFileSetDelta(pSynch, pSet) < 0) return -1;
+
+    tsdbInfo("vgId:%d, fileset:%d is sent by delta", REPO_ID(pRepo), pSet->fid);
   } else {
     tsdbInfo("vgId:%d, fileset:%d is same, no need to send", REPO_ID(pRepo), pSet->fid);
   }
@@ -700,6 +749,431 @@ static int32_t tsdbRecvDFileSetInfo(SSyncH *pSynch) {
   return 0;
 }
 
+void tsdbGetSyncStat(STsdbSyncStat *pStat) {
+  pStat->sentBytes = atomic_load_64(&tsdbSyncStat.sentBytes);
+  pStat->recvBytes = atomic_load_64(&tsdbSyncStat.recvBytes);
+  pStat->reusedBytes = atomic_load_64(&tsdbSyncStat.reusedBytes);
+  pStat->fileFSets = atomic_load_64(&tsdbSyncStat.fileFSets);
+  pStat->deltaFSets = atomic_load_64(&tsdbSyncStat.deltaFSets);
+}
+
+static int32_t tsdbSyncSendDFile(SSyncH *pSynch, SDFile *pDFile) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  SDFile     df = *pDFile;
+
+  if (tsdbOpenDFile(&df, O_RDONLY) < 0) {
+    tsdbError("vgId:%d, failed to file:%s since %s", REPO_ID(pRepo), df.f.aname, tstrerror(terrno));
+    return -1;
+  }
+
+  int64_t writeLen = df.info.size;
+  tsdbInfo("vgId:%d, file:%s will be sent, size:%" PRId64, REPO_ID(pRepo), df.f.aname, writeLen);
+
+  int64_t ret = taosSendFile(pSynch->socketFd, TSDB_FILE_FD(&df), 0, writeLen);
+  if (ret != writeLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to send file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
+              df.f.aname, tstrerror(terrno), ret, writeLen);
+    tsdbCloseDFile(&df);
+    return -1;
+  }
+
+  atomic_add_fetch_64(&tsdbSyncStat.sentBytes, writeLen);
+  tsdbInfo("vgId:%d, file:%s is sent", REPO_ID(pRepo), df.f.aname);
+  tsdbCloseDFile(&df);
+  return 0;
+}
+
+static int32_t tsdbSyncRecvDFile(SSyncH *pSynch, SDFile *pDFile, SDFile *pRDFile) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+
+  tsdbInfo("vgId:%d, file:%s will be received, osize:%" PRIu64 " rsize:%" PRIu64, REPO_ID(pRepo), pDFile->f.aname,
+           pDFile->info.size, pRDFile->info.size);
+
+  int64_t writeLen = pRDFile->info.size;
+  int64_t ret = taosCopyFds(pSynch->socketFd, pDFile->fd, writeLen, tsdbSyncRecvProgress, pSynch);
+  if (ret != writeLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to recv file:%s since %s, ret:%" PRId64 " writeLen:%" PRId64, REPO_ID(pRepo),
+              pDFile->f.aname, tstrerror(terrno), ret, writeLen);
+    return -1;
+  }
+
+  // Update new file info
+  pDFile->info = pRDFile->info;
+  atomic_add_fetch_64(&tsdbSyncStat.recvBytes, writeLen);
+  tsdbInfo("vgId:%d, file:%s is received, size:%" PRId64, REPO_ID(pRepo), pDFile->f.aname, writeLen);
+  return 0;
+}
+
+// The remote head file is received as it is, so the remote blocks must be put at the same offsets of the local data
+// and last files. A block of the same digest and length in the local file set is copied from there, the others are
+// received.
+static int32_t tsdbSyncSendDFileSetDelta(SSyncH *pSynch, SDFileSet *pSet) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  SReadH     readh;
+  SArray *   aBlock = NULL;
+  uint32_t   tlen = 0;
+  int32_t    nsent = 0;
+  int64_t    sentBytes = 0;
+  int32_t    code = -1;
+
+  if (tsdbSyncSendDFile(pSynch, TSDB_DFILE_IN_SET(pSet, TSDB_FILE_HEAD)) < 0) return -1;
+
+  if (tsdbInitReadH(&readh, pRepo) < 0) return -1;
+
+  aBlock = taosArrayInit(1024, sizeof(SSyncBlock));
+  if (aBlock == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    goto _over;
+  }
+
+  if (tsdbSetAndOpenReadFSet(&readh, pSet) < 0 || tsdbSyncLoadBlocks(&readh, aBlock) < 0) {
+    tsdbError("vgId:%d, failed to load blocks of fileset:%d since %s", REPO_ID(pRepo), pSet->fid, tstrerror(terrno));
+    goto _over;
+  }
+
+  // The blocks are sent in the order of the files, so the files are read and written sequentially on both sides
+  taosArraySort(aBlock, tsdbCompSyncBlock);
+
+  uint32_t nblocks = (uint32_t)taosArrayGetSize(aBlock);
+  tlen = (uint32_t)(sizeof(uint32_t) + nblocks * TSDB_SYNC_BLOCK_ENC_SIZE + sizeof(TSCKSUM));
+  if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), tlen + sizeof(uint32_t)) < 0) goto _over;
+
+  void *ptr = POINTER_SHIFT(SYNC_BUFFER(pSynch), sizeof(uint32_t));
+  taosEncodeFixedU32(&ptr, nblocks);
+  for (uint32_t i = 0; i < nblocks; i++) {
+    SSyncBlock *pBlock = taosArrayGet(aBlock, i);
+    taosEncodeFixedU64(&ptr, pBlock->digest);
+    taosEncodeFixedI64(&ptr, pBlock->offset);
+    taosEncodeFixedI32(&ptr, pBlock->len);
+    taosEncodeFixedI8(&ptr, pBlock->last);
+  }
+
+  if (tsdbSendSyncMsg(pSynch, tlen) < 0) goto _over;
+
+  // Bitmap of the blocks the receiver misses
+  if (tsdbRecvSyncMsg(pSynch, &tlen) < 0) goto _over;
+  if (tlen != (nblocks + 7) / 8 + sizeof(TSCKSUM)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, invalid block bitmap of fileset:%d, len:%u blocks:%u", REPO_ID(pRepo), pSet->fid, tlen,
+              nblocks);
+    goto _over;
+  }
+
+  uint8_t *bitmap = (uint8_t *)SYNC_BUFFER(pSynch);
+  for (uint32_t i = 0; i < nblocks; i++) {
+    if ((bitmap[i >> 3] & (1u << (i & 7))) == 0) continue;
+
+    SSyncBlock *pBlock = taosArrayGet(aBlock, i);
+    SDFile *    pDFile = pBlock->last ? TSDB_READ_LAST_FILE(&readh) : TSDB_READ_DATA_FILE(&readh);
+    int64_t     offset = pBlock->offset;
+
+    int64_t ret = taosSendFile(pSynch->socketFd, TSDB_FILE_FD(pDFile), &offset, pBlock->len);
+    if (ret != pBlock->len) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      tsdbError("vgId:%d, failed to send block of file:%s since %s, offset:%" PRId64 " ret:%" PRId64 " len:%d",
+                REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), pBlock->offset, ret, pBlock->len);
+      goto _over;
+    }
+
+    nsent++;
+    sentBytes += pBlock->len;
+  }
+
+  atomic_add_fetch_64(&tsdbSyncStat.sentBytes, sentBytes);
+  tsdbInfo("vgId:%d, fileset:%d %d of %u blocks are sent, %" PRId64 " bytes", REPO_ID(pRepo), pSet->fid, nsent,
+           nblocks, sentBytes);
+  code = 0;
+
+_over:
+  taosArrayDestroy(aBlock);
+  tsdbDestroyReadH(&readh);
+  return code;
+}
+
+static int32_t tsdbSyncRecvDFileSetDelta(SSyncH *pSynch, SDFileSet *pLSet, SDFileSet *pSet) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  SReadH     readh;
+  SArray *   aBlock = NULL;   // blocks of the remote file set
+  SArray *   aLBlock = NULL;  // blocks of the local file set
+  SHashObj * pLBlocks = NULL;  // blocks of the local file set by digest and length
+  uint32_t   tlen = 0;
+  uint32_t   nblocks = 0;
+  int32_t    nrecv = 0;
+  int64_t    recvBytes = 0;
+  int64_t    reusedBytes = 0;
+  int32_t    code = -1;
+
+  if (tsdbSyncRecvDFile(pSynch, TSDB_DFILE_IN_SET(pSet, TSDB_FILE_HEAD),
+                        TSDB_DFILE_IN_SET(pSynch->pdf, TSDB_FILE_HEAD)) < 0) {
+    return -1;
+  }
+
+  if (tsdbInitReadH(&readh, pRepo) < 0) return -1;
+
+  if (tsdbRecvSyncMsg(pSynch, &tlen) < 0) goto _over;
+
+  void *ptr = SYNC_BUFFER(pSynch);
+  if (tlen >= sizeof(uint32_t) + sizeof(TSCKSUM)) {
+    ptr = taosDecodeFixedU32(ptr, &nblocks);
+  }
+  if (tlen != sizeof(uint32_t) + (uint64_t)nblocks * TSDB_SYNC_BLOCK_ENC_SIZE + sizeof(TSCKSUM)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, invalid block list of fileset:%d, len:%u blocks:%u", REPO_ID(pRepo), pSet->fid, tlen,
+              nblocks);
+    goto _over;
+  }
+
+  aBlock = taosArrayInit(nblocks > 0 ? nblocks : 1, sizeof(SSyncBlock));
+  aLBlock = taosArrayInit(1024, sizeof(SSyncBlock));
+  pLBlocks = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (aBlock == NULL || aLBlock == NULL || pLBlocks == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    goto _over;
+  }
+
+  for (uint32_t i = 0; i < nblocks; i++) {
+    SSyncBlock block = {0};
+    ptr = taosDecodeFixedU64(ptr, &block.digest);
+    ptr = taosDecodeFixedI64(ptr, &block.offset);
+    ptr = taosDecodeFixedI32(ptr, &block.len);
+    ptr = taosDecodeFixedI8(ptr, &block.last);
+
+    SDFile *pRDFile = TSDB_DFILE_IN_SET(pSynch->pdf, block.last ? TSDB_FILE_LAST : TSDB_FILE_DATA);
+    if (block.len <= 0 || block.offset < TSDB_FILE_HEAD_SIZE || block.offset + block.len > pRDFile->info.size) {
+      terrno = TSDB_CODE_TDB_MESSED_MSG;
+      tsdbError("vgId:%d, invalid block of fileset:%d, offset:%" PRId64 " len:%d", REPO_ID(pRepo), pSet->fid,
+                block.offset, block.len);
+      goto _over;
+    }
+
+    taosArrayPush(aBlock, &block);
+  }
+
+  // A local file set which can not be read just gives no block
+  if (tsdbSetAndOpenReadFSet(&readh, pLSet) < 0 || tsdbSyncLoadBlocks(&readh, aLBlock) < 0) {
+    tsdbWarn("vgId:%d, failed to load blocks of local fileset:%d since %s, all blocks will be received",
+             REPO_ID(pRepo), pLSet->fid, tstrerror(terrno));
+    taosArrayClear(aLBlock);
+  }
+
+  for (size_t i = 0; i < taosArrayGetSize(aLBlock); i++) {
+    SSyncBlock *  pLBlock = taosArrayGet(aLBlock, i);
+    SSyncBlockKey key = {.digest = pLBlock->digest, .len = pLBlock->len};
+    if (taosHashPut(pLBlocks, &key, sizeof(key), pLBlock, sizeof(SSyncBlock)) < 0) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      goto _over;
+    }
+  }
+
+  // Bitmap of the blocks to receive
+  uint32_t blen = (nblocks + 7) / 8;
+  if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), sizeof(uint32_t) + blen + sizeof(TSCKSUM)) < 0) goto _over;
+
+  uint8_t *bitmap = (uint8_t *)POINTER_SHIFT(SYNC_BUFFER(pSynch), sizeof(uint32_t));
+  memset(bitmap, 0, blen);
+  for (uint32_t i = 0; i < nblocks; i++) {
+    SSyncBlock *  pBlock = taosArrayGet(aBlock, i);
+    SSyncBlockKey key = {.digest = pBlock->digest, .len = pBlock->len};
+    if (taosHashGet(pLBlocks, &key, sizeof(key)) == NULL) {
+      bitmap[i >> 3] |= (uint8_t)(1u << (i & 7));
+    }
+  }
+
+  if (tsdbSendSyncMsg(pSynch, blen + sizeof(TSCKSUM)) < 0) goto _over;
+
+  for (uint32_t i = 0; i < nblocks; i++) {
+    SSyncBlock *pBlock = taosArrayGet(aBlock, i);
+    SDFile *    pDFile = TSDB_DFILE_IN_SET(pSet, pBlock->last ? TSDB_FILE_LAST : TSDB_FILE_DATA);
+
+    if (tsdbSeekDFile(pDFile, pBlock->offset, SEEK_SET) < 0) goto _over;
+
+    if (bitmap[i >> 3] & (1u << (i & 7))) {
+      int64_t ret = taosCopyFds(pSynch->socketFd, TSDB_FILE_FD(pDFile), pBlock->len, tsdbSyncRecvProgress, pSynch);
+      if (ret != pBlock->len) {
+        terrno = TAOS_SYSTEM_ERROR(errno);
+        tsdbError("vgId:%d, failed to recv block of file:%s since %s, offset:%" PRId64 " ret:%" PRId64 " len:%d",
+                  REPO_ID(pRepo), TSDB_FILE_FULL_NAME(pDFile), tstrerror(terrno), pBlock->offset, ret, pBlock->len);
+        goto _over;
+      }
+
+      nrecv++;
+      recvBytes += pBlock->len;
+    } else {
+      SSyncBlockKey key = {.digest = pBlock->digest, .len = pBlock->len};
+      SSyncBlock *  pLBlock = taosHashGet(pLBlocks, &key, sizeof(key));
+      SDFile *      pLDFile = pLBlock->last ? TSDB_READ_LAST_FILE(&readh) : TSDB_READ_DATA_FILE(&readh);
+
+      if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(&readh)), pLBlock->len) < 0) goto _over;
+      if (tsdbSeekDFile(pLDFile, pLBlock->offset, SEEK_SET) < 0) goto _over;
+
+      int64_t nread = tsdbReadDFile(pLDFile, TSDB_READ_BUF(&readh), pLBlock->len);
+      if (nread < pLBlock->len) {
+        if (nread >= 0) terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+        tsdbError("vgId:%d, failed to read block of file:%s since %s, offset:%" PRId64 " len:%d", REPO_ID(pRepo),
+                  TSDB_FILE_FULL_NAME(pLDFile), tstrerror(terrno), pLBlock->offset, pLBlock->len);
+        goto _over;
+      }
+
+      if (tsdbWriteDFile(pDFile, TSDB_READ_BUF(&readh), pLBlock->len) < pLBlock->len) goto _over;
+
+      reusedBytes += pBlock->len;
+    }
+  }
+
+  // The bytes of the remote files in no block are left as holes
+  for (TSDB_FILE_T ftype = TSDB_FILE_DATA; ftype <= TSDB_FILE_LAST; ftype++) {
+    SDFile *pDFile = TSDB_DFILE_IN_SET(pSet, ftype);
+
+    pDFile->info = TSDB_DFILE_IN_SET(pSynch->pdf, ftype)->info;
+    if (tsdbUpdateDFileHeader(pDFile) < 0) goto _over;
+    if (taosFtruncate(TSDB_FILE_FD(pDFile), pDFile->info.size) < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      goto _over;
+    }
+  }
+
+  atomic_add_fetch_64(&tsdbSyncStat.recvBytes, recvBytes);
+  atomic_add_fetch_64(&tsdbSyncStat.reusedBytes, reusedBytes);
+  tsdbInfo("vgId:%d, fileset:%d %d of %u blocks are received, %" PRId64 " bytes received and %" PRId64
+           " bytes copied from local files",
+           REPO_ID(pRepo), pSet->fid, nrecv, nblocks, recvBytes, reusedBytes);
+  code = 0;
+
+_over:
+  if (code < 0) {
+    tsdbError("vgId:%d, failed to recv fileset:%d by delta since %s", REPO_ID(pRepo), pSet->fid, tstrerror(terrno));
+  }
+  taosHashCleanup(pLBlocks);
+  taosArrayDestroy(aLBlock);
+  taosArrayDestroy(aBlock);
+  tsdbDestroyReadH(&readh);
+  return code;
+}
+
+// Lists the data blocks and sub-blocks in the data and last files of the file set with the digests of their bytes
+static int tsdbSyncLoadBlocks(SReadH *pReadh, SArray *aBlock) {
+  if (tsdbLoadBlockIdx(pReadh) < 0) return -1;
+
+  for (size_t i = 0; i < taosArrayGetSize(pReadh->aBlkIdx); i++) {
+    pReadh->pBlkIdx = taosArrayGet(pReadh->aBlkIdx, i);
+    if (tsdbLoadBlockInfo(pReadh, NULL) < 0) return -1;
+
+    for (int bidx = 0; bidx < pReadh->pBlkIdx->numOfBlocks; bidx++) {
+      SBlock *pBlock = pReadh->pBlkInfo->blocks + bidx;
+      int     nSubBlocks = pBlock->numOfSubBlocks;
+
+      if (nSubBlocks > 1) {
+        pBlock = (SBlock *)POINTER_SHIFT(pReadh->pBlkInfo, pBlock->offset);
+      }
+
+      for (int k = 0; k < nSubBlocks; k++) {
+        if (tsdbSyncAddBlock(pReadh, pBlock + k, aBlock) < 0) return -1;
+      }
+    }
+  }
+
+  pReadh->pBlkIdx = NULL;
+  return 0;
+}
+
+static int tsdbSyncAddBlock(SReadH *pReadh, SBlock *pBlock, SArray *aBlock) {
+  SDFile *   pDFile = (pBlock->last) ? TSDB_READ_LAST_FILE(pReadh) : TSDB_READ_DATA_FILE(pReadh);
+  SSyncBlock block = {0};
+
+  if (tsdbMakeRoom((void **)(&TSDB_READ_BUF(pReadh)), pBlock->len) < 0) return -1;
+  if (tsdbSeekDFile(pDFile, pBlock->offset, SEEK_SET) < 0) return -1;
+
+  int64_t nread = tsdbReadDFile(pDFile, TSDB_READ_BUF(pReadh), pBlock->len);
+  if (nread < 0) return -1;
+  if (nread < pBlock->len) {
+    terrno = TSDB_CODE_TDB_FILE_CORRUPTED;
+    return -1;
+  }
+
+  block.digest = tsdbSyncDigest(TSDB_READ_BUF(pReadh), pBlock->len);
+  block.offset = pBlock->offset;
+  block.len = pBlock->len;
+  block.last = (pBlock->last) ? 1 : 0;
+
+  if (taosArrayPush(aBlock, &block) == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+static int tsdbCompSyncBlock(const void *arg1, const void *arg2) {
+  const SSyncBlock *pBlock1 = (const SSyncBlock *)arg1;
+  const SSyncBlock *pBlock2 = (const SSyncBlock *)arg2;
+
+  if (pBlock1->last != pBlock2->last) return (pBlock1->last < pBlock2->last) ? -1 : 1;
+  if (pBlock1->offset != pBlock2->offset) return (pBlock1->offset < pBlock2->offset) ? -1 : 1;
+  return 0;
+}
+
+// The body of tlen bytes is put after the length in the sync buffer, and its last bytes are left for the checksum
+static int32_t tsdbSendSyncMsg(SSyncH *pSynch, uint32_t tlen) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  void *     ptr = SYNC_BUFFER(pSynch);
+
+  taosEncodeFixedU32(&ptr, tlen);
+  taosCalcChecksumAppend(0, (uint8_t *)ptr, tlen);
+
+  int32_t writeLen = tlen + sizeof(uint32_t);
+  int32_t ret = taosWriteMsg(pSynch->socketFd, SYNC_BUFFER(pSynch), writeLen);
+  if (ret != writeLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to send sync msg, ret:%d writeLen:%d", REPO_ID(pRepo), ret, writeLen);
+    return -1;
+  }
+
+  return 0;
+}
+
+// The body is received at the start of the sync buffer
+static int32_t tsdbRecvSyncMsg(SSyncH *pSynch, uint32_t *tlen) {
+  STsdbRepo *pRepo = pSynch->pRepo;
+  char       buf[64] = {0};
+
+  int32_t readLen = sizeof(uint32_t);
+  int32_t ret = taosReadMsg(pSynch->socketFd, buf, readLen);
+  if (ret != readLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to recv sync msg len, ret:%d readLen:%d", REPO_ID(pRepo), ret, readLen);
+    return -1;
+  }
+
+  taosDecodeFixedU32(buf, tlen);
+  if (*tlen < sizeof(TSCKSUM)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, invalid sync msg len:%u", REPO_ID(pRepo), *tlen);
+    return -1;
+  }
+
+  if (tsdbMakeRoom((void **)(&SYNC_BUFFER(pSynch)), *tlen) < 0) {
+    tsdbError("vgId:%d, failed to makeroom while recv sync msg since %s", REPO_ID(pRepo), tstrerror(terrno));
+    return -1;
+  }
+
+  ret = taosReadMsg(pSynch->socketFd, SYNC_BUFFER(pSynch), *tlen);
+  if (ret != *tlen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    tsdbError("vgId:%d, failed to recv sync msg, ret:%d tlen:%u", REPO_ID(pRepo), ret, *tlen);
+    return -1;
+  }
+
+  if (!taosCheckChecksumWhole((uint8_t *)SYNC_BUFFER(pSynch), *tlen)) {
+    terrno = TSDB_CODE_TDB_MESSED_MSG;
+    tsdbError("vgId:%d, failed to checksum while recv sync msg since %s", REPO_ID(pRepo), tstrerror(terrno));
+    return -1;
+  }
+
+  return 0;
+}
+
 static int tsdbReload(STsdbRepo *pRepo, bool isMfChanged) {
   // TODO: may need to stop and restart stream
   // if (isMfChanged) {
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "tsdbint.h"
+
+#define TSDB_TAG_INDEX_INIT_SIZE 64
+
+static STagIndex *tsdbNewTagIndex(STSchema *pTagSchema);
+static void       tsdbRebuildTagIndex(STable *pSTable);
+static void       tsdbSortTagIndex(STagIndex *pTagIndex);
+static int        tsdbAddTableIntoTagIndexImpl(STagIndex *pTagIndex, STable *pTable, bool append);
+static void       tsdbRemoveTableFromTagIndexImpl(STagIndex *pTagIndex, STable *pTable);
+static int        tsdbAddTidIntoTagIndexCol(STagIndexCol *pCol, const void *val, int32_t tid, bool append);
+static void       tsdbRemoveTidFromTagIndexCol(STagIndexCol *pCol, const void *val, int32_t tid);
+static size_t     tsdbLowerBoundOfTid(SArray *tids, int32_t tid);
+static int        tsdbCompareTid(const void *p1, const void *p2);
+static int        tsdbGetTagValLen(int8_t type, const void *val);
+
+// The skiplist index of the super table must already have the table
+void tsdbAddTableIntoTagIndex(STable *pSTable, STable *pTable) {
+  STagIndex *pTagIndex = pSTable->pTagIndex;
+
+  if (pTagIndex == NULL && !tsTagInvertedIndex) return;
+
+  if (pTagIndex == NULL || pTagIndex->version != schemaVersion(pSTable->tagSchema)) {
+    tsdbRebuildTagIndex(pSTable);
+    return;
+  }
+
+  if (tsdbAddTableIntoTagIndexImpl(pTagIndex, pTable, false) < 0) {
+    // Queries go back to the skiplist index until the tag index is rebuilt by the next table added
+    tsdbError("failed to add table %s into the tag index of super table %s since %s, the tag index is dropped",
+              TABLE_CHAR_NAME(pTable), TABLE_CHAR_NAME(pSTable), tstrerror(terrno));
+    tsdbFreeTagIndex(pTagIndex);
+    pSTable->pTagIndex = NULL;
+  }
+}
+
+// The skiplist index of the super table must still have the table
+void tsdbRemoveTableFromTagIndex(STable *pSTable, STable *pTable) {
+  if (pSTable->pTagIndex == NULL) return;
+
+  if (pSTable->pTagIndex->version != schemaVersion(pSTable->tagSchema)) {
+    tsdbRebuildTagIndex(pSTable);
+    if (pSTable->pTagIndex == NULL) return;
+  }
+
+  tsdbRemoveTableFromTagIndexImpl(pSTable->pTagIndex, pTable);
+}
+
+void tsdbFreeTagIndex(STagIndex *pTagIndex) {
+  if (pTagIndex == NULL) return;
+
+  for (int i = 0; i < pTagIndex->numOfCols; i++) {
+    STagIndexCol *pCol = pTagIndex->cols + i;
+
+    if (pCol->postings != NULL) {
+      STagPosting **ppPosting = taosHashIterate(pCol->postings, NULL);
+      while (ppPosting != NULL) {
+        taosArrayDestroy((*ppPosting)->tids);
+        free(*ppPosting);
+        ppPosting = taosHashIterate(pCol->postings, ppPosting);
+      }
+      taosHashCleanup(pCol->postings);
+    }
+    taosArrayDestroy(pCol->missing);
+  }
+
+  tfree(pTagIndex->cols);
+  free(pTagIndex);
+}
+
+STagIndexCol *tsdbGetTagIndexCol(STagIndex *pTagIndex, int16_t colId) {
+  for (int i = 0; i < pTagIndex->numOfCols; i++) {
+    if (pTagIndex->cols[i].colId == colId) return pTagIndex->cols + i;
+  }
+
+  return NULL;
+}
+
+static STagIndex *tsdbNewTagIndex(STSchema *pTagSchema) {
+  STagIndex *pTagIndex = (STagIndex *)calloc(1, sizeof(*pTagIndex));
+  if (pTagIndex == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pTagIndex->version = schemaVersion(pTagSchema);
+  pTagIndex->numOfCols = schemaNCols(pTagSchema);
+  pTagIndex->cols = (STagIndexCol *)calloc(pTagIndex->numOfCols, sizeof(STagIndexCol));
+  if (pTagIndex->cols == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    free(pTagIndex);
+    return NULL;
+  }
+
+  for (int i = 0; i < pTagIndex->numOfCols; i++) {
+    STColumn *    pTCol = schemaColAt(pTagSchema, i);
+    STagIndexCol *pCol = pTagIndex->cols + i;
+
+    pCol->colId = colColId(pTCol);
+    pCol->type = colType(pTCol);
+    pCol->postings = taosHashInit(TSDB_TAG_INDEX_INIT_SIZE, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), true,
+                                  HASH_NO_LOCK);
+    pCol->missing = taosArrayInit(4, sizeof(int32_t));
+    if (pCol->postings == NULL || pCol->missing == NULL) {
+      terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+      tsdbFreeTagIndex(pTagIndex);
+      return NULL;
+    }
+  }
+
+  return pTagIndex;
+}
+
+static void tsdbRebuildTagIndex(STable *pSTable) {
+  tsdbFreeTagIndex(pSTable->pTagIndex);
+  pSTable->pTagIndex = NULL;
+
+  STagIndex *pTagIndex = tsdbNewTagIndex(pSTable->tagSchema);
+  if (pTagIndex == NULL) {
+    tsdbError("failed to build the tag index of super table %s since %s", TABLE_CHAR_NAME(pSTable),
+              tstrerror(terrno));
+    return;
+  }
+
+  SSkipListIterator *pIter = tSkipListCreateIter(pSTable->pIndex);
+  while (tSkipListIterNext(pIter)) {
+    STable *pTable = (STable *)SL_GET_NODE_DATA(tSkipListIterGet(pIter));
+    if (tsdbAddTableIntoTagIndexImpl(pTagIndex, pTable, true) < 0) {
+      tsdbError("failed to build the tag index of super table %s since %s", TABLE_CHAR_NAME(pSTable),
+                tstrerror(terrno));
+      tSkipListDestroyIter(pIter);
+      tsdbFreeTagIndex(pTagIndex);
+      return;
+    }
+  }
+  tSkipListDestroyIter(pIter);
+
+  // the skiplist is in the order of the first tag, not of tid
+  tsdbSortTagIndex(pTagIndex);
+
+  pSTable->pTagIndex = pTagIndex;
+  tsdbDebug("tag index of super table %s is built for tag version %d, %d tables", TABLE_CHAR_NAME(pSTable),
+            pTagIndex->version, (int)SL_SIZE(pSTable->pIndex));
+}
+
+static void tsdbSortTagIndex(STagIndex *pTagIndex) {
+  for (int i = 0; i < pTagIndex->numOfCols; i++) {
+    STagIndexCol *pCol = pTagIndex->cols + i;
+
+    STagPosting **ppPosting = taosHashIterate(pCol->postings, NULL);
+    while (ppPosting != NULL) {
+      taosArraySort((*ppPosting)->tids, tsdbCompareTid);
+      ppPosting = taosHashIterate(pCol->postings, ppPosting);
+    }
+    taosArraySort(pCol->missing, tsdbCompareTid);
+  }
+}
+
+// With append, the tid is pushed to the end of its lists, and the lists must be sorted by tsdbSortTagIndex later
+static int tsdbAddTableIntoTagIndexImpl(STagIndex *pTagIndex, STable *pTable, bool append) {
+  for (int i = 0; i < pTagIndex->numOfCols; i++) {
+    STagIndexCol *pCol = pTagIndex->cols + i;
+    if (tsdbAddTidIntoTagIndexCol(pCol, tdGetKVRowValOfCol(pTable->tagVal, pCol->colId), TABLE_TID(pTable), append) <
+        0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+static void tsdbRemoveTableFromTagIndexImpl(STagIndex *pTagIndex, STable *pTable) {
+  for (int i = 0; i < pTagIndex->numOfCols; i++) {
+    STagIndexCol *pCol = pTagIndex->cols + i;
+    tsdbRemoveTidFromTagIndexCol(pCol, tdGetKVRowValOfCol(pTable->tagVal, pCol->colId), TABLE_TID(pTable));
+  }
+}
+
+static int tsdbAddTidIntoTagIndexCol(STagIndexCol *pCol, const void *val, int32_t tid, bool append) {
+  SArray *tids = pCol->missing;
+
+  if (val != NULL) {
+    int           len = tsdbGetTagValLen(pCol->type, val);
+    STagPosting **ppPosting = taosHashGet(pCol->postings, val, len);
+
+    if (ppPosting == NULL) {
+      STagPosting *pPosting = (STagPosting *)malloc(sizeof(*pPosting) + len);
+      if (pPosting == NULL) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        return -1;
+      }
+
+      memcpy(pPosting->val, val, len);
+      pPosting->tids = taosArrayInit(1, sizeof(int32_t));
+      if (pPosting->tids == NULL || taosHashPut(pCol->postings, val, len, &pPosting, sizeof(pPosting)) < 0) {
+        terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+        taosArrayDestroy(pPosting->tids);
+        free(pPosting);
+        return -1;
+      }
+
+      tids = pPosting->tids;
+    } else {
+      tids = (*ppPosting)->tids;
+    }
+  }
+
+  // a new table has the largest tid mostly, so it is appended without moving any other tid
+  size_t idx = append ? taosArrayGetSize(tids) : tsdbLowerBoundOfTid(tids, tid);
+  if (taosArrayInsert(tids, idx, &tid) == NULL) {
+    terrno = TSDB_CODE_TDB_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  return 0;
+}
+
+static void tsdbRemoveTidFromTagIndexCol(STagIndexCol *pCol, const void *val, int32_t tid) {
+  SArray *      tids = pCol->missing;
+  STagPosting **ppPosting = NULL;
+  int           len = 0;
+
+  if (val != NULL) {
+    len = tsdbGetTagValLen(pCol->type, val);
+    ppPosting = taosHashGet(pCol->postings, val, len);
+    if (ppPosting == NULL) return;
+    tids = (*ppPosting)->tids;
+  }
+
+  size_t idx = tsdbLowerBoundOfTid(tids, tid);
+  if (idx < taosArrayGetSize(tids) && *(int32_t *)taosArrayGet(tids, idx) == tid) {
+    taosArrayRemove(tids, idx);
+  }
+
+  if (ppPosting != NULL && taosArrayGetSize(tids) == 0) {
+    STagPosting *pPosting = *ppPosting;
+    taosHashRemove(pCol->postings, val, len);
+    taosArrayDestroy(pPosting->tids);
+    free(pPosting);
+  }
+}
+
+// the index of the first tid not less than tid in the sorted tids
+static size_t tsdbLowerBoundOfTid(SArray *tids, int32_t tid) {
+  size_t l = 0;
+  size_t r = taosArrayGetSize(tids);
+
+  while (l < r) {
+    size_t m = (l + r) / 2;
+    if (*(int32_t *)taosArrayGet(tids, m) < tid) {
+      l = m + 1;
+    } else {
+      r = m;
+    }
+  }
+
+  return l;
+}
+
+static int tsdbCompareTid(const void *p1, const void *p2) {
+  int32_t tid1 = *(const int32_t *)p1;
+  int32_t tid2 = *(const int32_t *)p2;
+  return (tid1 < tid2) ? -1 : ((tid1 > tid2) ? 1 : 0);
+}
+
+static int tsdbGetTagValLen(int8_t type, const void *val) {
+  return IS_VAR_DATA_TYPE(type) ? varDataTLen(val) : TYPE_BYTES[type];
+}
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+
+extern "C" {
+#include "tcoding.h"
+#include "tdataformat.h"
+#include "tsdbCodec.h"
+}
+
+namespace {
+
+const int32_t  MAX_ROWS = 1024;
+const uint8_t  INT_CODECS[] = {TSDB_CODEC_RLE, TSDB_CODEC_DICT, TSDB_CODEC_FOR, TSDB_CODEC_DOD};
+const uint8_t  VAR_CODECS[] = {TSDB_CODEC_RLE, TSDB_CODEC_DICT};
+
+// a column of at most MAX_ROWS rows, the values are appended like the commit does
+SDataCol *createDataCol(int8_t type, uint16_t bytes) {
+  STColumn col = {0};
+  colSetType(&col, type);
+  colSetColId(&col, 1);
+  colSetBytes(&col, bytes);
+
+  SDataCol *pDataCol = (SDataCol *)calloc(1, sizeof(SDataCol) + (sizeof(VarDataOffsetT) + bytes) * MAX_ROWS);
+  void *    pBuf = POINTER_SHIFT(pDataCol, sizeof(SDataCol));
+  dataColInit(pDataCol, &col, &pBuf, MAX_ROWS);
+  return pDataCol;
+}
+
+void appendInt(SDataCol *pDataCol, int row, uint64_t v) {
+  char val[sizeof(uint64_t)];
+  memcpy(val, &v, pDataCol->bytes);  // little endian, the low bytes are the value of narrower types
+  dataColAppendVal(pDataCol, val, row, MAX_ROWS);
+}
+
+void appendStr(SDataCol *pDataCol, int row, const char *str) {
+  char val[64];
+  varDataSetLen(val, strlen(str));
+  memcpy(varDataVal(val), str, strlen(str));
+  dataColAppendVal(pDataCol, val, row, MAX_ROWS);
+}
+
+// encode the column by the codec, and expect the data decoded to be the same
+std::vector<char> roundTrip(uint8_t codec, SDataCol *pDataCol, int numOfRows) {
+  std::vector<char> output(pDataCol->len * 2 + numOfRows * 16 + 64);
+  int32_t           elen = tsdbCodecEncode(codec, pDataCol, numOfRows, output.data());
+  EXPECT_GE(elen, 0);
+  output.resize(elen);
+
+  SDataCol *pDecoded = createDataCol(pDataCol->type, pDataCol->bytes);
+  int32_t   dlen = tsdbCodecDecode(codec, pDecoded, output.data(), elen, numOfRows);
+  EXPECT_EQ(dlen, pDataCol->len) << "codec:" << (int)codec << " rows:" << numOfRows;
+  if (dlen == pDataCol->len) {
+    EXPECT_EQ(memcmp(pDecoded->pData, pDataCol->pData, dlen), 0) << "codec:" << (int)codec << " rows:" << numOfRows;
+  }
+
+  free(pDecoded);
+  return output;
+}
+
+// all the codecs of the type round trip, and the size given by tsdbCodecChoose is the one encoded
+void roundTripAll(SDataCol *pDataCol, int numOfRows) {
+  bool           isVar = IS_VAR_DATA_TYPE(pDataCol->type);
+  const uint8_t *codecs = isVar ? VAR_CODECS : INT_CODECS;
+  int            numOfCodecs = isVar ? tListLen(VAR_CODECS) : tListLen(INT_CODECS);
+
+  for (int i = 0; i < numOfCodecs; i++) {
+    roundTrip(codecs[i], pDataCol, numOfRows);
+  }
+
+  int32_t size = 0;
+  uint8_t codec = tsdbCodecChoose(pDataCol, numOfRows, &size);
+  EXPECT_EQ(roundTrip(codec, pDataCol, numOfRows).size(), size);
+}
+
+// each proper prefix of the encoded data is rejected
+void expectTruncatedRejected(uint8_t codec, SDataCol *pDataCol, int numOfRows) {
+  std::vector<char> encoded = roundTrip(codec, pDataCol, numOfRows);
+  SDataCol *        pDecoded = createDataCol(pDataCol->type, pDataCol->bytes);
+
+  for (int32_t len = 0; len < (int32_t)encoded.size(); len++) {
+    EXPECT_EQ(tsdbCodecDecode(codec, pDecoded, encoded.data(), len, numOfRows), -1)
+        << "codec:" << (int)codec << " len:" << len;
+  }
+
+  free(pDecoded);
+}
+
+}  // namespace
+
+TEST(tsdbCodecTest, empty_and_one_row) {
+  SDataCol *pInt = createDataCol(TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  SDataCol *pStr = createDataCol(TSDB_DATA_TYPE_BINARY, VARSTR_HEADER_SIZE + 16);
+
+  roundTripAll(pInt, 0);
+  roundTripAll(pStr, 0);
+
+  appendInt(pInt, 0, (uint64_t)-5);
+  appendStr(pStr, 0, "one");
+  roundTripAll(pInt, 1);
+  roundTripAll(pStr, 1);
+
+  free(pInt);
+  free(pStr);
+}
+
+TEST(tsdbCodecTest, all_equal) {
+  SDataCol *pInt = createDataCol(TSDB_DATA_TYPE_SMALLINT, sizeof(int16_t));
+  SDataCol *pStr = createDataCol(TSDB_DATA_TYPE_NCHAR, VARSTR_HEADER_SIZE + 16);
+
+  for (int row = 0; row < MAX_ROWS; row++) {
+    appendInt(pInt, row, 7);
+    appendStr(pStr, row, "same");
+  }
+
+  roundTripAll(pInt, MAX_ROWS);
+  roundTripAll(pStr, MAX_ROWS);
+
+  // a single run of a value is the smallest of all
+  int32_t size = 0;
+  EXPECT_EQ(tsdbCodecChoose(pInt, MAX_ROWS, &size), TSDB_CODEC_RLE);
+  EXPECT_EQ(size, 2 + sizeof(int16_t));
+
+  free(pInt);
+  free(pStr);
+}
+
+TEST(tsdbCodecTest, int64_min_max) {
+  SDataCol *pBig = createDataCol(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  SDataCol *pUBig = createDataCol(TSDB_DATA_TYPE_UBIGINT, sizeof(uint64_t));
+  int64_t   vals[] = {INT64_MIN, INT64_MAX, 0, -1, INT64_MAX, INT64_MIN, 1};
+
+  for (int row = 0; row < (int)tListLen(vals); row++) {
+    appendInt(pBig, row, (uint64_t)vals[row]);
+    appendInt(pUBig, row, (uint64_t)vals[row]);
+  }
+
+  roundTripAll(pBig, tListLen(vals));
+  roundTripAll(pUBig, tListLen(vals));
+
+  free(pBig);
+  free(pUBig);
+}
+
+TEST(tsdbCodecTest, dict_overflow) {
+  SDataCol *pInt = createDataCol(TSDB_DATA_TYPE_INT, sizeof(int32_t));
+
+  // exactly as many distinct values as the dictionary holds
+  for (int row = 0; row < 512; row++) {
+    appendInt(pInt, row, (row * 37) % 256);
+  }
+  roundTrip(TSDB_CODEC_DICT, pInt, 512);
+
+  // one more distinct value, the dictionary is not chosen any more
+  appendInt(pInt, 512, 100000);
+  int32_t size = 0;
+  uint8_t codec = tsdbCodecChoose(pInt, 513, &size);
+  EXPECT_NE(codec, TSDB_CODEC_DICT);
+  EXPECT_EQ(roundTrip(codec, pInt, 513).size(), size);
+  roundTrip(TSDB_CODEC_RLE, pInt, 513);
+  roundTrip(TSDB_CODEC_FOR, pInt, 513);
+  roundTrip(TSDB_CODEC_DOD, pInt, 513);
+
+  // the data of a dictionary with more entries than allowed is broken
+  char     input[1024] = {0};
+  void *   ptr = input;
+  uint16_t entries = 257;
+  taosEncodeFixedU16(&ptr, entries);
+  EXPECT_EQ(tsdbCodecDecode(TSDB_CODEC_DICT, pInt, input, sizeof(input), 1), -1);
+
+  free(pInt);
+}
+
+TEST(tsdbCodecTest, negative_delta_of_delta) {
+  SDataCol *pTs = createDataCol(TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t));
+  SDataCol *pTiny = createDataCol(TSDB_DATA_TYPE_TINYINT, sizeof(int8_t));
+  int64_t   ts[] = {1000, 990, 970, 940, 900, 1000, 1000, -5000, 1600000000000};
+  int8_t    tiny[] = {127, -128, 127, -128, 0, -1, 1};
+
+  for (int row = 0; row < (int)tListLen(ts); row++) {
+    appendInt(pTs, row, (uint64_t)ts[row]);
+  }
+  for (int row = 0; row < (int)tListLen(tiny); row++) {
+    appendInt(pTiny, row, (uint64_t)(int64_t)tiny[row]);
+  }
+
+  roundTripAll(pTs, tListLen(ts));
+  roundTripAll(pTiny, tListLen(tiny));
+
+  free(pTs);
+  free(pTiny);
+}
+
+TEST(tsdbCodecTest, truncated_input) {
+  SDataCol *pInt = createDataCol(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  SDataCol *pStr = createDataCol(TSDB_DATA_TYPE_BINARY, VARSTR_HEADER_SIZE + 16);
+  const char *strs[] = {"a", "a", "bb", "ccc", "bb", "a"};
+
+  for (int row = 0; row < 100; row++) {
+    appendInt(pInt, row, (uint64_t)(row * row * 1000 - row % 7));
+    appendStr(pStr, row, strs[row % tListLen(strs)]);
+  }
+
+  for (int i = 0; i < (int)tListLen(INT_CODECS); i++) {
+    expectTruncatedRejected(INT_CODECS[i], pInt, 100);
+  }
+  for (int i = 0; i < (int)tListLen(VAR_CODECS); i++) {
+    expectTruncatedRejected(VAR_CODECS[i], pStr, 100);
+  }
+
+  free(pInt);
+  free(pStr);
+}
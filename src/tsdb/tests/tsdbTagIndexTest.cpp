@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+#include "os.h"
+#include "taosdef.h"
+
+extern "C" {
+#include "hash.h"
+#include "texpr.h"
+#include "tglobal.h"
+#include "tlockfree.h"
+#include "tskiplist.h"
+#include "tsdb.h"
+#include "tsdbMeta.h"
+#include "tsdbTagIndex.h"
+}
+
+namespace {
+
+const int32_t MAX_TABLES = 256;
+const int16_t T1 = 1;  // int
+const int16_t T2 = 2;  // int
+const int16_t T3 = 3;  // binary(8)
+
+struct STags {
+  int32_t     t1;
+  int32_t     t2;
+  const char *t3;  // NULL if the table has no value of t3
+};
+
+// the skiplist of a super table is in the order of its first tag, this one is in the reverse order of tid
+int32_t compareTidDesc(const void *p1, const void *p2) {
+  int32_t tid1 = *(const int32_t *)p1;
+  int32_t tid2 = *(const int32_t *)p2;
+  return (tid1 < tid2) ? 1 : ((tid1 > tid2) ? -1 : 0);
+}
+
+char *getTid(const void *pData) { return (char *)&((STable *)pData)->tableId.tid; }
+
+SKVRow buildTagVal(const STags &tags) {
+  SKVRowBuilder builder;
+  tdInitKVRowBuilder(&builder);
+
+  int32_t t1 = tags.t1, t2 = tags.t2;
+  tdAddColToKVRow(&builder, T1, TSDB_DATA_TYPE_INT, &t1);
+  tdAddColToKVRow(&builder, T2, TSDB_DATA_TYPE_INT, &t2);
+
+  char t3[VARSTR_HEADER_SIZE + 8];
+  if (tags.t3 != NULL) {
+    STR_WITH_SIZE_TO_VARSTR(t3, tags.t3, (VarDataLenT)strlen(tags.t3));
+    tdAddColToKVRow(&builder, T3, TSDB_DATA_TYPE_BINARY, t3);
+  }
+
+  SKVRow row = tdGetKVRowFromBuilder(&builder);
+  tdDestroyKVRowBuilder(&builder);
+  return row;
+}
+
+tExprNode *colNode(int16_t colId) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_COL;
+  pNode->pSchema = (SSchema *)calloc(1, sizeof(SSchema));
+  pNode->pSchema->colId = colId;
+  pNode->pSchema->type = (colId == T3) ? TSDB_DATA_TYPE_BINARY : TSDB_DATA_TYPE_INT;
+  pNode->pSchema->bytes = (colId == T3) ? VARSTR_HEADER_SIZE + 8 : sizeof(int32_t);
+  return pNode;
+}
+
+tExprNode *exprNode(uint8_t optr, tExprNode *pLeft, tExprNode *pRight) {
+  tExprNode *pNode = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pNode->nodeType = TSQL_NODE_EXPR;
+  pNode->_node.optr = optr;
+  pNode->_node.pLeft = pLeft;
+  pNode->_node.pRight = pRight;
+  return pNode;
+}
+
+// is null of the binary tag
+tExprNode *isNullCond() {
+  tExprNode *pDummy = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pDummy->nodeType = TSQL_NODE_DUMMY;
+  return exprNode(TSDB_RELATION_ISNULL, colNode(T3), pDummy);
+}
+
+// a condition of an int tag
+tExprNode *intCond(int16_t colId, uint8_t optr, int32_t val) {
+  tExprNode *pVal = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pVal->nodeType = TSQL_NODE_VALUE;
+  pVal->pVal = (tVariant *)calloc(1, sizeof(tVariant));
+  tVariantCreateFromBinary(pVal->pVal, (const char *)&val, sizeof(val), TSDB_DATA_TYPE_INT);
+  return exprNode(optr, colNode(colId), pVal);
+}
+
+// a condition of the binary tag
+tExprNode *strCond(uint8_t optr, const char *val) {
+  tExprNode *pVal = (tExprNode *)calloc(1, sizeof(tExprNode));
+  pVal->nodeType = TSQL_NODE_VALUE;
+  pVal->pVal = (tVariant *)calloc(1, sizeof(tVariant));
+  tVariantCreateFromBinary(pVal->pVal, val, strlen(val), TSDB_DATA_TYPE_BINARY);
+  return exprNode(optr, colNode(T3), pVal);
+}
+
+// a super table of tags t1, t2 and t3, its child tables are indexed by tid in the skiplist
+class TagIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tagInvertedIndex = tsTagInvertedIndex;
+    tsTagInvertedIndex = 1;
+
+    memset(&meta, 0, sizeof(meta));
+    meta.maxTables = MAX_TABLES;
+    meta.tables = (STable **)calloc(MAX_TABLES, sizeof(STable *));
+
+    STSchemaBuilder builder;
+    tdInitTSchemaBuilder(&builder, 0);
+    tdAddColToSchema(&builder, TSDB_DATA_TYPE_INT, T1, sizeof(int32_t));
+    tdAddColToSchema(&builder, TSDB_DATA_TYPE_INT, T2, sizeof(int32_t));
+    tdAddColToSchema(&builder, TSDB_DATA_TYPE_BINARY, T3, VARSTR_HEADER_SIZE + 8);
+
+    pSTable = (STable *)calloc(1, sizeof(STable));
+    pSTable->type = TSDB_SUPER_TABLE;
+    pSTable->tagSchema = tdGetSchemaFromBuilder(&builder);
+    pSTable->pIndex = tSkipListCreate(5, TSDB_DATA_TYPE_INT, sizeof(int32_t), compareTidDesc, SL_ALLOW_DUP_KEY, getTid);
+    tdDestroyTSchemaBuilder(&builder);
+  }
+
+  void TearDown() override {
+    tsTagInvertedIndex = tagInvertedIndex;
+
+    tsdbFreeTagIndex(pSTable->pTagIndex);
+    tSkipListDestroy(pSTable->pIndex);
+    tdFreeSchema(pSTable->tagSchema);
+    free(pSTable);
+
+    for (int32_t tid = 0; tid < MAX_TABLES; ++tid) {
+      if (meta.tables[tid] == NULL) continue;
+      kvRowFree(meta.tables[tid]->tagVal);
+      free(meta.tables[tid]->name);
+      free(meta.tables[tid]);
+    }
+    free(meta.tables);
+  }
+
+  // as tsdbAddTableIntoIndex does
+  void addTable(int32_t tid, const STags &tags) {
+    STable *pTable = (STable *)calloc(1, sizeof(STable));
+    pTable->type = TSDB_CHILD_TABLE;
+    pTable->tableId.tid = tid;
+    pTable->name = (tstr *)calloc(1, sizeof(VarDataLenT) + 16);
+    STR_TO_VARSTR(pTable->name, "child");
+    pTable->pSuper = pSTable;
+    pTable->tagVal = buildTagVal(tags);
+
+    meta.tables[tid] = pTable;
+    tSkipListPut(pSTable->pIndex, pTable);
+    tsdbAddTableIntoTagIndex(pSTable, pTable);
+  }
+
+  // t1 = tid % 10, t2 = tid % 7, t3 is "a", "b" or none by tid % 3
+  void addTables(int32_t first, int32_t last) {
+    static const char *t3[] = {"a", "b", NULL};
+    for (int32_t tid = first; tid <= last; ++tid) {
+      STags tags = {tid % 10, tid % 7, t3[tid % 3]};
+      addTable(tid, tags);
+    }
+  }
+
+  // as tsdbRemoveTableFromIndex does
+  void dropTable(int32_t tid) {
+    STable *pTable = meta.tables[tid];
+    tsdbRemoveTableFromTagIndex(pSTable, pTable);
+    tSkipListRemove(pSTable->pIndex, getTid(pTable));
+
+    meta.tables[tid] = NULL;
+    kvRowFree(pTable->tagVal);
+    free(pTable->name);
+    free(pTable);
+  }
+
+  // as tsdbUpdateTableTagValue does for a tag other than the first one
+  void setT2(int32_t tid, int32_t t2) {
+    STable *pTable = meta.tables[tid];
+    tsdbRemoveTableFromTagIndex(pSTable, pTable);
+    tdSetKVRowDataOfCol(&pTable->tagVal, T2, TSDB_DATA_TYPE_INT, &t2);
+    tsdbAddTableIntoTagIndex(pSTable, pTable);
+  }
+
+  std::vector<int32_t> posting(int16_t colId, const void *val, size_t len) {
+    std::vector<int32_t> tids;
+
+    STagIndexCol *pCol = tsdbGetTagIndexCol(pSTable->pTagIndex, colId);
+    EXPECT_NE(pCol, (STagIndexCol *)NULL);
+    if (pCol == NULL) return tids;
+
+    SArray *pTids = pCol->missing;
+    if (val != NULL) {
+      STagPosting **ppPosting = (STagPosting **)taosHashGet(pCol->postings, val, len);
+      if (ppPosting == NULL) return tids;
+      pTids = (*ppPosting)->tids;
+    }
+
+    for (size_t i = 0; i < taosArrayGetSize(pTids); ++i) tids.push_back(*(int32_t *)taosArrayGet(pTids, i));
+    return tids;
+  }
+
+  std::vector<int32_t> intPosting(int16_t colId, int32_t val) { return posting(colId, &val, sizeof(val)); }
+
+  // the tids qualified by the expression built by build, through the tag index and through the skiplist
+  void query(tExprNode *(*build)(), std::vector<int32_t> *byTagIndex, std::vector<int32_t> *bySkipList) {
+    SArray *res = (SArray *)taosArrayInit(8, sizeof(STableKeyInfo));
+
+    ASSERT_NE(pSTable->pTagIndex, (STagIndex *)NULL);
+    tsdbQueryTableList(&meta, pSTable, res, build());
+    for (size_t i = 0; i < taosArrayGetSize(res); ++i) {
+      byTagIndex->push_back(TABLE_TID((STable *)((STableKeyInfo *)taosArrayGet(res, i))->pTable));
+    }
+
+    STagIndex *pTagIndex = pSTable->pTagIndex;
+    pSTable->pTagIndex = NULL;
+    taosArrayClear(res);
+    tsdbQueryTableList(&meta, pSTable, res, build());
+    for (size_t i = 0; i < taosArrayGetSize(res); ++i) {
+      bySkipList->push_back(TABLE_TID((STable *)((STableKeyInfo *)taosArrayGet(res, i))->pTable));
+    }
+    pSTable->pTagIndex = pTagIndex;
+
+    taosArrayDestroy(res);
+    std::sort(bySkipList->begin(), bySkipList->end());
+  }
+
+  STsdbMeta meta;
+  STable *  pSTable;
+  int32_t   tagInvertedIndex;
+};
+
+std::vector<int32_t> expected(int32_t first, int32_t last, bool (*qualified)(int32_t tid)) {
+  std::vector<int32_t> tids;
+  for (int32_t tid = first; tid <= last; ++tid) {
+    if (qualified(tid)) tids.push_back(tid);
+  }
+  return tids;
+}
+
+}  // namespace
+
+TEST_F(TagIndexTest, add_table) {
+  // the tables are added in reverse order of tid, the posting lists are still sorted
+  for (int32_t tid = 100; tid >= 1; --tid) {
+    STags tags = {tid % 10, tid % 7, (tid % 3 == 0) ? NULL : "a"};
+    addTable(tid, tags);
+  }
+
+  EXPECT_EQ(intPosting(T1, 3), expected(1, 100, [](int32_t tid) { return tid % 10 == 3; }));
+  EXPECT_EQ(intPosting(T2, 0), expected(1, 100, [](int32_t tid) { return tid % 7 == 0; }));
+  EXPECT_EQ(posting(T3, NULL, 0), expected(1, 100, [](int32_t tid) { return tid % 3 == 0; }));
+  EXPECT_TRUE(intPosting(T1, 10).empty());
+}
+
+TEST_F(TagIndexTest, build_from_skiplist) {
+  // the tag index is built from the skiplist when the first table is added after it is enabled
+  tsTagInvertedIndex = 0;
+  addTables(1, 100);
+  EXPECT_EQ(pSTable->pTagIndex, (STagIndex *)NULL);
+
+  tsTagInvertedIndex = 1;
+  addTables(101, 120);
+  ASSERT_NE(pSTable->pTagIndex, (STagIndex *)NULL);
+
+  EXPECT_EQ(intPosting(T2, 5), expected(1, 120, [](int32_t tid) { return tid % 7 == 5; }));
+  EXPECT_EQ(posting(T3, NULL, 0), expected(1, 120, [](int32_t tid) { return tid % 3 == 2; }));
+}
+
+TEST_F(TagIndexTest, drop_table) {
+  addTables(1, 100);
+
+  // the first, a middle and the last tid of the posting list of t1 = 4
+  dropTable(4);
+  dropTable(54);
+  dropTable(94);
+  for (int32_t tid = 60; tid <= 69; ++tid) dropTable(tid);
+
+  auto qualified = [](int32_t tid) { return tid % 10 == 4 && tid != 4 && tid != 54 && tid != 94 && tid != 64; };
+  EXPECT_EQ(intPosting(T1, 4), expected(1, 100, qualified));
+  EXPECT_EQ(intPosting(T2, 0), expected(1, 100, [](int32_t tid) {
+              return tid % 7 == 0 && tid != 4 && tid != 54 && tid != 94 && (tid < 60 || tid > 69);
+            }));
+
+  // the posting list of a value is dropped with its last table
+  for (int32_t tid = 8; tid <= 100; tid += 10) {
+    if (meta.tables[tid] != NULL) dropTable(tid);
+  }
+  int32_t t1 = 8;
+  EXPECT_EQ(taosHashGet(tsdbGetTagIndexCol(pSTable->pTagIndex, T1)->postings, &t1, sizeof(t1)), (void *)NULL);
+}
+
+TEST_F(TagIndexTest, update_tag) {
+  addTables(1, 100);
+
+  // move every table of t2 = 3 to t2 = 5
+  for (int32_t tid = 3; tid <= 100; tid += 7) setT2(tid, 5);
+
+  EXPECT_TRUE(intPosting(T2, 3).empty());
+  EXPECT_EQ(intPosting(T2, 5), expected(1, 100, [](int32_t tid) { return tid % 7 == 3 || tid % 7 == 5; }));
+  EXPECT_EQ(intPosting(T1, 3), expected(1, 100, [](int32_t tid) { return tid % 10 == 3; }));
+
+  // and back, one by one from the last
+  for (int32_t tid = 94; tid >= 3; tid -= 7) setT2(tid, 3);
+  EXPECT_EQ(intPosting(T2, 3), expected(1, 100, [](int32_t tid) { return tid % 7 == 3; }));
+  EXPECT_EQ(intPosting(T2, 5), expected(1, 100, [](int32_t tid) { return tid % 7 == 5; }));
+}
+
+TEST_F(TagIndexTest, multi_tag_intersection) {
+  addTables(1, 200);
+  dropTable(33);
+  setT2(40, 3);
+
+  std::vector<int32_t> byTagIndex, bySkipList;
+
+  // t2 = 3 and t3 = 'b', both by direct lookup
+  query([]() { return exprNode(TSDB_RELATION_AND, intCond(T2, TSDB_RELATION_EQUAL, 3), strCond(TSDB_RELATION_EQUAL, "b")); },
+        &byTagIndex, &bySkipList);
+  EXPECT_EQ(byTagIndex, expected(1, 200, [](int32_t tid) {
+              return tid != 33 && (tid % 7 == 3 || tid == 40) && tid % 3 == 1;
+            }));
+  EXPECT_EQ(byTagIndex, bySkipList);
+
+  // t1 >= 5 and t2 < 2 and t3 is null
+  byTagIndex.clear();
+  bySkipList.clear();
+  query(
+      []() {
+        return exprNode(TSDB_RELATION_AND,
+                        exprNode(TSDB_RELATION_AND, intCond(T1, TSDB_RELATION_GREATER_EQUAL, 5),
+                                 intCond(T2, TSDB_RELATION_LESS, 2)),
+                        isNullCond());
+      },
+      &byTagIndex, &bySkipList);
+  EXPECT_EQ(byTagIndex, expected(1, 200, [](int32_t tid) { return tid % 10 >= 5 && tid % 7 < 2 && tid % 3 == 2; }));
+  EXPECT_EQ(byTagIndex, bySkipList);
+
+  // (t2 = 1 or t3 = 'a') and t1 = 7
+  byTagIndex.clear();
+  bySkipList.clear();
+  query(
+      []() {
+        return exprNode(TSDB_RELATION_AND,
+                        exprNode(TSDB_RELATION_OR, intCond(T2, TSDB_RELATION_EQUAL, 1), strCond(TSDB_RELATION_EQUAL, "a")),
+                        intCond(T1, TSDB_RELATION_EQUAL, 7));
+      },
+      &byTagIndex, &bySkipList);
+  EXPECT_EQ(byTagIndex, expected(1, 200, [](int32_t tid) { return tid != 33 && (tid % 7 == 1 || tid % 3 == 0) && tid % 10 == 7; }));
+  EXPECT_EQ(byTagIndex, bySkipList);
+}
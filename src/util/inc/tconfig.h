@@ -20,7 +20,7 @@
 extern "C" {
 #endif
 
-#define TSDB_CFG_MAX_NUM    116  // 110 + 6 with lossy option
+#define TSDB_CFG_MAX_NUM    160  // all the options registered by taosInitGlobalCfg, and room for more
 #define TSDB_CFG_PRINT_LEN  23
 #define TSDB_CFG_OPTION_LEN 24
 #define TSDB_CFG_VALUE_LEN  41
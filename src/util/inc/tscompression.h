@@ -50,6 +50,11 @@ extern "C" {
 #define HEAD_MODE(x)  x%2
 #define HEAD_ALGO(x)  x/2
 
+// SIMD level of the decode kernels, picked from the running CPU on first use
+#define TSDB_SIMD_NONE   0
+#define TSDB_SIMD_SSE42  1
+#define TSDB_SIMD_AVX2   2
+
 extern int tsCompressINTImp(const char *const input, const int nelements, char *const output, const char type);
 extern int tsDecompressINTImp(const char *const input, const int nelements, char *const output, const char type);
 extern int tsCompressBoolImp(const char *const input, const int nelements, char *const output);
@@ -68,6 +73,10 @@ extern int tsDecompressFloatLossyImp(const char * input, int compressedSize, con
 extern int tsCompressDoubleLossyImp(const char * input, const int nelements, char *const output);
 extern int tsDecompressDoubleLossyImp(const char * input, int compressedSize, const int nelements, char *const output);
 
+extern int tsGetDecompressSimdLevel();
+// cap the decode kernels at the given level (mainly for tests and benchmarks), returns the level in use
+extern int tsSetDecompressSimdLevel(int level);
+
 #ifdef TD_TSZ
 extern bool lossyFloat;
 extern bool lossyDouble;
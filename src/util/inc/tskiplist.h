@@ -33,6 +33,11 @@ extern "C" {
 #define SL_UPDATE_DUP_KEY (uint8_t)0x2   // Update duplicate key by remove/insert (for data update=1 case)
 // For thread safety setting
 #define SL_THREAD_SAFE (uint8_t)0x4
+// Lock-free insertion for multiple producers, only for unique keys (SL_DISCARD_DUP_KEY or SL_UPDATE_DUP_KEY).
+// Nodes are linked by CAS on the forward pointers and never removed, tSkipListRemove and tSkipListRemoveNode
+// refuse it; the level 0 backward pointer is only a hint to a smaller node, from which the previous node is found
+// by walking forward.
+#define SL_LOCK_FREE (uint8_t)0x8
 
 typedef char *SSkipListKey;
 typedef char *(*__sl_key_fn_t)(const void *);
@@ -122,6 +127,7 @@ typedef struct SSkipListIterator {
 } SSkipListIterator;
 
 #define SL_IS_THREAD_SAFE(s) (((s)->flags) & SL_THREAD_SAFE)
+#define SL_IS_LOCK_FREE(s) (((s)->flags) & SL_LOCK_FREE)
 #define SL_DUP_MODE(s) (((s)->flags) & ((((uint8_t)1) << 2) - 1))
 #define SL_GET_NODE_KEY(s, n) ((s)->keyFn((n)->pData))
 #define SL_GET_MIN_KEY(s) SL_GET_NODE_KEY(s, SL_NODE_GET_FORWARD_POINTER((s)->pHead, 0))
@@ -28,9 +28,14 @@ int32_t taosReadn(SOCKET sock, char *buffer, int32_t len);
 int32_t taosWriteMsg(SOCKET fd, void *ptr, int32_t nbytes);
 int32_t taosReadMsg(SOCKET fd, void *ptr, int32_t nbytes);
 int32_t taosNonblockwrite(SOCKET fd, char *ptr, int32_t nbytes);
-int64_t taosCopyFds(SOCKET sfd, int32_t dfd, int64_t len);
 int32_t taosSetNonblocking(SOCKET sock, int32_t on);
 
+extern int32_t tsSyncRecvRate;
+
+typedef void (*FCopyFdsFp)(void *param, int64_t bytes);
+int64_t taosCopyFds(SOCKET sfd, int32_t dfd, int64_t len, FCopyFdsFp fp, void *param);
+void    taosThrottleRecv(int64_t bytes);
+
 SOCKET  taosOpenUdpSocket(uint32_t localIp, uint16_t localPort);
 SOCKET  taosOpenTcpClientSocket(uint32_t ip, uint16_t port, uint32_t localIp);
 SOCKET  taosOpenTcpServerSocket(uint32_t ip, uint16_t port);
@@ -99,6 +99,249 @@ void tsCompressExit(){
 
 #endif
 
+/* ----------------------------------------------Decode Kernels
+ * ---------------------------------------------- */
+// The hot decode loops of simple8b words and 2-bit booleans have scalar, SSE4.2 and AVX2
+// versions. The best one supported by the running CPU is picked on
+// first use, and the scalar one is always kept as the fallback.
+#if !defined(_TD_ARM_) && !defined(_TD_MIPS_) && !defined(WINDOWS) && defined(__x86_64__)
+#define TD_COMPRESS_SIMD
+#include <immintrin.h>
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+static const char SIMPLE8B_BITS[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+static const int  SIMPLE8B_ELEMS[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+typedef int32_t (*FDecodeSimple8b)(const char *ip, const int nelements, char *const output, const char type);
+typedef void (*FDecodeBool)(const char *const input, const int nelements, char *const output);
+
+static int32_t tsDecodeSimple8bScalar(const char *ip, const int nelements, char *const output, const char type);
+static void tsDecodeBoolScalar(const char *const input, const int nelements, char *const output);
+
+static pthread_once_t  decodeKernelsInit = PTHREAD_ONCE_INIT;
+static int             decodeSimdLevel = TSDB_SIMD_NONE;
+static FDecodeSimple8b decodeSimple8bFp = tsDecodeSimple8bScalar;
+static FDecodeBool     decodeBoolFp = tsDecodeBoolScalar;
+
+// Unpack one simple8b word into elems running values starting from prev, return the last one.
+static FORCE_INLINE int64_t tsDecodeSimple8bWord(uint64_t w, int32_t bit, int32_t elems, int64_t prev,
+                                                 int64_t *out) {
+  if (bit == 0) {
+    for (int32_t i = 0; i < elems; i++) out[i] = prev;
+    return prev;
+  }
+
+  uint64_t mask = INT64MASK(bit);
+  int32_t  shift = 4;
+  for (int32_t i = 0; i < elems; i++) {
+    uint64_t zigzag_value = (w >> shift) & mask;
+    prev += (int64_t)(ZIGZAG_DECODE(int64_t, zigzag_value));
+    out[i] = prev;
+    shift += bit;
+  }
+
+  return prev;
+}
+
+// Shared driver over all words of a simple8b stream; decodeWord is a compile time constant in
+// each instantiation so it gets inlined into the ISA specific caller.
+static FORCE_INLINE int32_t tsDecodeSimple8bImpl(const char *ip, const int nelements, char *const output,
+                                                 const char type,
+                                                 int64_t (*decodeWord)(uint64_t, int32_t, int32_t, int64_t, int64_t *)) {
+  int64_t buf[240];
+  int     count = 0;
+  int64_t prev_value = 0;
+
+  while (count < nelements) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+    ip += LONG_BYTES;
+
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t elems = SIMPLE8B_ELEMS[selector];
+    int32_t nvalid = MIN(elems, nelements - count);
+
+    if (type == TSDB_DATA_TYPE_BIGINT && nvalid == elems) {
+      prev_value = (*decodeWord)(w, SIMPLE8B_BITS[selector], elems, prev_value, (int64_t *)output + count);
+      count += elems;
+      continue;
+    }
+
+    prev_value = (*decodeWord)(w, SIMPLE8B_BITS[selector], elems, prev_value, buf);
+    switch (type) {
+      case TSDB_DATA_TYPE_BIGINT:
+        memcpy((int64_t *)output + count, buf, nvalid * LONG_BYTES);
+        break;
+      case TSDB_DATA_TYPE_INT:
+        for (int32_t i = 0; i < nvalid; i++) *((int32_t *)output + count + i) = (int32_t)buf[i];
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        for (int32_t i = 0; i < nvalid; i++) *((int16_t *)output + count + i) = (int16_t)buf[i];
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        for (int32_t i = 0; i < nvalid; i++) *((int8_t *)output + count + i) = (int8_t)buf[i];
+        break;
+      default:
+        uError("Invalid decompress integer type:%d", type);
+        return -1;
+    }
+    count += nvalid;
+  }
+
+  return 0;
+}
+
+static int32_t tsDecodeSimple8bScalar(const char *ip, const int nelements, char *const output, const char type) {
+  return tsDecodeSimple8bImpl(ip, nelements, output, type, tsDecodeSimple8bWord);
+}
+
+// 2 bits per value: 1 is true, 2 is null, anything else is false.
+static FORCE_INLINE void tsDecodeBoolRange(const char *const input, int start, const int nelements, char *const output) {
+  int ele_per_byte = BITS_PER_BYTE / 2;
+
+  for (int i = start; i < nelements; i++) {
+    uint8_t ele = (input[i / ele_per_byte] >> (2 * (i % ele_per_byte))) & INT8MASK(2);
+    if (ele == 1) {
+      output[i] = 1;
+    } else if (ele == 2) {
+      output[i] = TSDB_DATA_BOOL_NULL;
+    } else {
+      output[i] = 0;
+    }
+  }
+}
+
+static void tsDecodeBoolScalar(const char *const input, const int nelements, char *const output) {
+  tsDecodeBoolRange(input, 0, nelements, output);
+}
+
+#ifdef TD_COMPRESS_SIMD
+// Inclusive prefix sum of the four lanes: [a, b, c, d] -> [a, a+b, a+b+c, a+b+c+d].
+static FORCE_INLINE TARGET_AVX2 __m256i tsPrefixSum4Avx2(__m256i x) {
+  __m256i zero = _mm256_setzero_si256();
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+  return x;
+}
+
+static FORCE_INLINE TARGET_AVX2 int64_t tsDecodeSimple8bWordAvx2(uint64_t w, int32_t bit, int32_t elems, int64_t prev,
+                                                                 int64_t *out) {
+  if (bit == 0 || elems < 8) {
+    return tsDecodeSimple8bWord(w, bit, elems, prev, out);
+  }
+
+  __m256i vw = _mm256_set1_epi64x((int64_t)w);
+  __m256i vmask = _mm256_set1_epi64x((int64_t)INT64MASK(bit));
+  __m256i vone = _mm256_set1_epi64x(1);
+  __m256i vzero = _mm256_setzero_si256();
+  __m256i vshift = _mm256_setr_epi64x(4, 4 + bit, 4 + 2 * bit, 4 + 3 * bit);
+  __m256i vstep = _mm256_set1_epi64x(4 * bit);
+  __m256i vprev = _mm256_set1_epi64x(prev);
+
+  int32_t i = 0;
+  for (; i + 4 <= elems; i += 4) {
+    __m256i zigzag = _mm256_and_si256(_mm256_srlv_epi64(vw, vshift), vmask);
+    __m256i diff = _mm256_xor_si256(_mm256_srli_epi64(zigzag, 1), _mm256_sub_epi64(vzero, _mm256_and_si256(zigzag, vone)));
+    __m256i value = _mm256_add_epi64(tsPrefixSum4Avx2(diff), vprev);
+    _mm256_storeu_si256((__m256i *)(out + i), value);
+    vprev = _mm256_permute4x64_epi64(value, _MM_SHUFFLE(3, 3, 3, 3));
+    vshift = _mm256_add_epi64(vshift, vstep);
+  }
+
+  prev = out[i - 1];
+  if (i < elems) {
+    prev = tsDecodeSimple8bWord(w >> (bit * i), bit, elems - i, prev, out + i);
+  }
+
+  return prev;
+}
+
+static TARGET_AVX2 int32_t tsDecodeSimple8bAvx2(const char *ip, const int nelements, char *const output,
+                                                const char type) {
+  return tsDecodeSimple8bImpl(ip, nelements, output, type, tsDecodeSimple8bWordAvx2);
+}
+
+// Each input byte carries 4 values: spread every byte over 4 output lanes, isolate the 2 bit field of
+// each lane and compare it against the "true" (01) and "null" (10) patterns.
+static TARGET_SSE42 void tsDecodeBoolSse42(const char *const input, const int nelements, char *const output) {
+  const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+  const __m128i field = _mm_set1_epi32((int32_t)0xC0300C03);
+  const __m128i trueBits = _mm_set1_epi32(0x40100401);
+  const __m128i nullBits = _mm_set1_epi32((int32_t)0x80200802);
+  const __m128i trueVal = _mm_set1_epi8(1);
+  const __m128i nullVal = _mm_set1_epi8(TSDB_DATA_BOOL_NULL);
+
+  int i = 0;
+  for (; i + 16 <= nelements; i += 16) {
+    int32_t packed;
+    memcpy(&packed, input + i / 4, sizeof(packed));
+    __m128i v = _mm_and_si128(_mm_shuffle_epi8(_mm_cvtsi32_si128(packed), spread), field);
+    __m128i r = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(v, trueBits), trueVal),
+                             _mm_and_si128(_mm_cmpeq_epi8(v, nullBits), nullVal));
+    _mm_storeu_si128((__m128i *)(output + i), r);
+  }
+
+  tsDecodeBoolRange(input, i, nelements, output);
+}
+
+static TARGET_AVX2 void tsDecodeBoolAvx2(const char *const input, const int nelements, char *const output) {
+  const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                          4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+  const __m256i field = _mm256_set1_epi32((int32_t)0xC0300C03);
+  const __m256i trueBits = _mm256_set1_epi32(0x40100401);
+  const __m256i nullBits = _mm256_set1_epi32((int32_t)0x80200802);
+  const __m256i trueVal = _mm256_set1_epi8(1);
+  const __m256i nullVal = _mm256_set1_epi8(TSDB_DATA_BOOL_NULL);
+
+  int i = 0;
+  for (; i + 32 <= nelements; i += 32) {
+    int64_t packed;
+    memcpy(&packed, input + i / 4, sizeof(packed));
+    __m256i v = _mm256_and_si256(_mm256_shuffle_epi8(_mm256_set1_epi64x(packed), spread), field);
+    __m256i r = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(v, trueBits), trueVal),
+                                _mm256_and_si256(_mm256_cmpeq_epi8(v, nullBits), nullVal));
+    _mm256_storeu_si256((__m256i *)(output + i), r);
+  }
+
+  tsDecodeBoolRange(input, i, nelements, output);
+}
+#endif
+
+static void tsSetDecodeKernels(int level) {
+  decodeSimdLevel = TSDB_SIMD_NONE;
+  decodeSimple8bFp = tsDecodeSimple8bScalar;
+  decodeBoolFp = tsDecodeBoolScalar;
+
+#ifdef TD_COMPRESS_SIMD
+  __builtin_cpu_init();
+  if (level >= TSDB_SIMD_SSE42 && __builtin_cpu_supports("sse4.2")) {
+    decodeSimdLevel = TSDB_SIMD_SSE42;
+    decodeBoolFp = tsDecodeBoolSse42;
+  }
+
+  if (level >= TSDB_SIMD_AVX2 && __builtin_cpu_supports("avx2")) {
+    decodeSimdLevel = TSDB_SIMD_AVX2;
+    decodeSimple8bFp = tsDecodeSimple8bAvx2;
+    decodeBoolFp = tsDecodeBoolAvx2;
+  }
+#endif
+}
+
+static void tsResolveDecodeKernels() { tsSetDecodeKernels(TSDB_SIMD_AVX2); }
+
+int tsGetDecompressSimdLevel() {
+  pthread_once(&decodeKernelsInit, tsResolveDecodeKernels);
+  return decodeSimdLevel;
+}
+
+int tsSetDecompressSimdLevel(int level) {
+  pthread_once(&decodeKernelsInit, tsResolveDecodeKernels);
+  tsSetDecodeKernels(level);
+  return decodeSimdLevel;
+}
+
 /*
  * Compress Integer (Simple8B).
  */
@@ -258,68 +501,11 @@ int tsDecompressINTImp(const char *const input, const int nelements, char *const
     return nelements * word_length;
   }
 
-  // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
-  // 12  13  14  15
-  char bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
-  int  selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
-
-  const char *ip = input + 1;
-  int         count = 0;
-  int         _pos = 0;
-  int64_t     prev_value = 0;
-
-  while (1) {
-    if (count == nelements) break;
-
-    uint64_t w = 0;
-    memcpy(&w, ip, LONG_BYTES);
-
-    char selector = (char)(w & INT64MASK(4));  // selector = 4
-    char bit = bit_per_integer[(int)selector];      // bit = 3
-    int  elems = selector_to_elems[(int)selector];
-
-    for (int i = 0; i < elems; i++) {
-      uint64_t zigzag_value;
-
-      if (selector == 0 || selector == 1) {
-        zigzag_value = 0;
-      } else {
-        zigzag_value = ((w >> (4 + bit * i)) & INT64MASK(bit));
-      }
-      int64_t diff = ZIGZAG_DECODE(int64_t, zigzag_value);
-      int64_t curr_value = diff + prev_value;
-      prev_value = curr_value;
-
-      switch (type) {
-        case TSDB_DATA_TYPE_BIGINT:
-          *((int64_t *)output + _pos) = (int64_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_INT:
-          *((int32_t *)output + _pos) = (int32_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_SMALLINT:
-          *((int16_t *)output + _pos) = (int16_t)curr_value;
-          _pos++;
-          break;
-        case TSDB_DATA_TYPE_TINYINT:
-          *((int8_t *)output + _pos) = (int8_t)curr_value;
-          _pos++;
-          break;
-        default:
-          perror("Wrong integer types.\n");
-          return -1;
-      }
-      count++;
-      if (count == nelements) break;
-    }
-    ip += LONG_BYTES;
-  }
+  pthread_once(&decodeKernelsInit, tsResolveDecodeKernels);
+  if ((*decodeSimple8bFp)(input + 1, nelements, output, type) < 0) return -1;
 
   return nelements * word_length;
 }
-
 /* ----------------------------------------------Bool Compression
  * ---------------------------------------------- */
 // TODO: You can also implement it using RLE method.
@@ -355,27 +541,11 @@ int tsCompressBoolImp(const char *const input, const int nelements, char *const
 }
 
 int tsDecompressBoolImp(const char *const input, const int nelements, char *const output) {
-  int ipos = -1, opos = 0;
-  int ele_per_byte = BITS_PER_BYTE / 2;
-
-  for (int i = 0; i < nelements; i++) {
-    if (i % ele_per_byte == 0) {
-      ipos++;
-    }
-
-    uint8_t ele = (input[ipos] >> (2 * (i % ele_per_byte))) & INT8MASK(2);
-    if (ele == 1) {
-      output[opos++] = 1;
-    } else if (ele == 2) {
-      output[opos++] = TSDB_DATA_BOOL_NULL;
-    } else {
-      output[opos++] = 0;
-    }
-  }
+  pthread_once(&decodeKernelsInit, tsResolveDecodeKernels);
+  (*decodeBoolFp)(input, nelements, output);
 
   return nelements;
 }
-
 /* Run Length Encoding(RLE) Method */
 int tsCompressBoolRLEImp(const char *const input, const int nelements, char *const output) {
   int _pos = 0;
@@ -563,6 +733,24 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
+static const uint64_t TS_NBYTES_MASK[16] = {
+    0x0000000000000000, 0x00000000000000FF, 0x000000000000FFFF, 0x0000000000FFFFFF,
+    0x00000000FFFFFFFF, 0x000000FFFFFFFFFF, 0x0000FFFFFFFFFFFF, 0x00FFFFFFFFFFFFFF,
+    0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF,
+    0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF};
+
+static FORCE_INLINE uint64_t tsReadTimestampBytes(const char *const input, int8_t nbytes) {
+  uint64_t dd = 0;
+  if (nbytes == 0) return dd;
+
+  if (is_bigendian()) {
+    memcpy(((char *)(&dd)) + LONG_BYTES - nbytes, input, nbytes);
+  } else {
+    memcpy(&dd, input, nbytes);
+  }
+  return dd;
+}
+
 int tsDecompressTimestampImp(const char *const input, const int nelements, char *const output) {
   assert(nelements >= 0);
   if (nelements == 0) return 0;
@@ -574,64 +762,49 @@ int tsDecompressTimestampImp(const char *const input, const int nelements, char
     int64_t *ostream = (int64_t *)output;
 
     int     ipos = 1, opos = 0;
-    int8_t  nbytes = 0;
+    int     npairs = (nelements + 1) / 2;
     int64_t prev_value = 0;
     int64_t prev_delta = 0;
-    int64_t delta_of_delta = 0;
-
-    while (1) {
-      uint8_t flags = input[ipos++];
-      // Decode dd1
-      uint64_t dd1 = 0;
-      nbytes = flags & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
-      } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd1)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd1, input + ipos, nbytes);
-        }
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd1);
-      }
-      ipos += nbytes;
-      if (opos == 0) {
-        prev_value = delta_of_delta;
-        prev_delta = 0;
-        ostream[opos++] = delta_of_delta;
-      } else {
-        prev_delta = delta_of_delta + prev_delta;
-        prev_value = prev_value + prev_delta;
-        ostream[opos++] = prev_value;
-      }
-      if (opos == nelements) return nelements * LONG_BYTES;
 
-      // Decode dd2
-      uint64_t dd2 = 0;
-      nbytes = (flags >> 4) & INT8MASK(4);
-      if (nbytes == 0) {
-        delta_of_delta = 0;
+    for (int k = 0; k < npairs; k++) {
+      uint8_t  flags = input[ipos++];
+      int8_t   nbytes1 = flags & INT8MASK(4);
+      int8_t   nbytes2 = (flags >> 4) & INT8MASK(4);
+      uint64_t dd1 = 0, dd2 = 0;
+
+      // Each pair starts with its own flags byte, so while 8 more pairs follow this one an 8 byte
+      // load cannot run past the end of the input: take one unaligned load per value and mask off
+      // the bytes belonging to the next value instead of a variable length copy.
+      if (k + 8 < npairs && !is_bigendian()) {
+        memcpy(&dd1, input + ipos, LONG_BYTES);
+        memcpy(&dd2, input + ipos + nbytes1, LONG_BYTES);
+        dd1 &= TS_NBYTES_MASK[(int)nbytes1];
+        dd2 &= TS_NBYTES_MASK[(int)nbytes2];
       } else {
-        if (is_bigendian()) {
-          memcpy(((char *)(&dd2)) + LONG_BYTES - nbytes, input + ipos, nbytes);
-        } else {
-          memcpy(&dd2, input + ipos, nbytes);
-        }
-        // zigzag_decoding
-        delta_of_delta = ZIGZAG_DECODE(int64_t, dd2);
+        dd1 = tsReadTimestampBytes(input + ipos, nbytes1);
+        dd2 = tsReadTimestampBytes(input + ipos + nbytes1, nbytes2);
       }
-      ipos += nbytes;
-      prev_delta = delta_of_delta + prev_delta;
-      prev_value = prev_value + prev_delta;
+      ipos += nbytes1 + nbytes2;
+
+      // zigzag_decoding, the first value is stored as is and starts the delta chain from zero
+      prev_delta += (int64_t)(ZIGZAG_DECODE(int64_t, dd1));
+      prev_value += prev_delta;
+      ostream[opos++] = prev_value;
+      if (k == 0) prev_delta = 0;
+      if (opos == nelements) break;
+
+      prev_delta += (int64_t)(ZIGZAG_DECODE(int64_t, dd2));
+      prev_value += prev_delta;
       ostream[opos++] = prev_value;
-      if (opos == nelements) return nelements * LONG_BYTES;
     }
 
+    return nelements * LONG_BYTES;
   } else {
     assert(0);
     return -1;
   }
 }
+
 /* --------------------------------------------Double Compression
  * ---------------------------------------------- */
 void encodeDoubleValue(uint64_t diff, uint8_t flag, char *const output, int *const pos) {
@@ -306,6 +306,13 @@ static void taosReadConfigOption(const char *option, char *value, char *value2,
 }
 
 void taosInitConfigOption(SGlobalCfg cfg) {
+  if (tsGlobalConfigNum >= TSDB_CFG_MAX_NUM) {
+    // the log is not initialized yet while the options are registered
+    printf("\nconfig option:%s can't be registered, more than %d options, raise TSDB_CFG_MAX_NUM\n", cfg.option,
+           TSDB_CFG_MAX_NUM);
+    exit(-1);
+  }
+
   tsGlobalConfig[tsGlobalConfigNum++] = cfg;
 }
 
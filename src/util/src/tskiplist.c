@@ -30,6 +30,8 @@ static SSkipListNode *tSkipListNewNode(uint8_t level);
 #define tSkipListFreeNode(n) tfree((n))
 static SSkipListNode *tSkipListPutImpl(SSkipList *pSkipList, void *pData, SSkipListNode **direction, bool isForward,
                                        bool hasDup);
+static SSkipListNode *tSkipListPutLockFree(SSkipList *pSkipList, void *pData);
+static SSkipListNode *tSkipListGetPrevNode(SSkipList *pSkipList, SSkipListNode *pNode);
 
 static FORCE_INLINE int     tSkipListWLock(SSkipList *pSkipList);
 static FORCE_INLINE int     tSkipListRLock(SSkipList *pSkipList);
@@ -51,6 +53,12 @@ SSkipList *tSkipListCreate(uint8_t maxLevel, uint8_t keyType, uint16_t keyLen, _
   pSkipList->flags = flags;
   pSkipList->keyFn = fn;
   pSkipList->seed = rand();
+  if (SL_IS_LOCK_FREE(pSkipList) && SL_DUP_MODE(pSkipList) == SL_ALLOW_DUP_KEY) {
+    uError("lock-free skiplist does not support duplicate keys");
+    tfree(pSkipList);
+    return NULL;
+  }
+
   if (comparFn == NULL) {
     pSkipList->comparFn = getKeyComparFunc(keyType);
   } else {
@@ -62,7 +70,7 @@ SSkipList *tSkipListCreate(uint8_t maxLevel, uint8_t keyType, uint16_t keyLen, _
     return NULL;
   }
 
-  if (SL_IS_THREAD_SAFE(pSkipList)) {
+  if (SL_IS_THREAD_SAFE(pSkipList) && !SL_IS_LOCK_FREE(pSkipList)) {
     pSkipList->lock = (pthread_rwlock_t *)calloc(1, sizeof(pthread_rwlock_t));
     if (pSkipList->lock == NULL) {
       tSkipListDestroy(pSkipList);
@@ -111,6 +119,10 @@ void tSkipListDestroy(SSkipList *pSkipList) {
 SSkipListNode *tSkipListPut(SSkipList *pSkipList, void *pData) {
   if (pSkipList == NULL || pData == NULL) return NULL;
 
+  if (SL_IS_LOCK_FREE(pSkipList)) {
+    return tSkipListPutLockFree(pSkipList, pData);
+  }
+
   SSkipListNode *backward[MAX_SKIP_LIST_LEVEL] = {0};
   SSkipListNode *pNode = NULL;
 
@@ -133,6 +145,13 @@ void tSkipListPutBatch(SSkipList *pSkipList, void **ppData, int ndata) {
   char *         pDataKey = NULL;
   int            compare = 0;
 
+  if (SL_IS_LOCK_FREE(pSkipList)) {
+    for (int idata = 0; idata < ndata; idata++) {
+      tSkipListPutLockFree(pSkipList, ppData[idata]);
+    }
+    return;
+  }
+
   tSkipListWLock(pSkipList);
 
   // backward to put the first data
@@ -195,6 +214,12 @@ void tSkipListPutBatch(SSkipList *pSkipList, void **ppData, int ndata) {
 uint32_t tSkipListRemove(SSkipList *pSkipList, SSkipListKey key) {
   uint32_t count = 0;
 
+  // the puts of a lock-free skiplist take no lock, and may be linking new nodes to the removed one
+  if (SL_IS_LOCK_FREE(pSkipList)) {
+    uError("skiplist:%p, nodes of a lock-free skiplist can't be removed", pSkipList);
+    return 0;
+  }
+
   tSkipListWLock(pSkipList);
 
   SSkipListNode *pNode = getPriorNode(pSkipList, key, TSDB_ORDER_ASC, NULL);
@@ -243,6 +268,11 @@ SArray *tSkipListGet(SSkipList *pSkipList, SSkipListKey key) {
 }
 
 void tSkipListRemoveNode(SSkipList *pSkipList, SSkipListNode *pNode) {
+  if (SL_IS_LOCK_FREE(pSkipList)) {
+    uError("skiplist:%p, nodes of a lock-free skiplist can't be removed", pSkipList);
+    return;
+  }
+
   tSkipListWLock(pSkipList);
   tSkipListRemoveNodeImpl(pSkipList, pNode);
   tSkipListCorrectLevel(pSkipList);
@@ -304,14 +334,14 @@ bool tSkipListIterNext(SSkipListIterator *iter) {
       return false;
     }
 
-    iter->cur = SL_NODE_GET_BACKWARD_POINTER(iter->cur, 0);
+    iter->cur = tSkipListGetPrevNode(pSkipList, iter->cur);
 
     // a new node is inserted into between iter->cur and iter->next, ignore it
     if (iter->cur != iter->next && (iter->next != NULL)) {
       iter->cur = iter->next;
     }
 
-    iter->next = SL_NODE_GET_BACKWARD_POINTER(iter->cur, 0);
+    iter->next = tSkipListGetPrevNode(pSkipList, iter->cur);
     iter->step++;
   }
 
@@ -415,7 +445,7 @@ static SSkipListIterator *doCreateSkipListIterator(SSkipList *pSkipList, int32_t
     iter->next = SL_NODE_GET_FORWARD_POINTER(iter->cur, 0);
   } else {
     iter->cur = pSkipList->pTail;
-    iter->next = SL_NODE_GET_BACKWARD_POINTER(iter->cur, 0);
+    iter->next = tSkipListGetPrevNode(pSkipList, iter->cur);
   }
 
   return iter;
@@ -602,6 +632,21 @@ static SSkipListNode *getPriorNode(SSkipList *pSkipList, const char *val, int32_
         }
       }
     }
+  } else if (SL_IS_LOCK_FREE(pSkipList)) {
+    // no reliable backward pointers, find the last node with key not larger than val instead
+    SSkipListNode *px = pSkipList->pHead;
+    for (int32_t i = pSkipList->maxLevel - 1; i >= 0; --i) {
+      SSkipListNode *p = atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER(px, i));
+      while (p != pSkipList->pTail && comparFn(SL_GET_NODE_KEY(pSkipList, p), val) <= 0) {
+        px = p;
+        p = atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER(px, i));
+      }
+    }
+
+    pNode = atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER(px, 0));
+    if (pCur != NULL && px != pSkipList->pHead) {
+      *pCur = px;
+    }
   } else {
     pNode = pSkipList->pTail;
     for (int32_t i = pSkipList->level - 1; i >= 0; --i) {
@@ -681,3 +726,148 @@ static SSkipListNode *tSkipListPutImpl(SSkipList *pSkipList, void *pData, SSkipL
 
   return pNode;
 }
+
+// Find the node with key pKey, and fill the last node with smaller key and the first node with
+// larger or equal key of each level
+static SSkipListNode *tSkipListFindLockFree(SSkipList *pSkipList, const char *pKey, SSkipListNode **preds,
+                                            SSkipListNode **succs) {
+  SSkipListNode *px = pSkipList->pHead;
+  SSkipListNode *p = NULL;
+
+  for (int32_t i = pSkipList->maxLevel - 1; i >= 0; --i) {
+    p = atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER(px, i));
+    while (p != pSkipList->pTail && pSkipList->comparFn(SL_GET_NODE_KEY(pSkipList, p), pKey) < 0) {
+      px = p;
+      p = atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER(px, i));
+    }
+
+    preds[i] = px;
+    succs[i] = p;
+  }
+
+  if (p != pSkipList->pTail && pSkipList->comparFn(SL_GET_NODE_KEY(pSkipList, p), pKey) == 0) {
+    return p;
+  }
+
+  return NULL;
+}
+
+static int32_t getSkipListRandLevelLockFree(SSkipList *pSkipList) {
+  const uint32_t factor = 4;
+
+  int32_t n = 1;
+#if defined(_TD_WINDOWS_64) || defined(_TD_WINDOWS_32)
+  while ((rand() % factor) == 0 && n < pSkipList->maxLevel) {
+#else
+  // the seed in SSkipList is shared by the producers, use a seed of each thread instead
+  static __thread unsigned int seed = 0;
+  if (seed == 0) {
+    seed = (unsigned int)taosGetSelfPthreadId() ^ (unsigned int)taosGetTimestampUs() ^ pSkipList->seed;
+  }
+
+  while ((rand_r(&seed) % factor) == 0 && n < pSkipList->maxLevel) {
+#endif
+    n++;
+  }
+
+  uint8_t level = atomic_load_8(&pSkipList->level);
+  if (n > level + 1) n = level + 1;
+
+  return n;
+}
+
+// Raise the backward hint of pNode to pPrev if pPrev is closer to pNode
+static void tSkipListRaisePrevHint(SSkipList *pSkipList, SSkipListNode *pNode, SSkipListNode *pPrev) {
+  while (true) {
+    SSkipListNode *pOld = atomic_load_ptr(&SL_NODE_GET_BACKWARD_POINTER(pNode, 0));
+    if (pOld != pSkipList->pHead &&
+        pSkipList->comparFn(SL_GET_NODE_KEY(pSkipList, pOld), SL_GET_NODE_KEY(pSkipList, pPrev)) >= 0) {
+      return;
+    }
+
+    if (atomic_val_compare_exchange_ptr(&SL_NODE_GET_BACKWARD_POINTER(pNode, 0), pOld, pPrev) == pOld) {
+      return;
+    }
+  }
+}
+
+static SSkipListNode *tSkipListPutLockFree(SSkipList *pSkipList, void *pData) {
+  SSkipListNode *preds[MAX_SKIP_LIST_LEVEL] = {0};
+  SSkipListNode *succs[MAX_SKIP_LIST_LEVEL] = {0};
+  SSkipListNode *pNode = NULL;
+  char *         pKey = pSkipList->keyFn(pData);
+
+  pNode = tSkipListNewNode(getSkipListRandLevelLockFree(pSkipList));
+  if (pNode == NULL) return NULL;
+  pNode->pData = pData;
+
+  // append a node of level 1 after the last node directly, which is the common case of time-series data
+  if (pNode->level == 1) {
+    SSkipListNode *pLast = atomic_load_ptr(&SL_NODE_GET_BACKWARD_POINTER(pSkipList->pTail, 0));
+    if (pLast == pSkipList->pHead || pSkipList->comparFn(SL_GET_NODE_KEY(pSkipList, pLast), pKey) < 0) {
+      SL_NODE_GET_FORWARD_POINTER(pNode, 0) = pSkipList->pTail;
+      SL_NODE_GET_BACKWARD_POINTER(pNode, 0) = pLast;
+      if (atomic_val_compare_exchange_ptr(&SL_NODE_GET_FORWARD_POINTER(pLast, 0), pSkipList->pTail, pNode) ==
+          pSkipList->pTail) {
+        tSkipListRaisePrevHint(pSkipList, pSkipList->pTail, pNode);
+        atomic_add_fetch_32(&pSkipList->size, 1);
+        return pNode;
+      }
+    }
+  }
+
+  // link level 0 first, the node is visible to readers once it succeeds
+  while (true) {
+    SSkipListNode *pDup = tSkipListFindLockFree(pSkipList, pKey, preds, succs);
+    if (pDup != NULL) {
+      tSkipListFreeNode(pNode);
+      if (SL_DUP_MODE(pSkipList) == SL_UPDATE_DUP_KEY) {
+        atomic_store_ptr(&(pDup->pData), pData);
+        return pDup;
+      }
+      return NULL;
+    }
+
+    for (int32_t i = 0; i < pNode->level; ++i) {
+      SL_NODE_GET_FORWARD_POINTER(pNode, i) = succs[i];
+    }
+    SL_NODE_GET_BACKWARD_POINTER(pNode, 0) = preds[0];
+
+    if (atomic_val_compare_exchange_ptr(&SL_NODE_GET_FORWARD_POINTER(preds[0], 0), succs[0], pNode) == succs[0]) {
+      break;
+    }
+  }
+
+  tSkipListRaisePrevHint(pSkipList, succs[0], pNode);
+
+  for (int32_t i = 1; i < pNode->level; ++i) {
+    while (atomic_val_compare_exchange_ptr(&SL_NODE_GET_FORWARD_POINTER(preds[i], i), succs[i], pNode) != succs[i]) {
+      tSkipListFindLockFree(pSkipList, pKey, preds, succs);
+      atomic_store_ptr(&SL_NODE_GET_FORWARD_POINTER(pNode, i), succs[i]);
+    }
+  }
+
+  while (true) {
+    uint8_t level = atomic_load_8(&pSkipList->level);
+    if (level >= pNode->level || atomic_val_compare_exchange_8(&pSkipList->level, level, pNode->level) == level) {
+      break;
+    }
+  }
+
+  atomic_add_fetch_32(&pSkipList->size, 1);
+  return pNode;
+}
+
+static SSkipListNode *tSkipListGetPrevNode(SSkipList *pSkipList, SSkipListNode *pNode) {
+  if (!SL_IS_LOCK_FREE(pSkipList) || pNode == pSkipList->pHead) {
+    return SL_NODE_GET_BACKWARD_POINTER(pNode, 0);
+  }
+
+  // the hint always points to a node with smaller key, and nodes are never removed
+  SSkipListNode *p = atomic_load_ptr(&SL_NODE_GET_BACKWARD_POINTER(pNode, 0));
+  while (true) {
+    SSkipListNode *next = atomic_load_ptr(&SL_NODE_GET_FORWARD_POINTER(p, 0));
+    if (next == pNode) return p;
+    p = next;
+  }
+}
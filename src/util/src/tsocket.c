@@ -13,6 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#define _GNU_SOURCE
 #include "os.h"
 #include "tulog.h"
 #include "tsocket.h"
@@ -502,38 +503,140 @@ void tinet_ntoa(char *ipstr, uint32_t ip) {
 }
 
 #define COPY_SIZE 32768
-// sendfile shall be used
+#define COPY_SPLICE_SIZE 65536  // the default capacity of a pipe
+#define RECV_BURST_US 100000
 
-int64_t taosCopyFds(SOCKET sfd, int32_t dfd, int64_t len) {
-  int64_t leftLen;
-  int64_t readLen, writeLen;
-  char    temp[COPY_SIZE];
+// MB per second all the copies from sync sockets of the process receive at most, 0 means no limit
+int32_t tsSyncRecvRate = 0;
 
-  leftLen = len;
+// Virtual clock of the receive budget shared by all the copies: a step of n bytes takes the slot of n bytes at the
+// capped rate from the clock, and waits until its slot starts. The idle time of the clock is given back as a burst
+// of at most RECV_BURST_US.
+static int64_t tsRecvClockUs = 0;
+
+void taosThrottleRecv(int64_t bytes) {
+  int32_t rate = tsSyncRecvRate;
+  if (rate <= 0 || bytes <= 0) return;
+
+  int64_t costUs = bytes * 1000000 / ((int64_t)rate * 1024 * 1024);
+  int64_t nowUs = taosGetTimestampUs();
+  int64_t startUs = 0;
+
+  while (1) {
+    int64_t clockUs = atomic_load_64(&tsRecvClockUs);
+    startUs = MAX(clockUs, nowUs - RECV_BURST_US);
+    if (atomic_val_compare_exchange_64(&tsRecvClockUs, clockUs, startUs + costUs) == clockUs) break;
+  }
+
+  if (startUs > nowUs) {
+    taosMsleep((int32_t)((startUs - nowUs + 999) / 1000));
+  }
+}
+
+static int64_t taosCopyFdsByBuffer(SOCKET sfd, int32_t dfd, int64_t len) {
+  char temp[COPY_SIZE];
+
+  int64_t readLen = len;
+  int64_t retLen = taosReadMsg(sfd, temp, (int32_t)readLen);
+  if (readLen != retLen) {
+    uError("read error, readLen:%" PRId64 " retLen:%" PRId64 ", reason:%s", readLen, retLen, strerror(errno));
+    return -1;
+  }
+
+  int64_t writeLen = taosWriteMsg(dfd, temp, (int32_t)readLen);
+  if (readLen != writeLen) {
+    uError("copy error, readLen:%" PRId64 " writeLen:%" PRId64 ", reason:%s", readLen, writeLen, strerror(errno));
+    return -1;
+  }
+
+  return len;
+}
+
+#ifdef _TD_LINUX
+// Move len bytes from the socket to the file through the pipe without copying them into the user space. If the
+// socket can not be spliced, nothing is read and errno is EINVAL. If the file can not be spliced, the bytes in the
+// pipe are written to it by a buffer.
+static int64_t taosCopyFdsBySplice(SOCKET sfd, int32_t dfd, int64_t len, int32_t pipefd[2]) {
+  int64_t leftLen = len;
 
   while (leftLen > 0) {
-    if (leftLen < COPY_SIZE)
-      readLen = leftLen;
-    else
-      readLen = COPY_SIZE;  // 4K
-
-    int64_t retLen = taosReadMsg(sfd, temp, (int32_t)readLen);
-    if (readLen != retLen) {
-      uError("read error, readLen:%" PRId64 " retLen:%" PRId64 " len:%" PRId64 " leftLen:%" PRId64 ", reason:%s",
-             readLen, retLen, len, leftLen, strerror(errno));
+    ssize_t inLen = splice(sfd, NULL, pipefd[1], NULL, (size_t)leftLen, SPLICE_F_MOVE | SPLICE_F_MORE);
+    if (inLen < 0) {
+      if (errno == EINTR || errno == EAGAIN) continue;
+      return -1;
+    } else if (inLen == 0) {
+      uError("splice error, peer is closed, len:%" PRId64 " leftLen:%" PRId64, len, leftLen);
+      errno = ECONNRESET;
       return -1;
     }
 
-    writeLen = taosWriteMsg(dfd, temp, (int32_t)readLen);
+    while (inLen > 0) {
+      ssize_t outLen = splice(pipefd[0], NULL, dfd, NULL, (size_t)inLen, SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (outLen < 0 && errno == EINTR) continue;
+      if (outLen < 0 && errno == EINVAL) {
+        char    temp[COPY_SIZE];
+        int64_t readLen = MIN(inLen, COPY_SIZE);
+        outLen = read(pipefd[0], temp, (size_t)readLen);
+        if (outLen > 0 && taosWriteMsg(dfd, temp, (int32_t)outLen) != outLen) outLen = -1;
+      }
+      if (outLen <= 0) {
+        uError("splice error, len:%" PRId64 " leftLen:%" PRId64 ", reason:%s", len, leftLen, strerror(errno));
+        return -1;
+      }
+
+      inLen -= outLen;
+      leftLen -= outLen;
+    }
+  }
+
+  return len;
+}
+#endif
 
-    if (readLen != writeLen) {
-      uError("copy error, readLen:%" PRId64 " writeLen:%" PRId64 " len:%" PRId64 " leftLen:%" PRId64 ", reason:%s",
-             readLen, writeLen, len, leftLen, strerror(errno));
-      return -1;
+// Copy len bytes from the socket to the current position of the file. Each step of the copy is kept within
+// tsSyncRecvRate, and fp is called with the bytes of the step after it is done.
+int64_t taosCopyFds(SOCKET sfd, int32_t dfd, int64_t len, FCopyFdsFp fp, void *param) {
+  int64_t leftLen = len;
+  int32_t pipefd[2] = {-1, -1};
+  bool    bySplice = false;
+
+#ifdef _TD_LINUX
+  bySplice = (pipe(pipefd) == 0);
+#endif
+
+  while (leftLen > 0) {
+    int64_t stepLen = MIN(leftLen, bySplice ? COPY_SPLICE_SIZE : COPY_SIZE);
+    int64_t retLen = -1;
+
+    taosThrottleRecv(stepLen);
+
+#ifdef _TD_LINUX
+    if (bySplice) {
+      retLen = taosCopyFdsBySplice(sfd, dfd, stepLen, pipefd);
+      if (retLen < 0 && errno == EINVAL) {
+        // the socket can not be spliced, and nothing is read from it
+        bySplice = false;
+        stepLen = MIN(leftLen, COPY_SIZE);
+      }
+    }
+#endif
+
+    if (!bySplice) {
+      retLen = taosCopyFdsByBuffer(sfd, dfd, stepLen);
     }
 
-    leftLen -= readLen;
+    if (retLen != stepLen) {
+      uError("failed to copy fds, len:%" PRId64 " leftLen:%" PRId64 ", reason:%s", len, leftLen, strerror(errno));
+      len = -1;
+      break;
+    }
+
+    leftLen -= stepLen;
+    if (fp != NULL) (*fp)(param, stepLen);
   }
 
+  if (pipefd[0] >= 0) close(pipefd[0]);
+  if (pipefd[1] >= 0) close(pipefd[1]);
+
   return len;
 }
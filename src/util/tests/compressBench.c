@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Decode throughput of the integer, timestamp and bool codecs for every SIMD level supported
+// by this CPU. Usage: compressBench [rows per block] [rounds]
+
+#include "os.h"
+#include "taosdef.h"
+#include "tscompression.h"
+
+typedef int (*FDecode)(const char *const input, const int nelements, char *const output);
+
+static int decodeBigint(const char *const input, const int nelements, char *const output) {
+  return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_BIGINT);
+}
+
+static int decodeInt(const char *const input, const int nelements, char *const output) {
+  return tsDecompressINTImp(input, nelements, output, TSDB_DATA_TYPE_INT);
+}
+
+static const char *simdName(int level) {
+  switch (level) {
+    case TSDB_SIMD_AVX2:  return "avx2";
+    case TSDB_SIMD_SSE42: return "sse4.2";
+    default:              return "scalar";
+  }
+}
+
+static void benchDecode(const char *codec, FDecode fp, const char *comp, int rows, int bytes, int rounds, int level) {
+  char *output = malloc(rows * LONG_BYTES);
+
+  int64_t st = taosGetTimestampUs();
+  for (int i = 0; i < rounds; ++i) {
+    fp(comp, rows, output);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  double gbps = (double)bytes * rounds / (el > 0 ? el : 1) / 1000.0;
+  printf("%-10s %-7s rows:%d rounds:%d elapsed:%" PRId64 "us throughput:%.3f GB/s\n", codec, simdName(level), rows,
+         rounds, el, gbps);
+  free(output);
+}
+
+int main(int argc, char *argv[]) {
+  int rows = (argc > 1) ? atoi(argv[1]) : 4096;
+  int rounds = (argc > 2) ? atoi(argv[2]) : 20000;
+
+  int64_t *ts = malloc(rows * sizeof(int64_t));
+  int64_t *i64 = malloc(rows * sizeof(int64_t));
+  int32_t *i32 = malloc(rows * sizeof(int32_t));
+  char    *b = malloc(rows);
+
+  srand(0);
+  int64_t start = 1609430400000L;
+  for (int i = 0; i < rows; ++i) {
+    ts[i] = start + i * 1000 + ((i % 64 == 0) ? rand() % 10 : 0);
+    i64[i] = (i == 0) ? 0 : i64[i - 1] + rand() % 17 - 8;
+    i32[i] = (i / 128) % 2 ? 42 : rand() % 1000;
+    b[i] = (rand() % 10 == 0) ? TSDB_DATA_BOOL_NULL : (rand() % 2);
+  }
+
+  char *cts = malloc(rows * LONG_BYTES + 16);
+  char *ci64 = malloc(rows * LONG_BYTES + 16);
+  char *ci32 = malloc(rows * LONG_BYTES + 16);
+  char *cb = malloc(rows + 16);
+
+  tsCompressTimestampImp((const char *)ts, rows, cts);
+  tsCompressINTImp((const char *)i64, rows, ci64, TSDB_DATA_TYPE_BIGINT);
+  tsCompressINTImp((const char *)i32, rows, ci32, TSDB_DATA_TYPE_INT);
+  tsCompressBoolImp(b, rows, cb);
+
+  int supported = tsGetDecompressSimdLevel();
+  for (int level = TSDB_SIMD_NONE; level <= supported; ++level) {
+    if (tsSetDecompressSimdLevel(level) != level) continue;
+
+    benchDecode("timestamp", tsDecompressTimestampImp, cts, rows, rows * LONG_BYTES, rounds, level);
+    benchDecode("bigint", decodeBigint, ci64, rows, rows * LONG_BYTES, rounds, level);
+    benchDecode("int", decodeInt, ci32, rows, rows * INT_BYTES, rounds, level);
+    benchDecode("bool", tsDecompressBoolImp, cb, rows, rows, rounds, level);
+  }
+
+  free(ts);
+  free(i64);
+  free(i32);
+  free(b);
+  free(cts);
+  free(ci64);
+  free(ci32);
+  free(cb);
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <time.h>
+#include <random>
+
+#include "taosdef.h"
+#include "tscompression.h"
+
+namespace {
+
+const int32_t ROWS = 4096 + 37;
+
+template <typename T>
+void int_round_trip(char type, int64_t range, int level) {
+  std::mt19937_64 rng(level * 131 + type);
+  std::vector<T>  input(ROWS), output(ROWS);
+  std::vector<char> buf(ROWS * sizeof(T) + 64);
+
+  int64_t v = 0;
+  for (int32_t i = 0; i < ROWS; ++i) {
+    // long constant runs exercise the zero width selectors
+    if ((i / 300) % 2 == 0) {
+      v += (int64_t)(rng() % (2 * range + 1)) - range;
+    }
+    input[i] = (T)v;
+    v = input[i];
+  }
+
+  int clen = tsCompressINTImp((const char *)input.data(), ROWS, buf.data(), type);
+  ASSERT_GT(clen, 0);
+  EXPECT_EQ(tsDecompressINTImp(buf.data(), ROWS, (char *)output.data(), type), (int)(ROWS * sizeof(T)));
+  EXPECT_EQ(memcmp(input.data(), output.data(), ROWS * sizeof(T)), 0);
+}
+
+void timestamp_round_trip(int level) {
+  std::mt19937_64      rng(level);
+  std::vector<int64_t> input(ROWS), output(ROWS);
+  std::vector<char>    buf(ROWS * sizeof(int64_t) + 64);
+
+  int64_t ts = 1609430400000L;
+  for (int32_t i = 0; i < ROWS; ++i) {
+    ts += (i % 500 < 250) ? 1000 : (int64_t)(rng() % 100000);
+    input[i] = ts;
+  }
+
+  for (int32_t n = 1; n <= ROWS; n += (n < 10) ? 1 : 997) {
+    int clen = tsCompressTimestampImp((const char *)input.data(), n, buf.data());
+    ASSERT_GT(clen, 0);
+    EXPECT_EQ(tsDecompressTimestampImp(buf.data(), n, (char *)output.data()), (int)(n * sizeof(int64_t)));
+    EXPECT_EQ(memcmp(input.data(), output.data(), n * sizeof(int64_t)), 0);
+  }
+}
+
+void bool_round_trip(int level) {
+  std::mt19937      rng(level);
+  std::vector<char> input(ROWS), output(ROWS), buf(ROWS);
+
+  for (int32_t i = 0; i < ROWS; ++i) {
+    int r = rng() % 3;
+    input[i] = (r == 2) ? TSDB_DATA_BOOL_NULL : (char)r;
+  }
+
+  for (int32_t n = 1; n <= ROWS; n += (n < 40) ? 1 : 1013) {
+    int clen = tsCompressBoolImp(input.data(), n, buf.data());
+    ASSERT_GT(clen, 0);
+    EXPECT_EQ(tsDecompressBoolImp(buf.data(), n, output.data()), n);
+    EXPECT_EQ(memcmp(input.data(), output.data(), n), 0);
+  }
+}
+
+}  // namespace
+
+TEST(compressTest, decode_kernels_round_trip) {
+  int supported = tsGetDecompressSimdLevel();
+
+  for (int level = TSDB_SIMD_NONE; level <= supported; ++level) {
+    EXPECT_EQ(tsSetDecompressSimdLevel(level), level);
+
+    int_round_trip<int8_t>(TSDB_DATA_TYPE_TINYINT, 3, level);
+    int_round_trip<int16_t>(TSDB_DATA_TYPE_SMALLINT, 200, level);
+    int_round_trip<int32_t>(TSDB_DATA_TYPE_INT, 70000, level);
+    int_round_trip<int64_t>(TSDB_DATA_TYPE_BIGINT, 1, level);
+    int_round_trip<int64_t>(TSDB_DATA_TYPE_BIGINT, 1L << 40, level);
+    timestamp_round_trip(level);
+    bool_round_trip(level);
+  }
+
+  tsSetDecompressSimdLevel(supported);
+}
+
+TEST(compressTest, decode_invalid_int_type) {
+  int supported = tsGetDecompressSimdLevel();
+
+  std::vector<int32_t> input(ROWS, 7), output(ROWS);
+  std::vector<char>    buf(ROWS * sizeof(int32_t) + 64);
+  ASSERT_GT(tsCompressINTImp((const char *)input.data(), ROWS, buf.data(), TSDB_DATA_TYPE_INT), 0);
+
+  // no kernel decodes a type without an integer width
+  for (int level = TSDB_SIMD_NONE; level <= supported; ++level) {
+    EXPECT_EQ(tsSetDecompressSimdLevel(level), level);
+    EXPECT_EQ(tsDecompressINTImp(buf.data(), ROWS, (char *)output.data(), TSDB_DATA_TYPE_FLOAT), -1);
+  }
+
+  tsSetDecompressSimdLevel(supported);
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Insert throughput of one skiplist shared by many producers, with the rwlock and with the lock-free mode,
+// while one reader keeps iterating it. Usage: skiplistBench [producers] [keys per producer]
+
+#include "os.h"
+#include "taosdef.h"
+#include "tskiplist.h"
+
+typedef struct {
+  SSkipList *pSkipList;
+  int64_t *  keys;
+  int        nkeys;
+} SProducer;
+
+static volatile int32_t stopReader = 0;
+
+static char *getInt64Key(const void *data) { return (char *)data; }
+
+static void *produce(void *param) {
+  SProducer *pProducer = (SProducer *)param;
+  for (int i = 0; i < pProducer->nkeys; ++i) {
+    tSkipListPut(pProducer->pSkipList, pProducer->keys + i);
+  }
+  return NULL;
+}
+
+static void *consume(void *param) {
+  SSkipList *pSkipList = (SSkipList *)param;
+  int64_t    scanned = 0;
+
+  while (!atomic_load_32(&stopReader)) {
+    SSkipListIterator *iter = tSkipListCreateIter(pSkipList);
+    while (tSkipListIterNext(iter)) scanned++;
+    tSkipListDestroyIter(iter);
+  }
+
+  return (void *)scanned;
+}
+
+static void benchPut(const char *mode, uint8_t flags, int nproducers, int nkeys) {
+  SSkipList *pSkipList =
+      tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), NULL, flags, getInt64Key);
+  SProducer *producers = calloc(nproducers, sizeof(SProducer));
+  pthread_t *threads = calloc(nproducers, sizeof(pthread_t));
+  pthread_t  reader;
+
+  // a hot table: producers write interleaved timestamps of the same time range
+  for (int i = 0; i < nproducers; ++i) {
+    producers[i].pSkipList = pSkipList;
+    producers[i].nkeys = nkeys;
+    producers[i].keys = malloc(sizeof(int64_t) * nkeys);
+    for (int j = 0; j < nkeys; ++j) {
+      producers[i].keys[j] = (int64_t)j * nproducers + i;
+    }
+  }
+
+  atomic_store_32(&stopReader, 0);
+  pthread_create(&reader, NULL, consume, pSkipList);
+
+  int64_t st = taosGetTimestampUs();
+  for (int i = 0; i < nproducers; ++i) {
+    pthread_create(threads + i, NULL, produce, producers + i);
+  }
+  for (int i = 0; i < nproducers; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+  int64_t el = taosGetTimestampUs() - st;
+
+  void *scanned = NULL;
+  atomic_store_32(&stopReader, 1);
+  pthread_join(reader, &scanned);
+
+  printf("%-9s producers:%d keys:%u elapsed:%" PRId64 "us throughput:%.3f Mputs/s scanned:%" PRId64 "\n", mode,
+         nproducers, SL_SIZE(pSkipList), el, (double)nproducers * nkeys / (el > 0 ? el : 1), (int64_t)scanned);
+
+  for (int i = 0; i < nproducers; ++i) {
+    free(producers[i].keys);
+  }
+  free(producers);
+  free(threads);
+  tSkipListDestroy(pSkipList);
+}
+
+int main(int argc, char *argv[]) {
+  int nproducers = (argc > 1) ? atoi(argv[1]) : 8;
+  int nkeys = (argc > 2) ? atoi(argv[2]) : 200000;
+
+  for (int n = 1; n <= nproducers; n *= 2) {
+    benchPut("rwlock", SL_DISCARD_DUP_KEY | SL_THREAD_SAFE, n, nkeys);
+    benchPut("lock-free", SL_DISCARD_DUP_KEY | SL_LOCK_FREE, n, nkeys);
+  }
+
+  return 0;
+}
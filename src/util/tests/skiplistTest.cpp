@@ -377,4 +377,137 @@ TEST(testCase, skiplist_test) {
       free(pKeys);*/
 }
 
-#endif
\ No newline at end of file
+#endif
+
+namespace {
+
+const int32_t lockFreeProducers = 4;
+const int32_t lockFreeKeys = 20000;
+
+char* getInt64Key(const void* data) { return (char*)(data); }
+
+typedef struct {
+  SSkipList* pSkipList;
+  int64_t*   keys;
+  int32_t    id;
+} SLockFreeProducer;
+
+void* lockFreeProduce(void* param) {
+  SLockFreeProducer* pProducer = (SLockFreeProducer*)param;
+
+  // producers insert interleaved keys, and every key is inserted twice
+  for (int32_t i = pProducer->id; i < lockFreeKeys; i += lockFreeProducers) {
+    tSkipListPut(pProducer->pSkipList, pProducer->keys + (lockFreeKeys - 1 - i));
+  }
+  for (int32_t i = pProducer->id; i < lockFreeKeys; i += lockFreeProducers) {
+    tSkipListPut(pProducer->pSkipList, pProducer->keys + i);
+  }
+
+  return NULL;
+}
+
+}  // namespace
+
+TEST(testCase, skiplist_lock_free_test) {
+  int64_t* keys = (int64_t*)malloc(sizeof(int64_t) * lockFreeKeys);
+  for (int32_t i = 0; i < lockFreeKeys; ++i) {
+    keys[i] = i;
+  }
+
+  SSkipList* pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), NULL,
+                                         SL_DISCARD_DUP_KEY | SL_LOCK_FREE, getInt64Key);
+  ASSERT_TRUE(pSkipList != NULL);
+
+  pthread_t         threads[lockFreeProducers];
+  SLockFreeProducer producers[lockFreeProducers];
+  for (int32_t i = 0; i < lockFreeProducers; ++i) {
+    producers[i].pSkipList = pSkipList;
+    producers[i].keys = keys;
+    producers[i].id = i;
+    pthread_create(&threads[i], NULL, lockFreeProduce, &producers[i]);
+  }
+
+  // iterate concurrently with the producers, keys must always be in order
+  for (int32_t round = 0; round < 20; ++round) {
+    SSkipListIterator* iter = tSkipListCreateIterFromVal(pSkipList, NULL, TSDB_DATA_TYPE_BIGINT,
+                                                         (round % 2) ? TSDB_ORDER_DESC : TSDB_ORDER_ASC);
+    int64_t prev = (round % 2) ? INT64_MAX : -1;
+    while (tSkipListIterNext(iter)) {
+      int64_t key = *(int64_t*)SL_GET_NODE_KEY(pSkipList, tSkipListIterGet(iter));
+      if (round % 2) {
+        ASSERT_LT(key, prev);
+      } else {
+        ASSERT_GT(key, prev);
+      }
+      prev = key;
+    }
+    tSkipListDestroyIter(iter);
+  }
+
+  for (int32_t i = 0; i < lockFreeProducers; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  ASSERT_EQ(SL_SIZE(pSkipList), (uint32_t)lockFreeKeys);
+
+  int32_t            count = 0;
+  SSkipListIterator* iter = tSkipListCreateIter(pSkipList);
+  while (tSkipListIterNext(iter)) {
+    ASSERT_EQ(*(int64_t*)SL_GET_NODE_KEY(pSkipList, tSkipListIterGet(iter)), count);
+    count++;
+  }
+  tSkipListDestroyIter(iter);
+  ASSERT_EQ(count, lockFreeKeys);
+
+  count = 0;
+  iter = tSkipListCreateIterFromVal(pSkipList, NULL, TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_DESC);
+  while (tSkipListIterNext(iter)) {
+    ASSERT_EQ(*(int64_t*)SL_GET_NODE_KEY(pSkipList, tSkipListIterGet(iter)), lockFreeKeys - 1 - count);
+    count++;
+  }
+  tSkipListDestroyIter(iter);
+  ASSERT_EQ(count, lockFreeKeys);
+
+  int64_t val = 100;
+  iter = tSkipListCreateIterFromVal(pSkipList, (const char*)&val, TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_ASC);
+  ASSERT_TRUE(tSkipListIterNext(iter));
+  ASSERT_EQ(*(int64_t*)SL_GET_NODE_KEY(pSkipList, tSkipListIterGet(iter)), 100);
+  tSkipListDestroyIter(iter);
+
+  iter = tSkipListCreateIterFromVal(pSkipList, (const char*)&val, TSDB_DATA_TYPE_BIGINT, TSDB_ORDER_DESC);
+  ASSERT_TRUE(tSkipListIterNext(iter));
+  ASSERT_EQ(*(int64_t*)SL_GET_NODE_KEY(pSkipList, tSkipListIterGet(iter)), 100);
+  ASSERT_TRUE(tSkipListIterNext(iter));
+  ASSERT_EQ(*(int64_t*)SL_GET_NODE_KEY(pSkipList, tSkipListIterGet(iter)), 99);
+  tSkipListDestroyIter(iter);
+
+  tSkipListDestroy(pSkipList);
+
+  // duplicate keys are not supported
+  pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), NULL,
+                              SL_ALLOW_DUP_KEY | SL_LOCK_FREE, getInt64Key);
+  ASSERT_TRUE(pSkipList == NULL);
+
+  // update the data of a duplicate key
+  int64_t dup = 5;
+  pSkipList = tSkipListCreate(MAX_SKIP_LIST_LEVEL, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), NULL,
+                              SL_UPDATE_DUP_KEY | SL_LOCK_FREE, getInt64Key);
+  tSkipListPut(pSkipList, keys + 5);
+  SSkipListNode* pNode = tSkipListPut(pSkipList, &dup);
+  ASSERT_TRUE(pNode != NULL);
+  ASSERT_EQ(SL_GET_NODE_DATA(pNode), (void*)&dup);
+  ASSERT_EQ(SL_SIZE(pSkipList), 1u);
+
+  // nodes are never removed, the puts may be linking new nodes to them
+  ASSERT_EQ(tSkipListRemove(pSkipList, (SSkipListKey)&dup), 0u);
+  tSkipListRemoveNode(pSkipList, pNode);
+  ASSERT_EQ(SL_SIZE(pSkipList), 1u);
+  iter = tSkipListCreateIter(pSkipList);
+  ASSERT_TRUE(tSkipListIterNext(iter));
+  ASSERT_EQ(SL_GET_NODE_DATA(tSkipListIterGet(iter)), (void*)&dup);
+  ASSERT_FALSE(tSkipListIterNext(iter));
+  tSkipListDestroyIter(iter);
+  tSkipListDestroy(pSkipList);
+
+  free(keys);
+}
@@ -0,0 +1,89 @@
+#include "os.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <iostream>
+
+#include "tsocket.h"
+
+namespace {
+const int64_t TEST_COPY_LEN = 1024 * 1024 + 333;
+
+typedef struct {
+  int     fd;
+  int64_t len;
+} SWriteParam;
+
+void *writeToSocket(void *param) {
+  SWriteParam *pParam = (SWriteParam *)param;
+  char         buf[4096];
+
+  for (int64_t off = 0; off < pParam->len;) {
+    int32_t n = (int32_t)std::min(pParam->len - off, (int64_t)sizeof(buf));
+    for (int32_t i = 0; i < n; i++) buf[i] = (char)((off + i) % 251);
+    if (taosWriteMsg(pParam->fd, buf, n) != n) break;
+    off += n;
+  }
+
+  return NULL;
+}
+
+void addProgress(void *param, int64_t bytes) { *(int64_t *)param += bytes; }
+
+// copy TEST_COPY_LEN bytes through a socket into a file, return the ms it takes
+int64_t copyAndCheck() {
+  int  sv[2];
+  char fname[] = "/tmp/socketTestXXXXXX";
+
+  EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+  int fd = mkstemp(fname);
+  EXPECT_GE(fd, 0);
+
+  SWriteParam param = {sv[1], TEST_COPY_LEN};
+  pthread_t   thread;
+  pthread_create(&thread, NULL, writeToSocket, &param);
+
+  int64_t progress = 0;
+  int64_t startMs = taosGetTimestampMs();
+  EXPECT_EQ(taosCopyFds(sv[0], fd, TEST_COPY_LEN, addProgress, &progress), TEST_COPY_LEN);
+  int64_t elapsed = taosGetTimestampMs() - startMs;
+  EXPECT_EQ(progress, TEST_COPY_LEN);
+
+  pthread_join(thread, NULL);
+
+  struct stat st;
+  EXPECT_EQ(fstat(fd, &st), 0);
+  EXPECT_EQ(st.st_size, TEST_COPY_LEN);
+
+  char *buf = (char *)malloc(TEST_COPY_LEN);
+  EXPECT_EQ(pread(fd, buf, TEST_COPY_LEN, 0), TEST_COPY_LEN);
+  for (int64_t i = 0; i < TEST_COPY_LEN; i++) {
+    if (buf[i] != (char)(i % 251)) {
+      ADD_FAILURE() << "wrong byte at " << i;
+      break;
+    }
+  }
+
+  free(buf);
+  close(fd);
+  remove(fname);
+  close(sv[0]);
+  close(sv[1]);
+
+  return elapsed;
+}
+}  // namespace
+
+TEST(testCase, copy_fds_test) {
+  tsSyncRecvRate = 0;
+  copyAndCheck();
+}
+
+TEST(testCase, copy_fds_rate_test) {
+  // 1MB at 4MB per second takes 250ms, of which at most 100ms is given as a burst
+  tsSyncRecvRate = 4;
+  int64_t elapsed = copyAndCheck();
+  tsSyncRecvRate = 0;
+
+  std::cout << "copy of " << TEST_COPY_LEN << " bytes at 4MB/s takes " << elapsed << " ms" << std::endl;
+  ASSERT_GE(elapsed, 140);
+}
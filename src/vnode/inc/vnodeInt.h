@@ -58,6 +58,7 @@ typedef struct {
   void *   wqueue;    // write queue
   void *   qqueue;    // read query queue
   void *   fqueue;    // read fetch/cancel queue
+  void *   hqueue;    // read queue of the heavy queries, NULL if the queries are not scheduled by cost
   void *   wal;
   void *   tsdb;
   int64_t  sync;
@@ -32,6 +32,7 @@ int32_t  vnodeWriteToCache(int32_t vgId, void *wparam, int32_t qtype, void *rpar
 int32_t  vnodeGetVersion(int32_t vgId, uint64_t *fver, uint64_t *wver);
 
 void     vnodeConfirmForward(void *pVnode, uint64_t version, int32_t code, bool force);
+void     vnodeFlushForwards(void *pVnode);
 
 #ifdef __cplusplus
 }
@@ -295,7 +295,9 @@ int32_t vnodeOpen(int32_t vgId) {
   pVnode->wqueue = dnodeAllocVWriteQueue(pVnode);
   pVnode->qqueue = dnodeAllocVQueryQueue(pVnode);
   pVnode->fqueue = dnodeAllocVFetchQueue(pVnode);
-  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->fqueue == NULL) {
+  pVnode->hqueue = dnodeAllocVHeavyQueue(pVnode);
+  if (pVnode->wqueue == NULL || pVnode->qqueue == NULL || pVnode->fqueue == NULL ||
+      (tsQueryHeavyCost > 0 && pVnode->hqueue == NULL)) {
     vnodeCleanUp(pVnode);
     return terrno;
   }
@@ -354,6 +356,8 @@ int32_t vnodeOpen(int32_t vgId) {
 
   sprintf(temp, "%s/wal", walRootDir);
   pVnode->walCfg.vgId = pVnode->vgId;
+  pVnode->walCfg.bufSize = tsWalGroupCommit * 1024;
+  pVnode->walCfg.restoreBufSize = tsWalRestoreReadAhead * 1024;
   pVnode->wal = walOpen(temp, &pVnode->walCfg);
   if (pVnode->wal == NULL) { 
     vnodeCleanUp(pVnode);
@@ -489,6 +493,11 @@ void vnodeDestroy(SVnodeObj *pVnode) {
     pVnode->fqueue = NULL;
   }
 
+  if (pVnode->hqueue) {
+    dnodeFreeVHeavyQueue(pVnode->hqueue);
+    pVnode->hqueue = NULL;
+  }
+
   tfree(pVnode->rootDir);
 
   if (pVnode->dropped) {
@@ -88,6 +88,16 @@ void vnodeFreeFromRQueue(void *vparam, SVReadMsg *pRead) {
   vnodeRelease(pVnode);
 }
 
+// Only the executions of the created queries are scheduled by cost, the query messages themselves create the
+// queries and stay in the vquery queue, and so the heavy query goes back to the vheavy queue after each result block
+static bool vnodeIsHeavyQuery(SVnodeObj *pVnode, SVReadMsg *pRead) {
+  if (pVnode->hqueue == NULL || pRead->qtype != TAOS_QTYPE_QUERY || pRead->qhandle == NULL) {
+    return false;
+  }
+
+  return qGetQueryCost(*(void **)pRead->qhandle) >= (int64_t)tsQueryHeavyCost * 1024 * 1024;
+}
+
 static SVReadMsg *vnodeBuildVReadMsg(SVnodeObj *pVnode, void *pCont, int32_t contLen, int8_t qtype, SRpcMsg *pRpcMsg) {
   int32_t size = sizeof(SVReadMsg) + contLen;
   SVReadMsg *pRead = taosAllocateQitem(size);
@@ -111,6 +121,7 @@ static SVReadMsg *vnodeBuildVReadMsg(SVnodeObj *pVnode, void *pCont, int32_t con
   }
 
   pRead->qtype = qtype;
+  pRead->qtime = taosGetTimestampUs();
   atomic_add_fetch_32(&pVnode->refCount, 1);
 
   return pRead;
@@ -141,6 +152,10 @@ int32_t vnodeWriteToRQueue(void *vparam, void *pCont, int32_t contLen, int8_t qt
     vTrace("vgId:%d, write into vfetch queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
     return taosWriteQitem(pVnode->fqueue, qtype, pRead);
+  } else if (vnodeIsHeavyQuery(pVnode, pRead)) {
+    vTrace("vgId:%d, write into vheavy queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
+           pVnode->queuedRMsg);
+    return taosWriteQitem(pVnode->hqueue, qtype, pRead);
   } else {
     vTrace("vgId:%d, write into vquery queue, refCount:%d queued:%d", pVnode->vgId, pVnode->refCount,
            pVnode->queuedRMsg);
@@ -334,6 +349,9 @@ static int32_t vnodeProcessFetchMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
   pRetrieve->free = htons(pRetrieve->free);
   pRetrieve->qId = htobe64(pRetrieve->qId);
 
+  // the retrieve msg of the old client does not carry the compColData field
+  bool compColData = (pRead->contLen >= (int32_t)sizeof(SRetrieveTableMsg) && pRetrieve->compColData != 0);
+
   vTrace("vgId:%d, qId:0x%" PRIx64 ", retrieve msg is disposed, free:%d, conn:%p", pVnode->vgId, pRetrieve->qId,
          pRetrieve->free, pRead->rpcHandle);
 
@@ -378,7 +396,7 @@ static int32_t vnodeProcessFetchMsg(SVnodeObj *pVnode, SVReadMsg *pRead) {
   bool freeHandle = true;
   bool buildRes = false;
 
-  code = qRetrieveQueryResultInfo(*handle, &buildRes, pRead->rpcHandle);
+  code = qRetrieveQueryResultInfo(*handle, &buildRes, pRead->rpcHandle, compColData);
   if (code != TSDB_CODE_SUCCESS) {
     // TODO handle malloc failure
     pRet->rsp = (SRetrieveTableRsp *)rpcMallocCont(sizeof(SRetrieveTableRsp));
@@ -51,15 +51,24 @@ typedef struct {
   int32_t  fsyncPeriod;
   int32_t  fsyncSeq;
   int8_t   stop;
-  int8_t   reserved[3];
+  int8_t   broken;  // the buffered records failed to be written and the file can't be truncated back
+  int8_t   reserved[2];
+  int32_t  bufSize;     // size of the group commit ring buffer
+  int32_t  bufHead;     // offset of the first record not written into file yet
+  int32_t  bufLen;      // bytes of the records in ring buffer
+  int32_t  bufRecords;  // number of the records in ring buffer
+  char *   buf;
+  int32_t  restoreBufSize;  // size of the read ahead buffer of restore, 0: records are read and applied by one thread
   char     path[WAL_PATH_LEN];
   char     name[WAL_FILE_LEN];
   pthread_mutex_t mutex;
+  pthread_mutex_t fmutex;  // serializes the group commits and the switch of the wal file
 } SWal;
 
 int32_t walGetNextFile(SWal *pWal, int64_t *nextFileId);
 int32_t walGetOldFile(SWal *pWal, int64_t curFileId, int32_t minDiff, int64_t *oldFileId);
 int32_t walGetNewFile(SWal *pWal, int64_t *newFileId);
+int32_t walFlush(SWal *pWal, bool sync);
 
 #ifdef __cplusplus
 }
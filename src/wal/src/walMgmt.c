@@ -77,7 +77,19 @@ void *walOpen(char *path, SWalCfg *pCfg) {
   pWal->fsyncPeriod = pCfg->fsyncPeriod;
   tstrncpy(pWal->path, path, sizeof(pWal->path));
   pthread_mutex_init(&pWal->mutex, NULL);
+  pthread_mutex_init(&pWal->fmutex, NULL);
+
+  if (pCfg->bufSize > 0) {
+    pWal->buf = tmalloc(pCfg->bufSize);
+    if (pWal->buf == NULL) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      walFreeObj(pWal);
+      return NULL;
+    }
+    pWal->bufSize = pCfg->bufSize;
+  }
 
+  pWal->restoreBufSize = pCfg->restoreBufSize;
   pWal->fsyncSeq = pCfg->fsyncPeriod / 1000;
   if (pWal->fsyncSeq <= 0) pWal->fsyncSeq = 1;
 
@@ -92,7 +104,8 @@ void *walOpen(char *path, SWalCfg *pCfg) {
     return NULL;
   }
 
-  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d", pWal->vgId, pWal, pWal->level, pWal->fsyncPeriod);
+  wDebug("vgId:%d, wal:%p is opened, level:%d fsyncPeriod:%d bufSize:%d", pWal->vgId, pWal, pWal->level,
+         pWal->fsyncPeriod, pWal->bufSize);
 
   return pWal;
 }
@@ -132,9 +145,12 @@ void walClose(void *handle) {
   if (handle == NULL) return;
 
   SWal *pWal = handle;
+  pthread_mutex_lock(&pWal->fmutex);
+  walFlush(pWal, false);
   pthread_mutex_lock(&pWal->mutex);
   tfClose(pWal->tfd);
   pthread_mutex_unlock(&pWal->mutex);
+  pthread_mutex_unlock(&pWal->fmutex);
   taosRemoveRef(tsWal.refId, pWal->rid);
 }
 
@@ -154,6 +170,8 @@ static void walFreeObj(void *wal) {
 
   tfClose(pWal->tfd);
   pthread_mutex_destroy(&pWal->mutex);
+  pthread_mutex_destroy(&pWal->fmutex);
+  tfree(pWal->buf);
   tfree(pWal);
 }
 
@@ -179,7 +197,12 @@ static void walUpdateSeq() {
 static void walFsyncAll() {
   SWal *pWal = taosIterateRef(tsWal.refId, 0);
   while (pWal) {
-    if (walNeedFsync(pWal)) {
+    if (pWal->bufSize > 0) {
+      // the records left in ring buffer by the writers not calling walFsync are committed here
+      pthread_mutex_lock(&pWal->fmutex);
+      walFlush(pWal, walNeedFsync(pWal));
+      pthread_mutex_unlock(&pWal->fmutex);
+    } else if (walNeedFsync(pWal)) {
       wTrace("vgId:%d, do fsync, level:%d seq:%d rseq:%d", pWal->vgId, pWal->level, pWal->fsyncSeq, tsWal.seq);
       int32_t code = tfFsync(pWal->tfd);
       if (code != 0) {
@@ -22,7 +22,44 @@
 #include "twal.h"
 #include "walInt.h"
 
-static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, char *name, int64_t fileId);
+#define WAL_READ_AHEAD_ALIGN(len) (((len) + 7) & ~7)
+
+typedef void (*FWalRecord)(void *param, SWalHead *pHead);
+
+typedef struct {
+  SWal *     pWal;
+  void *     pVnode;
+  FWalWrite *writeFp;
+  int64_t    records;  // records applied
+  int64_t    bytes;    // bytes of the records applied
+} SWalRestore;
+
+// The records read and validated by the reader thread wait in the ring buffer to be applied in order. A record is
+// kept contiguous, the reader wraps around early if the space left at the end is too small.
+typedef struct {
+  SWal *          pWal;
+  char *          name;
+  int64_t         fileId;
+  int32_t         code;          // result of the reader
+  int8_t          done;          // the reader reached the end of the file
+  int32_t         size;
+  int32_t         rpos;          // offset of the first record not applied yet
+  int32_t         wpos;          // offset where the next record is put
+  int32_t         wrapPos;       // end of the records before the reader wrapped around, -1 if not wrapped
+  int32_t         numOfRecords;  // records in the buffer, including the one being applied
+  int32_t         bytes;         // bytes of the records in the buffer
+  int8_t          readerWaiting;
+  int8_t          applierWaiting;
+  char *          buf;
+  pthread_mutex_t mutex;
+  pthread_cond_t  notEmpty;
+  pthread_cond_t  notFull;
+} SWalReadAhead;
+
+static int32_t walRestoreWalFile(SWalRestore *pRestore, char *name, int64_t fileId);
+static int32_t walReadWalFile(SWal *pWal, char *name, int64_t fileId, FWalRecord fp, void *param);
+
+static SWalStat tsWalStat = {0};
 
 int32_t walRenew(void *handle) {
   if (handle == NULL) return 0;
@@ -35,6 +72,8 @@ int32_t walRenew(void *handle) {
     return 0;
   }
 
+  pthread_mutex_lock(&pWal->fmutex);
+  walFlush(pWal, false);
   pthread_mutex_lock(&pWal->mutex);
 
   if (tfValid(pWal->tfd)) {
@@ -60,6 +99,7 @@ int32_t walRenew(void *handle) {
   }
 
   pthread_mutex_unlock(&pWal->mutex);
+  pthread_mutex_unlock(&pWal->fmutex);
 
   return code;
 }
@@ -94,8 +134,10 @@ void walRemoveAllOldFiles(void *handle) {
   SWal *  pWal = handle;
   int64_t fileId = -1;
 
+  pthread_mutex_lock(&pWal->fmutex);
+  walFlush(pWal, false);
   pthread_mutex_lock(&pWal->mutex);
-  
+
   tfClose(pWal->tfd);
   wDebug("vgId:%d, file:%s, it is closed before remove all wals", pWal->vgId, pWal->name);
 
@@ -109,6 +151,7 @@ void walRemoveAllOldFiles(void *handle) {
     }
   }
   pthread_mutex_unlock(&pWal->mutex);
+  pthread_mutex_unlock(&pWal->fmutex);
 }
 
 #if defined(WAL_CHECKSUM_WHOLE)
@@ -133,6 +176,155 @@ static int walValidateChecksum(SWalHead *pHead) {
 
 #endif
 
+static void walAddToHist(int64_t *hist, int64_t val, int64_t bound, int32_t step) {
+  int32_t i = 0;
+  while (i < WAL_HIST_BUCKETS - 1 && val > bound) {
+    bound *= step;
+    i++;
+  }
+
+  atomic_add_fetch_64(&hist[i], 1);
+}
+
+// write the records in ring buffer into file by one vectored write, the caller shall hold fmutex. The mutex is
+// released during the write and sync, so the records can be appended into ring buffer by writers at the same time.
+// If the write fails, the records are kept in ring buffer and the partially written bytes are truncated, so the
+// write can be retried. If the file can't be truncated, the wal is marked broken and the later writes fail
+int32_t walFlush(SWal *pWal, bool sync) {
+  int32_t code = 0;
+  int64_t start = taosGetTimestampUs();
+
+  pthread_mutex_lock(&pWal->mutex);
+  int32_t head = pWal->bufHead;
+  int32_t len = pWal->bufLen;
+  int32_t records = pWal->bufRecords;
+  pWal->bufRecords = 0;
+  pthread_mutex_unlock(&pWal->mutex);
+
+  if (len > 0) {
+    // the records may wrap around the end of ring buffer
+    struct iovec iov[2];
+    int32_t      iovcnt = 1;
+
+    iov[0].iov_base = pWal->buf + head;
+    iov[0].iov_len = MIN(len, pWal->bufSize - head);
+    if (iov[0].iov_len < len) {
+      iov[1].iov_base = pWal->buf;
+      iov[1].iov_len = len - iov[0].iov_len;
+      iovcnt = 2;
+    }
+
+    int64_t offset = tfLseek(pWal->tfd, 0, SEEK_END);
+    if (offset < 0 || tfWritev(pWal->tfd, iov, iovcnt) != len) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, file:%s, failed to write %d records since %s", pWal->vgId, pWal->name, records,
+             strerror(errno));
+
+      if (offset < 0 || tfFtruncate(pWal->tfd, offset) < 0) {
+        wError("vgId:%d, file:%s, failed to truncate to %" PRId64 " since %s, wal is broken", pWal->vgId, pWal->name,
+               offset, strerror(errno));
+        pWal->broken = 1;
+      }
+    }
+
+    pthread_mutex_lock(&pWal->mutex);
+    if (code == 0) {
+      pWal->bufHead = (head + len) % pWal->bufSize;
+      pWal->bufLen -= len;
+    } else {
+      pWal->bufRecords += records;
+    }
+    pthread_mutex_unlock(&pWal->mutex);
+
+    if (code != 0) return code;
+  }
+
+  if (code == 0 && sync && tfFdatasync(pWal->tfd) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%s, fdatasync failed since %s", pWal->vgId, pWal->name, strerror(errno));
+  }
+
+  if (len > 0) {
+    int64_t elapsed = taosGetTimestampUs() - start;
+    wTrace("vgId:%d, fileId:%" PRId64 ", group commit %d records len:%d sync:%d cost:%" PRId64 "us", pWal->vgId,
+           pWal->fileId, records, len, sync, elapsed);
+
+    atomic_add_fetch_64(&tsWalStat.flushes, 1);
+    atomic_add_fetch_64(&tsWalStat.records, records);
+    atomic_add_fetch_64(&tsWalStat.bytes, len);
+    walAddToHist(tsWalStat.batchHist, records, 1, 4);
+    walAddToHist(tsWalStat.latencyHist, elapsed, 100, 10);
+  }
+
+  return code;
+}
+
+static int32_t walWriteToFile(SWal *pWal, SWalHead *pHead, int32_t contLen) {
+  int32_t code = 0;
+
+  if (tfWrite(pWal->tfd, pHead, contLen) != contLen) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%s, failed to write since %s", pWal->vgId, pWal->name, strerror(errno));
+  } else {
+    wTrace("vgId:%d, write wal, fileId:%" PRId64 " tfd:%" PRId64 " hver:%" PRId64 " wver:%" PRIu64 " len:%d", pWal->vgId,
+           pWal->fileId, pWal->tfd, pHead->version, pWal->version, pHead->len);
+    pWal->version = pHead->version;
+  }
+
+  return code;
+}
+
+static int32_t walWriteToBuf(SWal *pWal, SWalHead *pHead, int32_t contLen) {
+  int32_t code = 0;
+
+  if (contLen > pWal->bufSize) {
+    // too large for ring buffer, the buffered records are written first to keep the order in file
+    pthread_mutex_lock(&pWal->fmutex);
+    while (1) {
+      code = walFlush(pWal, false);
+      if (code != 0) break;
+
+      pthread_mutex_lock(&pWal->mutex);
+      if (pWal->bufLen == 0) {
+        code = walWriteToFile(pWal, pHead, contLen);
+        pthread_mutex_unlock(&pWal->mutex);
+        break;
+      }
+      pthread_mutex_unlock(&pWal->mutex);
+    }
+    pthread_mutex_unlock(&pWal->fmutex);
+    return code;
+  }
+
+  pthread_mutex_lock(&pWal->mutex);
+
+  while (pWal->bufSize - pWal->bufLen < contLen) {
+    // ring buffer is full, commit the buffered records
+    pthread_mutex_unlock(&pWal->mutex);
+    pthread_mutex_lock(&pWal->fmutex);
+    code = walFlush(pWal, false);
+    pthread_mutex_unlock(&pWal->fmutex);
+    if (code != 0) return code;
+    pthread_mutex_lock(&pWal->mutex);
+  }
+
+  int32_t tail = (pWal->bufHead + pWal->bufLen) % pWal->bufSize;
+  int32_t len = MIN(contLen, pWal->bufSize - tail);
+  memcpy(pWal->buf + tail, pHead, len);
+  if (len < contLen) memcpy(pWal->buf, (char *)pHead + len, contLen - len);
+
+  pWal->bufLen += contLen;
+  pWal->bufRecords++;
+  pWal->version = pHead->version;
+
+  wTrace("vgId:%d, buffer wal, fileId:%" PRId64 " hver:%" PRId64 " len:%d buffered:%d", pWal->vgId, pWal->fileId,
+         pHead->version, pHead->len, pWal->bufLen);
+
+  pthread_mutex_unlock(&pWal->mutex);
+
+  return code;
+}
+
 int32_t walWrite(void *handle, SWalHead *pHead) {
   if (handle == NULL) return -1;
 
@@ -143,6 +335,7 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
   if (!tfValid(pWal->tfd)) return 0;
   if (pWal->level == TAOS_WAL_NOLOG) return 0;
   if (pHead->version <= pWal->version) return 0;
+  if (pWal->broken) return TSDB_CODE_WAL_FILE_CORRUPTED;
 
   pHead->signature = WAL_SIGNATURE;
 #if defined(WAL_CHECKSUM_WHOLE)
@@ -154,17 +347,13 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
 
   int32_t contLen = pHead->len + sizeof(SWalHead);
 
-  pthread_mutex_lock(&pWal->mutex);
-
-  if (tfWrite(pWal->tfd, pHead, contLen) != contLen) {
-    code = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%s, failed to write since %s", pWal->vgId, pWal->name, strerror(errno));
-  } else {
-    wTrace("vgId:%d, write wal, fileId:%" PRId64 " tfd:%" PRId64 " hver:%" PRId64 " wver:%" PRIu64 " len:%d", pWal->vgId,
-           pWal->fileId, pWal->tfd, pHead->version, pWal->version, pHead->len);
-    pWal->version = pHead->version;
+  // group commit, the record is written into file by walFsync with the others of the same batch
+  if (pWal->bufSize > 0) {
+    return walWriteToBuf(pWal, pHead, contLen);
   }
 
+  pthread_mutex_lock(&pWal->mutex);
+  code = walWriteToFile(pWal, pHead, contLen);
   pthread_mutex_unlock(&pWal->mutex);
 
   ASSERT(contLen == pHead->len + sizeof(SWalHead));
@@ -172,16 +361,29 @@ int32_t walWrite(void *handle, SWalHead *pHead) {
   return code;
 }
 
-void walFsync(void *handle, bool forceFsync) {
+int32_t walFsync(void *handle, bool forceFsync) {
   SWal *pWal = handle;
-  if (pWal == NULL || !tfValid(pWal->tfd)) return;
+  if (pWal == NULL || !tfValid(pWal->tfd)) return 0;
 
-  if (forceFsync || (pWal->level == TAOS_WAL_FSYNC && pWal->fsyncPeriod == 0)) {
+  int32_t code = 0;
+  bool    sync = forceFsync || (pWal->level == TAOS_WAL_FSYNC && pWal->fsyncPeriod == 0);
+
+  if (pWal->bufSize > 0) {
+    pthread_mutex_lock(&pWal->fmutex);
+    code = walFlush(pWal, sync);
+    pthread_mutex_unlock(&pWal->fmutex);
+    return code;
+  }
+
+  if (sync) {
     wTrace("vgId:%d, fileId:%" PRId64 ", do fsync", pWal->vgId, pWal->fileId);
     if (tfFsync(pWal->tfd) < 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
       wError("vgId:%d, fileId:%" PRId64 ", fsync failed since %s", pWal->vgId, pWal->fileId, strerror(errno));
     }
   }
+
+  return code;
 }
 
 int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
@@ -199,13 +401,19 @@ int32_t walRestore(void *handle, void *pVnode, FWalWrite writeFp) {
     snprintf(walName, sizeof(pWal->name), "%s/%s%" PRId64, pWal->path, WAL_PREFIX, fileId);
 
     wInfo("vgId:%d, file:%s, will be restored", pWal->vgId, walName);
-    code = walRestoreWalFile(pWal, pVnode, writeFp, walName, fileId);
+    SWalRestore restore = {.pWal = pWal, .pVnode = pVnode, .writeFp = writeFp};
+    int64_t     st = taosGetTimestampUs();
+    code = walRestoreWalFile(&restore, walName, fileId);
     if (code != TSDB_CODE_SUCCESS) {
       wError("vgId:%d, file:%s, failed to restore since %s", pWal->vgId, walName, tstrerror(code));
       continue;
     }
 
-    wInfo("vgId:%d, file:%s, restore success, wver:%" PRIu64, pWal->vgId, walName, pWal->version);
+    int64_t elapsed = taosGetTimestampUs() - st;
+    wInfo("vgId:%d, file:%s, restore success, wver:%" PRIu64 " records:%" PRId64 " bytes:%" PRId64
+          " elapsed:%" PRId64 "us throughput:%.2fMB/s",
+          pWal->vgId, walName, pWal->version, restore.records, restore.bytes, elapsed,
+          (double)restore.bytes / MAX(elapsed, 1));
 
     count++;
   }
@@ -236,6 +444,9 @@ int32_t walGetWalFile(void *handle, char *fileName, int64_t *fileId) {
 
   if (*fileId == 0) *fileId = -1;
 
+  // the buffered records shall be in file before it is retrieved
+  pthread_mutex_lock(&(pWal->fmutex));
+  walFlush(pWal, false);
   pthread_mutex_lock(&(pWal->mutex));
 
   int32_t code = walGetNextFile(pWal, fileId);
@@ -246,6 +457,7 @@ int32_t walGetWalFile(void *handle, char *fileName, int64_t *fileId) {
 
   wDebug("vgId:%d, get wal file, code:%d curId:%" PRId64 " outId:%" PRId64, pWal->vgId, code, pWal->fileId, *fileId);
   pthread_mutex_unlock(&(pWal->mutex));
+  pthread_mutex_unlock(&(pWal->fmutex));
 
   return code;
 }
@@ -308,7 +520,149 @@ static int32_t walSkipCorruptedRecord(SWal *pWal, SWalHead *pHead, int64_t tfd,
 }
 
 
-static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, char *name, int64_t fileId) {
+static void walApplyRecord(void *param, SWalHead *pHead) {
+  SWalRestore *pRestore = param;
+
+  pRestore->pWal->version = pHead->version;
+  pRestore->records++;
+  pRestore->bytes += sizeof(SWalHead) + pHead->len;
+
+  (*pRestore->writeFp)(pRestore->pVnode, pHead, TAOS_QTYPE_WAL, NULL);
+}
+
+// Reserve the space of a record, return the offset or -1 if the buffer has no room now
+static int32_t walReadAheadReserve(SWalReadAhead *pRa, int32_t len) {
+  int32_t pos = -1;
+
+  if (pRa->numOfRecords == 0) {
+    pRa->rpos = 0;
+    pRa->wrapPos = -1;
+    pos = 0;
+  } else if (pRa->wpos > pRa->rpos) {
+    if (pRa->size - pRa->wpos >= len) {
+      pos = pRa->wpos;
+    } else if (pRa->rpos >= len) {
+      pRa->wrapPos = pRa->wpos;
+      pos = 0;
+    }
+  } else if (pRa->wpos < pRa->rpos) {
+    if (pRa->rpos - pRa->wpos >= len) pos = pRa->wpos;
+  }
+
+  if (pos >= 0) pRa->wpos = pos + len;
+  return pos;
+}
+
+static void walReadAheadPut(void *param, SWalHead *pHead) {
+  SWalReadAhead *pRa = param;
+  int32_t        len = WAL_READ_AHEAD_ALIGN((int32_t)sizeof(SWalHead) + pHead->len);
+  int32_t        pos = -1;
+
+  pthread_mutex_lock(&pRa->mutex);
+  while ((pos = walReadAheadReserve(pRa, len)) < 0) {
+    if (pRa->applierWaiting) pthread_cond_signal(&pRa->notEmpty);
+    pRa->readerWaiting = 1;
+    pthread_cond_wait(&pRa->notFull, &pRa->mutex);
+    pRa->readerWaiting = 0;
+  }
+
+  memcpy(pRa->buf + pos, pHead, sizeof(SWalHead) + pHead->len);
+  pRa->numOfRecords++;
+  pRa->bytes += len;
+
+  // wake up the applier in batches, the reader and the applier are not switched for each record
+  if (pRa->applierWaiting && pRa->bytes >= pRa->size / 4) pthread_cond_signal(&pRa->notEmpty);
+  pthread_mutex_unlock(&pRa->mutex);
+}
+
+static void *walReadAheadFunc(void *param) {
+  SWalReadAhead *pRa = param;
+  setThreadName("walRestore");
+
+  int32_t code = walReadWalFile(pRa->pWal, pRa->name, pRa->fileId, walReadAheadPut, pRa);
+
+  pthread_mutex_lock(&pRa->mutex);
+  pRa->code = code;
+  pRa->done = 1;
+  pthread_cond_signal(&pRa->notEmpty);
+  pthread_mutex_unlock(&pRa->mutex);
+
+  return NULL;
+}
+
+// The reader thread reads and validates the records, while this thread applies them in the order of the file
+static int32_t walRestoreWalFileByReadAhead(SWalRestore *pRestore, char *name, int64_t fileId) {
+  SWal *        pWal = pRestore->pWal;
+  SWalReadAhead ra = {.pWal = pWal, .name = name, .fileId = fileId, .wrapPos = -1};
+
+  ra.size = WAL_READ_AHEAD_ALIGN(MAX(pWal->restoreBufSize, (int32_t)WAL_MAX_SIZE));
+  ra.buf = tmalloc(ra.size);
+  if (ra.buf == NULL) {
+    wError("vgId:%d, file:%s, failed to alloc read ahead buffer, restore it without read ahead", pWal->vgId, name);
+    return walReadWalFile(pWal, name, fileId, walApplyRecord, pRestore);
+  }
+
+  pthread_mutex_init(&ra.mutex, NULL);
+  pthread_cond_init(&ra.notEmpty, NULL);
+  pthread_cond_init(&ra.notFull, NULL);
+
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, walReadAheadFunc, &ra) != 0) {
+    wError("vgId:%d, file:%s, failed to create read ahead thread since %s, restore it without read ahead", pWal->vgId,
+           name, strerror(errno));
+    ra.code = walReadWalFile(pWal, name, fileId, walApplyRecord, pRestore);
+  } else {
+    while (1) {
+      pthread_mutex_lock(&ra.mutex);
+      while (ra.numOfRecords == 0 && !ra.done) {
+        ra.applierWaiting = 1;
+        pthread_cond_wait(&ra.notEmpty, &ra.mutex);
+        ra.applierWaiting = 0;
+      }
+
+      if (ra.numOfRecords == 0) {
+        pthread_mutex_unlock(&ra.mutex);
+        break;
+      }
+
+      SWalHead *pHead = (SWalHead *)(ra.buf + ra.rpos);
+      int32_t   len = WAL_READ_AHEAD_ALIGN((int32_t)sizeof(SWalHead) + pHead->len);
+      pthread_mutex_unlock(&ra.mutex);
+
+      walApplyRecord(pRestore, pHead);
+
+      pthread_mutex_lock(&ra.mutex);
+      ra.rpos += len;
+      if (ra.rpos == ra.wrapPos) {
+        ra.rpos = 0;
+        ra.wrapPos = -1;
+      }
+      ra.numOfRecords--;
+      ra.bytes -= len;
+      if (ra.readerWaiting && ra.bytes <= ra.size / 2) pthread_cond_signal(&ra.notFull);
+      pthread_mutex_unlock(&ra.mutex);
+    }
+
+    pthread_join(thread, NULL);
+  }
+
+  pthread_cond_destroy(&ra.notFull);
+  pthread_cond_destroy(&ra.notEmpty);
+  pthread_mutex_destroy(&ra.mutex);
+  tfree(ra.buf);
+
+  return ra.code;
+}
+
+static int32_t walRestoreWalFile(SWalRestore *pRestore, char *name, int64_t fileId) {
+  if (pRestore->pWal->restoreBufSize > 0) {
+    return walRestoreWalFileByReadAhead(pRestore, name, fileId);
+  }
+
+  return walReadWalFile(pRestore->pWal, name, fileId, walApplyRecord, pRestore);
+}
+
+static int32_t walReadWalFile(SWal *pWal, char *name, int64_t fileId, FWalRecord fp, void *param) {
   int32_t size = WAL_MAX_SIZE;
   void *  buffer = tmalloc(size);
   if (buffer == NULL) {
@@ -426,13 +780,10 @@ static int32_t walRestoreWalFile(SWal *pWal, void *pVnode, FWalWrite writeFp, ch
 #endif
     offset = offset + sizeof(SWalHead) + pHead->len;
 
-    wTrace("vgId:%d, restore wal, fileId:%" PRId64 " hver:%" PRIu64 " wver:%" PRIu64 " len:%d offset:%" PRId64,
-           pWal->vgId, fileId, pHead->version, pWal->version, pHead->len, offset);
-
-    pWal->version = pHead->version;
+    wTrace("vgId:%d, restore wal, fileId:%" PRId64 " hver:%" PRIu64 " len:%d offset:%" PRId64, pWal->vgId, fileId,
+           pHead->version, pHead->len, offset);
 
-    //wInfo("writeFp: %ld", offset);
-    (*writeFp)(pVnode, pHead, TAOS_QTYPE_WAL, NULL);
+    (*fp)(param, pHead);
   }
 
   tfClose(tfd);
@@ -460,4 +811,14 @@ void walResetVersion(twalh param, uint64_t newVer) {
   wInfo("vgId:%d, version reset from %" PRIu64 " to %" PRIu64, pWal->vgId, pWal->version, newVer);
 
   pWal->version = newVer;
-}
\ No newline at end of file
+}
+
+void walGetStat(SWalStat *pStat) {
+  pStat->flushes = atomic_load_64(&tsWalStat.flushes);
+  pStat->records = atomic_load_64(&tsWalStat.records);
+  pStat->bytes = atomic_load_64(&tsWalStat.bytes);
+  for (int32_t i = 0; i < WAL_HIST_BUCKETS; ++i) {
+    pStat->batchHist[i] = atomic_load_64(&tsWalStat.batchHist[i]);
+    pStat->latencyHist[i] = atomic_load_64(&tsWalStat.latencyHist[i]);
+  }
+}
@@ -0,0 +1,171 @@
+// Test of taos_stmt_bind_columns: the columns bound are inserted and read back, rows of a duplicated
+// timestamp are deduplicated like those bound by taos_stmt_bind_param_batch
+// to compile: gcc -o stmtColumnsTest stmtColumnsTest.c -ltaos
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "taos.h"
+
+#define NUM_OF_ROWS 6
+
+static int g_failed = 0;
+
+static void execute(TAOS *taos, const char *sql) {
+  TAOS_RES *res = taos_query(taos, sql);
+  if (taos_errno(res) != 0) {
+    printf("failed to execute: %s, reason:%s\n", sql, taos_errstr(res));
+    exit(1);
+  }
+  taos_free_result(res);
+}
+
+static void check(int cond, const char *desc) {
+  if (!cond) {
+    printf("check failed: %s\n", desc);
+    g_failed = 1;
+  }
+}
+
+// keys are not in order, and key 1600000000003 is bound twice
+static int64_t g_ts[NUM_OF_ROWS] = {1600000000003, 1600000000001, 1600000000002,
+                                    1600000000003, 1600000000005, 1600000000004};
+static int32_t g_iv[NUM_OF_ROWS] = {30, 10, 20, 31, 50, 40};
+static char    g_iNull[NUM_OF_ROWS] = {0, 0, 0, 0, 0, 1};
+static int64_t g_bv[NUM_OF_ROWS] = {300, 100, 200, 301, 500, 400};
+static char    g_bNull[NUM_OF_ROWS] = {0, 1, 0, 0, 0, 0};
+static char    g_sv[NUM_OF_ROWS][10] = {"c", "a", "bb", "cc", "eeeee", "dddd"};
+static int32_t g_sLen[NUM_OF_ROWS] = {1, 1, 2, 2, 5, 4};
+static char    g_nv[NUM_OF_ROWS][10] = {"n3", "n1", "n2", "n33", "n5", "n4"};
+static int32_t g_nLen[NUM_OF_ROWS] = {2, 2, 2, 3, 2, 2};
+
+static void bindRows(TAOS *taos, const char *tname, int columns) {
+  TAOS_MULTI_BIND params[5];
+  memset(params, 0, sizeof(params));
+
+  params[0].buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  params[0].buffer_length = sizeof(int64_t);
+  params[0].buffer = g_ts;
+  params[0].num = NUM_OF_ROWS;
+
+  params[1].buffer_type = TSDB_DATA_TYPE_INT;
+  params[1].buffer_length = sizeof(int32_t);
+  params[1].buffer = g_iv;
+  params[1].is_null = g_iNull;
+  params[1].num = NUM_OF_ROWS;
+
+  params[2].buffer_type = TSDB_DATA_TYPE_BIGINT;
+  params[2].buffer_length = sizeof(int64_t);
+  params[2].buffer = g_bv;
+  params[2].is_null = g_bNull;
+  params[2].num = NUM_OF_ROWS;
+
+  params[3].buffer_type = TSDB_DATA_TYPE_BINARY;
+  params[3].buffer_length = sizeof(g_sv[0]);
+  params[3].buffer = g_sv;
+  params[3].length = g_sLen;
+  params[3].num = NUM_OF_ROWS;
+
+  params[4].buffer_type = TSDB_DATA_TYPE_NCHAR;
+  params[4].buffer_length = sizeof(g_nv[0]);
+  params[4].buffer = g_nv;
+  params[4].length = g_nLen;
+  params[4].num = NUM_OF_ROWS;
+
+  char sql[128];
+  snprintf(sql, sizeof(sql), "insert into %s values(?,?,?,?,?)", tname);
+
+  TAOS_STMT *stmt = taos_stmt_init(taos);
+  if (taos_stmt_prepare(stmt, sql, 0) != 0) {
+    printf("failed to prepare: %s, reason:%s\n", sql, taos_stmt_errstr(stmt));
+    exit(1);
+  }
+
+  int code;
+  if (columns) {
+    code = taos_stmt_bind_columns(stmt, params);
+  } else {
+    code = taos_stmt_bind_param_batch(stmt, params);
+    if (code == 0) code = taos_stmt_add_batch(stmt);
+  }
+
+  if (code != 0 || taos_stmt_execute(stmt) != 0) {
+    printf("failed to insert into %s, reason:%s\n", tname, taos_stmt_errstr(stmt));
+    exit(1);
+  }
+
+  taos_stmt_close(stmt);
+}
+
+// read back the rows of the table, the row of key 1600000000003 is expected to be the one bound first
+static void checkRows(TAOS *taos, const char *tname, int checkDupRow) {
+  char sql[128];
+  snprintf(sql, sizeof(sql), "select ts, i, b, s, n from %s", tname);
+
+  TAOS_RES *res = taos_query(taos, sql);
+  if (taos_errno(res) != 0) {
+    printf("failed to query: %s, reason:%s\n", sql, taos_errstr(res));
+    exit(1);
+  }
+
+  // the expected rows in key order, the index of the rows bound
+  int32_t expected[] = {1, 2, 0, 5, 4};
+  int32_t numOfRows = 0;
+
+  TAOS_ROW row;
+  while ((row = taos_fetch_row(res)) != NULL) {
+    int32_t *lengths = taos_fetch_lengths(res);
+    if (numOfRows >= (int32_t)(sizeof(expected) / sizeof(expected[0]))) {
+      numOfRows++;
+      continue;
+    }
+
+    int32_t idx = expected[numOfRows++];
+    check(*(int64_t *)row[0] == g_ts[idx], "timestamp");
+    if (idx == 0 && !checkDupRow) continue;
+
+    check(g_iNull[idx] ? row[1] == NULL : (row[1] != NULL && *(int32_t *)row[1] == g_iv[idx]), "int column");
+    check(g_bNull[idx] ? row[2] == NULL : (row[2] != NULL && *(int64_t *)row[2] == g_bv[idx]), "bigint column");
+    check(row[3] != NULL && lengths[3] == g_sLen[idx] && memcmp(row[3], g_sv[idx], g_sLen[idx]) == 0,
+          "binary column");
+    check(row[4] != NULL && lengths[4] == g_nLen[idx] && memcmp(row[4], g_nv[idx], g_nLen[idx]) == 0,
+          "nchar column");
+  }
+
+  check(numOfRows == 5, "number of rows");
+  printf("%s: %d rows read back\n", tname, numOfRows);
+  taos_free_result(res);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("please input server ip \n");
+    return 0;
+  }
+
+  TAOS *taos = taos_connect(argv[1], "root", "taosdata", NULL, 0);
+  if (taos == NULL) {
+    printf("failed to connect to db, reason:%s\n", taos_errstr(taos));
+    exit(1);
+  }
+
+  execute(taos, "drop database if exists stmt_col_db");
+  // with update 1 a duplicated row inserted later replaces the former, so the rows must be deduplicated before
+  execute(taos, "create database stmt_col_db update 1");
+  execute(taos, "use stmt_col_db");
+  execute(taos, "create table tcol (ts timestamp, i int, b bigint, s binary(10), n nchar(10))");
+  execute(taos, "create table trow (ts timestamp, i int, b bigint, s binary(10), n nchar(10))");
+
+  bindRows(taos, "tcol", 1);
+  bindRows(taos, "trow", 0);
+
+  checkRows(taos, "tcol", 1);
+  // the row path keeps one of the duplicated rows, not always the first one
+  checkRows(taos, "trow", 0);
+
+  taos_close(taos);
+
+  printf("test %s\n", g_failed ? "failed" : "passed");
+  return g_failed ? 1 : 0;
+}